@@ -0,0 +1,98 @@
+<?php
+/**
+ * This file is part of Swow
+ *
+ * @link    https://github.com/swow/swow
+ * @contact twosee <twosee@php.net>
+ *
+ * For the full copyright and license information,
+ * please view the LICENSE file that was distributed with this source code
+ */
+
+declare(strict_types=1);
+
+use Swow\Coroutine;
+use Swow\Sync\WaitGroup;
+
+/* php benchmark/fs_backend.php [concurrency] [operations]
+ * it runs itself again with io_uring on and off to compare file-system backends */
+
+$concurrency = (int) ($argv[1] ?? 64);
+$operations = (int) ($argv[2] ?? 2000);
+$blockSize = 4096;
+
+if (getenv('SWOW_FS_BENCHMARK_CHILD') === false) {
+    putenv('SWOW_FS_BENCHMARK_CHILD=1');
+    $options = '';
+    foreach (ini_get_all('swow', false) as $name => $value) {
+        if ($name !== 'swow.io_uring') {
+            $options .= sprintf(' -d %s', escapeshellarg("{$name}={$value}"));
+        }
+    }
+    foreach (['thread_pool' => 0, 'io_uring' => 1] as $backend => $ioUring) {
+        echo sprintf('[%s]' . PHP_EOL, $backend);
+        passthru(sprintf(
+            '%s%s -d swow.io_uring=%d %s %d %d',
+            escapeshellarg(PHP_BINARY), $options, $ioUring, escapeshellarg(__FILE__), $concurrency, $operations
+        ));
+    }
+    exit(0);
+}
+
+$file = tempnam(sys_get_temp_dir(), 'swow_fs_');
+file_put_contents($file, str_repeat('x', $blockSize * $concurrency));
+
+$benchmarks = [
+    'pread' => static function (int $id) use ($file, $blockSize, $operations): void {
+        $fp = fopen($file, 'rb');
+        for ($n = $operations; $n--;) {
+            fseek($fp, $id * $blockSize);
+            fread($fp, $blockSize);
+        }
+        fclose($fp);
+    },
+    'pwrite' => static function (int $id) use ($file, $blockSize, $operations): void {
+        $fp = fopen($file, 'r+b');
+        $data = str_repeat(chr(ord('a') + $id % 26), $blockSize);
+        for ($n = $operations; $n--;) {
+            fseek($fp, $id * $blockSize);
+            fwrite($fp, $data);
+        }
+        fclose($fp);
+    },
+    'stat' => static function () use ($file, $operations): void {
+        for ($n = $operations; $n--;) {
+            clearstatcache();
+            stat($file);
+        }
+    },
+    'open+close' => static function () use ($file, $operations): void {
+        for ($n = $operations; $n--;) {
+            fclose(fopen($file, 'rb'));
+        }
+    },
+];
+
+foreach ($benchmarks as $name => $benchmark) {
+    $wg = new WaitGroup();
+    $use = microtime(true);
+    for ($id = 0; $id < $concurrency; $id++) {
+        $wg->add();
+        Coroutine::run(static function () use ($benchmark, $id, $wg): void {
+            try {
+                $benchmark($id);
+            } finally {
+                $wg->done();
+            }
+        });
+    }
+    $wg->wait();
+    $use = microtime(true) - $use;
+    $times = $concurrency * $operations;
+    echo sprintf(
+        '%-12s %8d ops in %7.3fs, %10.2f ops/s, %8.2fus/op' . PHP_EOL,
+        $name, $times, $use, $times / $use, $use * 1000 * 1000 / $times
+    );
+}
+
+unlink($file);
@@ -6,7 +6,9 @@ ulimit -n 8192
 export SERVER_HOST=127.0.0.1
 export SERVER_PORT=9764
 export SERVER_BACKLOG=8192
-/usr/bin/env php -dextension=swow "${__DIR__}/../examples/http_server/echo.php" &
+# SERVER_EXAMPLE=native to benchmark the native Swow\Http\Server
+SERVER_EXAMPLE=${SERVER_EXAMPLE:-echo}
+/usr/bin/env php -dextension=swow "${__DIR__}/../examples/http_server/${SERVER_EXAMPLE}.php" &
 pid=$!
 
 sleep 1
@@ -0,0 +1,47 @@
+<?php
+/**
+ * This file is part of Swow
+ *
+ * @link    https://github.com/swow/swow
+ * @contact twosee <twosee@php.net>
+ *
+ * For the full copyright and license information,
+ * please view the LICENSE file that was distributed with this source code
+ */
+
+declare(strict_types=1);
+
+use Swow\Buffer;
+use Swow\WebSocket\WebSocket;
+
+$sizes = [64, 1024, 64 * 1024, 1024 * 1024, 8 * 1024 * 1024];
+$bytesPerRound = 256 * 1024 * 1024;
+$maskingKey = WebSocket::DEFAULT_MASKING_KEY;
+
+echo sprintf('Default kernel: %s' . PHP_EOL, WebSocket::getMaskingKernel());
+foreach ($sizes as $size) {
+    $buffer = new Buffer($size);
+    $buffer->append(str_repeat('x', $size));
+    $times = max(1, intdiv($bytesPerRound, $size));
+    $baseline = null;
+    foreach (['scalar', 'sse2', 'avx2', 'neon'] as $kernel) {
+        try {
+            WebSocket::setMaskingKernel($kernel);
+        } catch (ValueError) {
+            continue; /* unsupported */
+        }
+        $use = microtime(true);
+        for ($n = $times; $n--;) {
+            /* index is rotated to go through the unaligned masking key path */
+            WebSocket::unmask($buffer, 0, -1, $maskingKey, $n);
+        }
+        $use = microtime(true) - $use;
+        $throughput = $size * $times / $use / (1024 * 1024 * 1024);
+        $baseline ??= $throughput;
+        echo sprintf(
+            '%-8s %10d bytes x %-8d %8.3fs %8.2f GiB/s (x%.2f)' . PHP_EOL,
+            $kernel, $size, $times, $use, $throughput, $throughput / $baseline
+        );
+    }
+}
+WebSocket::setMaskingKernel('auto');
@@ -0,0 +1,33 @@
+<?php
+/**
+ * This file is part of Swow
+ *
+ * @link    https://github.com/swow/swow
+ * @contact twosee <twosee@php.net>
+ *
+ * For the full copyright and license information,
+ * please view the LICENSE file that was distributed with this source code
+ */
+
+declare(strict_types=1);
+
+use Swow\Http\Server;
+use Swow\Http\Server\Request;
+use Swow\Socket;
+
+$host = getenv('SERVER_HOST') ?: '127.0.0.1';
+$port = (int) (getenv('SERVER_PORT') ?: 9764);
+$backlog = (int) (getenv('SERVER_BACKLOG') ?: 8192);
+$multi = (bool) (getenv('SERVER_MULTI') ?: false);
+$bindFlag = Socket::BIND_FLAG_NONE;
+
+$socket = new Socket(Socket::TYPE_TCP);
+if ($multi) {
+    $bindFlag |= Socket::BIND_FLAG_REUSEPORT;
+}
+$socket->bind($host, $port, $bindFlag)->listen($backlog);
+/* accepting, parsing, keep-alive and pipelining are all done by the native server,
+ * we only need to echo the request body back */
+(new Server($socket))->serve(static function (Request $request): string {
+    return $request->getBody();
+});
@@ -378,6 +378,7 @@ EOF
     swow_defer.c \
     swow_coroutine.c \
     swow_channel.c \
+    swow_thread.c \
     swow_sync.c \
     swow_event.c \
     swow_time.c \
@@ -392,6 +393,7 @@ EOF
     swow_closure.c \
     swow_ipaddress.c \
     swow_http.c \
+    swow_http_server.c \
     swow_websocket.c \
     swow_proc_open.c \
     , SWOW_INCLUDES, SWOW_CFLAGS)
@@ -485,6 +487,7 @@ EOF
       cat_signal.c \
       cat_os_wait.c \
       cat_async.c \
+      cat_thread_channel.c \
       cat_watchdog.c \
       cat_http.c \
       cat_websocket.c, SWOW_CAT_INCLUDES, SWOW_CAT_CFLAGS)
@@ -622,6 +625,37 @@ EOF
             procfs-exepath.c \
             random-getrandom.c \
             random-sysctl-linux.c, SWOW_UV_INCLUDES, SWOW_UV_CFLAGS)
+
+          dnl io_uring backend of libcat fs (syscalls are used directly, liburing is not required)
+          AC_MSG_CHECKING([for io_uring])
+          AC_COMPILE_IFELSE([AC_LANG_PROGRAM([[
+            #include <linux/io_uring.h>
+          ]], [[
+            struct io_uring_probe probe;
+            int ops[] = { IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_READ, IORING_OP_WRITE, IORING_OP_LAST };
+            (void) probe; (void) ops;
+            return IORING_REGISTER_PROBE + IORING_FEAT_RW_CUR_POS + IO_URING_OP_SUPPORTED;
+          ]])], [
+            AC_MSG_RESULT([yes])
+            AC_DEFINE([CAT_HAVE_IO_URING], 1, [Have io_uring])
+          ], [
+            AC_MSG_RESULT([no])
+          ])
+
+          dnl kernel TLS offload of libcat ssl (the tls module is probed at runtime)
+          AC_MSG_CHECKING([for kernel TLS])
+          AC_COMPILE_IFELSE([AC_LANG_PROGRAM([[
+            #include <linux/tls.h>
+          ]], [[
+            struct tls12_crypto_info_aes_gcm_128 crypto_info;
+            (void) crypto_info;
+            return TLS_TX + TLS_1_2_VERSION + TLS_CIPHER_AES_GCM_128;
+          ]])], [
+            AC_MSG_RESULT([yes])
+            AC_DEFINE([CAT_HAVE_KTLS], 1, [Have kernel TLS])
+          ], [
+            AC_MSG_RESULT([no])
+          ])
         ],
         [freebsd*], [
           SWOW_ADD_SOURCES(deps/libcat/deps/libuv/src/unix,
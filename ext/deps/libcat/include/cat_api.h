@@ -37,6 +37,7 @@ extern "C" {
 #include "cat_signal.h"
 #include "cat_os_wait.h"
 #include "cat_async.h"
+#include "cat_thread_channel.h"
 #include "cat_watchdog.h"
 #include "cat_process.h"
 #include "cat_ssl.h"
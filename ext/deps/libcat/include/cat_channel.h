@@ -44,11 +44,9 @@ typedef uint8_t cat_channel_data_size_t;
 
 typedef void (*cat_channel_data_dtor_t)(const cat_data_t *data);
 
-/* Note: this should be public, it's used by channel_get_storage() */
-typedef struct cat_channel_bucket_s {
-    cat_queue_node_t node;
-    char data[1];
-} cat_channel_bucket_t;
+/* buffered channel stores data in a ring buffer whose size is power of two,
+ * it is allocated on the first push, and it grows up to the capacity on demand */
+#define CAT_CHANNEL_STORAGE_INITIAL_MAX_SIZE 1024
 
 typedef struct cat_channel_s {
     cat_channel_flags_t flags;
@@ -70,7 +68,11 @@ typedef struct cat_channel_s {
             } able;
         } unbuffered;
         struct {
-            cat_queue_t storage;
+            char *storage;
+            /* count of slots (power of two) */
+            cat_channel_size_t size;
+            /* index of the front slot */
+            cat_channel_size_t head;
         } buffered;
     } u;
 } cat_channel_t;
@@ -82,6 +84,13 @@ CAT_API cat_channel_t *cat_channel_create(cat_channel_t *channel, cat_channel_si
 CAT_API cat_bool_t cat_channel_push(cat_channel_t *channel, const cat_data_t *data, cat_timeout_t timeout);
 CAT_API cat_bool_t cat_channel_pop(cat_channel_t *channel, cat_data_t *data, cat_timeout_t timeout);
 
+/* transfer data as many as the storage and the waiting peers allow at once,
+ * it waits only if none of them can be transferred, waiting peers are woken up only once
+ * for all transferred data (except that unbuffered channel hands over one data per wake-up),
+ * returns count of data which have been transferred (from the front of data), or 0 on failure */
+CAT_API size_t cat_channel_push_many(cat_channel_t *channel, const cat_data_t *data, size_t count, cat_timeout_t timeout);
+CAT_API size_t cat_channel_pop_many(cat_channel_t *channel, cat_data_t *data, size_t count, cat_timeout_t timeout);
+
 /* close channel without clean storage */
 CAT_API cat_bool_t cat_channel_close(cat_channel_t *channel);
 /* close channel if channel is not closed and clean storage */
@@ -131,7 +140,18 @@ CAT_API cat_channel_data_dtor_t cat_channel_set_dtor(cat_channel_t *channel, cat
 
 /* ext */
 
-CAT_API cat_queue_t *cat_channel_get_storage(cat_channel_t *channel); CAT_INTERNAL
+/* index 0 is the front one, index must be less than length */
+CAT_API cat_data_t *cat_channel_get_storage_data(cat_channel_t *channel, cat_channel_size_t index); CAT_INTERNAL
+
+#define CAT_CHANNEL_STORAGE_FOREACH_DATA_START(channel, name) do { \
+    cat_channel_t *_channel = (channel); \
+    cat_channel_size_t _index; \
+    for (_index = 0; _index < _channel->length; _index++) { \
+        cat_data_t *name = cat_channel_get_storage_data(_channel, _index);
+
+#define CAT_CHANNEL_STORAGE_FOREACH_DATA_END() \
+    } \
+} while (0)
 
 #ifdef __cplusplus
 }
@@ -61,6 +61,17 @@ typedef void *cat_coroutine_context_t;
 #define CAT_COROUTINE_USE_ASAN
 #endif
 
+/* ASan poisons the stack frames which never return,
+ * so we can not reuse the stack memory safely */
+#if defined(CAT_COROUTINE_USE_USER_STACK) && !defined(CAT_COROUTINE_USE_ASAN)
+#define CAT_COROUTINE_USE_STACK_POOL 1
+#endif
+
+/* max count of different stack sizes can be cached */
+#define CAT_COROUTINE_STACK_POOL_MAX_CLASSES          8
+/* max count of cached stacks for each stack size by default */
+#define CAT_COROUTINE_STACK_POOL_DEFAULT_MAX_COUNT    64
+
 typedef uint64_t cat_coroutine_id_t;
 #define CAT_COROUTINE_ID_FMT "%" PRIu64
 #define CAT_COROUTINE_ID_FMT_SPEC PRIu64
@@ -164,6 +175,35 @@ typedef void (*cat_coroutine_deadlock_callback_t)(void);
 
 typedef cat_msec_t (*cat_coroutine_msec_time_function_t)(void);
 
+typedef struct cat_coroutine_stack_pool_class_s {
+    /* size of virtual memory (including padding) */
+    size_t size;
+    size_t count;
+    void *head;
+} cat_coroutine_stack_pool_class_t;
+
+typedef struct cat_coroutine_stack_pool_s {
+    /* options */
+    size_t max_count;
+    cat_bool_t trim;
+    /* storage */
+    cat_coroutine_stack_pool_class_t classes[CAT_COROUTINE_STACK_POOL_MAX_CLASSES];
+    /* info */
+    size_t count;
+    size_t size;
+    uint64_t hits;
+    uint64_t misses;
+} cat_coroutine_stack_pool_t;
+
+typedef struct cat_coroutine_stack_pool_info_s {
+    size_t max_count;
+    cat_bool_t trim;
+    size_t count;
+    size_t size;
+    uint64_t hits;
+    uint64_t misses;
+} cat_coroutine_stack_pool_info_t;
+
 CAT_GLOBALS_STRUCT_BEGIN(cat_coroutine) {
     /* options */
     cat_coroutine_stack_size_t default_stack_size;
@@ -187,6 +227,8 @@ CAT_GLOBALS_STRUCT_BEGIN(cat_coroutine) {
     cat_coroutine_count_t peak_count;
     /* global switches (for watchdog) */
     cat_coroutine_switches_t switches;
+    /* stack pool */
+    cat_coroutine_stack_pool_t stack_pool;
 } CAT_GLOBALS_STRUCT_END(cat_coroutine);
 
 extern CAT_API CAT_GLOBALS_DECLARE(cat_coroutine);
@@ -215,6 +257,12 @@ CAT_API cat_log_type_t cat_coroutine_set_deadlock_log_type(cat_log_type_t type);
 CAT_API cat_coroutine_deadlock_callback_t cat_coroutine_set_deadlock_callback(cat_coroutine_deadlock_callback_t callback);
 /* function will be used for coroutine_get_start_time()/coroutine_get_end_time() (non-thread-safe) */
 CAT_API cat_coroutine_msec_time_function_t cat_coroutine_set_msec_time_function(cat_coroutine_msec_time_function_t callback);
+/* max count of cached stacks for each stack size, 0 means disable the pool,
+ * return the original max count */
+CAT_API size_t cat_coroutine_set_stack_pool_max_count(size_t count);
+/* release physical pages of cached stacks (MADV_FREE/MADV_DONTNEED),
+ * return the original value */
+CAT_API cat_bool_t cat_coroutine_set_stack_pool_trim(cat_bool_t trim);
 
 /* globals */
 CAT_API cat_coroutine_stack_size_t cat_coroutine_get_default_stack_size(void);
@@ -228,6 +276,8 @@ CAT_API cat_coroutine_count_t cat_coroutine_get_count(void);
 CAT_API cat_coroutine_count_t cat_coroutine_get_real_count(void);
 CAT_API cat_coroutine_count_t cat_coroutine_get_peak_count(void);
 CAT_API cat_coroutine_switches_t cat_coroutine_get_global_switches(void);
+CAT_API void cat_coroutine_get_stack_pool_info(cat_coroutine_stack_pool_info_t *info);
+CAT_API void cat_coroutine_stack_pool_clear(void);
 
 /* ctor and dtor */
 CAT_API cat_coroutine_t *cat_coroutine_create(cat_coroutine_t *coroutine, cat_coroutine_function_t function);
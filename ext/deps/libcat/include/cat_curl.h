@@ -29,12 +29,16 @@ extern "C" {
 
 #include <curl/curl.h>
 
+/* max number of idle multi handles kept for cat_curl_easy_perform() */
+#define CAT_CURL_MULTI_POOL_DEFAULT_MAX_COUNT 16
+
 CAT_API cat_bool_t cat_curl_module_init(void);
 CAT_API cat_bool_t cat_curl_module_shutdown(void);
 CAT_API cat_bool_t cat_curl_runtime_init(void);
 CAT_API cat_bool_t cat_curl_runtime_close(void);
 
 CAT_API CURLcode cat_curl_easy_perform(CURL *ch);
+CAT_API void cat_curl_set_multi_pool_max_count(size_t max_count);
 
 CAT_API CURLM *cat_curl_multi_init(void);
 CAT_API CURLMcode cat_curl_multi_cleanup(CURLM *multi);
@@ -23,16 +23,79 @@ extern "C" {
 #endif
 
 #include "cat.h"
-#include "cat_socket.h"
+#include "cat_queue.h"
+
+#include "uv/tree.h"
 
 /* Notice: this module is a part of Socket */
 
-/*
-typedef struct cat_dns_cache_s {
+/* cache (it is a part of socket globals, so it must be defined before cat_socket.h) */
+
+#define CAT_DNS_CACHE_DEFAULT_MAX_SIZE     0
+#define CAT_DNS_CACHE_DEFAULT_TTL          (30 * 1000)
+#define CAT_DNS_CACHE_DEFAULT_NEGATIVE_TTL (1 * 1000)
+
+struct cat_dns_request_s;
+
+typedef struct cat_dns_cache_entry_s {
+    RB_ENTRY(cat_dns_cache_entry_s) tree_entry;
+    /* LRU node, only for resolved entries */
+    cat_queue_node_t node;
+    /* key */
+    const char *hostname;
+    const char *service;
+    int family;
+    int socktype;
+    int protocol;
+    int flags;
+    /* value (zero status for positive, or resolver error for negative) */
+    int status;
+    struct addrinfo *response;
+    cat_msec_t expires;
+    /* the in-flight resolution, NULL if it has been resolved */
+    struct cat_dns_request_s *request;
+} cat_dns_cache_entry_t;
 
+RB_HEAD(cat_dns_cache_tree_s, cat_dns_cache_entry_s);
+
+typedef struct cat_dns_cache_s {
+    /* all entries (including in-flight ones) */
+    struct cat_dns_cache_tree_s tree;
+    /* resolved entries, least recently used first */
+    cat_queue_t lru;
+    size_t count;
+    size_t max_size;
+    cat_msec_t ttl;
+    cat_msec_t negative_ttl;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t coalesced;
+    cat_bool_t shutdown_task_registered;
 } cat_dns_cache_t;
-*/
 
+typedef struct cat_dns_cache_info_s {
+    size_t count;
+    size_t max_size;
+    cat_msec_t ttl;
+    cat_msec_t negative_ttl;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t coalesced;
+} cat_dns_cache_info_t;
+
+#include "cat_socket.h"
+
+CAT_API void cat_dns_cache_runtime_init(void); CAT_INTERNAL
+
+/* max_size is the max number of resolved entries, zero means that only
+ * concurrent lookups of the same name will be coalesced */
+CAT_API void cat_dns_cache_set_max_size(size_t max_size);
+CAT_API void cat_dns_cache_set_ttl(cat_msec_t ttl);
+CAT_API void cat_dns_cache_set_negative_ttl(cat_msec_t ttl);
+CAT_API void cat_dns_cache_get_info(cat_dns_cache_info_t *info);
+CAT_API void cat_dns_cache_clear(void);
+
+/* Notice: responses are always owned by the caller and must be freed by cat_dns_freeaddrinfo() */
 CAT_API struct addrinfo *cat_dns_getaddrinfo(const char *hostname, const char *service, const struct addrinfo *hints);
 CAT_API struct addrinfo *cat_dns_getaddrinfo_ex(const char *hostname, const char *service, const struct addrinfo *hints, cat_timeout_t timeout);
 CAT_API void cat_dns_freeaddrinfo(struct addrinfo *response);
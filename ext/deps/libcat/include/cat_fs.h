@@ -24,6 +24,7 @@ extern "C" {
 #endif
 
 #include "cat.h"
+#include "cat_work.h"
 #ifndef CAT_OS_WIN
 # include <sys/file.h>
 #endif
@@ -67,6 +68,54 @@ typedef int cat_fs_open_flags_t;
 #define CAT_FS_OPEN_FLAGS_FMT "%d"
 #define CAT_FS_OPEN_FLAGS_FMT_SPEC "d"
 
+#if defined(CAT_OS_LINUX) && defined(CAT_HAVE_IO_URING)
+# define CAT_FS_IO_URING 1
+#endif
+
+/* size of the io_uring submission queue of each event loop */
+#define CAT_FS_IO_URING_ENTRIES 256
+
+#define CAT_FS_BACKEND_MAP(XX) \
+    XX(AUTO,        "auto") \
+    XX(THREAD_POOL, "thread_pool") \
+    XX(IO_URING,    "io_uring")
+
+typedef enum cat_fs_backend_e {
+#define CAT_FS_BACKEND_GEN(name, unused1) CAT_FS_BACKEND_##name,
+    CAT_FS_BACKEND_MAP(CAT_FS_BACKEND_GEN)
+#undef CAT_FS_BACKEND_GEN
+} cat_fs_backend_t;
+
+typedef struct cat_fs_io_uring_s cat_fs_io_uring_t;
+
+CAT_GLOBALS_STRUCT_BEGIN(cat_fs) {
+    cat_fs_backend_t backend;
+    cat_fs_io_uring_t *io_uring;
+    cat_bool_t io_uring_unavailable;
+    /* globals of other threads are zero-filled, so we need a flag to tell the default lane */
+    cat_bool_t work_kind_overridden;
+    cat_work_kind_t work_kind;
+} CAT_GLOBALS_STRUCT_END(cat_fs);
+
+extern CAT_API CAT_GLOBALS_DECLARE(cat_fs);
+
+#define CAT_FS_G(x) CAT_GLOBALS_GET(cat_fs, x)
+
+CAT_API cat_bool_t cat_fs_module_init(void);
+CAT_API cat_bool_t cat_fs_module_shutdown(void);
+
+CAT_API const char *cat_fs_backend_get_name(cat_fs_backend_t backend);
+/* io_uring is used for open/close/read/write/pread/pwrite/fsync/fdatasync/stat/lstat/fstat
+ * in AUTO mode if it is available, it fails if the backend is unavailable */
+CAT_API cat_bool_t cat_fs_set_backend(cat_fs_backend_t backend);
+/* the backend which is actually in use (never AUTO) */
+CAT_API cat_fs_backend_t cat_fs_get_backend(void);
+/* lane of the work executor which operations are submitted to if they run in the thread pool,
+ * it is CAT_WORK_KIND_FS by default, returns the original one
+ * (operations which are delegated to uv_fs_*() always run in the libuv thread pool) */
+CAT_API cat_work_kind_t cat_fs_set_work_kind(cat_work_kind_t kind);
+CAT_API cat_work_kind_t cat_fs_get_work_kind(void);
+
 CAT_API cat_file_t cat_fs_open(const char *path, cat_fs_open_flags_t flags, ...);
 CAT_API int cat_fs_close(cat_file_t fd);
 CAT_API ssize_t cat_fs_read(cat_file_t fd, void *buffer, size_t size);
@@ -42,6 +42,25 @@ CAT_API PGresult *cat_pq_exec(PGconn *conn, const char *query);
 CAT_API PGresult *cat_pq_exec_params(PGconn *conn, const char *command, int n_params,
     const Oid *param_types, const char *const *param_values, const int *param_lengths, const int *param_formats, int result_format);
 
+typedef struct cat_pq_query_s {
+    const char *command;
+    int n_params;
+    const Oid *param_types;
+    const char *const *param_values;
+    const int *param_lengths;
+    const int *param_formats;
+    int result_format;
+} cat_pq_query_t;
+
+/* Send all queries and collect their results in one round trip by pipeline mode (libpq >= 14),
+ * or execute them one by one on older versions.
+ * results[i] is the last result of queries[i], queries after a failed one are not executed,
+ * and their results are PGRES_PIPELINE_ABORTED or NULL, the caller should PQclear() all of them.
+ * It returns false and all results are NULL if the connection failed.
+ * @note: queries outside an explicit transaction are executed in one implicit transaction,
+ *        it is committed only if all of them succeeded (on older versions it is emulated by BEGIN/COMMIT) */
+CAT_API cat_bool_t cat_pq_exec_batch(PGconn *conn, const cat_pq_query_t *queries, size_t count, PGresult **results);
+
 #endif /* CAT_HAVE_PQ */
 
 #ifdef __cplusplus
@@ -42,6 +42,7 @@ extern "C" {
 /* sockaddr */
 
 #define CAT_SOCKET_DEFAULT_BACKLOG  511
+#define CAT_SOCKET_DEFAULT_ACCEPT_BATCH_SIZE 64
 
 #ifdef INET_ADDRSTRLEN
 # define CAT_SOCKET_IPV4_BUFFER_SIZE INET_ADDRSTRLEN
@@ -408,11 +409,34 @@ typedef struct uv_udg_s {
 typedef struct cat_socket_s cat_socket_t;
 typedef struct cat_socket_internal_s cat_socket_internal_t;
 
+typedef struct cat_socket_write_coalescing_s cat_socket_write_coalescing_t;
+
 typedef struct cat_socket_options_s {
     cat_socket_timeout_options_t timeout;
     unsigned int tcp_keepalive_delay;
 } cat_socket_options_t;
 
+/* stats: counters are always-on and cheap (no syscall, no lock),
+ * they are collected per socket and aggregated globally (per thread) */
+
+/* latency histogram buckets: <100us, <1ms, <10ms, <100ms, <1s, >=1s */
+#define CAT_SOCKET_STATS_LATENCY_BUCKET_COUNT 6
+#define CAT_SOCKET_STATS_LATENCY_BUCKET_MIN   (100 * 1000) /* ns */
+
+typedef struct cat_socket_stats_s {
+    uint64_t bytes_read;
+    uint64_t bytes_written;
+    uint64_t read_syscalls;
+    uint64_t write_syscalls;
+    uint64_t read_eagains;
+    uint64_t write_eagains;
+    /* time blocked waiting for readable/writable (ns) */
+    uint64_t read_wait_time;
+    uint64_t write_wait_time;
+    uint64_t accept_latency[CAT_SOCKET_STATS_LATENCY_BUCKET_COUNT];
+    uint64_t connect_latency[CAT_SOCKET_STATS_LATENCY_BUCKET_COUNT];
+} cat_socket_stats_t;
+
 typedef struct cat_socket_inheritance_info_s {
     cat_socket_type_t type;
     cat_socket_options_t options;
@@ -455,6 +479,10 @@ struct cat_socket_internal_s
     cat_ssl_t *ssl;
     char *ssl_peer_name;
 #endif
+    /* it is NULL unless write coalescing is enabled */
+    cat_socket_write_coalescing_t *write_coalescing;
+    /* stats */
+    cat_socket_stats_t stats;
     /* tree */
     RB_ENTRY(cat_socket_internal_s) tree_entry;
     /* bound socket objects */
@@ -518,7 +546,9 @@ CAT_GLOBALS_STRUCT_BEGIN(cat_socket) {
      * e.g., server sockets for poll module. */
     struct cat_socket_internal_tree_s internal_tree;
     /* dns */
-    // TODO: dns_cache (we should implement lru_cache)
+    cat_dns_cache_t dns_cache;
+    /* stats of all sockets (including closed ones) */
+    cat_socket_stats_t stats;
 } CAT_GLOBALS_STRUCT_END(cat_socket);
 
 extern CAT_API CAT_GLOBALS_DECLARE(cat_socket);
@@ -591,6 +621,14 @@ CAT_API cat_bool_t cat_socket_bind_to_ex(cat_socket_t *socket, const char *name,
 CAT_API cat_bool_t cat_socket_listen(cat_socket_t *socket, int backlog);
 CAT_API cat_bool_t cat_socket_accept(cat_socket_t *server, cat_socket_t *client);
 CAT_API cat_bool_t cat_socket_accept_ex(cat_socket_t *server, cat_socket_t *client, cat_timeout_t timeout);
+/* accept a pending connection without waiting, it fails with CAT_EAGAIN if there is none */
+CAT_API cat_bool_t cat_socket_try_accept(cat_socket_t *server, cat_socket_t *client);
+/* accept up to count pending connections without waiting (IPC is not supported),
+ * clients must be lazy sockets, returns the number of accepted connections */
+CAT_API size_t cat_socket_try_accept_many(cat_socket_t *server, cat_socket_t **clients, size_t count);
+/* wait for the first connection, then drain up to count - 1 pending connections without waiting,
+ * clients must be lazy sockets, returns the number of accepted connections (0 on failure) */
+CAT_API size_t cat_socket_accept_many(cat_socket_t *server, cat_socket_t **clients, size_t count, cat_timeout_t timeout);
 
 CAT_API cat_bool_t cat_socket_connect(cat_socket_t *socket, const cat_sockaddr_t *address, cat_socklen_t address_length);
 CAT_API cat_bool_t cat_socket_connect_ex(cat_socket_t *socket, const cat_sockaddr_t *address, cat_socklen_t address_length, cat_timeout_t timeout);
@@ -631,6 +669,7 @@ typedef struct cat_socket_crypto_options_s {
     cat_bool_t no_ticket;
     cat_bool_t no_compression;
     cat_bool_t no_client_ca_list;
+    cat_bool_t ktls; /* offload encryption of sending to kernel if possible */
     void *context; /* context for crypto things */
 } cat_socket_crypto_options_t;
 
@@ -687,6 +726,39 @@ CAT_API ssize_t cat_socket_try_write(cat_socket_t *socket, const cat_socket_writ
 CAT_API ssize_t cat_socket_try_writeto(cat_socket_t *socket, const cat_socket_write_vector_t *vector, unsigned int vector_count, const cat_sockaddr_t *address, cat_socklen_t address_length);
 CAT_API ssize_t cat_socket_try_write_to(cat_socket_t *socket, const cat_socket_write_vector_t *vector, unsigned int vector_count, const char *name, size_t name_length, int port);
 
+/* broadcast: write the same data to many sockets, data is written by try_write() first,
+ * and only the remaining data of sockets which would block is queued and waited together,
+ * errors[i] will be set to the error code of sockets[i] (or 0), it returns the count of failed sockets */
+CAT_API size_t cat_socket_broadcast(cat_socket_t * const *sockets, size_t count, const cat_socket_write_vector_t *vector, unsigned int vector_count, cat_timeout_t timeout, cat_errno_t *errors);
+
+/* batched datagram I/O (by recvmmsg()/sendmmsg() on Linux, or by loop on other platforms) */
+
+typedef struct cat_socket_datagram_s {
+    /* for send_many(), it is the data to send,
+     * for recv_many(), it is the buffer with the given size, and length will be set to the received bytes */
+    char *buffer;
+    size_t size;
+    size_t length;
+    /* for recv_many(), it is set if the datagram was larger than size and the rest of it has been discarded */
+    cat_bool_t truncated;
+    /* destination (send) or source (recv) address, address.length = 0 means none */
+    cat_sockaddr_info_t address;
+} cat_socket_datagram_t;
+
+/* recv_many: it waits for the first datagram and then receives datagrams which have been queued as many as possible without waiting,
+ * it returns the count of received datagrams, or -1 if error occurred before any datagram has been received */
+CAT_API ssize_t cat_socket_recv_many(cat_socket_t *socket, cat_socket_datagram_t *datagrams, size_t count);
+CAT_API ssize_t cat_socket_recv_many_ex(cat_socket_t *socket, cat_socket_datagram_t *datagrams, size_t count, cat_timeout_t timeout);
+/* send_many: it sends datagrams as many as possible at once and only waits when the socket would block,
+ * it returns the count of sent datagrams, it is less than count if error occurred */
+CAT_API size_t cat_socket_send_many(cat_socket_t *socket, const cat_socket_datagram_t *datagrams, size_t count);
+CAT_API size_t cat_socket_send_many_ex(cat_socket_t *socket, const cat_socket_datagram_t *datagrams, size_t count, cat_timeout_t timeout);
+
+/* wait_readable: it waits until the socket has data to read (or EOF, or error) without reading anything,
+ * so that callers do not need to hold a buffer while the connection is idle */
+CAT_API cat_bool_t cat_socket_wait_readable(cat_socket_t *socket);
+CAT_API cat_bool_t cat_socket_wait_readable_ex(cat_socket_t *socket, cat_timeout_t timeout);
+
 CAT_API ssize_t cat_socket_peek(const cat_socket_t *socket, char *buffer, size_t size);
 CAT_API ssize_t cat_socket_peek_ex(const cat_socket_t *socket, char *buffer, size_t size, cat_timeout_t timeout);
 CAT_API ssize_t cat_socket_peekfrom(const cat_socket_t *socket, char *buffer, size_t size, cat_sockaddr_t *address, cat_socklen_t *address_length);
@@ -700,6 +772,23 @@ CAT_API cat_bool_t cat_socket_send_handle_ex(cat_socket_t *socket, cat_socket_t
 CAT_API ssize_t cat_socket_send_file(cat_socket_t *socket, const char *filename, int64_t offset, size_t length);
 CAT_API ssize_t cat_socket_send_file_ex(cat_socket_t *socket, const char *filename, int64_t offset, size_t length, cat_timeout_t timeout);
 
+/* write coalescing: writes on stream sockets are buffered until the buffered data reaches the threshold,
+ * then they are written with the buffered data by one writev(),
+ * the remaining data is flushed at the end of the current event loop round or by flush() */
+#define CAT_SOCKET_WRITE_COALESCING_DEFAULT_THRESHOLD (16 * 1024)
+
+/* threshold = 0 means default one */
+CAT_API cat_bool_t cat_socket_enable_write_coalescing(cat_socket_t *socket, size_t threshold);
+/* buffered data would be flushed before it returns */
+CAT_API cat_bool_t cat_socket_disable_write_coalescing(cat_socket_t *socket);
+CAT_API cat_bool_t cat_socket_is_write_coalescing_enabled(const cat_socket_t *socket);
+CAT_API size_t cat_socket_get_write_coalescing_threshold(const cat_socket_t *socket);
+CAT_API size_t cat_socket_get_write_coalescing_buffered_size(const cat_socket_t *socket);
+
+/* write out the buffered data (if any) and wait for it to be done */
+CAT_API cat_bool_t cat_socket_flush(cat_socket_t *socket);
+CAT_API cat_bool_t cat_socket_flush_ex(cat_socket_t *socket, cat_timeout_t timeout);
+
 /* @note last_error will not be updated when close failed,  */
 CAT_API cat_bool_t cat_socket_close(cat_socket_t *socket);
 
@@ -710,6 +799,7 @@ CAT_API cat_bool_t cat_socket_is_open(const cat_socket_t *socket);
 CAT_API cat_bool_t cat_socket_is_established(const cat_socket_t *socket);
 #ifdef CAT_SSL
 CAT_API cat_bool_t cat_socket_has_crypto(const cat_socket_t *socket);
+CAT_API cat_bool_t cat_socket_is_ktls_send_enabled(const cat_socket_t *socket);
 CAT_API cat_bool_t cat_socket_is_encrypted(const cat_socket_t *socket);
 #endif
 CAT_API cat_bool_t cat_socket_is_server(const cat_socket_t *socket);
@@ -753,6 +843,14 @@ CAT_API cat_bool_t cat_socket_set_tcp_keepalive(cat_socket_t *socket, cat_bool_t
 CAT_API cat_bool_t cat_socket_get_udp_broadcast(const cat_socket_t *socket);
 CAT_API cat_bool_t cat_socket_set_udp_broadcast(cat_socket_t *socket, cat_bool_t enable);
 
+/* stats */
+
+CAT_API cat_bool_t cat_socket_get_stats(const cat_socket_t *socket, cat_socket_stats_t *stats);
+CAT_API void cat_socket_get_global_stats(cat_socket_stats_t *stats);
+CAT_API void cat_socket_reset_global_stats(void);
+/* upper bound (ns, exclusive) of the latency bucket, the last one has no upper bound (returns 0) */
+CAT_API cat_nsec_t cat_socket_stats_get_latency_bucket_bound(size_t index);
+
 /* helper */
 
 CAT_API int cat_socket_get_local_free_port(void);
@@ -24,12 +24,15 @@ extern "C" {
 
 #include "cat.h"
 #include "cat_ref.h"
+#include "cat_queue.h"
 
 #ifdef CAT_HAVE_OPENSSL
 #define CAT_SSL 1
 
 #include "cat_buffer.h"
 
+#include "uv/tree.h"
+
 #ifdef _MSC_VER
 # pragma warning(push)
 # pragma warning(disable:4191) /* FIXME: workaround for MSVC bug */
@@ -127,6 +130,12 @@ extern "C" {
 # endif
 #endif
 
+/* kernel TLS offload (Linux), we export the negotiated keys from OpenSSL by ourselves
+ * because BIO pair is used, so OpenSSL built-in kTLS support can not work for us */
+#if defined(CAT_HAVE_KTLS) && OPENSSL_VERSION_NUMBER >= 0x10101000L && !defined(LIBRESSL_VERSION_NUMBER)
+# define CAT_SSL_HAVE_KTLS 1
+#endif
+
 typedef enum cat_ssl_flag_e {
     CAT_SSL_FLAG_NONE                  = 0,
     CAT_SSL_FLAG_ALLOC                 = 1 << 0,
@@ -135,6 +144,7 @@ typedef enum cat_ssl_flag_e {
     CAT_SSL_FLAG_HANDSHAKE_OK          = 1 << 3,
     CAT_SSL_FLAG_RENEGOTIATION         = 1 << 4,
     CAT_SSL_FLAG_HANDSHAKE_BUFFER_SET  = 1 << 5,
+    CAT_SSL_FLAG_KTLS_SEND             = 1 << 6,
     CAT_SSL_FLAG_UNRECOVERABLE_ERROR   = 1 << 31,
 } cat_ssl_flag_t;
 
@@ -190,8 +200,16 @@ typedef struct cat_ssl_context_s {
 #ifdef CAT_SSL_HAVE_TLS_ALPN
     cat_string_t alpn;
 #endif
+#ifdef CAT_SSL_HAVE_KTLS
+    /* keylog callback which was set before kTLS hooked the SSL_CTX, it is still called for every connection */
+    SSL_CTX_keylog_cb_func ktls_previous_keylog_callback;
+#endif
 } cat_ssl_context_t;
 
+#ifdef CAT_SSL_HAVE_KTLS
+typedef struct cat_ssl_ktls_s cat_ssl_ktls_t;
+#endif
+
 typedef struct cat_ssl_s {
     cat_ssl_flags_t flags;
     cat_ssl_connection_t *connection;
@@ -202,6 +220,10 @@ typedef struct cat_ssl_s {
     cat_bool_t allow_self_signed;
     /* internals */
     cat_ssl_context_t *context; // for free data before SSL_free()
+#ifdef CAT_SSL_HAVE_KTLS
+    cat_ssl_ktls_t *ktls; // it is NULL if kTLS was not requested
+#endif
+    cat_string_t session_cache_key; // client only
 } cat_ssl_t;
 
 typedef enum cat_ssl_ret_e {
@@ -213,7 +235,108 @@ typedef enum cat_ssl_ret_e {
     CAT_SSL_RET_WANT_IO = CAT_SSL_RET_WANT_READ | CAT_SSL_RET_WANT_WRITE,
 } cat_ssl_ret_t;
 
+/* session cache and ticket keys (per runtime, they are shared by all connections) */
+
+#define CAT_SSL_SESSION_CACHE_DEFAULT_MAX_SIZE 1024
+#define CAT_SSL_SESSION_CACHE_DEFAULT_TTL      (300 * 1000)
+
+/* key name (16) + HMAC-SHA256 secret (32) + AES-256-CBC key (32), it is compatible with nginx */
+#define CAT_SSL_TICKET_KEY_NAME_LENGTH          16
+#define CAT_SSL_TICKET_KEY_LENGTH               80
+/* the first one is used to encrypt, others are only used to decrypt (tickets will be renewed) */
+#define CAT_SSL_TICKET_KEYS_MAX                 4
+#define CAT_SSL_TICKET_KEY_DEFAULT_LIFETIME     (3600 * 1000)
+
+typedef enum cat_ssl_session_cache_entry_type_e {
+    CAT_SSL_SESSION_CACHE_ENTRY_SERVER, /* keyed by session id */
+    CAT_SSL_SESSION_CACHE_ENTRY_CLIENT, /* keyed by peer (host:port) */
+} cat_ssl_session_cache_entry_type_t;
+
+typedef struct cat_ssl_session_cache_entry_s {
+    RB_ENTRY(cat_ssl_session_cache_entry_s) tree_entry;
+    /* LRU node */
+    cat_queue_node_t node;
+    /* key */
+    cat_ssl_session_cache_entry_type_t type;
+    size_t key_length;
+    const unsigned char *key;
+    /* value */
+    SSL_SESSION *session;
+    cat_msec_t expires;
+} cat_ssl_session_cache_entry_t;
+
+RB_HEAD(cat_ssl_session_cache_tree_s, cat_ssl_session_cache_entry_s);
+
+typedef struct cat_ssl_session_cache_s {
+    struct cat_ssl_session_cache_tree_s tree;
+    /* least recently used first */
+    cat_queue_t lru;
+    size_t count;
+    size_t max_size;
+    cat_msec_t ttl;
+    uint64_t hits;
+    uint64_t misses;
+    cat_bool_t shutdown_task_registered;
+} cat_ssl_session_cache_t;
+
+typedef struct cat_ssl_ticket_key_s {
+    unsigned char name[CAT_SSL_TICKET_KEY_NAME_LENGTH];
+    unsigned char hmac_secret[32];
+    unsigned char aes_key[32];
+    cat_msec_t created;
+} cat_ssl_ticket_key_t;
+
+typedef struct cat_ssl_ticket_keys_s {
+    cat_ssl_ticket_key_t keys[CAT_SSL_TICKET_KEYS_MAX];
+    size_t count;
+    /* keys are generated and rotated by us unless they were set by user */
+    cat_bool_t user_defined;
+    cat_msec_t lifetime;
+} cat_ssl_ticket_keys_t;
+
+typedef struct cat_ssl_session_cache_info_s {
+    size_t count;
+    size_t max_size;
+    cat_msec_t ttl;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t server_handshakes;
+    uint64_t server_resumptions;
+    uint64_t client_handshakes;
+    uint64_t client_resumptions;
+    size_t ticket_key_count;
+    cat_msec_t ticket_key_lifetime;
+} cat_ssl_session_cache_info_t;
+
+CAT_GLOBALS_STRUCT_BEGIN(cat_ssl) {
+    cat_ssl_session_cache_t session_cache;
+    cat_ssl_ticket_keys_t ticket_keys;
+    uint64_t server_handshakes;
+    uint64_t server_resumptions;
+    uint64_t client_handshakes;
+    uint64_t client_resumptions;
+} CAT_GLOBALS_STRUCT_END(cat_ssl);
+
+extern CAT_API CAT_GLOBALS_DECLARE(cat_ssl);
+
+#define CAT_SSL_G(x) CAT_GLOBALS_GET(cat_ssl, x)
+
 CAT_API cat_bool_t cat_ssl_module_init(void);
+CAT_API cat_bool_t cat_ssl_module_shutdown(void);
+CAT_API cat_bool_t cat_ssl_runtime_init(void);
+
+/* max_size is the max number of cached sessions (server and client), zero disables the cache,
+ * but server can still resume sessions by tickets */
+CAT_API void cat_ssl_session_cache_set_max_size(size_t max_size);
+CAT_API void cat_ssl_session_cache_set_ttl(cat_msec_t ttl);
+CAT_API void cat_ssl_session_cache_get_info(cat_ssl_session_cache_info_t *info);
+CAT_API void cat_ssl_session_cache_clear(void);
+
+/* keys is an array of CAT_SSL_TICKET_KEY_LENGTH bytes keys, the first one is used to encrypt,
+ * set them with the same keys on all processes so that tickets can be resumed by any of them,
+ * count 0 means keys will be generated and rotated automatically (it is the default) */
+CAT_API cat_bool_t cat_ssl_set_ticket_keys(const char *keys, size_t count);
+CAT_API void cat_ssl_set_ticket_key_lifetime(cat_msec_t lifetime);
 
 /* context */
 
@@ -228,6 +351,9 @@ CAT_API cat_bool_t cat_ssl_context_load_verify_locations(cat_ssl_context_t *cont
 CAT_API cat_bool_t cat_ssl_context_set_passphrase(cat_ssl_context_t *context, const char *passphrase, size_t passphrase_length);
 CAT_API cat_bool_t cat_ssl_context_set_certificate(cat_ssl_context_t *context, const char *certificate, const char *certificate_key);
 CAT_API void cat_ssl_context_set_verify_depth(cat_ssl_context_t *context, int depth);
+/* server only, sessions can only be resumed by servers with the same certificate and settings,
+ * it is derived from the digest of certificate (if any) and the given settings */
+CAT_API cat_bool_t cat_ssl_context_set_session_id_context(cat_ssl_context_t *context, const char *settings, size_t settings_length);
 #ifdef CAT_OS_WIN
 CAT_API void cat_ssl_context_configure_cert_verify_callback(cat_ssl_context_t *context);
 #endif
@@ -251,6 +377,10 @@ CAT_API void cat_ssl_set_accept_state(cat_ssl_t *ssl);
 CAT_API void cat_ssl_set_connect_state(cat_ssl_t *ssl);
 
 CAT_API cat_bool_t cat_ssl_set_sni_server_name(cat_ssl_t *ssl, const char *name);
+/* client only, it resumes the cached session of the same key (e.g. host:port and settings) if there is,
+ * and new sessions from server will be cached with this key (only its digest is stored) */
+CAT_API cat_bool_t cat_ssl_set_session_cache_key(cat_ssl_t *ssl, const char *key, size_t key_length);
+CAT_API cat_bool_t cat_ssl_is_session_reused(const cat_ssl_t *ssl);
 
 CAT_API cat_bool_t cat_ssl_is_established(const cat_ssl_t *ssl);
 
@@ -270,6 +400,19 @@ CAT_API cat_bool_t cat_ssl_encrypt(
 );
 CAT_API void cat_ssl_encrypted_vector_free(cat_ssl_t *ssl, cat_io_vector_t *vector, unsigned int vector_count);
 CAT_API cat_bool_t cat_ssl_decrypt(cat_ssl_t *ssl, char *out, size_t *out_length, cat_bool_t *eof);
+/* whether there is buffered data which can be decrypted without reading from the socket */
+CAT_API cat_bool_t cat_ssl_has_pending_data(const cat_ssl_t *ssl);
+
+/* kernel TLS */
+
+#ifdef CAT_SSL_HAVE_KTLS
+/* it must be called before handshake, it tracks keys and record sequence for kTLS */
+CAT_API cat_bool_t cat_ssl_prepare_ktls(cat_ssl_t *ssl);
+/* hand our write keys to the kernel, then plain data written to fd will be encrypted by kernel,
+ * it fails if kernel or cipher does not support it, and then SSL still works as usual */
+CAT_API cat_bool_t cat_ssl_enable_ktls_send(cat_ssl_t *ssl, cat_os_socket_t fd);
+#endif
+CAT_API cat_bool_t cat_ssl_is_ktls_send_enabled(const cat_ssl_t *ssl);
 
 typedef enum cat_ssl_shutdown_mask_e {
     CAT_SSL_SENT_SHUTDOWN = SSL_SENT_SHUTDOWN,
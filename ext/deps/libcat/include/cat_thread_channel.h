@@ -0,0 +1,71 @@
+/*
+  +--------------------------------------------------------------------------+
+  | libcat                                                                   |
+  +--------------------------------------------------------------------------+
+  | Licensed under the Apache License, Version 2.0 (the "License");          |
+  | you may not use this file except in compliance with the License.         |
+  | You may obtain a copy of the License at                                  |
+  | http://www.apache.org/licenses/LICENSE-2.0                               |
+  | Unless required by applicable law or agreed to in writing, software      |
+  | distributed under the License is distributed on an "AS IS" BASIS,        |
+  | WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. |
+  | See the License for the specific language governing permissions and      |
+  | limitations under the License. See accompanying LICENSE file.            |
+  +--------------------------------------------------------------------------+
+  | Author: Twosee <twosee@php.net>                                          |
+  +--------------------------------------------------------------------------+
+ */
+
+#ifndef CAT_THREAD_CHANNEL_H
+#define CAT_THREAD_CHANNEL_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "cat.h"
+#include "cat_coroutine.h"
+
+/* Thread channel is a bounded multi-producer multi-consumer channel
+ * which can be shared by coroutines of different threads (event loops).
+ * Data are copied into a lock-free (Vyukov MPMC) ring buffer,
+ * push and pop never block the thread, coroutines which are waiting for
+ * room or data are woken up by cat_async (uv_async_t) of their own event loop. */
+
+typedef struct cat_thread_channel_s cat_thread_channel_t;
+
+typedef uint32_t cat_thread_channel_size_t;
+#define CAT_THREAD_CHANNEL_SIZE_FMT "%u"
+/* sequence differences are compared as int32_t, so that they must be less than 2^31 */
+#define CAT_THREAD_CHANNEL_SIZE_MAX (UINT32_C(1) << 30)
+
+typedef void (*cat_thread_channel_data_dtor_t)(void *data);
+
+/* capacity is rounded up to power of two (at least 2), channel is created with one reference */
+CAT_API cat_thread_channel_t *cat_thread_channel_create(cat_thread_channel_size_t capacity, size_t data_size, cat_thread_channel_data_dtor_t dtor);
+/* every thread which shares the channel should hold its own reference,
+ * the remaining data will be destructed when the last reference is released */
+CAT_API cat_thread_channel_t *cat_thread_channel_add_ref(cat_thread_channel_t *channel);
+CAT_API void cat_thread_channel_release(cat_thread_channel_t *channel);
+
+/* data is copied in (push) and out (pop) with data_size bytes,
+ * pop still gets the remaining data after the channel was closed */
+CAT_API cat_bool_t cat_thread_channel_push(cat_thread_channel_t *channel, const void *data, cat_timeout_t timeout);
+CAT_API cat_bool_t cat_thread_channel_pop(cat_thread_channel_t *channel, void *data, cat_timeout_t timeout);
+/* never wait, and never update last error (they are available in any thread) */
+CAT_API cat_bool_t cat_thread_channel_try_push(cat_thread_channel_t *channel, const void *data);
+CAT_API cat_bool_t cat_thread_channel_try_pop(cat_thread_channel_t *channel, void *data);
+
+/* all waiters will be woken up and fail with CAT_ECLOSED */
+CAT_API void cat_thread_channel_close(cat_thread_channel_t *channel);
+
+/* status (they are just snapshots if other threads are accessing the channel) */
+
+CAT_API cat_thread_channel_size_t cat_thread_channel_get_capacity(const cat_thread_channel_t *channel);
+CAT_API cat_thread_channel_size_t cat_thread_channel_get_length(const cat_thread_channel_t *channel);
+CAT_API size_t cat_thread_channel_get_data_size(const cat_thread_channel_t *channel);
+CAT_API cat_bool_t cat_thread_channel_is_closed(const cat_thread_channel_t *channel);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* CAT_THREAD_CHANNEL_H */
@@ -23,6 +23,44 @@ extern "C" {
 #endif
 
 #include "cat.h"
+#include "cat_queue.h"
+
+/* Coroutine wait timers are managed by a hierarchical timing wheel
+ * (1 root level with 256 slots + 4 node levels with 64 slots, 1ms per tick),
+ * which is driven by a single uv_timer, so arming and canceling a timer
+ * is O(1) and does not need any memory allocation. */
+#define CAT_TIME_WHEEL_ROOT_BITS   8
+#define CAT_TIME_WHEEL_NODE_BITS   6
+#define CAT_TIME_WHEEL_ROOT_SIZE   (1 << CAT_TIME_WHEEL_ROOT_BITS)
+#define CAT_TIME_WHEEL_NODE_SIZE   (1 << CAT_TIME_WHEEL_NODE_BITS)
+#define CAT_TIME_WHEEL_ROOT_MASK   (CAT_TIME_WHEEL_ROOT_SIZE - 1)
+#define CAT_TIME_WHEEL_NODE_MASK   (CAT_TIME_WHEEL_NODE_SIZE - 1)
+#define CAT_TIME_WHEEL_NODE_LEVELS 4
+#define CAT_TIME_WHEEL_MAX_TIMEOUT ((cat_msec_t) UINT32_MAX)
+
+typedef struct cat_time_wheel_s {
+    uv_timer_t timer;
+    cat_bool_t initialized;
+    cat_bool_t running;
+    /* the next tick to be processed */
+    cat_msec_t time;
+    /* the time when timer will be triggered */
+    cat_msec_t due;
+    size_t count;
+    cat_queue_t root[CAT_TIME_WHEEL_ROOT_SIZE];
+    cat_queue_t nodes[CAT_TIME_WHEEL_NODE_LEVELS][CAT_TIME_WHEEL_NODE_SIZE];
+} cat_time_wheel_t;
+
+CAT_GLOBALS_STRUCT_BEGIN(cat_time) {
+    cat_time_wheel_t wheel;
+} CAT_GLOBALS_STRUCT_END(cat_time);
+
+extern CAT_API CAT_GLOBALS_DECLARE(cat_time);
+
+#define CAT_TIME_G(x) CAT_GLOBALS_GET(cat_time, x)
+
+CAT_API cat_bool_t cat_time_module_init(void);
+CAT_API cat_bool_t cat_time_module_shutdown(void);
 
 /* powered by hr_time() */
 CAT_API cat_nsec_t cat_time_nsec(void);
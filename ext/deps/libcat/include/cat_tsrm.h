@@ -23,6 +23,14 @@
 #define CAT_GLOBALS_STRUCT_BEGIN(name) typedef struct CAT_GLOBALS_STRUCT(name)
 #define CAT_GLOBALS_STRUCT_END(name)   CAT_GLOBALS_TYPE(name)
 
+#define CAT_GLOBALS_CTOR(name)         name##_globals_ctor
+
+/* some thread-safe implementations allocate globals of new threads
+ * without initialization, they require a ctor which zeros the globals */
+#ifndef CAT_GLOBALS_CTOR_DECLARE_SZ
+# define CAT_GLOBALS_CTOR_DECLARE_SZ(name)
+#endif
+
 #define CAT_GLOBALS_BZERO(name)        memset(CAT_GLOBALS_BULK(name), 0, sizeof(CAT_GLOBALS_TYPE(name)))
 
 #define CAT_GLOBALS_GET(name, value) (CAT_GLOBALS_BULK(name)->value)
@@ -157,6 +157,32 @@ CAT_API void cat_websocket_mask_ex(const char *from, char *to, uint64_t length,
 CAT_API void cat_websocket_unmask(char *data, uint64_t length, const char *masking_key);
 CAT_API void cat_websocket_unmask_ex(char *data, uint64_t length, const char *masking_key, uint64_t index);
 
+/* mask kernels, the best one supported by CPU is selected by default (auto),
+ * others are mostly used for tests and benchmarks */
+
+#define CAT_WEBSOCKET_MASK_KERNEL_MAP(XX) \
+    XX(AUTO,   0, "auto") \
+    XX(SCALAR, 1, "scalar") \
+    XX(SSE2,   2, "sse2") \
+    XX(AVX2,   3, "avx2") \
+    XX(NEON,   4, "neon")
+
+typedef enum cat_websocket_mask_kernel_e {
+#define CAT_WEBSOCKET_MASK_KERNEL_GEN(name, value, description) CAT_WEBSOCKET_MASK_KERNEL_##name = value,
+    CAT_WEBSOCKET_MASK_KERNEL_MAP(CAT_WEBSOCKET_MASK_KERNEL_GEN)
+#undef CAT_WEBSOCKET_MASK_KERNEL_GEN
+} cat_websocket_mask_kernel_t;
+
+/* vector kernels do not pay off for tiny payloads (e.g. control frames) */
+#ifndef CAT_WEBSOCKET_MASK_SIMD_MIN_LENGTH
+#define CAT_WEBSOCKET_MASK_SIMD_MIN_LENGTH 64
+#endif
+
+CAT_API const char *cat_websocket_mask_kernel_get_name(cat_websocket_mask_kernel_t kernel);
+CAT_API cat_bool_t cat_websocket_mask_kernel_is_supported(cat_websocket_mask_kernel_t kernel);
+CAT_API cat_websocket_mask_kernel_t cat_websocket_get_mask_kernel(void);
+CAT_API cat_bool_t cat_websocket_set_mask_kernel(cat_websocket_mask_kernel_t kernel);
+
 #ifdef __cplusplus
 }
 #endif
@@ -23,18 +23,74 @@ extern "C" {
 #endif
 
 #include "cat.h"
+#include "cat_atomic.h"
 
 typedef cat_data_callback_t cat_work_function_t;
 typedef cat_data_callback_t cat_work_cleanup_callback_t;
 
+/* kinds are the priority lanes of the executor: FS > DNS > CPU,
+ * long CPU-bound works can never occupy all threads,
+ * so file operations are always able to make progress. */
 typedef enum cat_work_kind_e {
   CAT_WORK_KIND_CPU = UV_WORK_CPU,
   CAT_WORK_KIND_FAST_IO = UV_WORK_FAST_IO,
   CAT_WORK_KIND_SLOW_IO = UV_WORK_SLOW_IO,
+  /* lane aliases */
+  CAT_WORK_KIND_FS = CAT_WORK_KIND_FAST_IO,
+  CAT_WORK_KIND_DNS = CAT_WORK_KIND_SLOW_IO,
 } cat_work_kind_t;
 
+#define CAT_WORK_KIND_COUNT 3
+
+/* number of executor threads, 0 means the number of available CPUs,
+ * it can be overridden by cat_work_set_thread_count() or the env CAT_WORK_THREADS */
+#define CAT_WORK_EXECUTOR_DEFAULT_THREADS 0
+#define CAT_WORK_EXECUTOR_MAX_THREADS     1024
+/* capacity of the lock-free queue of each lane of each worker thread,
+ * works are put into a shared locked queue when all of them are full */
+#define CAT_WORK_EXECUTOR_QUEUE_SIZE      256
+
+typedef struct cat_work_stats_s {
+    uint64_t submitted;
+    uint64_t completed;
+    uint64_t canceled;
+    /* works taken from the queue of another worker thread */
+    uint64_t stolen;
+    /* works which can not be put into lock-free queues */
+    uint64_t overflowed;
+    /* total time works spent in queues (ns) */
+    uint64_t wait_time;
+    /* total time works spent in running (ns) */
+    uint64_t run_time;
+    /* backpressure */
+    uint32_t queued;
+    uint32_t max_queued;
+    uint32_t running;
+    uint32_t max_running;
+} cat_work_stats_t;
+
+typedef struct cat_work_runtime_s cat_work_runtime_t;
+
+CAT_GLOBALS_STRUCT_BEGIN(cat_work) {
+    cat_work_runtime_t *runtime;
+} CAT_GLOBALS_STRUCT_END(cat_work);
+
+extern CAT_API CAT_GLOBALS_DECLARE(cat_work);
+
+#define CAT_WORK_G(x) CAT_GLOBALS_GET(cat_work, x)
+
+CAT_API cat_bool_t cat_work_module_init(void);
+CAT_API cat_bool_t cat_work_module_shutdown(void);
+
 CAT_API cat_bool_t cat_work(cat_work_kind_t kind, cat_work_function_t function, cat_work_cleanup_callback_t cleanup, cat_data_t *data, cat_timeout_t timeout);
 
+/* it only takes effect if the executor has not been started yet,
+ * 0 means falling back to the env CAT_WORK_THREADS or the default */
+CAT_API void cat_work_set_thread_count(uint32_t count);
+/* the number of executor threads, 0 if the executor has not been started yet */
+CAT_API uint32_t cat_work_get_thread_count(void);
+CAT_API cat_bool_t cat_work_get_stats(cat_work_kind_t kind, cat_work_stats_t *stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -20,6 +20,8 @@
 
 CAT_API CAT_GLOBALS_DECLARE(cat);
 
+CAT_GLOBALS_CTOR_DECLARE_SZ(cat)
+
 static cat_bool_t cat_args_registered = cat_false;
 
 static uv_thread_t cat_main_thread_tid;
@@ -40,6 +40,9 @@ CAT_API cat_bool_t cat_module_init_all(void)
     return cat_module_init() &&
            cat_coroutine_module_init() &&
            cat_event_module_init() &&
+           cat_work_module_init() &&
+           cat_time_module_init() &&
+           cat_fs_module_init() &&
            cat_buffer_module_init() &&
 #ifdef CAT_SSL
            cat_ssl_module_init() &&
@@ -61,6 +64,12 @@ CAT_API cat_bool_t cat_module_shutdown_all(void)
     ret = cat_os_wait_module_shutdown() && ret;
 #endif
     ret = cat_socket_module_shutdown() && ret;
+#ifdef CAT_SSL
+    ret = cat_ssl_module_shutdown() && ret;
+#endif
+    ret = cat_fs_module_shutdown() && ret;
+    ret = cat_time_module_shutdown() && ret;
+    ret = cat_work_module_shutdown() && ret;
     ret = cat_event_module_shutdown() && ret;
     ret = cat_coroutine_module_shutdown() && ret;
     ret = cat_module_shutdown() && ret;
@@ -73,6 +82,9 @@ CAT_API cat_bool_t cat_runtime_init_all(void)
     return cat_runtime_init() &&
            cat_coroutine_runtime_init() &&
            cat_event_runtime_init() &&
+#ifdef CAT_SSL
+           cat_ssl_runtime_init() &&
+#endif
            cat_socket_runtime_init() &&
 #ifdef CAT_OS_WAIT
            cat_os_wait_runtime_init() &&
@@ -256,37 +256,58 @@ static cat_bool_t cat_channel_unbuffered_pop(cat_channel_t *channel, cat_data_t
     return cat_true;
 }
 
-static cat_always_inline cat_channel_bucket_t *cat_channel_buffered_bucket_create(const cat_data_t *data, size_t data_size)
+static cat_always_inline char *cat_channel_buffered_slot(const cat_channel_t *channel, cat_channel_size_t index)
 {
-    cat_channel_bucket_t *bucket;
+    return channel->u.buffered.storage +
+        (size_t) ((channel->u.buffered.head + index) & (channel->u.buffered.size - 1)) * channel->data_size;
+}
+
+static cat_never_inline cat_bool_t cat_channel_buffered_storage_grow(cat_channel_t *channel)
+{
+    cat_channel_size_t size = channel->u.buffered.size;
+    cat_channel_size_t new_size;
+    char *storage;
 
-    bucket = (cat_channel_bucket_t *) cat_malloc(offsetof(cat_channel_bucket_t, data) + data_size);
+    if (size == 0) {
+        new_size = 1;
+        while (new_size < channel->capacity && new_size < CAT_CHANNEL_STORAGE_INITIAL_MAX_SIZE) {
+            new_size <<= 1;
+        }
+    } else {
+        if (unlikely(size > CAT_CHANNEL_SIZE_MAX / 2)) {
+            cat_update_last_error(CAT_ENOMEM, "Channel storage size overflow");
+            return cat_false;
+        }
+        new_size = size << 1;
+    }
 
+    storage = (char *) cat_realloc(channel->u.buffered.storage, (size_t) new_size * channel->data_size);
 #if CAT_ALLOC_HANDLE_ERRORS
-    if (unlikely(bucket == NULL)) {
-        cat_update_last_error_of_syscall("Malloc for channel bucket failed");
-        return NULL;
+    if (unlikely(storage == NULL)) {
+        cat_update_last_error_of_syscall("Realloc for channel storage failed");
+        return cat_false;
     }
 #endif
+    /* slots which were wrapped to the beginning should be moved to the end of previous ones */
+    if (channel->u.buffered.head + channel->length > size) {
+        cat_channel_size_t n = channel->u.buffered.head + channel->length - size;
+        memcpy(storage + (size_t) size * channel->data_size, storage, (size_t) n * channel->data_size);
+    }
+    channel->u.buffered.storage = storage;
+    channel->u.buffered.size = new_size;
 
-    memcpy(bucket->data, data, data_size);
-
-    return bucket;
+    return cat_true;
 }
 
 static cat_always_inline cat_bool_t cat_channel_buffered_push_data(cat_channel_t *channel, const cat_data_t *data)
 {
-    cat_channel_bucket_t *bucket;
-
-    bucket = cat_channel_buffered_bucket_create(data, channel->data_size);
-
-#if CAT_ALLOC_HANDLE_ERRORS
-    if (unlikely(bucket == NULL)) {
-        return cat_false;
+    if (unlikely(channel->length == channel->u.buffered.size)) {
+        if (unlikely(!cat_channel_buffered_storage_grow(channel))) {
+            return cat_false;
+        }
     }
-#endif
 
-    cat_queue_push_back(&channel->u.buffered.storage, &bucket->node);
+    memcpy(cat_channel_buffered_slot(channel, channel->length), data, channel->data_size);
     channel->length++;
 
     return cat_true;
@@ -294,16 +315,14 @@ static cat_always_inline cat_bool_t cat_channel_buffered_push_data(cat_channel_t
 
 static cat_always_inline void cat_channel_buffered_pop_data(cat_channel_t *channel, cat_data_t *data)
 {
-    cat_channel_bucket_t *bucket;
+    char *slot = cat_channel_buffered_slot(channel, 0);
 
-    bucket = cat_queue_front_data(&channel->u.buffered.storage, cat_channel_bucket_t, node);
-    cat_queue_remove(&bucket->node);
     if (data != NULL) {
-        memcpy(data, bucket->data, channel->data_size);
+        memcpy(data, slot, channel->data_size);
     } else if (channel->dtor != NULL) {
-        channel->dtor(bucket->data);
+        channel->dtor(slot);
     }
-    cat_free(bucket);
+    channel->u.buffered.head = (channel->u.buffered.head + 1) & (channel->u.buffered.size - 1);
     channel->length--;
 }
 
@@ -345,7 +364,7 @@ static cat_bool_t cat_channel_buffered_push(cat_channel_t *channel, const cat_da
         /* push data to the storage queue and return */
         return cat_channel_buffered_push_data(channel, data);
     } else {
-        CAT_ASSERT(!cat_channel__has_producers(channel));
+        /* Notice: there may be other producers which have been notified by pop_many() but not run yet */
         /* push data to the storage queue */
 #if CAT_ALLOC_HANDLE_ERRORS
         if (unlikely(!cat_channel_buffered_push_data(channel, data))) {
@@ -378,7 +397,7 @@ static cat_bool_t cat_channel_buffered_pop(cat_channel_t *channel, cat_data_t *d
         /* pop data from the storage queue and return */
         cat_channel_buffered_pop_data(channel, data);
     } else {
-        CAT_ASSERT(!cat_channel__has_consumers(channel));
+        /* Notice: there may be other consumers which have been notified by push_many() but not run yet */
         /* pop data from the storage queue */
         cat_channel_buffered_pop_data(channel, data);
         /* try to notify one for balance */
@@ -388,6 +407,101 @@ static cat_bool_t cat_channel_buffered_pop(cat_channel_t *channel, cat_data_t *d
     return cat_true;
 }
 
+/* many */
+
+static cat_always_inline const cat_data_t *cat_channel_data_at(const cat_channel_t *channel, const cat_data_t *data, size_t index)
+{
+    return (const char *) data + index * channel->data_size;
+}
+
+static size_t cat_channel_unbuffered_push_many(cat_channel_t *channel, const cat_data_t *data, size_t count, cat_timeout_t timeout)
+{
+    size_t n = 0;
+
+    if (!cat_channel__has_consumers(channel)) {
+        if (unlikely(!cat_channel_unbuffered_push(channel, data, timeout))) {
+            return 0;
+        }
+        n++;
+    }
+    /* hand over the rest to the waiting consumers one by one,
+     * each of them takes one and it will not be queued again before we are back */
+    while (n < count && likely(cat_channel__is_available(channel)) && cat_channel__has_consumers(channel)) {
+        cat_channel_unbuffered_notify_consumer(channel, cat_channel_data_at(channel, data, n));
+        n++;
+    }
+
+    return n;
+}
+
+static size_t cat_channel_unbuffered_pop_many(cat_channel_t *channel, cat_data_t *data, size_t count, cat_timeout_t timeout)
+{
+    size_t n = 0;
+
+    if (!cat_channel__has_producers(channel)) {
+        if (unlikely(!cat_channel_unbuffered_pop(channel, data, timeout))) {
+            return 0;
+        }
+        n++;
+    }
+    while (n < count && cat_channel__has_producers(channel)) {
+        cat_channel_unbuffered_notify_producer(channel, (cat_data_t *) cat_channel_data_at(channel, data, n));
+        n++;
+    }
+
+    return n;
+}
+
+static size_t cat_channel_buffered_push_many(cat_channel_t *channel, const cat_data_t *data, size_t count, cat_timeout_t timeout)
+{
+    size_t n = 0;
+
+    if (cat_channel__is_full(channel)) {
+        /* wait for the first one (consumers will not be notified) */
+        if (unlikely(!cat_channel_buffered_push(channel, data, timeout))) {
+            return 0;
+        }
+        n++;
+    }
+    while (n < count && !cat_channel__is_full(channel)) {
+        if (unlikely(!cat_channel_buffered_push_data(channel, cat_channel_data_at(channel, data, n)))) {
+            if (n == 0) {
+                return 0;
+            }
+            break;
+        }
+        n++;
+    }
+    /* resumed consumer takes data and removes itself from the queue before it yields back */
+    while (!cat_channel__is_empty(channel) && cat_channel__has_consumers(channel)) {
+        cat_channel_notify_possible_consumer(channel);
+    }
+
+    return n;
+}
+
+static size_t cat_channel_buffered_pop_many(cat_channel_t *channel, cat_data_t *data, size_t count, cat_timeout_t timeout)
+{
+    size_t n = 0;
+
+    if (cat_channel__is_empty(channel)) {
+        /* wait for the first one (producers will not be notified) */
+        if (unlikely(!cat_channel_buffered_pop(channel, data, timeout))) {
+            return 0;
+        }
+        n++;
+    }
+    while (n < count && !cat_channel__is_empty(channel)) {
+        cat_channel_buffered_pop_data(channel, (cat_data_t *) cat_channel_data_at(channel, data, n));
+        n++;
+    }
+    while (likely(cat_channel__is_available(channel)) && !cat_channel__is_full(channel) && cat_channel__has_producers(channel)) {
+        cat_channel_notify_possible_producer(channel);
+    }
+
+    return n;
+}
+
 /* common */
 
 CAT_API cat_channel_t *cat_channel_create(cat_channel_t *channel, cat_channel_size_t capacity, cat_channel_data_size_t data_size, cat_channel_data_dtor_t dtor)
@@ -402,7 +516,9 @@ CAT_API cat_channel_t *cat_channel_create(cat_channel_t *channel, cat_channel_si
     if (cat_channel__is_unbuffered(channel)) {
         memset(&channel->u.unbuffered, 0, sizeof(channel->u.unbuffered));
     } else {
-        cat_queue_init(&channel->u.buffered.storage);
+        channel->u.buffered.storage = NULL;
+        channel->u.buffered.size = 0;
+        channel->u.buffered.head = 0;
     }
 
     return channel;
@@ -431,6 +547,40 @@ CAT_API cat_bool_t cat_channel_pop(cat_channel_t *channel, cat_data_t *data, cat
     }
 }
 
+CAT_API size_t cat_channel_push_many(cat_channel_t *channel, const cat_data_t *data, size_t count, cat_timeout_t timeout)
+{
+    CAT_CHANNEL_CHECK_STATE(channel, return 0);
+    CAT_ASSERT(data != NULL);
+
+    if (unlikely(count == 0)) {
+        cat_update_last_error(CAT_EINVAL, "Channel push many requires at least one data");
+        return 0;
+    }
+
+    if (cat_channel__is_unbuffered(channel)) {
+        return cat_channel_unbuffered_push_many(channel, data, count, timeout);
+    } else {
+        return cat_channel_buffered_push_many(channel, data, count, timeout);
+    }
+}
+
+CAT_API size_t cat_channel_pop_many(cat_channel_t *channel, cat_data_t *data, size_t count, cat_timeout_t timeout)
+{
+    CAT_CHANNEL_CHECK_STATE_FOR_READING(channel, return 0);
+    CAT_ASSERT(data != NULL);
+
+    if (unlikely(count == 0)) {
+        cat_update_last_error(CAT_EINVAL, "Channel pop many requires at least one data");
+        return 0;
+    }
+
+    if (cat_channel__is_unbuffered(channel)) {
+        return cat_channel_unbuffered_pop_many(channel, data, count, timeout);
+    } else {
+        return cat_channel_buffered_pop_many(channel, data, count, timeout);
+    }
+}
+
 CAT_API cat_bool_t cat_channel_close(cat_channel_t *channel)
 {
     CAT_CHANNEL_CHECK_STATE(channel, return cat_false);
@@ -459,18 +609,16 @@ CAT_API void cat_channel_cleanup(cat_channel_t *channel)
         (void) cat_channel_close(channel);
     }
 
-    /* clean up the data bucket (no more consumers) */
+    /* clean up the storage (no more consumers) */
     if (!cat_channel__is_unbuffered(channel)) {
-        cat_queue_t *storage = &channel->u.buffered.storage;
-        cat_channel_data_dtor_t dtor = channel->dtor;
-        cat_channel_bucket_t *bucket;
-        while ((bucket = cat_queue_front_data(storage, cat_channel_bucket_t, node))) {
-            cat_queue_remove(&bucket->node);
-            if (dtor != NULL) {
-                dtor(bucket->data);
-            }
-            cat_free(bucket);
-            channel->length--;
+        while (!cat_channel__is_empty(channel)) {
+            cat_channel_buffered_pop_data(channel, NULL);
+        }
+        if (channel->u.buffered.storage != NULL) {
+            cat_free(channel->u.buffered.storage);
+            channel->u.buffered.storage = NULL;
+            channel->u.buffered.size = 0;
+            channel->u.buffered.head = 0;
         }
     }
 
@@ -657,10 +805,10 @@ CAT_API cat_channel_data_dtor_t cat_channel_set_dtor(cat_channel_t *channel, cat
 
 /* ext */
 
-CAT_API cat_queue_t *cat_channel_get_storage(cat_channel_t *channel)
+CAT_API cat_data_t *cat_channel_get_storage_data(cat_channel_t *channel, cat_channel_size_t index)
 {
-    if (unlikely(cat_channel__is_unbuffered(channel))) {
-        return NULL;
-    }
-    return &channel->u.buffered.storage;
+    CAT_ASSERT(!cat_channel__is_unbuffered(channel));
+    CAT_ASSERT(index < channel->length);
+
+    return cat_channel_buffered_slot(channel, index);
 }
@@ -156,6 +156,270 @@ static cat_coroutine_stack_size_t cat_coroutine_align_stack_size(size_t size)
 
 CAT_API CAT_GLOBALS_DECLARE(cat_coroutine);
 
+CAT_GLOBALS_CTOR_DECLARE_SZ(cat_coroutine)
+
+/* stack */
+
+#ifdef CAT_COROUTINE_USE_USER_STACK
+
+static void *cat_coroutine_virtual_memory_alloc(size_t virtual_memory_size)
+{
+    void *virtual_memory;
+
+#if defined(CAT_COROUTINE_USE_MMAP)
+    virtual_memory = mmap(NULL, virtual_memory_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+#elif defined(CAT_COROUTINE_USE_VIRTUAL_ALLOC)
+    virtual_memory = VirtualAlloc(0, virtual_memory_size, MEM_COMMIT, PAGE_READWRITE);
+#else // if defined(CAT_COROUTINE_USE_SYS_MALLOC)
+    virtual_memory = cat_sys_malloc_recoverable(virtual_memory_size);
+#endif
+    if (unlikely(virtual_memory == CAT_COROUTINE_MEMORY_INVALID)) {
+        return CAT_COROUTINE_MEMORY_INVALID;
+    }
+
+#ifdef CAT_COROUTINE_MEMORY_PROTECT_SUPPORT
+    /* protect a page of memory after the stack top
+     * to notify stack overflow */
+    if (cat_coroutine_use_memory_protect) {
+        void *page = virtual_memory;
+        cat_bool_t ret;
+# ifdef CAT_COROUTINE_USE_SYS_MALLOC
+        /* mallocated memory is not aligned with the page */
+        page = cat_getpageafter(page);
+# endif
+# ifndef CAT_OS_WIN
+        ret = mprotect(page, cat_getpagesize(), PROT_NONE) == 0;
+# else
+        DWORD old_protect;
+        ret = VirtualProtect(page, cat_getpagesize(), PAGE_NOACCESS /* PAGE_READWRITE | PAGE_GUARD */, &old_protect) != 0;
+# endif
+        CAT_LOG_DEBUG_V2(COROUTINE, "Protect stack page at %p with %zu bytes %s", page, cat_getpagesize(), ret ? "successfully" : "failed");
+        if (unlikely(!ret)) {
+            CAT_SYSCALL_FAILURE(NOTICE, COROUTINE, "Protect stack page failed");
+        }
+    }
+#endif /* CAT_COROUTINE_MEMORY_PROTECT_SUPPORT */
+
+    return virtual_memory;
+}
+
+static void cat_coroutine_virtual_memory_free(void *virtual_memory, size_t virtual_memory_size)
+{
+#if defined(CAT_COROUTINE_MEMORY_PROTECT_SUPPORT) && defined(CAT_COROUTINE_USE_SYS_MALLOC)
+    if (cat_coroutine_use_memory_protect) {
+        void *page = cat_getpageafter(virtual_memory);
+        cat_bool_t ret;
+# ifndef CAT_OS_WIN
+        ret = mprotect(page, cat_getpagesize(), PROT_READ | PROT_WRITE) == 0;
+# else
+        DWORD old_protect;
+        ret = VirtualProtect(page, cat_getpagesize(), PAGE_READWRITE, &old_protect) != 0;
+# endif
+        CAT_LOG_DEBUG_V2(COROUTINE, "Unprotect stack page at %p with %zu bytes %s", page, cat_getpagesize(), ret ? "successfully" : "failed");
+        if (unlikely(!ret)) {
+            CAT_SYSCALL_FAILURE(NOTICE, COROUTINE, "Unprotect stack page failed");
+        }
+    }
+#endif
+#if defined(CAT_COROUTINE_USE_MMAP)
+    munmap(virtual_memory, virtual_memory_size);
+#elif defined(CAT_COROUTINE_USE_VIRTUAL_ALLOC)
+    VirtualFree(virtual_memory, 0, MEM_RELEASE);
+#elif defined(CAT_COROUTINE_USE_SYS_MALLOC)
+    cat_sys_free(virtual_memory);
+#endif
+}
+
+#ifdef CAT_COROUTINE_USE_STACK_POOL
+/* Note: the node is stored at the bottom of the stack (right after the padding),
+ * it is the farthest place from the stack start, so it is almost never touched,
+ * and the protected page (if any) is kept as it is when the stack is cached */
+typedef struct cat_coroutine_stack_pool_node_s {
+    struct cat_coroutine_stack_pool_node_s *next;
+} cat_coroutine_stack_pool_node_t;
+
+static cat_always_inline size_t cat_coroutine_stack_get_padding_size(void)
+{
+    return cat_getpagesize() * CAT_COROUTINE_STACK_PADDING_PAGE_COUNT;
+}
+
+static cat_coroutine_stack_pool_class_t *cat_coroutine_stack_pool_find_class(size_t virtual_memory_size, cat_bool_t create)
+{
+    cat_coroutine_stack_pool_t *pool = &CAT_COROUTINE_G(stack_pool);
+    cat_coroutine_stack_pool_class_t *klass, *unused_class = NULL;
+    size_t n;
+
+    for (n = 0; n < CAT_ARRAY_SIZE(pool->classes); n++) {
+        klass = &pool->classes[n];
+        if (klass->size == virtual_memory_size) {
+            return klass;
+        }
+        if (klass->count == 0 && unused_class == NULL) {
+            unused_class = klass;
+        }
+    }
+    if (create && unused_class != NULL) {
+        unused_class->size = virtual_memory_size;
+        return unused_class;
+    }
+
+    return NULL;
+}
+
+static void cat_coroutine_stack_pool_trim_stack(void *virtual_memory, size_t virtual_memory_size)
+{
+    size_t page_size = cat_getpagesize();
+    size_t reserved_size = cat_coroutine_stack_get_padding_size() + page_size; /* padding + node page */
+    char *address = ((char *) virtual_memory) + reserved_size;
+    size_t length = virtual_memory_size - reserved_size;
+    cat_bool_t ret = cat_false;
+
+#if defined(CAT_COROUTINE_USE_MMAP)
+# ifdef MADV_FREE
+    /* MADV_FREE is lazy (pages are reclaimed only under memory pressure) */
+    ret = madvise(address, length, MADV_FREE) == 0;
+# endif
+# ifdef MADV_DONTNEED
+    if (!ret) {
+        ret = madvise(address, length, MADV_DONTNEED) == 0;
+    }
+# endif
+#elif defined(CAT_COROUTINE_USE_VIRTUAL_ALLOC)
+    ret = VirtualAlloc(address, length, MEM_RESET, PAGE_READWRITE) != NULL;
+#endif
+    CAT_LOG_DEBUG_V2(COROUTINE, "Trim stack at %p with %zu bytes %s", address, length, ret ? "successfully" : "failed");
+    (void) ret;
+}
+
+static void *cat_coroutine_stack_pool_class_shift(cat_coroutine_stack_pool_class_t *klass)
+{
+    cat_coroutine_stack_pool_t *pool = &CAT_COROUTINE_G(stack_pool);
+    cat_coroutine_stack_pool_node_t *node = (cat_coroutine_stack_pool_node_t *) klass->head;
+
+    CAT_ASSERT(klass->count > 0 && node != NULL);
+    klass->head = node->next;
+    klass->count--;
+    pool->count--;
+    pool->size -= klass->size;
+
+    return ((char *) node) - cat_coroutine_stack_get_padding_size();
+}
+
+static void *cat_coroutine_stack_pool_pop(size_t virtual_memory_size)
+{
+    cat_coroutine_stack_pool_t *pool = &CAT_COROUTINE_G(stack_pool);
+    cat_coroutine_stack_pool_class_t *klass;
+
+    klass = cat_coroutine_stack_pool_find_class(virtual_memory_size, cat_false);
+    if (klass == NULL || klass->count == 0) {
+        pool->misses++;
+        return NULL;
+    }
+    pool->hits++;
+
+    return cat_coroutine_stack_pool_class_shift(klass);
+}
+
+static cat_bool_t cat_coroutine_stack_pool_push(void *virtual_memory, size_t virtual_memory_size)
+{
+    cat_coroutine_stack_pool_t *pool = &CAT_COROUTINE_G(stack_pool);
+    cat_coroutine_stack_pool_class_t *klass;
+    cat_coroutine_stack_pool_node_t *node;
+
+    if (pool->max_count == 0) {
+        return cat_false;
+    }
+    klass = cat_coroutine_stack_pool_find_class(virtual_memory_size, cat_true);
+    if (klass == NULL || klass->count >= pool->max_count) {
+        return cat_false;
+    }
+    if (pool->trim) {
+        cat_coroutine_stack_pool_trim_stack(virtual_memory, virtual_memory_size);
+    }
+    node = (cat_coroutine_stack_pool_node_t *) (((char *) virtual_memory) + cat_coroutine_stack_get_padding_size());
+    node->next = (cat_coroutine_stack_pool_node_t *) klass->head;
+    klass->head = node;
+    klass->count++;
+    pool->count++;
+    pool->size += virtual_memory_size;
+
+    return cat_true;
+}
+#endif /* CAT_COROUTINE_USE_STACK_POOL */
+
+static void *cat_coroutine_stack_alloc(size_t virtual_memory_size)
+{
+#ifdef CAT_COROUTINE_USE_STACK_POOL
+    void *virtual_memory = cat_coroutine_stack_pool_pop(virtual_memory_size);
+    if (virtual_memory != NULL) {
+        return virtual_memory;
+    }
+#endif
+    return cat_coroutine_virtual_memory_alloc(virtual_memory_size);
+}
+
+static void cat_coroutine_stack_free(void *virtual_memory, size_t virtual_memory_size)
+{
+#ifdef CAT_COROUTINE_USE_STACK_POOL
+    if (cat_coroutine_stack_pool_push(virtual_memory, virtual_memory_size)) {
+        return;
+    }
+#endif
+    cat_coroutine_virtual_memory_free(virtual_memory, virtual_memory_size);
+}
+
+#endif /* CAT_COROUTINE_USE_USER_STACK */
+
+CAT_API size_t cat_coroutine_set_stack_pool_max_count(size_t count)
+{
+    cat_coroutine_stack_pool_t *pool = &CAT_COROUTINE_G(stack_pool);
+    size_t original_count = pool->max_count;
+#ifdef CAT_COROUTINE_USE_STACK_POOL
+    pool->max_count = count;
+    if (count < original_count) {
+        /* release the redundant stacks */
+        size_t n;
+        for (n = 0; n < CAT_ARRAY_SIZE(pool->classes); n++) {
+            cat_coroutine_stack_pool_class_t *klass = &pool->classes[n];
+            while (klass->count > count) {
+                cat_coroutine_virtual_memory_free(cat_coroutine_stack_pool_class_shift(klass), klass->size);
+            }
+        }
+    }
+#else
+    (void) count;
+#endif
+    return original_count;
+}
+
+CAT_API cat_bool_t cat_coroutine_set_stack_pool_trim(cat_bool_t trim)
+{
+    cat_coroutine_stack_pool_t *pool = &CAT_COROUTINE_G(stack_pool);
+    cat_bool_t original_trim = pool->trim;
+    pool->trim = trim;
+    return original_trim;
+}
+
+CAT_API void cat_coroutine_get_stack_pool_info(cat_coroutine_stack_pool_info_t *info)
+{
+    const cat_coroutine_stack_pool_t *pool = &CAT_COROUTINE_G(stack_pool);
+
+    info->max_count = pool->max_count;
+    info->trim = pool->trim;
+    info->count = pool->count;
+    info->size = pool->size;
+    info->hits = pool->hits;
+    info->misses = pool->misses;
+}
+
+CAT_API void cat_coroutine_stack_pool_clear(void)
+{
+#ifdef CAT_COROUTINE_USE_STACK_POOL
+    size_t max_count = cat_coroutine_set_stack_pool_max_count(0);
+    CAT_COROUTINE_G(stack_pool).max_count = max_count;
+#endif
+}
+
 CAT_API cat_bool_t cat_coroutine_module_init(void)
 {
     CAT_GLOBALS_REGISTER(cat_coroutine);
@@ -183,6 +447,11 @@ CAT_API cat_bool_t cat_coroutine_runtime_init(void)
     cat_coroutine_set_deadlock_log_type(CAT_LOG_TYPE_WARNING);
     cat_coroutine_set_deadlock_callback(NULL);
 
+    /* init stack pool */
+    memset(&CAT_COROUTINE_G(stack_pool), 0, sizeof(CAT_COROUTINE_G(stack_pool)));
+    cat_coroutine_set_stack_pool_max_count(CAT_COROUTINE_STACK_POOL_DEFAULT_MAX_COUNT);
+    cat_coroutine_set_stack_pool_trim(cat_false);
+
     /* init info */
     CAT_COROUTINE_G(last_id) = 0;
     CAT_COROUTINE_G(count) = 0;
@@ -250,6 +519,10 @@ CAT_API cat_bool_t cat_coroutine_runtime_shutdown(void)
     CAT_ASSERT(cat_coroutine_get_scheduler() == NULL && "Coroutine scheduler should have been stopped");
     CAT_ASSERT(CAT_COROUTINE_G(count) == 1 && "Coroutine count should be 1");
 
+    /* release all cached stacks, and the stacks of
+     * coroutines which are closed after shutdown will not be cached */
+    cat_coroutine_set_stack_pool_max_count(0);
+
     return cat_true;
 }
 
@@ -508,14 +781,8 @@ CAT_API cat_coroutine_t *cat_coroutine_create_ex(cat_coroutine_t *coroutine, cat
     *       stack                                         stack_start
     */
     virtual_memory_size = padding_size + stack_size;
-    /* alloc memory */
-#if defined(CAT_COROUTINE_USE_MMAP)
-    virtual_memory = mmap(NULL, virtual_memory_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
-#elif defined(CAT_COROUTINE_USE_VIRTUAL_ALLOC)
-    virtual_memory = VirtualAlloc(0, virtual_memory_size, MEM_COMMIT, PAGE_READWRITE);
-#else // if defined(CAT_COROUTINE_USE_SYS_MALLOC)
-    virtual_memory = cat_sys_malloc_recoverable(virtual_memory_size);
-#endif
+    /* alloc memory (or reuse a cached one) */
+    virtual_memory = cat_coroutine_stack_alloc(virtual_memory_size);
     if (unlikely(virtual_memory == CAT_COROUTINE_MEMORY_INVALID)) {
         cat_update_last_error_of_syscall("Allocate virtual memory for coroutine stack failed with size %zu", virtual_memory_size);
         if (flags & CAT_COROUTINE_FLAG_ALLOCATED) {
@@ -525,29 +792,6 @@ CAT_API cat_coroutine_t *cat_coroutine_create_ex(cat_coroutine_t *coroutine, cat
     }
     stack = ((char *) virtual_memory) + padding_size;
     stack_start = ((char *) stack) + stack_size;
-
-#ifdef CAT_COROUTINE_MEMORY_PROTECT_SUPPORT
-    /* protect a page of memory after the stack top
-     * to notify stack overflow */
-    if (cat_coroutine_use_memory_protect) {
-        void *page = virtual_memory;
-        cat_bool_t ret;
-# ifdef CAT_COROUTINE_USE_SYS_MALLOC
-        /* mallocated memory is not aligned with the page */
-        page = cat_getpageafter(page);
-# endif
-# ifndef CAT_OS_WIN
-        ret = mprotect(page, cat_getpagesize(), PROT_NONE) == 0;
-# else
-        DWORD old_protect;
-        ret = VirtualProtect(page, cat_getpagesize(), PAGE_NOACCESS /* PAGE_READWRITE | PAGE_GUARD */, &old_protect) != 0;
-# endif
-        CAT_LOG_DEBUG_V2(COROUTINE, "Protect stack page at %p with %zu bytes %s", page, cat_getpagesize(), ret ? "successfully" : "failed");
-        if (unlikely(!ret)) {
-            CAT_SYSCALL_FAILURE(NOTICE, COROUTINE, "Protect stack page failed");
-        }
-    }
-#endif /* CAT_COROUTINE_MEMORY_PROTECT_SUPPORT */
 #endif /* CAT_COROUTINE_USE_USER_STACK */
 
     /* make context */
@@ -618,28 +862,8 @@ CAT_API void cat_coroutine_free(cat_coroutine_t *coroutine)
 #ifdef CAT_HAVE_VALGRIND
     VALGRIND_STACK_DEREGISTER(coroutine->valgrind_stack_id);
 #endif
-#if defined(CAT_COROUTINE_MEMORY_PROTECT_SUPPORT) && defined(CAT_COROUTINE_USE_SYS_MALLOC)
-    if (cat_coroutine_use_memory_protect) {
-        void *page = cat_getpageafter(coroutine->virtual_memory);
-        cat_bool_t ret;
-# ifndef CAT_OS_WIN
-        ret = mprotect(page, cat_getpagesize(), PROT_READ | PROT_WRITE) == 0;
-# else
-        DWORD old_protect;
-        ret = VirtualProtect(page, cat_getpagesize(), PAGE_READWRITE, &old_protect) != 0;
-# endif
-        CAT_LOG_DEBUG_V2(COROUTINE, "Unprotect stack page at %p with %zu bytes %s", page, cat_getpagesize(), ret ? "successfully" : "failed");
-        if (unlikely(!ret)) {
-            CAT_SYSCALL_FAILURE(NOTICE, COROUTINE, "Unprotect stack page failed");
-        }
-    }
-#endif
-#if defined(CAT_COROUTINE_USE_MMAP)
-    munmap(coroutine->virtual_memory, coroutine->virtual_memory_size);
-#elif defined(CAT_COROUTINE_USE_VIRTUAL_ALLOC)
-    VirtualFree(coroutine->virtual_memory, 0, MEM_RELEASE);
-#elif defined(CAT_COROUTINE_USE_SYS_MALLOC)
-    cat_sys_free(coroutine->virtual_memory);
+#ifdef CAT_COROUTINE_USE_USER_STACK
+    cat_coroutine_stack_free(coroutine->virtual_memory, coroutine->virtual_memory_size);
 #endif
     if (coroutine->flags & CAT_COROUTINE_FLAG_ALLOCATED) {
         cat_free(coroutine);
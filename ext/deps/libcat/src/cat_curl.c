@@ -44,11 +44,16 @@ typedef struct cat_curl_multi_context_s {
     cat_coroutine_t *waiter;
     cat_curl_multi_event_t event_storage;
     cat_queue_t events;
+    cat_queue_t sockets;
+    /* node of the idle multi pool for easy perform */
+    cat_queue_node_t pool_node;
 } cat_curl_multi_context_t;
 
 typedef struct cat_curl_multi_socket_context_s {
+    cat_queue_node_t node;
     cat_curl_multi_context_t *context;
     curl_socket_t sockfd;
+    int events;
     uv_poll_t poll;
 } cat_curl_multi_socket_context_t;
 
@@ -75,10 +80,17 @@ RB_GENERATE_STATIC(cat_curl_multi_context_tree_s,
 
 CAT_GLOBALS_STRUCT_BEGIN(cat_curl) {
     struct cat_curl_multi_context_tree_s multi_tree;
+    /* idle multi handles for easy perform, most recently used first,
+     * so that their connection/DNS/TLS session caches can be reused */
+    cat_queue_t multi_pool;
+    size_t multi_pool_count;
+    size_t multi_pool_max_count;
 } CAT_GLOBALS_STRUCT_END(cat_curl);
 
 CAT_GLOBALS_DECLARE(cat_curl);
 
+CAT_GLOBALS_CTOR_DECLARE_SZ(cat_curl)
+
 #define CAT_CURL_G(x) CAT_GLOBALS_GET(cat_curl, x)
 
 /* utils */
@@ -209,8 +221,10 @@ static int cat_curl_multi_socket_function(
 #endif
                     socket_context->context = context;
                     socket_context->sockfd = sockfd;
+                    socket_context->events = 0;
                     (void) uv_poll_init_socket(&CAT_EVENT_G(loop), &socket_context->poll, sockfd);
                     socket_context->poll.data = socket_context;
+                    cat_queue_push_back(&context->sockets, &socket_context->node);
                     curl_multi_assign(multi, sockfd, socket_context);
                 }
             }
@@ -221,12 +235,14 @@ static int cat_curl_multi_socket_function(
             if(action != CURL_POLL_IN) {
                 uv_events |= UV_WRITABLE;
             }
+            socket_context->events = uv_events;
             uv_poll_start(&socket_context->poll, uv_events, cat_curl_multi_socket_poll_callback);
             break;
         }
         case CURL_POLL_REMOVE:
             if (socket_context != NULL) {
                 curl_multi_assign(multi, sockfd, NULL);
+                cat_queue_remove(&socket_context->node);
                 uv_poll_stop(&socket_context->poll);
                 uv_close((uv_handle_t*) &socket_context->poll, cat_curl_multi_socket_context_close_callback);
             }
@@ -281,10 +297,16 @@ static void cat_curl_multi_context_close_callback(uv_handle_t *handle)
 
 static void cat_curl_multi_context_close(cat_curl_multi_context_t *context)
 {
+    cat_curl_multi_socket_context_t *socket_context;
+
     /* we assume that all resources should have been released in curl_multi_socket_function() before,
      * but when fatal error occurred and we called curl_multi_cleanup() without calling
      * curl_multi_remove_handle(), some will not be removed from context.  */
     CAT_ASSERT(cat_queue_empty(&context->events));
+    while ((socket_context = cat_queue_front_data(&context->sockets, cat_curl_multi_socket_context_t, node))) {
+        cat_queue_remove(&socket_context->node);
+        uv_close((uv_handle_t *) &socket_context->poll, cat_curl_multi_socket_context_close_callback);
+    }
     RB_REMOVE(cat_curl_multi_context_tree_s, &CAT_CURL_G(multi_tree), context);
     uv_close((uv_handle_t *) &context->timer, cat_curl_multi_context_close_callback);
 }
@@ -316,6 +338,7 @@ static cat_curl_multi_context_t *cat_curl_multi_create_context(CURLM *multi)
     context->timer.data = context;
     context->waiter = NULL;
     cat_queue_init(&context->events);
+    cat_queue_init(&context->sockets);
     /* following is outdated comment, but I didn't understand the specific meaning,
      * so I won't remove it yet:
      *   latest multi has higher priority
@@ -415,6 +438,77 @@ static cat_always_inline CURLMcode cat_curl_multi_perform_impl(CURLM *multi, int
     return cat_curl_multi_wait_impl(multi, 0, NULL, running_handles);
 }
 
+/* multi pool for easy perform */
+
+static void cat_curl_multi_pool_push(CURLM *multi)
+{
+    cat_curl_multi_context_t *context = cat_curl_multi_get_context(multi);
+    cat_curl_multi_event_t *event;
+
+    CAT_ASSERT(context != NULL);
+    if (CAT_CURL_G(multi_pool_count) >= CAT_CURL_G(multi_pool_max_count)) {
+        (void) cat_curl_multi_cleanup(multi);
+        return;
+    }
+    /* stop watching until it is reused, otherwise an idle connection
+     * which has been closed by peer would wake us up repeatedly,
+     * pending timeouts will be checked by the next perform */
+    (void) uv_timer_stop(&context->timer);
+    CAT_QUEUE_FOREACH_DATA_START(&context->sockets, cat_curl_multi_socket_context_t, node, socket_context) {
+        (void) uv_poll_stop(&socket_context->poll);
+    } CAT_QUEUE_FOREACH_DATA_END();
+    while ((event = cat_queue_front_data(&context->events, cat_curl_multi_event_t, node))) {
+        cat_queue_remove(&event->node);
+        if (event != &context->event_storage) {
+            cat_free(event);
+        }
+    }
+    cat_queue_push_front(&CAT_CURL_G(multi_pool), &context->pool_node);
+    CAT_CURL_G(multi_pool_count)++;
+}
+
+static CURLM *cat_curl_multi_pool_pop(void)
+{
+    cat_curl_multi_context_t *context;
+
+    context = cat_queue_front_data(&CAT_CURL_G(multi_pool), cat_curl_multi_context_t, pool_node);
+    if (context == NULL) {
+        return cat_curl_multi_init();
+    }
+    cat_queue_remove(&context->pool_node);
+    CAT_CURL_G(multi_pool_count)--;
+    CAT_QUEUE_FOREACH_DATA_START(&context->sockets, cat_curl_multi_socket_context_t, node, socket_context) {
+        if (socket_context->events != 0) {
+            (void) uv_poll_start(&socket_context->poll, socket_context->events, cat_curl_multi_socket_poll_callback);
+        }
+    } CAT_QUEUE_FOREACH_DATA_END();
+
+    return context->multi;
+}
+
+static void cat_curl_multi_pool_clear(cat_data_t *data)
+{
+    cat_curl_multi_context_t *context;
+    (void) data;
+
+    while ((context = cat_queue_front_data(&CAT_CURL_G(multi_pool), cat_curl_multi_context_t, pool_node))) {
+        cat_queue_remove(&context->pool_node);
+        CAT_CURL_G(multi_pool_count)--;
+        (void) cat_curl_multi_cleanup(context->multi);
+    }
+}
+
+CAT_API void cat_curl_set_multi_pool_max_count(size_t max_count)
+{
+    CAT_CURL_G(multi_pool_max_count) = max_count;
+    while (CAT_CURL_G(multi_pool_count) > max_count) {
+        cat_curl_multi_context_t *context = cat_queue_back_data(&CAT_CURL_G(multi_pool), cat_curl_multi_context_t, pool_node);
+        cat_queue_remove(&context->pool_node);
+        CAT_CURL_G(multi_pool_count)--;
+        (void) cat_curl_multi_cleanup(context->multi);
+    }
+}
+
 /* easy APIs  */
 
 static CURLcode cat_curl_easy_perform_impl(CURL *ch)
@@ -425,7 +519,7 @@ static CURLcode cat_curl_easy_perform_impl(CURL *ch)
     CURLMcode mcode;
     int running_handles;
 
-    multi = cat_curl_multi_init();
+    multi = cat_curl_multi_pool_pop();
     if (unlikely(multi == NULL)) {
         return CURLE_OUT_OF_MEMORY;
     }
@@ -472,7 +566,7 @@ static CURLcode cat_curl_easy_perform_impl(CURL *ch)
     _error:
     curl_multi_remove_handle(multi, ch);
     _add_failed:
-    cat_curl_multi_cleanup(multi);
+    cat_curl_multi_pool_push(multi);
 
     return code;
 }
@@ -607,6 +701,15 @@ CAT_API cat_bool_t cat_curl_module_shutdown(void)
 
 CAT_API cat_bool_t cat_curl_runtime_init(void)
 {
+    RB_INIT(&CAT_CURL_G(multi_tree));
+    cat_queue_init(&CAT_CURL_G(multi_pool));
+    CAT_CURL_G(multi_pool_count) = 0;
+    CAT_CURL_G(multi_pool_max_count) = CAT_CURL_MULTI_POOL_DEFAULT_MAX_COUNT;
+
+    /* pooled multi handles must be cleaned up before the event loop is closed */
+    if (unlikely(cat_event_register_runtime_shutdown_task(cat_curl_multi_pool_clear, NULL) == NULL)) {
+        return cat_false;
+    }
 
     return cat_true;
 }
@@ -21,79 +21,463 @@
 #include "cat_event.h"
 #include "cat_time.h"
 
-typedef struct cat_getaddrinfo_context_s {
+typedef struct cat_dns_request_s {
     union {
-        cat_coroutine_t *coroutine;
         uv_req_t req;
         uv_getaddrinfo_t getaddrinfo;
     } request;
+    /* NULL if the entry has been dropped from the cache */
+    cat_dns_cache_entry_t *entry;
+    /* coroutines which are waiting for the result */
+    cat_queue_t waiters;
+    cat_bool_t done;
+} cat_dns_request_t;
+
+typedef struct cat_dns_waiter_s {
+    cat_queue_node_t node;
+    /* it will be set to NULL after resolved */
+    cat_coroutine_t *coroutine;
     int status;
     struct addrinfo *response;
-} cat_getaddrinfo_context_t;
+} cat_dns_waiter_t;
+
+#define CAT_DNS_CACHE_G(x) CAT_SOCKET_G(dns_cache.x)
+
+/* addrinfo copy */
 
-static void cat_dns_getaddrinfo_callback(uv_getaddrinfo_t* request, int status, struct addrinfo *response)
+static cat_always_inline size_t cat_dns_addrinfo_node_size(const struct addrinfo *ai)
 {
-    cat_getaddrinfo_context_t *context = cat_container_of(request, cat_getaddrinfo_context_t, request.getaddrinfo);
+    size_t size = CAT_MEMORY_ALIGNED_SIZE(sizeof(struct addrinfo)) + CAT_MEMORY_ALIGNED_SIZE(ai->ai_addrlen);
 
-    if (likely(context->request.coroutine != NULL)) {
-        context->status = status;
-        context->response = response;
-        cat_coroutine_schedule(context->request.coroutine, DNS, "DNS resolver");
-    } else if (response != NULL) {
-        uv_freeaddrinfo(response);
+    if (ai->ai_canonname != NULL) {
+        size += CAT_MEMORY_ALIGNED_SIZE(strlen(ai->ai_canonname) + 1);
     }
 
-    cat_free(context);
+    return size;
 }
 
-CAT_API struct addrinfo *cat_dns_getaddrinfo(const char *hostname, const char *service, const struct addrinfo *hints)
+/* copy the whole list into a single block, so that it can be released by one cat_free() */
+static struct addrinfo *cat_dns_addrinfo_dup(const struct addrinfo *response)
 {
-    return cat_dns_getaddrinfo_ex(hostname, service, hints, cat_socket_get_global_dns_timeout());
+    const struct addrinfo *ai;
+    struct addrinfo *copy, *current, *previous = NULL;
+    size_t size = 0;
+    char *p;
+
+    for (ai = response; ai != NULL; ai = ai->ai_next) {
+        size += cat_dns_addrinfo_node_size(ai);
+    }
+    copy = (struct addrinfo *) cat_malloc(size);
+#if CAT_ALLOC_HANDLE_ERRORS
+    if (unlikely(copy == NULL)) {
+        cat_update_last_error_of_syscall("Malloc for DNS response copy failed");
+        return NULL;
+    }
+#endif
+    p = (char *) copy;
+    for (ai = response; ai != NULL; ai = ai->ai_next) {
+        current = (struct addrinfo *) p;
+        memcpy(current, ai, sizeof(*current));
+        p += CAT_MEMORY_ALIGNED_SIZE(sizeof(*current));
+        if (ai->ai_addr != NULL) {
+            current->ai_addr = (struct sockaddr *) p;
+            memcpy(current->ai_addr, ai->ai_addr, ai->ai_addrlen);
+        }
+        p += CAT_MEMORY_ALIGNED_SIZE(ai->ai_addrlen);
+        if (ai->ai_canonname != NULL) {
+            size_t length = strlen(ai->ai_canonname);
+            current->ai_canonname = p;
+            memcpy(current->ai_canonname, ai->ai_canonname, length + 1);
+            p += CAT_MEMORY_ALIGNED_SIZE(length + 1);
+        }
+        current->ai_next = NULL;
+        if (previous != NULL) {
+            previous->ai_next = current;
+        }
+        previous = current;
+    }
+
+    return copy;
 }
 
-CAT_API struct addrinfo *cat_dns_getaddrinfo_ex(const char *hostname, const char *service, const struct addrinfo *hints, cat_timeout_t timeout)
+/* cache */
+
+static cat_always_inline int cat_dns_cache_strcmp(const char *s1, const char *s2)
 {
-    cat_getaddrinfo_context_t *context = (cat_getaddrinfo_context_t *) cat_malloc(sizeof(*context));
-    cat_bool_t ret;
+    if (s1 == NULL || s2 == NULL) {
+        return (s1 != NULL) - (s2 != NULL);
+    }
+    return strcmp(s1, s2);
+}
+
+static int cat_dns_cache_entry_compare(cat_dns_cache_entry_t *entry1, cat_dns_cache_entry_t *entry2)
+{
+    int ret;
+
+#define CAT_DNS_CACHE_ENTRY_COMPARE_INT(field) \
+    if (entry1->field != entry2->field) { \
+        return entry1->field < entry2->field ? -1 : 1; \
+    }
+    CAT_DNS_CACHE_ENTRY_COMPARE_INT(family);
+    CAT_DNS_CACHE_ENTRY_COMPARE_INT(socktype);
+    CAT_DNS_CACHE_ENTRY_COMPARE_INT(protocol);
+    CAT_DNS_CACHE_ENTRY_COMPARE_INT(flags);
+#undef CAT_DNS_CACHE_ENTRY_COMPARE_INT
+    ret = cat_dns_cache_strcmp(entry1->hostname, entry2->hostname);
+    if (ret != 0) {
+        return ret;
+    }
+    return cat_dns_cache_strcmp(entry1->service, entry2->service);
+}
+
+RB_GENERATE_STATIC(cat_dns_cache_tree_s,
+                   cat_dns_cache_entry_s, tree_entry,
+                   cat_dns_cache_entry_compare);
+
+static cat_always_inline void cat_dns_cache_entry_init_key(cat_dns_cache_entry_t *entry, const char *hostname, const char *service, const struct addrinfo *hints)
+{
+    entry->hostname = hostname;
+    entry->service = service;
+    if (hints != NULL) {
+        entry->family = hints->ai_family;
+        entry->socktype = hints->ai_socktype;
+        entry->protocol = hints->ai_protocol;
+        entry->flags = hints->ai_flags;
+    } else {
+        entry->family = AF_UNSPEC;
+        entry->socktype = 0;
+        entry->protocol = 0;
+        entry->flags = 0;
+    }
+}
+
+static cat_dns_cache_entry_t *cat_dns_cache_entry_create(const cat_dns_cache_entry_t *key)
+{
+    size_t hostname_size = key->hostname != NULL ? strlen(key->hostname) + 1 : 0;
+    size_t service_size = key->service != NULL ? strlen(key->service) + 1 : 0;
+    cat_dns_cache_entry_t *entry;
+    char *p;
+
+    entry = (cat_dns_cache_entry_t *) cat_malloc(sizeof(*entry) + hostname_size + service_size);
+#if CAT_ALLOC_HANDLE_ERRORS
+    if (unlikely(entry == NULL)) {
+        cat_update_last_error_of_syscall("Malloc for DNS cache entry failed");
+        return NULL;
+    }
+#endif
+    memcpy(entry, key, sizeof(*entry));
+    /* key strings are stored after the entry */
+    p = (char *) (entry + 1);
+    if (key->hostname != NULL) {
+        entry->hostname = memcpy(p, key->hostname, hostname_size);
+        p += hostname_size;
+    }
+    if (key->service != NULL) {
+        entry->service = memcpy(p, key->service, service_size);
+    }
+    entry->status = 0;
+    entry->response = NULL;
+    entry->expires = 0;
+    entry->request = NULL;
+
+    return entry;
+}
+
+static void cat_dns_cache_entry_free(cat_dns_cache_entry_t *entry)
+{
+    RB_REMOVE(cat_dns_cache_tree_s, &CAT_DNS_CACHE_G(tree), entry);
+    if (entry->request != NULL) {
+        /* let the callback know that it should not touch the entry */
+        entry->request->entry = NULL;
+    } else {
+        cat_queue_remove(&entry->node);
+        CAT_DNS_CACHE_G(count)--;
+    }
+    if (entry->response != NULL) {
+        cat_free(entry->response);
+    }
+    cat_free(entry);
+}
+
+static void cat_dns_cache_evict(size_t max_size)
+{
+    cat_dns_cache_entry_t *entry;
+
+    while (CAT_DNS_CACHE_G(count) > max_size) {
+        entry = cat_queue_front_data(&CAT_DNS_CACHE_G(lru), cat_dns_cache_entry_t, node);
+        cat_dns_cache_entry_free(entry);
+    }
+}
+
+static void cat_dns_cache_shutdown(cat_data_t *data)
+{
+    cat_dns_cache_entry_t *entry, *next;
+    (void) data;
+
+    /* in-flight requests will be detached and released in the callback */
+    RB_FOREACH_SAFE(entry, cat_dns_cache_tree_s, &CAT_DNS_CACHE_G(tree), next) {
+        cat_dns_cache_entry_free(entry);
+    }
+    CAT_DNS_CACHE_G(shutdown_task_registered) = cat_false;
+}
+
+CAT_API void cat_dns_cache_runtime_init(void)
+{
+    RB_INIT(&CAT_DNS_CACHE_G(tree));
+    cat_queue_init(&CAT_DNS_CACHE_G(lru));
+    CAT_DNS_CACHE_G(count) = 0;
+    CAT_DNS_CACHE_G(max_size) = CAT_DNS_CACHE_DEFAULT_MAX_SIZE;
+    CAT_DNS_CACHE_G(ttl) = CAT_DNS_CACHE_DEFAULT_TTL;
+    CAT_DNS_CACHE_G(negative_ttl) = CAT_DNS_CACHE_DEFAULT_NEGATIVE_TTL;
+    CAT_DNS_CACHE_G(hits) = 0;
+    CAT_DNS_CACHE_G(misses) = 0;
+    CAT_DNS_CACHE_G(coalesced) = 0;
+    CAT_DNS_CACHE_G(shutdown_task_registered) = cat_false;
+}
+
+CAT_API void cat_dns_cache_set_max_size(size_t max_size)
+{
+    CAT_DNS_CACHE_G(max_size) = max_size;
+    cat_dns_cache_evict(max_size);
+}
+
+CAT_API void cat_dns_cache_set_ttl(cat_msec_t ttl)
+{
+    CAT_DNS_CACHE_G(ttl) = ttl;
+}
+
+CAT_API void cat_dns_cache_set_negative_ttl(cat_msec_t ttl)
+{
+    CAT_DNS_CACHE_G(negative_ttl) = ttl;
+}
+
+CAT_API void cat_dns_cache_get_info(cat_dns_cache_info_t *info)
+{
+    info->count = CAT_DNS_CACHE_G(count);
+    info->max_size = CAT_DNS_CACHE_G(max_size);
+    info->ttl = CAT_DNS_CACHE_G(ttl);
+    info->negative_ttl = CAT_DNS_CACHE_G(negative_ttl);
+    info->hits = CAT_DNS_CACHE_G(hits);
+    info->misses = CAT_DNS_CACHE_G(misses);
+    info->coalesced = CAT_DNS_CACHE_G(coalesced);
+}
+
+CAT_API void cat_dns_cache_clear(void)
+{
+    cat_dns_cache_evict(0);
+}
+
+/* only authoritative answers are worth caching negatively */
+static cat_always_inline cat_bool_t cat_dns_cache_is_negative_cacheable(int status)
+{
+    return status == UV_EAI_NONAME
+#ifdef EAI_NODATA
+        || status == UV_EAI_NODATA
+#endif
+    ;
+}
+
+/* return true if the response is owned by the cache */
+static cat_bool_t cat_dns_cache_store(cat_dns_cache_entry_t *entry, int status, struct addrinfo *response)
+{
+    cat_msec_t ttl = status == 0 ? CAT_DNS_CACHE_G(ttl) : CAT_DNS_CACHE_G(negative_ttl);
+
+    entry->request = NULL;
+    if (CAT_DNS_CACHE_G(max_size) == 0 || ttl == 0 ||
+        (status != 0 && !cat_dns_cache_is_negative_cacheable(status))) {
+        RB_REMOVE(cat_dns_cache_tree_s, &CAT_DNS_CACHE_G(tree), entry);
+        cat_free(entry);
+        return cat_false;
+    }
+    entry->status = status;
+    entry->response = response;
+    entry->expires = cat_time_msec_cached() + ttl;
+    cat_queue_push_back(&CAT_DNS_CACHE_G(lru), &entry->node);
+    CAT_DNS_CACHE_G(count)++;
+    cat_dns_cache_evict(CAT_DNS_CACHE_G(max_size));
+
+    return cat_true;
+}
+
+static void cat_dns_getaddrinfo_callback(uv_getaddrinfo_t* req, int status, struct addrinfo *response)
+{
+    cat_dns_request_t *request = cat_container_of(req, cat_dns_request_t, request.getaddrinfo);
+    cat_dns_cache_entry_t *entry = request->entry;
+    struct addrinfo *copy = NULL, *owned;
+    cat_dns_waiter_t *waiter;
+    cat_queue_t waiters;
+
+    request->done = cat_true;
+    if (response != NULL) {
+        if (likely(status == 0)) {
+            copy = cat_dns_addrinfo_dup(response);
+            if (unlikely(copy == NULL)) {
+                status = CAT_ENOMEM;
+            }
+        }
+        uv_freeaddrinfo(response);
+    }
+    owned = copy;
+    if (entry != NULL && cat_dns_cache_store(entry, status, copy)) {
+        /* waiters will get their own copies */
+        owned = NULL;
+    }
+    /* waiters may cancel each other while we are resuming them */
+    cat_queue_init(&waiters);
+    if (!cat_queue_empty(&request->waiters)) {
+        cat_queue_next(&waiters) = cat_queue_next(&request->waiters);
+        cat_queue_prev(&waiters) = cat_queue_prev(&request->waiters);
+        cat_queue_next_prev(&waiters) = &waiters;
+        cat_queue_prev_next(&waiters) = &waiters;
+        cat_queue_init(&request->waiters);
+    }
+    /* every waiter gets its own response before any of them runs,
+     * because the cached one may be released by them (e.g. cache is cleared) */
+    CAT_QUEUE_FOREACH_DATA_START(&waiters, cat_dns_waiter_t, node, waiter) {
+        waiter->status = status;
+        waiter->response = NULL;
+        if (status != 0) {
+            continue;
+        }
+        if (owned != NULL && &waiter->node == cat_queue_back(&waiters)) {
+            waiter->response = owned;
+            owned = NULL;
+        } else {
+            waiter->response = cat_dns_addrinfo_dup(copy);
+            if (unlikely(waiter->response == NULL)) {
+                waiter->status = CAT_ENOMEM;
+            }
+        }
+    } CAT_QUEUE_FOREACH_DATA_END();
+    while ((waiter = cat_queue_front_data(&waiters, cat_dns_waiter_t, node))) {
+        cat_coroutine_t *coroutine = waiter->coroutine;
+        cat_queue_remove(&waiter->node);
+        waiter->coroutine = NULL;
+        cat_coroutine_schedule(coroutine, DNS, "DNS resolver");
+    }
+    if (owned != NULL) {
+        cat_free(owned);
+    }
+
+    cat_free(request);
+}
+
+static cat_dns_request_t *cat_dns_request_create(cat_dns_cache_entry_t *entry, const struct addrinfo *hints)
+{
+    cat_dns_request_t *request = (cat_dns_request_t *) cat_malloc(sizeof(*request));
     int error;
 
 #if CAT_ALLOC_HANDLE_ERRORS
-    if (unlikely(context == NULL)) {
-        cat_update_last_error_of_syscall("Malloc for DNS getaddrinfo context failed");
+    if (unlikely(request == NULL)) {
+        cat_update_last_error_of_syscall("Malloc for DNS getaddrinfo request failed");
         return NULL;
     }
 #endif
-    error = uv_getaddrinfo(&CAT_EVENT_G(loop), &context->request.getaddrinfo, cat_dns_getaddrinfo_callback, hostname, service, hints);
+    error = uv_getaddrinfo(&CAT_EVENT_G(loop), &request->request.getaddrinfo, cat_dns_getaddrinfo_callback, entry->hostname, entry->service, hints);
     if (error != 0) {
         cat_update_last_error_with_reason(error, "DNS getaddrinfo init failed");
-        cat_free(context);
+        cat_free(request);
         return NULL;
     }
-    context->status = CAT_ECANCELED;
-    context->request.coroutine = CAT_COROUTINE_G(current);
-    ret = cat_time_wait(timeout);
-    context->request.coroutine = NULL;
-    if (unlikely(!ret)) {
-        cat_update_last_error_with_previous("DNS getaddrinfo wait failed");
-        (void) uv_cancel(&context->request.req);
-        return NULL;
+    request->entry = entry;
+    cat_queue_init(&request->waiters);
+    request->done = cat_false;
+
+    return request;
+}
+
+CAT_API struct addrinfo *cat_dns_getaddrinfo(const char *hostname, const char *service, const struct addrinfo *hints)
+{
+    return cat_dns_getaddrinfo_ex(hostname, service, hints, cat_socket_get_global_dns_timeout());
+}
+
+CAT_API struct addrinfo *cat_dns_getaddrinfo_ex(const char *hostname, const char *service, const struct addrinfo *hints, cat_timeout_t timeout)
+{
+    cat_dns_cache_entry_t key, *entry;
+    cat_dns_request_t *request;
+    cat_dns_waiter_t waiter;
+    cat_bool_t ret;
+
+    cat_dns_cache_entry_init_key(&key, hostname, service, hints);
+    entry = RB_FIND(cat_dns_cache_tree_s, &CAT_DNS_CACHE_G(tree), &key);
+    if (entry != NULL && entry->request == NULL) {
+        if (entry->expires > cat_time_msec_cached()) {
+            CAT_DNS_CACHE_G(hits)++;
+            cat_queue_remove(&entry->node);
+            cat_queue_push_back(&CAT_DNS_CACHE_G(lru), &entry->node);
+            if (entry->status != 0) {
+                cat_update_last_error_with_reason(entry->status, "DNS getaddrinfo failed (cached)");
+                return NULL;
+            }
+            return cat_dns_addrinfo_dup(entry->response);
+        }
+        cat_dns_cache_entry_free(entry);
+        entry = NULL;
     }
-    if (unlikely(context->status != 0)) {
-        if (context->status == CAT_ECANCELED) {
-            cat_update_last_error(CAT_ECANCELED, "DNS getaddrinfo has been canceled");
-            (void) uv_cancel(&context->request.req);
+    if (entry != NULL) {
+        /* share the in-flight resolution */
+        CAT_DNS_CACHE_G(coalesced)++;
+        request = entry->request;
+    } else {
+        CAT_DNS_CACHE_G(misses)++;
+        if (unlikely(!CAT_DNS_CACHE_G(shutdown_task_registered))) {
+            if (unlikely(cat_event_register_runtime_shutdown_task(cat_dns_cache_shutdown, NULL) == NULL)) {
+                cat_update_last_error_with_previous("DNS cache register shutdown task failed");
+                return NULL;
+            }
+            CAT_DNS_CACHE_G(shutdown_task_registered) = cat_true;
+        }
+        entry = cat_dns_cache_entry_create(&key);
+#if CAT_ALLOC_HANDLE_ERRORS
+        if (unlikely(entry == NULL)) {
+            return NULL;
+        }
+#endif
+        request = cat_dns_request_create(entry, hints);
+        if (unlikely(request == NULL)) {
+            cat_free(entry);
+            return NULL;
+        }
+        entry->request = request;
+        RB_INSERT(cat_dns_cache_tree_s, &CAT_DNS_CACHE_G(tree), entry);
+    }
+    waiter.coroutine = CAT_COROUTINE_G(current);
+    waiter.status = CAT_ECANCELED;
+    waiter.response = NULL;
+    cat_queue_push_back(&request->waiters, &waiter.node);
+    ret = cat_time_wait(timeout);
+    if (unlikely(waiter.coroutine != NULL)) {
+        /* it was not resolved yet, give up waiting */
+        cat_queue_remove(&waiter.node);
+        if (waiter.response != NULL) {
+            /* it was canceled while the other waiters were being resumed */
+            cat_dns_freeaddrinfo(waiter.response);
+        }
+        if (cat_queue_empty(&request->waiters) && !request->done) {
+            /* nobody cares about it anymore, new lookups should not share the canceled one */
+            if (request->entry != NULL) {
+                cat_dns_cache_entry_free(request->entry);
+            }
+            (void) uv_cancel(&request->request.req);
+        }
+        if (unlikely(!ret)) {
+            cat_update_last_error_with_previous("DNS getaddrinfo wait failed");
         } else {
-            cat_update_last_error_with_reason(context->status, "DNS getaddrinfo failed");
+            cat_update_last_error(CAT_ECANCELED, "DNS getaddrinfo has been canceled");
         }
         return NULL;
     }
+    if (unlikely(waiter.status != 0)) {
+        cat_update_last_error_with_reason(waiter.status, "DNS getaddrinfo failed");
+        return NULL;
+    }
 
-    return context->response;
+    return waiter.response;
 }
 
 CAT_API void cat_dns_freeaddrinfo(struct addrinfo *response)
 {
-    uv_freeaddrinfo(response);
+    cat_free(response);
 }
 
 CAT_API cat_bool_t cat_dns_get_ip(char *buffer, size_t buffer_size, const char *name, int af)
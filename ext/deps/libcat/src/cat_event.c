@@ -47,6 +47,8 @@ struct cat_event_io_defer_task_s {
 
 CAT_API CAT_GLOBALS_DECLARE(cat_event);
 
+CAT_GLOBALS_CTOR_DECLARE_SZ(cat_event)
+
 static void cat_event_do_io_defer_tasks(uv_check_t *check);
 
 CAT_API cat_bool_t cat_event_module_init(void)
@@ -219,6 +221,8 @@ static void cat_event_do_io_defer_tasks(uv_check_t *check)
     /* execute tasks of current round */
     while ((task = cat_queue_front_data(tasks, cat_event_io_defer_task_t, node)) != NULL) {
         cat_queue_remove(&task->node);
+        /* mark it as called, so that task_close() will not remove it again */
+        cat_queue_init(&task->node);
         task->callback(task, task->data);
         /* note: do not access the task anymore,
          * it may be free'd in callback. */
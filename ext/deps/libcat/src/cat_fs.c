@@ -32,6 +32,18 @@
 # include <winternl.h>
 #endif // CAT_OS_WIN
 
+#ifdef CAT_FS_IO_URING
+# include <linux/io_uring.h>
+# include <sys/mman.h>
+# include <sys/syscall.h>
+# include <sys/sysmacros.h>
+# ifdef CAT_IDE_HELPER
+#  include "uv-common.h"
+# else
+#  include "../deps/libuv/src/uv-common.h"
+# endif
+#endif // CAT_FS_IO_URING
+
 #ifdef CAT_OS_WIN
 # ifdef _WIN64
 #  define fseeko _fseeki64
@@ -156,6 +168,765 @@ static void cat_fs_callback(uv_fs_t *fs)
     cat_free(context);
 }
 
+CAT_API CAT_GLOBALS_DECLARE(cat_fs);
+
+CAT_GLOBALS_CTOR_DECLARE_SZ(cat_fs)
+
+CAT_API const char *cat_fs_backend_get_name(cat_fs_backend_t backend)
+{
+    switch (backend) {
+#define CAT_FS_BACKEND_NAME_GEN(name, value) case CAT_FS_BACKEND_##name: return value;
+        CAT_FS_BACKEND_MAP(CAT_FS_BACKEND_NAME_GEN)
+#undef CAT_FS_BACKEND_NAME_GEN
+    }
+    return "unknown";
+}
+
+#ifdef CAT_FS_IO_URING
+/* io_uring backend
+ * Operations are queued into the submission queue of the current event loop,
+ * and submitted in batch by one io_uring_enter() before the loop polls for I/O.
+ * The ring fd is polled by the event loop, completions are reaped there and
+ * scheduled to the waiting coroutines directly, no thread hop is involved. */
+
+typedef struct cat_fs_io_uring_statx_s {
+    uint32_t stx_mask;
+    uint32_t stx_blksize;
+    uint64_t stx_attributes;
+    uint32_t stx_nlink;
+    uint32_t stx_uid;
+    uint32_t stx_gid;
+    uint16_t stx_mode;
+    uint16_t unused0;
+    uint64_t stx_ino;
+    uint64_t stx_size;
+    uint64_t stx_blocks;
+    uint64_t stx_attributes_mask;
+    struct {
+        int64_t tv_sec;
+        uint32_t tv_nsec;
+        int32_t unused0;
+    } stx_atime, stx_btime, stx_ctime, stx_mtime;
+    uint32_t stx_rdev_major;
+    uint32_t stx_rdev_minor;
+    uint32_t stx_dev_major;
+    uint32_t stx_dev_minor;
+    uint64_t unused1[14];
+} cat_fs_io_uring_statx_t;
+
+typedef struct cat_fs_io_uring_request_s {
+    cat_coroutine_t *coroutine;
+    cat_bool_t done;
+    int result;
+    /* they must be alive until the operation is completed */
+    char *path;
+    cat_fs_io_uring_statx_t statx;
+} cat_fs_io_uring_request_t;
+
+struct cat_fs_io_uring_s {
+    int fd;
+    /* submission queue */
+    unsigned *sq_khead;
+    unsigned *sq_ktail;
+    unsigned *sq_array;
+    unsigned sq_mask;
+    unsigned sq_entries;
+    unsigned sq_tail;
+    struct io_uring_sqe *sqes;
+    /* completion queue */
+    unsigned *cq_khead;
+    unsigned *cq_ktail;
+    unsigned cq_mask;
+    unsigned cq_entries;
+    struct io_uring_cqe *cqes;
+    /* mappings */
+    void *sq_ring;
+    size_t sq_ring_size;
+    void *cq_ring;
+    size_t cq_ring_size;
+    size_t sqes_size;
+    /* operations which are supported by the kernel */
+    uint8_t ops[IORING_OP_LAST];
+    /* queued or submitted, but not completed yet */
+    size_t pending_count;
+    cat_bool_t closing;
+    cat_bool_t forked;
+    uint8_t closing_handles;
+    uv_poll_t poll;
+    uv_prepare_t prepare;
+};
+
+static cat_always_inline int cat_fs_io_uring_setup(unsigned entries, struct io_uring_params *params)
+{
+    return (int) syscall(__NR_io_uring_setup, entries, params);
+}
+
+static cat_always_inline int cat_fs_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags)
+{
+    return (int) syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+static cat_always_inline int cat_fs_io_uring_register(int fd, unsigned opcode, void *arg, unsigned nr_args)
+{
+    return (int) syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+static void cat_fs_io_uring_unmap(cat_fs_io_uring_t *ring)
+{
+    if (ring->sqes != NULL) {
+        (void) munmap(ring->sqes, ring->sqes_size);
+    }
+    if (ring->cq_ring != NULL && ring->cq_ring != ring->sq_ring) {
+        (void) munmap(ring->cq_ring, ring->cq_ring_size);
+    }
+    if (ring->sq_ring != NULL) {
+        (void) munmap(ring->sq_ring, ring->sq_ring_size);
+    }
+    if (ring->fd >= 0) {
+        (void) close(ring->fd);
+    }
+}
+
+static void cat_fs_io_uring_complete(cat_fs_io_uring_t *ring, cat_fs_io_uring_request_t *request, int result)
+{
+    ring->pending_count--;
+    request->result = result;
+    request->done = cat_true;
+    if (request->coroutine != NULL) {
+        cat_coroutine_t *coroutine = request->coroutine;
+        request->coroutine = NULL;
+        cat_coroutine_schedule(coroutine, FS, "File-System");
+    } else {
+        /* waiter has gone */
+        cat_free(request->path);
+        cat_free(request);
+    }
+}
+
+static void cat_fs_io_uring_close_callback(uv_handle_t *handle)
+{
+    cat_fs_io_uring_t *ring = (cat_fs_io_uring_t *) handle->data;
+
+    if (--ring->closing_handles != 0) {
+        return;
+    }
+    cat_fs_io_uring_unmap(ring);
+    if (CAT_FS_G(io_uring) == ring) {
+        CAT_FS_G(io_uring) = NULL;
+    }
+    cat_free(ring);
+}
+
+static void cat_fs_io_uring_close(cat_fs_io_uring_t *ring)
+{
+    if (ring->closing_handles != 0) {
+        return;
+    }
+    ring->closing = cat_true;
+    ring->closing_handles = 2;
+    uv_close((uv_handle_t *) &ring->poll, cat_fs_io_uring_close_callback);
+    uv_close((uv_handle_t *) &ring->prepare, cat_fs_io_uring_close_callback);
+}
+
+static void cat_fs_io_uring_update_ref(cat_fs_io_uring_t *ring)
+{
+    if (ring->pending_count == 0) {
+        if (unlikely(ring->closing)) {
+            cat_fs_io_uring_close(ring);
+        } else {
+            /* do not keep the event loop alive if there is no operation */
+            uv_unref((uv_handle_t *) &ring->poll);
+        }
+    }
+}
+
+static void cat_fs_io_uring_submit(cat_fs_io_uring_t *ring)
+{
+    unsigned head, to_submit;
+    int n;
+
+    head = __atomic_load_n(ring->sq_khead, __ATOMIC_ACQUIRE);
+    to_submit = ring->sq_tail - head;
+    if (to_submit == 0) {
+        return;
+    }
+    __atomic_store_n(ring->sq_ktail, ring->sq_tail, __ATOMIC_RELEASE);
+    do {
+        n = cat_fs_io_uring_enter(ring->fd, to_submit, 0, 0);
+    } while (unlikely(n < 0 && errno == EINTR));
+    if (likely(n >= 0) || errno == EAGAIN || errno == EBUSY) {
+        /* it will be retried before the next poll if something was left */
+        return;
+    }
+    do {
+        /* kernel refused to consume them, fail them all */
+        int error = -errno;
+        CAT_LOG_DEBUG(FS, "io_uring_enter() failed, error=%d", error);
+        head = __atomic_load_n(ring->sq_khead, __ATOMIC_ACQUIRE);
+        ring->sq_tail = head;
+        __atomic_store_n(ring->sq_ktail, head, __ATOMIC_RELEASE);
+        for (; to_submit > 0; to_submit--, head++) {
+            struct io_uring_sqe *sqe = &ring->sqes[head & ring->sq_mask];
+            cat_fs_io_uring_complete(ring, (cat_fs_io_uring_request_t *) (uintptr_t) sqe->user_data, error);
+        }
+        cat_fs_io_uring_update_ref(ring);
+    } while (0);
+}
+
+static void cat_fs_io_uring_reap(cat_fs_io_uring_t *ring)
+{
+    unsigned head = *ring->cq_khead;
+    unsigned tail;
+
+    while (head != (tail = __atomic_load_n(ring->cq_ktail, __ATOMIC_ACQUIRE))) {
+        do {
+            struct io_uring_cqe *cqe = &ring->cqes[head & ring->cq_mask];
+            cat_fs_io_uring_request_t *request = (cat_fs_io_uring_request_t *) (uintptr_t) cqe->user_data;
+            int result = cqe->res;
+            /* release the entry before the coroutine runs */
+            __atomic_store_n(ring->cq_khead, ++head, __ATOMIC_RELEASE);
+            cat_fs_io_uring_complete(ring, request, result);
+        } while (head != tail);
+    }
+    cat_fs_io_uring_update_ref(ring);
+}
+
+static void cat_fs_io_uring_abandon(cat_fs_io_uring_t *ring)
+{
+    /* the ring is shared with the parent process, never reap its completions */
+    if (CAT_FS_G(io_uring) == ring) {
+        CAT_FS_G(io_uring) = NULL;
+    }
+    /* operations in-flight are lost */
+    ring->pending_count = 0;
+    cat_fs_io_uring_close(ring);
+}
+
+static void cat_fs_io_uring_poll_callback(uv_poll_t *handle, int status, int events)
+{
+    cat_fs_io_uring_t *ring = (cat_fs_io_uring_t *) handle->data;
+    (void) status;
+    (void) events;
+
+    if (unlikely(ring->forked)) {
+        cat_fs_io_uring_abandon(ring);
+        return;
+    }
+    cat_fs_io_uring_reap(ring);
+}
+
+static void cat_fs_io_uring_prepare_callback(uv_prepare_t *handle)
+{
+    cat_fs_io_uring_t *ring = (cat_fs_io_uring_t *) handle->data;
+
+    if (unlikely(ring->forked)) {
+        cat_fs_io_uring_abandon(ring);
+        return;
+    }
+    cat_fs_io_uring_submit(ring);
+    if (__atomic_load_n(ring->sq_khead, __ATOMIC_ACQUIRE) == ring->sq_tail) {
+        uv_prepare_stop(handle);
+    }
+}
+
+static void cat_fs_io_uring_shutdown(cat_data_t *data)
+{
+    cat_fs_io_uring_t *ring = CAT_FS_G(io_uring);
+    (void) data;
+
+    if (ring == NULL || ring->closing) {
+        return;
+    }
+    if (unlikely(ring->forked)) {
+        cat_fs_io_uring_abandon(ring);
+        return;
+    }
+    ring->closing = cat_true;
+    /* otherwise, it will be closed after the last operation is done */
+    cat_fs_io_uring_update_ref(ring);
+}
+
+static cat_fs_io_uring_t *cat_fs_io_uring_create(void)
+{
+    static const uint8_t required_ops[] = {
+        IORING_OP_OPENAT, IORING_OP_CLOSE, IORING_OP_READ, IORING_OP_WRITE,
+        IORING_OP_FSYNC, IORING_OP_STATX,
+    };
+    struct io_uring_params params;
+    struct io_uring_probe *probe;
+    cat_fs_io_uring_t *ring;
+    size_t probe_size;
+    unsigned n;
+    int error;
+
+    ring = (cat_fs_io_uring_t *) cat_malloc(sizeof(*ring));
+#if CAT_ALLOC_HANDLE_ERRORS
+    if (unlikely(ring == NULL)) {
+        cat_update_last_error_of_syscall("Malloc for io_uring failed");
+        return NULL;
+    }
+#endif
+    memset(ring, 0, sizeof(*ring));
+    memset(&params, 0, sizeof(params));
+    ring->fd = cat_fs_io_uring_setup(CAT_FS_IO_URING_ENTRIES, &params);
+    if (ring->fd < 0) {
+        cat_update_last_error_of_syscall("io_uring setup failed");
+        goto _error;
+    }
+    if (!(params.features & IORING_FEAT_RW_CUR_POS)) {
+        /* read()/write() need it to use the file position */
+        cat_update_last_error(CAT_ENOTSUP, "io_uring is too old");
+        goto _error;
+    }
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        ring->sq_ring_size = ring->cq_ring_size = CAT_MAX(ring->sq_ring_size, ring->cq_ring_size);
+    }
+    ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    if (ring->sq_ring == MAP_FAILED) {
+        ring->sq_ring = NULL;
+        cat_update_last_error_of_syscall("io_uring map submission queue failed");
+        goto _error;
+    }
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        ring->cq_ring = ring->sq_ring;
+    } else {
+        ring->cq_ring = mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+        if (ring->cq_ring == MAP_FAILED) {
+            ring->cq_ring = NULL;
+            cat_update_last_error_of_syscall("io_uring map completion queue failed");
+            goto _error;
+        }
+    }
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = (struct io_uring_sqe *) mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED) {
+        ring->sqes = NULL;
+        cat_update_last_error_of_syscall("io_uring map submission entries failed");
+        goto _error;
+    }
+    ring->sq_khead = (unsigned *) ((char *) ring->sq_ring + params.sq_off.head);
+    ring->sq_ktail = (unsigned *) ((char *) ring->sq_ring + params.sq_off.tail);
+    ring->sq_array = (unsigned *) ((char *) ring->sq_ring + params.sq_off.array);
+    ring->sq_mask = *(unsigned *) ((char *) ring->sq_ring + params.sq_off.ring_mask);
+    ring->sq_entries = params.sq_entries;
+    ring->sq_tail = *ring->sq_ktail;
+    /* entries are always filled in order, so the index array is an identity mapping */
+    for (n = 0; n < ring->sq_entries; n++) {
+        ring->sq_array[n] = n;
+    }
+    ring->cq_khead = (unsigned *) ((char *) ring->cq_ring + params.cq_off.head);
+    ring->cq_ktail = (unsigned *) ((char *) ring->cq_ring + params.cq_off.tail);
+    ring->cq_mask = *(unsigned *) ((char *) ring->cq_ring + params.cq_off.ring_mask);
+    ring->cq_entries = params.cq_entries;
+    ring->cqes = (struct io_uring_cqe *) ((char *) ring->cq_ring + params.cq_off.cqes);
+
+    probe_size = sizeof(*probe) + IORING_OP_LAST * sizeof(struct io_uring_probe_op);
+    probe = (struct io_uring_probe *) cat_malloc(probe_size);
+#if CAT_ALLOC_HANDLE_ERRORS
+    if (unlikely(probe == NULL)) {
+        cat_update_last_error_of_syscall("Malloc for io_uring probe failed");
+        goto _error;
+    }
+#endif
+    memset(probe, 0, probe_size);
+    if (cat_fs_io_uring_register(ring->fd, IORING_REGISTER_PROBE, probe, IORING_OP_LAST) < 0) {
+        cat_update_last_error_of_syscall("io_uring probe failed");
+        cat_free(probe);
+        goto _error;
+    }
+    for (n = 0; n < probe->ops_len && n < IORING_OP_LAST; n++) {
+        ring->ops[n] = (probe->ops[n].flags & IO_URING_OP_SUPPORTED) ? 1 : 0;
+    }
+    cat_free(probe);
+    for (n = 0; n < CAT_ARRAY_SIZE(required_ops); n++) {
+        if (!ring->ops[required_ops[n]]) {
+            cat_update_last_error(CAT_ENOTSUP, "io_uring does not support operation %u", (unsigned) required_ops[n]);
+            goto _error;
+        }
+    }
+
+    error = uv_poll_init(&CAT_EVENT_G(loop), &ring->poll, ring->fd);
+    if (unlikely(error != 0)) {
+        cat_update_last_error_with_reason(error, "io_uring poll init failed");
+        goto _error;
+    }
+    ring->poll.data = ring;
+    ring->poll.flags |= UV_HANDLE_INTERNAL;
+    (void) uv_poll_start(&ring->poll, UV_READABLE, cat_fs_io_uring_poll_callback);
+    uv_unref((uv_handle_t *) &ring->poll);
+    (void) uv_prepare_init(&CAT_EVENT_G(loop), &ring->prepare);
+    ring->prepare.data = ring;
+    ring->prepare.flags |= UV_HANDLE_INTERNAL;
+    uv_unref((uv_handle_t *) &ring->prepare);
+    if (unlikely(cat_event_register_runtime_shutdown_task(cat_fs_io_uring_shutdown, NULL) == NULL)) {
+        cat_update_last_error_with_previous("io_uring register shutdown task failed");
+        cat_fs_io_uring_close(ring);
+        return NULL;
+    }
+
+    return ring;
+
+    _error:
+    cat_fs_io_uring_unmap(ring);
+    cat_free(ring);
+    return NULL;
+}
+
+static cat_fs_io_uring_t *cat_fs_io_uring_get(void)
+{
+    cat_fs_io_uring_t *ring = CAT_FS_G(io_uring);
+
+    if (likely(ring != NULL)) {
+        if (unlikely(ring->forked)) {
+            cat_fs_io_uring_abandon(ring);
+        } else {
+            return !ring->closing ? ring : NULL;
+        }
+    }
+    if (CAT_FS_G(backend) == CAT_FS_BACKEND_THREAD_POOL || CAT_FS_G(io_uring_unavailable)) {
+        return NULL;
+    }
+    ring = cat_fs_io_uring_create();
+    if (unlikely(ring == NULL)) {
+        CAT_LOG_DEBUG(FS, "io_uring is unavailable (%s), fallback to the thread pool", cat_get_last_error_message());
+        CAT_FS_G(io_uring_unavailable) = cat_true;
+        return NULL;
+    }
+    CAT_FS_G(io_uring) = ring;
+
+    return ring;
+}
+
+static void cat_fs_io_uring_atfork_child(void)
+{
+    cat_fs_io_uring_t *ring = CAT_FS_G(io_uring);
+
+    if (ring == NULL) {
+        return;
+    }
+    /* the epoll fd may be still shared with the parent process here,
+     * so we can not stop the watcher, it will be abandoned on the next event or use */
+    ring->forked = cat_true;
+}
+
+static uv_once_t cat_fs_io_uring_atfork_once = UV_ONCE_INIT;
+
+static void cat_fs_io_uring_atfork_register(void)
+{
+    if (pthread_atfork(NULL, NULL, cat_fs_io_uring_atfork_child) != 0) {
+        abort();
+    }
+}
+
+/* returns NULL if it is unavailable, then operation should fallback to the thread pool */
+static cat_fs_io_uring_request_t *cat_fs_io_uring_request_create(cat_fs_io_uring_t **ring_ptr, uint8_t opcode, struct io_uring_sqe **sqe_ptr)
+{
+    cat_fs_io_uring_t *ring = cat_fs_io_uring_get();
+    cat_fs_io_uring_request_t *request;
+    struct io_uring_sqe *sqe;
+
+    if (ring == NULL || !ring->ops[opcode] || ring->pending_count >= ring->cq_entries) {
+        return NULL;
+    }
+    if (ring->sq_tail - __atomic_load_n(ring->sq_khead, __ATOMIC_ACQUIRE) == ring->sq_entries) {
+        cat_fs_io_uring_submit(ring);
+        if (ring->sq_tail - __atomic_load_n(ring->sq_khead, __ATOMIC_ACQUIRE) == ring->sq_entries) {
+            return NULL;
+        }
+    }
+    request = (cat_fs_io_uring_request_t *) cat_malloc(sizeof(*request));
+#if CAT_ALLOC_HANDLE_ERRORS
+    if (unlikely(request == NULL)) {
+        return NULL;
+    }
+#endif
+    request->coroutine = NULL;
+    request->done = cat_false;
+    request->result = 0;
+    request->path = NULL;
+    sqe = &ring->sqes[ring->sq_tail & ring->sq_mask];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = opcode;
+    sqe->user_data = (uint64_t) (uintptr_t) request;
+    *ring_ptr = ring;
+    *sqe_ptr = sqe;
+
+    return request;
+}
+
+static void cat_fs_io_uring_commit(cat_fs_io_uring_t *ring)
+{
+    ring->sq_tail++;
+    if (ring->pending_count++ == 0) {
+        uv_ref((uv_handle_t *) &ring->poll);
+    }
+    if (!uv_is_active((uv_handle_t *) &ring->prepare)) {
+        (void) uv_prepare_start(&ring->prepare, cat_fs_io_uring_prepare_callback);
+    }
+}
+
+static void cat_fs_io_uring_cancel(cat_fs_io_uring_request_t *target)
+{
+    cat_fs_io_uring_t *ring;
+    cat_fs_io_uring_request_t *request;
+    struct io_uring_sqe *sqe;
+
+    request = cat_fs_io_uring_request_create(&ring, IORING_OP_ASYNC_CANCEL, &sqe);
+    if (request == NULL) {
+        /* it can only wait for the completion */
+        return;
+    }
+    sqe->addr = (uint64_t) (uintptr_t) target;
+    /* nobody waits for it, it will be released after it is completed */
+    cat_fs_io_uring_commit(ring);
+}
+
+static cat_bool_t cat_fs_io_uring_wait(cat_fs_io_uring_t *ring, cat_fs_io_uring_request_t *request, const char *operation)
+{
+    cat_bool_t ret;
+
+    cat_fs_io_uring_commit(ring);
+    request->coroutine = CAT_COROUTINE_G(current);
+    ret = cat_time_wait(CAT_TIMEOUT_FOREVER);
+    if (unlikely(!request->done)) {
+        /* it will be released after it is completed */
+        request->coroutine = NULL;
+        cat_fs_io_uring_cancel(request);
+        if (!ret) {
+            cat_update_last_error_with_previous("File-System %s wait failed", operation);
+        } else {
+            cat_update_last_error(CAT_ECANCELED, "File-System %s has been canceled", operation);
+        }
+        errno = cat_orig_errno(cat_get_last_error_code());
+        return cat_false;
+    }
+    if (unlikely(request->result < 0)) {
+        cat_update_last_error_with_reason((cat_errno_t) request->result, "File-System %s failed", operation);
+        errno = -request->result;
+        return cat_false;
+    }
+
+    return cat_true;
+}
+
+static cat_always_inline void cat_fs_io_uring_request_free(cat_fs_io_uring_request_t *request)
+{
+    if (request->done) {
+        cat_free(request->path);
+        cat_free(request);
+    }
+}
+
+static cat_bool_t cat_fs_io_uring_rw(ssize_t *ret, uint8_t opcode, cat_file_t fd, const void *buffer, size_t size, int64_t offset)
+{
+    cat_fs_io_uring_t *ring;
+    cat_fs_io_uring_request_t *request;
+    struct io_uring_sqe *sqe;
+
+    request = cat_fs_io_uring_request_create(&ring, opcode, &sqe);
+    if (request == NULL) {
+        return cat_false;
+    }
+    sqe->fd = fd;
+    /* the buffer is owned by the caller rather than the request (same as the thread pool path),
+     * so the kernel may still access it if the wait is interrupted before completion */
+    sqe->addr = (uint64_t) (uintptr_t) buffer;
+    sqe->len = (uint32_t) CAT_MIN(size, (size_t) INT_MAX);
+    sqe->off = (uint64_t) offset;
+    *ret = cat_fs_io_uring_wait(ring, request, opcode == IORING_OP_READ ? "read" : "write") ? request->result : -1;
+    cat_fs_io_uring_request_free(request);
+
+    return cat_true;
+}
+
+static cat_bool_t cat_fs_io_uring_open(cat_file_t *ret, const char *path, int flags, int mode)
+{
+    cat_fs_io_uring_t *ring;
+    cat_fs_io_uring_request_t *request;
+    struct io_uring_sqe *sqe;
+
+    request = cat_fs_io_uring_request_create(&ring, IORING_OP_OPENAT, &sqe);
+    if (request == NULL) {
+        return cat_false;
+    }
+    request->path = cat_strdup(path);
+    sqe->fd = AT_FDCWD;
+    sqe->addr = (uint64_t) (uintptr_t) request->path;
+    sqe->len = (uint32_t) mode;
+    sqe->open_flags = (uint32_t) (flags | O_CLOEXEC);
+    *ret = cat_fs_io_uring_wait(ring, request, "open") ? request->result : -1;
+    cat_fs_io_uring_request_free(request);
+
+    return cat_true;
+}
+
+static cat_bool_t cat_fs_io_uring_fd_operation(int *ret, uint8_t opcode, cat_file_t fd, uint32_t flags, const char *operation)
+{
+    cat_fs_io_uring_t *ring;
+    cat_fs_io_uring_request_t *request;
+    struct io_uring_sqe *sqe;
+
+    request = cat_fs_io_uring_request_create(&ring, opcode, &sqe);
+    if (request == NULL) {
+        return cat_false;
+    }
+    sqe->fd = fd;
+    sqe->fsync_flags = flags;
+    *ret = cat_fs_io_uring_wait(ring, request, operation) ? 0 : -1;
+    cat_fs_io_uring_request_free(request);
+
+    return cat_true;
+}
+
+static cat_bool_t cat_fs_io_uring_stat(int *ret, cat_file_t fd, const char *path, int flags, cat_stat_t *statbuf, const char *operation)
+{
+    cat_fs_io_uring_t *ring;
+    cat_fs_io_uring_request_t *request;
+    struct io_uring_sqe *sqe;
+
+    request = cat_fs_io_uring_request_create(&ring, IORING_OP_STATX, &sqe);
+    if (request == NULL) {
+        return cat_false;
+    }
+    request->path = cat_strdup(path);
+    sqe->fd = fd;
+    sqe->addr = (uint64_t) (uintptr_t) request->path;
+    sqe->len = 0xfff; /* STATX_BASIC_STATS | STATX_BTIME */
+    sqe->off = (uint64_t) (uintptr_t) &request->statx;
+    sqe->statx_flags = (uint32_t) flags;
+    if (cat_fs_io_uring_wait(ring, request, operation)) {
+        const cat_fs_io_uring_statx_t *statx = &request->statx;
+        statbuf->st_dev = makedev(statx->stx_dev_major, statx->stx_dev_minor);
+        statbuf->st_mode = statx->stx_mode;
+        statbuf->st_nlink = statx->stx_nlink;
+        statbuf->st_uid = statx->stx_uid;
+        statbuf->st_gid = statx->stx_gid;
+        statbuf->st_rdev = makedev(statx->stx_rdev_major, statx->stx_rdev_minor);
+        statbuf->st_ino = statx->stx_ino;
+        statbuf->st_size = statx->stx_size;
+        statbuf->st_blksize = statx->stx_blksize;
+        statbuf->st_blocks = statx->stx_blocks;
+        statbuf->st_atim.tv_sec = statx->stx_atime.tv_sec;
+        statbuf->st_atim.tv_nsec = statx->stx_atime.tv_nsec;
+        statbuf->st_mtim.tv_sec = statx->stx_mtime.tv_sec;
+        statbuf->st_mtim.tv_nsec = statx->stx_mtime.tv_nsec;
+        statbuf->st_ctim.tv_sec = statx->stx_ctime.tv_sec;
+        statbuf->st_ctim.tv_nsec = statx->stx_ctime.tv_nsec;
+        statbuf->st_birthtim.tv_sec = statx->stx_btime.tv_sec;
+        statbuf->st_birthtim.tv_nsec = statx->stx_btime.tv_nsec;
+        statbuf->st_flags = 0;
+        statbuf->st_gen = 0;
+        *ret = 0;
+    } else {
+        *ret = -1;
+    }
+    cat_fs_io_uring_request_free(request);
+
+    return cat_true;
+}
+
+/* try io_uring at first, fallback to the thread pool if it is unavailable */
+# define CAT_FS_IO_URING_TRY(return_type, function, ...) do { \
+    return_type _ret; \
+    if (cat_fs_io_uring_##function(&_ret, ##__VA_ARGS__)) { \
+        return _ret; \
+    } \
+} while (0)
+#else
+# define CAT_FS_IO_URING_TRY(return_type, function, ...)
+#endif // CAT_FS_IO_URING
+
+CAT_API cat_bool_t cat_fs_module_init(void)
+{
+    CAT_GLOBALS_REGISTER(cat_fs);
+
+    CAT_FS_G(backend) = CAT_FS_BACKEND_AUTO;
+    CAT_FS_G(io_uring) = NULL;
+    CAT_FS_G(io_uring_unavailable) = cat_false;
+    CAT_FS_G(work_kind_overridden) = cat_false;
+    CAT_FS_G(work_kind) = CAT_WORK_KIND_FS;
+
+#ifdef CAT_FS_IO_URING
+    /* module may be initialized by multiple threads, but the handler must be registered only once */
+    uv_once(&cat_fs_io_uring_atfork_once, cat_fs_io_uring_atfork_register);
+#endif
+
+    return cat_true;
+}
+
+CAT_API cat_bool_t cat_fs_module_shutdown(void)
+{
+    CAT_GLOBALS_UNREGISTER(cat_fs);
+
+    return cat_true;
+}
+
+CAT_API cat_bool_t cat_fs_set_backend(cat_fs_backend_t backend)
+{
+    switch (backend) {
+        case CAT_FS_BACKEND_AUTO:
+            CAT_FS_G(io_uring_unavailable) = cat_false;
+            break;
+        case CAT_FS_BACKEND_THREAD_POOL:
+            break;
+        case CAT_FS_BACKEND_IO_URING: {
+#ifdef CAT_FS_IO_URING
+            CAT_FS_G(backend) = backend;
+            CAT_FS_G(io_uring_unavailable) = cat_false;
+            if (cat_fs_io_uring_get() == NULL) {
+                cat_update_last_error_with_previous("File-System io_uring backend is unavailable");
+                CAT_FS_G(backend) = CAT_FS_BACKEND_AUTO;
+                return cat_false;
+            }
+            break;
+#else
+            cat_update_last_error(CAT_ENOTSUP, "File-System io_uring backend is not supported");
+            return cat_false;
+#endif
+        }
+        default:
+            cat_update_last_error(CAT_EINVAL, "Unknown File-System backend %d", (int) backend);
+            return cat_false;
+    }
+#ifdef CAT_FS_IO_URING
+    if (backend == CAT_FS_BACKEND_THREAD_POOL && CAT_FS_G(io_uring) != NULL) {
+        /* in-flight operations will be completed before it is closed */
+        cat_fs_io_uring_shutdown(NULL);
+        CAT_FS_G(io_uring) = NULL;
+    }
+#endif
+    CAT_FS_G(backend) = backend;
+
+    return cat_true;
+}
+
+CAT_API cat_fs_backend_t cat_fs_get_backend(void)
+{
+#ifdef CAT_FS_IO_URING
+    if (CAT_FS_G(backend) != CAT_FS_BACKEND_THREAD_POOL && cat_fs_io_uring_get() != NULL) {
+        return CAT_FS_BACKEND_IO_URING;
+    }
+#endif
+    return CAT_FS_BACKEND_THREAD_POOL;
+}
+
+CAT_API cat_work_kind_t cat_fs_set_work_kind(cat_work_kind_t kind)
+{
+    cat_work_kind_t original_kind = cat_fs_get_work_kind();
+
+    CAT_FS_G(work_kind_overridden) = cat_true;
+    CAT_FS_G(work_kind) = kind;
+
+    return original_kind;
+}
+
+CAT_API cat_work_kind_t cat_fs_get_work_kind(void)
+{
+    return CAT_FS_G(work_kind_overridden) ? CAT_FS_G(work_kind) : CAT_WORK_KIND_FS;
+}
+
 #ifdef CAT_OS_WIN
 # define wrappath(_path, path) \
 char path##buf[(32767/*hard limit*/ + 4/* \\?\ */ + 1/* \0 */)*sizeof(wchar_t)] = {'\\', '\\', '?', '\\'}; \
@@ -415,6 +1186,7 @@ static cat_always_inline cat_file_t cat_fs_open_impl(const char *_path, cat_fs_o
 {
     wrappath(_path, path);
 
+    CAT_FS_IO_URING_TRY(cat_file_t, open, path, flags, mode);
     CAT_FS_DO_RESULT(cat_file_t, open, path, flags, mode);
 }
 
@@ -450,6 +1222,7 @@ CAT_API cat_file_t cat_fs_open(const char *path, cat_fs_open_flags_t flags, ...)
 
 static cat_always_inline int cat_fs_close_impl(cat_file_t fd)
 {
+    CAT_FS_IO_URING_TRY(int, fd_operation, IORING_OP_CLOSE, fd, 0, "close");
     CAT_FS_DO_RESULT(int, close, fd);
 }
 
@@ -490,7 +1263,11 @@ static void cat_fs_read_cb(cat_data_t *ptr)
 
 static cat_always_inline ssize_t cat_fs_read_impl(cat_file_t fd, void *buf, size_t size)
 {
-    cat_fs_read_data_t *data = (cat_fs_read_data_t *) cat_malloc(sizeof(*data));
+    cat_fs_read_data_t *data;
+
+    /* offset -1 means the current file position */
+    CAT_FS_IO_URING_TRY(ssize_t, rw, IORING_OP_READ, fd, buf, size, -1);
+    data = (cat_fs_read_data_t *) cat_malloc(sizeof(*data));
 #if CAT_ALLOC_HANDLE_ERRORS
     if (data == NULL) {
         cat_update_last_error_of_syscall("Malloc for fs read failed");
@@ -501,7 +1278,7 @@ static cat_always_inline ssize_t cat_fs_read_impl(cat_file_t fd, void *buf, size
     data->fd = fd;
     data->buf = buf;
     data->size = (cat_fs_read_size_t) size;
-    if (!cat_work(CAT_WORK_KIND_FAST_IO, cat_fs_read_cb, cat_free_function, data, CAT_TIMEOUT_FOREVER)) {
+    if (!cat_work(cat_fs_get_work_kind(), cat_fs_read_cb, cat_free_function, data, CAT_TIMEOUT_FOREVER)) {
         return -1;
     }
     cat_fs_work_check_error(&data->ret.error, "read");
@@ -546,7 +1323,10 @@ static void cat_fs_write_cb(cat_data_t *ptr)
 
 static cat_always_inline ssize_t cat_fs_write_impl(cat_file_t fd, const void *buf, size_t length)
 {
-    cat_fs_write_data_t *data = (cat_fs_write_data_t *) cat_malloc(sizeof(*data));
+    cat_fs_write_data_t *data;
+
+    CAT_FS_IO_URING_TRY(ssize_t, rw, IORING_OP_WRITE, fd, buf, length, -1);
+    data = (cat_fs_write_data_t *) cat_malloc(sizeof(*data));
 #if CAT_ALLOC_HANDLE_ERRORS
     if (data == NULL) {
         cat_update_last_error_of_syscall("Malloc for fs write failed");
@@ -557,7 +1337,7 @@ static cat_always_inline ssize_t cat_fs_write_impl(cat_file_t fd, const void *bu
     data->fd = fd;
     data->buf = buf;
     data->length = (cat_fs_write_size_t) length;
-    if (!cat_work(CAT_WORK_KIND_FAST_IO, cat_fs_write_cb, cat_free_function, data, CAT_TIMEOUT_FOREVER)) {
+    if (!cat_work(cat_fs_get_work_kind(), cat_fs_write_cb, cat_free_function, data, CAT_TIMEOUT_FOREVER)) {
         return -1;
     }
     cat_fs_work_check_error(&data->ret.error, "write");
@@ -589,6 +1369,7 @@ static cat_always_inline ssize_t cat_fs_pread_impl(cat_file_t fd, void *buffer,
 {
     uv_buf_t buf = uv_buf_init((char *) buffer, (unsigned int) size);
 
+    CAT_FS_IO_URING_TRY(ssize_t, rw, IORING_OP_READ, fd, buffer, size, offset);
     CAT_FS_DO_RESULT(ssize_t, read, fd, &buf, 1, offset);
 }
 
@@ -615,6 +1396,7 @@ static cat_always_inline ssize_t cat_fs_pwrite_impl(cat_file_t fd, const void *b
 {
     uv_buf_t buf = uv_buf_init((char *) buffer, (unsigned int) length);
 
+    CAT_FS_IO_URING_TRY(ssize_t, rw, IORING_OP_WRITE, fd, buffer, length, offset);
     CAT_FS_DO_RESULT(ssize_t, write, fd, &buf, 1, offset);
 }
 
@@ -669,7 +1451,7 @@ static cat_always_inline off_t cat_fs_lseek_impl(cat_file_t fd, off_t offset, in
     data->fd = fd;
     data->offset = offset;
     data->whence = whence;
-    if (!cat_work(CAT_WORK_KIND_FAST_IO, cat_fs_lseek_cb, cat_free_function, data, CAT_TIMEOUT_FOREVER)) {
+    if (!cat_work(cat_fs_get_work_kind(), cat_fs_lseek_cb, cat_free_function, data, CAT_TIMEOUT_FOREVER)) {
         return -1;
     }
     cat_fs_work_check_error(&data->ret.error, "lseek");
@@ -687,6 +1469,7 @@ CAT_API off_t cat_fs_lseek(cat_file_t fd, off_t offset, int whence)
 
 static cat_always_inline int cat_fs_fsync_impl(cat_file_t fd)
 {
+    CAT_FS_IO_URING_TRY(int, fd_operation, IORING_OP_FSYNC, fd, 0, "fsync");
     CAT_FS_DO_RESULT(int, fsync, fd);
 }
 
@@ -701,6 +1484,7 @@ CAT_API int cat_fs_fsync(cat_file_t fd)
 
 static cat_always_inline int cat_fs_fdatasync_impl(cat_file_t fd)
 {
+    CAT_FS_IO_URING_TRY(int, fd_operation, IORING_OP_FSYNC, fd, IORING_FSYNC_DATASYNC, "fdatasync");
     CAT_FS_DO_RESULT(int, fdatasync, fd);
 }
 
@@ -911,6 +1695,7 @@ CAT_API int cat_fs_access(const char *path, int mode)
 static cat_always_inline int cat_fs_stat_impl(const char *_path, cat_stat_t *statbuf)
 {
     wrappath(_path, path);
+    CAT_FS_IO_URING_TRY(int, stat, AT_FDCWD, path, 0, statbuf, "stat");
     CAT_FS_DO_STAT(stat, path);
 }
 
@@ -927,6 +1712,7 @@ CAT_API int cat_fs_stat(const char *path, cat_stat_t *statbuf)
 static cat_always_inline int cat_fs_lstat_impl(const char *_path, cat_stat_t *statbuf)
 {
     wrappath(_path, path);
+    CAT_FS_IO_URING_TRY(int, stat, AT_FDCWD, path, AT_SYMLINK_NOFOLLOW, statbuf, "lstat");
     CAT_FS_DO_STAT(lstat, path);
 }
 
@@ -942,6 +1728,7 @@ CAT_API int cat_fs_lstat(const char *path, cat_stat_t *statbuf)
 
 static cat_always_inline int cat_fs_fstat_impl(cat_file_t fd, cat_stat_t *statbuf)
 {
+    CAT_FS_IO_URING_TRY(int, stat, fd, "", AT_EMPTY_PATH, statbuf, "fstat");
     CAT_FS_DO_STAT(fstat, fd);
 }
 
@@ -1349,7 +2136,7 @@ static cat_always_inline int cat_fs_fclose_impl(FILE *stream)
 #endif
     memset(&data->ret, 0, sizeof(data->ret));
     data->stream = stream;
-    if (!cat_work(CAT_WORK_KIND_FAST_IO, cat_fs_fclose_cb, cat_free_function, data, CAT_TIMEOUT_FOREVER)) {
+    if (!cat_work(cat_fs_get_work_kind(), cat_fs_fclose_cb, cat_free_function, data, CAT_TIMEOUT_FOREVER)) {
         return -1;
     }
     cat_fs_work_check_error(&data->ret.error, "fclose");
@@ -1410,7 +2197,7 @@ static cat_always_inline size_t cat_fs_fread_impl(void *ptr, size_t size, size_t
     data->size = size;
     data->nmemb = nmemb;
     data->stream = stream;
-    if (!cat_work(CAT_WORK_KIND_FAST_IO, cat_fs_fread_cb, cat_free_function, data, CAT_TIMEOUT_FOREVER)) {
+    if (!cat_work(cat_fs_get_work_kind(), cat_fs_fread_cb, cat_free_function, data, CAT_TIMEOUT_FOREVER)) {
         return 0;
     }
     cat_fs_work_check_error(&data->ret.error, "fread");
@@ -1471,7 +2258,7 @@ static cat_always_inline size_t cat_fs_fwrite_impl(const void *ptr, size_t size,
     data->size = size;
     data->nmemb = nmemb;
     data->stream = stream;
-    if (!cat_work(CAT_WORK_KIND_FAST_IO, cat_fs_fwrite_cb, cat_free_function, data, CAT_TIMEOUT_FOREVER)) {
+    if (!cat_work(cat_fs_get_work_kind(), cat_fs_fwrite_cb, cat_free_function, data, CAT_TIMEOUT_FOREVER)) {
         return 0;
     }
     cat_fs_work_check_error(&data->ret.error, "fwrite");
@@ -1529,7 +2316,7 @@ static cat_always_inline int cat_fs_fseek_impl(FILE *stream, off_t offset, int w
     data->stream = stream;
     data->offset = offset;
     data->whence = whence;
-    if (!cat_work(CAT_WORK_KIND_FAST_IO, cat_fs_fseek_cb, cat_free_function, data, CAT_TIMEOUT_FOREVER)) {
+    if (!cat_work(cat_fs_get_work_kind(), cat_fs_fseek_cb, cat_free_function, data, CAT_TIMEOUT_FOREVER)) {
         return -1;
     }
     cat_fs_work_check_error(&data->ret.error, "fseek");
@@ -1583,7 +2370,7 @@ static cat_always_inline off_t cat_fs_ftell_impl(FILE *stream)
 #endif
     memset(&data->ret, 0, sizeof(data->ret));
     data->stream = stream;
-    if (!cat_work(CAT_WORK_KIND_FAST_IO, cat_fs_ftell_cb, cat_free_function, data, CAT_TIMEOUT_FOREVER)) {
+    if (!cat_work(cat_fs_get_work_kind(), cat_fs_ftell_cb, cat_free_function, data, CAT_TIMEOUT_FOREVER)) {
         return -1;
     }
     cat_fs_work_check_error(&data->ret.error, "ftell");
@@ -1635,7 +2422,7 @@ static cat_always_inline int cat_fs_fflush_impl(FILE *stream)
 #endif
     memset(&data->ret, 0, sizeof(data->ret));
     data->stream = stream;
-    if (!cat_work(CAT_WORK_KIND_FAST_IO, cat_fs_fflush_cb, cat_free_function, data, CAT_TIMEOUT_FOREVER)) {
+    if (!cat_work(cat_fs_get_work_kind(), cat_fs_fflush_cb, cat_free_function, data, CAT_TIMEOUT_FOREVER)) {
         return -1;
     }
     cat_fs_work_check_error(&data->ret.error, "fflush");
@@ -1743,7 +2530,7 @@ static cat_always_inline cat_dir_t *cat_fs_opendir_impl(const char *path)
     memset(&data->ret, 0, sizeof(data->ret));
     data->canceled = cat_false;
     data->path = cat_strdup(path);
-    if (!cat_work(CAT_WORK_KIND_FAST_IO, cat_fs_opendir_cb, cat_fs_opendir_free, data, CAT_TIMEOUT_FOREVER)) {
+    if (!cat_work(cat_fs_get_work_kind(), cat_fs_opendir_cb, cat_fs_opendir_free, data, CAT_TIMEOUT_FOREVER)) {
         // canceled, tell freer close handle
         data->canceled = cat_true;
         return NULL;
@@ -1866,7 +2653,7 @@ static cat_always_inline cat_dirent_t *cat_fs_readdir_impl(cat_dir_t *dir)
     memset(data, 0, sizeof(*data));
     data->dir = uv_dir->dir;
     data->canceled = cat_false;
-    if (!cat_work(CAT_WORK_KIND_FAST_IO, cat_fs_readdir_cb, cat_fs_readdir_free, data, CAT_TIMEOUT_FOREVER)) {
+    if (!cat_work(cat_fs_get_work_kind(), cat_fs_readdir_cb, cat_fs_readdir_free, data, CAT_TIMEOUT_FOREVER)) {
         uv_dir->dir = NULL;
         data->canceled = cat_true;
         return NULL;
@@ -1931,7 +2718,7 @@ static cat_always_inline void cat_fs_rewinddir_impl(cat_dir_t *dir)
 #endif
     data->dir = uv_dir->dir;
     data->canceled = cat_false;
-    if (!cat_work(CAT_WORK_KIND_FAST_IO, cat_fs_rewinddir_cb, cat_fs_rewinddir_free, data, CAT_TIMEOUT_FOREVER)) {
+    if (!cat_work(cat_fs_get_work_kind(), cat_fs_rewinddir_cb, cat_fs_rewinddir_free, data, CAT_TIMEOUT_FOREVER)) {
         data->canceled = cat_true;
         uv_dir->dir = NULL;
     }
@@ -1973,7 +2760,7 @@ static cat_always_inline int cat_fs_closedir_impl(cat_dir_t *dir)
 #endif
     data->dir = uv_dir->dir;
     free(uv_dir);
-    if (!cat_work(CAT_WORK_KIND_FAST_IO, cat_fs_closedir_cb, cat_free_function, data, CAT_TIMEOUT_FOREVER)) {
+    if (!cat_work(cat_fs_get_work_kind(), cat_fs_closedir_cb, cat_free_function, data, CAT_TIMEOUT_FOREVER)) {
         return -1;
     }
     return 0;
@@ -2106,7 +2893,7 @@ static cat_always_inline cat_dir_t *cat_fs_opendir_impl(const char *_path)
     data->canceled = cat_false;
     data->path = cat_strdup(path);
     data->ret.ret.handle = INVALID_HANDLE_VALUE;
-    if (!cat_work(CAT_WORK_KIND_FAST_IO, cat_fs_opendir_cb, cat_fs_opendir_free, data, CAT_TIMEOUT_FOREVER)) {
+    if (!cat_work(cat_fs_get_work_kind(), cat_fs_opendir_cb, cat_fs_opendir_free, data, CAT_TIMEOUT_FOREVER)) {
         // canceled, tell freer close handle
         data->canceled = cat_true;
         return NULL;
@@ -2170,7 +2957,7 @@ static cat_always_inline int cat_fs_closedir_impl(cat_dir_t *dir)
     memset(&data->ret, 0, sizeof(data->ret));
     data->handle = ((cat_dir_int_t *) dir)->dir;
     free(dir);
-    cat_bool_t ret = cat_work(CAT_WORK_KIND_FAST_IO, cat_fs_closedir_cb, cat_free_function, data, CAT_TIMEOUT_FOREVER);
+    cat_bool_t ret = cat_work(cat_fs_get_work_kind(), cat_fs_closedir_cb, cat_free_function, data, CAT_TIMEOUT_FOREVER);
     if (!ret) {
         return -1;
     }
@@ -2351,7 +3138,7 @@ static cat_always_inline cat_dirent_t *cat_fs_readdir_impl(cat_dir_t *dir)
     memset(&data->ret, 0, sizeof(data->ret));
     data->dir.dir = pintdir->dir;
     data->dir.rewind = pintdir->rewind;
-    if (!cat_work(CAT_WORK_KIND_FAST_IO, cat_fs_readdir_cb, cat_fs_readdir_free, data, CAT_TIMEOUT_FOREVER)) {
+    if (!cat_work(cat_fs_get_work_kind(), cat_fs_readdir_cb, cat_fs_readdir_free, data, CAT_TIMEOUT_FOREVER)) {
         // canceled
         CloseHandle(pintdir->dir);
         pintdir->dir = INVALID_HANDLE_VALUE;
@@ -2716,14 +3503,14 @@ static cat_always_inline int cat_fs_flock_impl(cat_file_t fd, cat_fs_flock_flags
     data->shutdown_task = NULL;
     if (data->non_blocking) {
         // operation is non-blocking, things done immediately
-        if (!cat_work(CAT_WORK_KIND_FAST_IO, cat_fs_orig_flock, cat_free_function, data, CAT_TIMEOUT_FOREVER)) {
+        if (!cat_work(cat_fs_get_work_kind(), cat_fs_orig_flock, cat_free_function, data, CAT_TIMEOUT_FOREVER)) {
             return -1;
         }
     } else {
         if (cat_async_create(&data->async) != &data->async) {
             return -1;
         }
-        if (!cat_work(CAT_WORK_KIND_FAST_IO, cat_fs_flock_cb, NULL, data, CAT_TIMEOUT_FOREVER)) {
+        if (!cat_work(cat_fs_get_work_kind(), cat_fs_flock_cb, NULL, data, CAT_TIMEOUT_FOREVER)) {
             data->shutdown_task = cat_event_register_runtime_shutdown_task(cat_fs_flock_shutdown, data);
             cat_async_cleanup(&data->async, cat_fs_flock_data_cleanup);
             return -1;
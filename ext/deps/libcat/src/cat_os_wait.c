@@ -76,6 +76,8 @@ CAT_GLOBALS_STRUCT_BEGIN(cat_os_wait) {
 
 CAT_GLOBALS_DECLARE(cat_os_wait);
 
+CAT_GLOBALS_CTOR_DECLARE_SZ(cat_os_wait)
+
 #define CAT_OS_WAIT_G(x) CAT_GLOBALS_GET(cat_os_wait, x)
 
 static int cat_os__waitpid_task_compare(cat_os_waitpid_task_t* t1, cat_os_waitpid_task_t* t2)
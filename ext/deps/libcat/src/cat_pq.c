@@ -176,4 +176,221 @@ CAT_API PGresult *cat_pq_exec_params(PGconn *conn, const char *command, int n_pa
     return cat_pq_get_result(conn);
 }
 
+static cat_bool_t cat_pq_exec_batch_one_by_one(PGconn *conn, const cat_pq_query_t *queries, size_t count, PGresult **results)
+{
+    /* same as pipeline, queries outside an explicit transaction are executed in one implicit transaction */
+    cat_bool_t implicit_transaction = PQtransactionStatus(conn) == PQTRANS_IDLE;
+    cat_bool_t failed = cat_false;
+    PGresult *result;
+    size_t i;
+
+    if (implicit_transaction) {
+        result = cat_pq_exec(conn, "BEGIN");
+        if (unlikely(result == NULL)) {
+            return cat_false;
+        }
+        if (unlikely(PQresultStatus(result) != PGRES_COMMAND_OK)) {
+            /* report it as the error of the first query */
+            results[0] = result;
+            return cat_true;
+        }
+        PQclear(result);
+    }
+
+    for (i = 0; i < count; i++) {
+        const cat_pq_query_t *query = &queries[i];
+        ExecStatusType status;
+
+        results[i] = cat_pq_exec_params(conn, query->command, query->n_params,
+            query->param_types, query->param_values, query->param_lengths, query->param_formats, query->result_format);
+        if (unlikely(results[i] == NULL)) {
+            goto _error;
+        }
+        status = PQresultStatus(results[i]);
+        if (status == PGRES_FATAL_ERROR || status == PGRES_BAD_RESPONSE) {
+            /* same as pipeline, the rest will not be executed */
+            failed = cat_true;
+            break;
+        }
+    }
+
+    if (implicit_transaction) {
+        result = cat_pq_exec(conn, failed ? "ROLLBACK" : "COMMIT");
+        if (unlikely(result == NULL)) {
+            /* results of queries which have not been executed are NULL */
+            i = count;
+            goto _error;
+        }
+        if (unlikely(!failed && PQresultStatus(result) != PGRES_COMMAND_OK)) {
+            /* e.g. deferred constraints, nothing has been committed, report it as the error of the last query */
+            PQclear(results[count - 1]);
+            results[count - 1] = result;
+        } else {
+            PQclear(result);
+        }
+    }
+
+    return cat_true;
+
+    _error:
+    while (i-- > 0) {
+        PQclear(results[i]);
+        results[i] = NULL;
+    }
+    return cat_false;
+}
+
+#ifdef LIBPQ_HAS_PIPELINING
+static cat_bool_t cat_pq_pipeline_flush(PGconn *conn)
+{
+    int flush_ret;
+
+    while (1) {
+        CAT_LOG_DEBUG(PQ, "PQflush(conn=%p)", conn);
+        flush_ret = PQflush(conn);
+        if (flush_ret != 1) {
+            break;
+        }
+        /* server may be blocked on sending results of the former queries,
+         * so we should also consume input, otherwise both sides will wait for each other */
+        cat_pollfd_events_t revents = POLLNONE;
+        cat_ret_t poll_ret = cat_poll_one(PQsocket(conn), POLLIN | POLLOUT, &revents, -1);
+        if (unlikely(poll_ret == CAT_RET_ERROR)) {
+            return cat_false;
+        }
+        if ((revents & POLLIN) && unlikely(!PQconsumeInput(conn))) {
+            return cat_false;
+        }
+    }
+
+    return flush_ret == 0;
+}
+
+static cat_bool_t cat_pq_pipeline_get_result(PGconn *conn, PGresult **result)
+{
+    while (PQisBusy(conn)) {
+        cat_ret_t poll_ret = cat_poll_one(PQsocket(conn), POLLIN, NULL, -1);
+        if (unlikely(poll_ret == CAT_RET_ERROR)) {
+            return cat_false;
+        }
+        if (unlikely(!PQconsumeInput(conn))) {
+            return cat_false;
+        }
+    }
+
+    CAT_LOG_DEBUG(PQ, "PQgetResult(conn=%p)", conn);
+    *result = PQgetResult(conn);
+    if (*result == NULL && unlikely(PQstatus(conn) != CONNECTION_OK)) {
+        /* it will never reach the sync point */
+        return cat_false;
+    }
+
+    return cat_true;
+}
+
+/* discard results until the sync point */
+static cat_bool_t cat_pq_pipeline_drain(PGconn *conn)
+{
+    PGresult *result;
+    ExecStatusType status = PGRES_EMPTY_QUERY;
+
+    do {
+        if (unlikely(!cat_pq_pipeline_get_result(conn, &result))) {
+            return cat_false;
+        }
+        if (result == NULL) {
+            continue;
+        }
+        status = PQresultStatus(result);
+        PQclear(result);
+    } while (result == NULL || status != PGRES_PIPELINE_SYNC);
+
+    CAT_LOG_DEBUG(PQ, "PQexitPipelineMode(conn=%p)", conn);
+    return PQexitPipelineMode(conn);
+}
+
+static cat_bool_t cat_pq_exec_batch_pipeline(PGconn *conn, const cat_pq_query_t *queries, size_t count, PGresult **results)
+{
+    PGresult *result, *last_result;
+    size_t i;
+
+    CAT_LOG_DEBUG(PQ, "PQenterPipelineMode(conn=%p)", conn);
+    if (unlikely(!PQenterPipelineMode(conn))) {
+        return cat_false;
+    }
+
+    for (i = 0; i < count; i++) {
+        const cat_pq_query_t *query = &queries[i];
+        CAT_LOG_DEBUG(PQ, "PQsendQueryParams(conn=%p, command='%s')", conn, query->command);
+        if (unlikely(!PQsendQueryParams(conn, query->command, query->n_params,
+                query->param_types, query->param_values, query->param_lengths, query->param_formats, query->result_format))) {
+            goto _send_error;
+        }
+    }
+    CAT_LOG_DEBUG(PQ, "PQpipelineSync(conn=%p)", conn);
+    if (unlikely(!PQpipelineSync(conn))) {
+        goto _send_error;
+    }
+    /* all queries are sent at once */
+    if (unlikely(!cat_pq_pipeline_flush(conn))) {
+        goto _error;
+    }
+
+    /* results of every query are terminated by NULL */
+    for (i = 0; i < count; i++) {
+        last_result = NULL;
+        while (1) {
+            if (unlikely(!cat_pq_pipeline_get_result(conn, &result))) {
+                PQclear(last_result);
+                goto _error;
+            }
+            if (result == NULL) {
+                break;
+            }
+            PQclear(last_result);
+            last_result = result;
+        }
+        results[i] = last_result;
+    }
+    if (unlikely(!cat_pq_pipeline_drain(conn))) {
+        goto _error;
+    }
+
+    return cat_true;
+
+    _send_error:
+    /* discard the queued queries and leave pipeline mode if the connection is still alive */
+    if (PQpipelineSync(conn) && cat_pq_pipeline_flush(conn)) {
+        (void) cat_pq_pipeline_drain(conn);
+    }
+    _error:
+    for (i = 0; i < count; i++) {
+        PQclear(results[i]);
+        results[i] = NULL;
+    }
+    return cat_false;
+}
+#endif /* LIBPQ_HAS_PIPELINING */
+
+CAT_API cat_bool_t cat_pq_exec_batch(PGconn *conn, const cat_pq_query_t *queries, size_t count, PGresult **results)
+{
+    size_t i;
+
+    for (i = 0; i < count; i++) {
+        results[i] = NULL;
+    }
+    if (count == 0) {
+        return cat_true;
+    }
+
+#ifdef LIBPQ_HAS_PIPELINING
+    /* libpq may be loaded at runtime, so check its version again */
+    if (PQlibVersion() >= 140000) {
+        return cat_pq_exec_batch_pipeline(conn, queries, count, results);
+    }
+#endif
+
+    return cat_pq_exec_batch_one_by_one(conn, queries, count, results);
+}
+
 #endif /* CAT_PQ */
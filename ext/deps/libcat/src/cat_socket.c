@@ -435,6 +435,8 @@ CAT_API cat_bool_t cat_sockaddr_check(const cat_sockaddr_t *address, cat_socklen
 
 CAT_API CAT_GLOBALS_DECLARE(cat_socket);
 
+CAT_GLOBALS_CTOR_DECLARE_SZ(cat_socket)
+
 static const cat_socket_timeout_options_t cat_socket_default_global_timeout_options = {
     CAT_TIMEOUT_FOREVER,
     CAT_TIMEOUT_FOREVER,
@@ -490,9 +492,77 @@ CAT_API cat_bool_t cat_socket_runtime_init(void)
 
     RB_INIT(&CAT_SOCKET_G(internal_tree));
 
+    cat_dns_cache_runtime_init();
+
+    memset(&CAT_SOCKET_G(stats), 0, sizeof(CAT_SOCKET_G(stats)));
+
     return cat_true;
 }
 
+/* stats */
+
+#define CAT_SOCKET_INTERNAL_STATS_ADD(socket_i, field, value) do { \
+    (socket_i)->stats.field += (value); \
+    CAT_SOCKET_G(stats.field) += (value); \
+} while (0)
+
+/* result is the return value of syscall (bytes) or error code */
+static cat_always_inline void cat_socket_internal_stats_on_read(cat_socket_internal_t *socket_i, ssize_t result)
+{
+    CAT_SOCKET_INTERNAL_STATS_ADD(socket_i, read_syscalls, 1);
+    if (result > 0) {
+        CAT_SOCKET_INTERNAL_STATS_ADD(socket_i, bytes_read, (uint64_t) result);
+    } else if (result == CAT_EAGAIN) {
+        CAT_SOCKET_INTERNAL_STATS_ADD(socket_i, read_eagains, 1);
+    }
+}
+
+static cat_always_inline void cat_socket_internal_stats_on_write(cat_socket_internal_t *socket_i, ssize_t result)
+{
+    CAT_SOCKET_INTERNAL_STATS_ADD(socket_i, write_syscalls, 1);
+    if (result > 0) {
+        CAT_SOCKET_INTERNAL_STATS_ADD(socket_i, bytes_written, (uint64_t) result);
+    } else if (result == CAT_EAGAIN) {
+        CAT_SOCKET_INTERNAL_STATS_ADD(socket_i, write_eagains, 1);
+    }
+}
+
+static cat_always_inline void cat_socket_internal_stats_on_read_wait_done(cat_socket_internal_t *socket_i, cat_nsec_t start)
+{
+    CAT_SOCKET_INTERNAL_STATS_ADD(socket_i, read_wait_time, cat_time_nsec() - start);
+}
+
+static cat_always_inline void cat_socket_internal_stats_on_write_wait_done(cat_socket_internal_t *socket_i, cat_nsec_t start)
+{
+    CAT_SOCKET_INTERNAL_STATS_ADD(socket_i, write_wait_time, cat_time_nsec() - start);
+}
+
+static cat_always_inline size_t cat_socket_stats_get_latency_bucket(cat_nsec_t latency)
+{
+    cat_nsec_t bound = CAT_SOCKET_STATS_LATENCY_BUCKET_MIN;
+    size_t index;
+
+    for (index = 0; index < CAT_SOCKET_STATS_LATENCY_BUCKET_COUNT - 1; index++, bound *= 10) {
+        if (latency < bound) {
+            break;
+        }
+    }
+
+    return index;
+}
+
+static cat_always_inline void cat_socket_internal_stats_on_accepted(cat_socket_internal_t *server_i, cat_nsec_t start)
+{
+    size_t index = cat_socket_stats_get_latency_bucket(cat_time_nsec() - start);
+    CAT_SOCKET_INTERNAL_STATS_ADD(server_i, accept_latency[index], 1);
+}
+
+static cat_always_inline void cat_socket_internal_stats_on_connected(cat_socket_internal_t *socket_i, cat_nsec_t start)
+{
+    size_t index = cat_socket_stats_get_latency_bucket(cat_time_nsec() - start);
+    CAT_SOCKET_INTERNAL_STATS_ADD(socket_i, connect_latency[index], 1);
+}
+
 static cat_never_inline const char *cat_socket_get_error_from_flags(cat_errno_t *error, cat_socket_flags_t flags)
 {
     if (flags & CAT_SOCKET_FLAG_UNRECOVERABLE_ERROR) {
@@ -666,6 +736,7 @@ RB_GENERATE_STATIC(cat_socket_internal_tree_s,
 static cat_always_inline cat_timeout_t cat_socket_internal_get_dns_timeout(const cat_socket_internal_t *socket_i);
 static cat_always_inline cat_sa_family_t cat_socket_internal_get_af(const cat_socket_internal_t *socket_i);
 static const cat_sockaddr_info_t *cat_socket_internal_getname_fast(cat_socket_internal_t *socket_i, cat_bool_t is_peer, int *error_ptr);
+static cat_bool_t cat_socket_internal_wait_readable(cat_socket_internal_t *socket_i, cat_timeout_t timeout);
 
 #ifdef CAT_ENABLE_DEBUG_LOG
 static cat_bool_t cat_socket_internal_getaddrbyname_detect_whether_io_is_required(
@@ -959,6 +1030,8 @@ static cat_always_inline cat_socket_t *cat_socket_create_impl(cat_socket_t *sock
     socket_i->ssl = NULL;
     socket_i->ssl_peer_name = NULL;
 #endif
+    socket_i->write_coalescing = NULL;
+    memset(&socket_i->stats, 0, sizeof(socket_i->stats));
 
     if (af != AF_UNSPEC) {
         cat_socket_internal_on_open(socket_i, af);
@@ -1653,18 +1726,65 @@ CAT_API cat_bool_t cat_socket_listen(cat_socket_t *socket, int backlog)
     return ret;
 }
 
+static cat_always_inline cat_bool_t cat_socket_internal_accept_check_type(cat_socket_internal_t *server_i, cat_socket_internal_t *connection_i)
+{
+    cat_socket_type_t server_type = cat_socket_type_simplify(server_i->type);
+    cat_socket_type_t connection_type = connection_i->type;
+
+    if (unlikely((server_type & connection_type) != server_type)) {
+        cat_update_last_error(CAT_EINVAL, "Socket accept connection type mismatch, expect %s but got %s",
+            cat_socket_type_get_name(server_type), cat_socket_type_get_name(connection_type));
+        return cat_false;
+    }
+
+    return cat_true;
+}
+
+static void cat_socket_internal_on_accepted(
+    cat_socket_internal_t *server_i, cat_socket_internal_t *connection_i,
+    cat_socket_inheritance_info_t *handle_info
+) {
+    /* init client properties */
+    connection_i->flags |= (CAT_SOCKET_INTERNAL_FLAG_ESTABLISHED | CAT_SOCKET_INTERNAL_FLAG_SERVER_CONNECTION);
+    /* TODO: socket_extends() ? */
+    memcpy(&connection_i->options, handle_info == NULL ? &server_i->options : &handle_info->options, sizeof(connection_i->options));
+    cat_socket_internal_on_open(connection_i, cat_socket_type_to_af(handle_info == NULL ? server_i->type : handle_info->type));
+}
+
+/* accept a pending connection without waiting, returns CAT_EAGAIN if there is no more */
+static int cat_socket_internal_try_accept(cat_socket_internal_t *server_i, cat_socket_internal_t *connection_i)
+{
+    int error;
+
+    error = uv_accept(&server_i->u.stream, &connection_i->u.stream);
+#ifndef CAT_OS_WIN
+    if (error == CAT_EAGAIN) {
+        /* libuv only accepts one connection per event loop iteration,
+         * drain the backlog by ourselves to save the round trips */
+        int fd = uv__accept(uv__stream_fd(&server_i->u.stream));
+        if (fd < 0) {
+            return fd == UV_EMFILE || fd == UV_ENFILE || fd == UV_ECONNABORTED ? CAT_EAGAIN : fd;
+        }
+        server_i->u.stream.accepted_fd = fd;
+        error = uv_accept(&server_i->u.stream, &connection_i->u.stream);
+    }
+#endif
+    if (error == 0) {
+        cat_socket_internal_on_accepted(server_i, connection_i, NULL);
+    }
+
+    return error;
+}
+
 static cat_bool_t cat_socket_internal_accept(
     cat_socket_internal_t *server_i, cat_socket_internal_t *connection_i,
     cat_socket_inheritance_info_t *handle_info, cat_timeout_t timeout
 ) {
+    cat_nsec_t start = cat_time_nsec();
     int error;
 
     if (handle_info == NULL) {
-        cat_socket_type_t server_type = cat_socket_type_simplify(server_i->type);
-        cat_socket_type_t connection_type = connection_i->type;
-        if (unlikely((server_type & connection_type) != server_type)) {
-            cat_update_last_error(CAT_EINVAL, "Socket accept connection type mismatch, expect %s but got %s",
-                cat_socket_type_get_name(server_type), cat_socket_type_get_name(connection_type));
+        if (unlikely(!cat_socket_internal_accept_check_type(server_i, connection_i))) {
             return cat_false;
         }
     }
@@ -1673,11 +1793,8 @@ static cat_bool_t cat_socket_internal_accept(
         cat_bool_t ret;
         error = uv_accept(&server_i->u.stream, &connection_i->u.stream);
         if (error == 0) {
-            /* init client properties */
-            connection_i->flags |= (CAT_SOCKET_INTERNAL_FLAG_ESTABLISHED | CAT_SOCKET_INTERNAL_FLAG_SERVER_CONNECTION);
-            /* TODO: socket_extends() ? */
-            memcpy(&connection_i->options, handle_info == NULL ? &server_i->options : &handle_info->options, sizeof(connection_i->options));
-            cat_socket_internal_on_open(connection_i, cat_socket_type_to_af(handle_info == NULL ? server_i->type : handle_info->type));
+            cat_socket_internal_on_accepted(server_i, connection_i, handle_info);
+            cat_socket_internal_stats_on_accepted(server_i, start);
             return cat_true;
         }
         if (unlikely(error != CAT_EAGAIN)) {
@@ -1748,6 +1865,77 @@ CAT_API cat_bool_t cat_socket_accept(cat_socket_t *server, cat_socket_t *connect
     return cat_socket_accept_ex(server, connection, cat_socket_get_accept_timeout_fast(server));
 }
 
+static cat_always_inline cat_bool_t cat_socket_try_accept_impl(cat_socket_t *server, cat_socket_t *connection)
+{
+    CAT_SOCKET_INTERNAL_GETTER_WITH_IO(server, server_i, CAT_SOCKET_IO_FLAG_ACCEPT, return cat_false);
+    CAT_SOCKET_INTERNAL_SERVER_ONLY(server_i, return cat_false);
+    cat_nsec_t start = cat_time_nsec();
+    int error;
+
+    CAT_SOCKET_INTERNAL_GETTER_SILENT(connection, connection_i, {
+        cat_update_last_error(CAT_EINVAL, "Socket accept can not act on an unavailable socket");
+        return cat_false;
+    });
+    if (unlikely(cat_socket_is_open(connection))) {
+        cat_update_last_error(CAT_EMISUSE, "Socket accept can only act on a lazy socket");
+        return cat_false;
+    }
+    if (unlikely(!cat_socket_internal_accept_check_type(server_i, connection_i))) {
+        return cat_false;
+    }
+
+    error = cat_socket_internal_try_accept(server_i, connection_i);
+    if (unlikely(error != 0)) {
+        cat_update_last_error_with_reason(error, "Socket accept failed");
+        return cat_false;
+    }
+    cat_socket_internal_stats_on_accepted(server_i, start);
+
+    return cat_true;
+}
+
+CAT_API cat_bool_t cat_socket_try_accept(cat_socket_t *server, cat_socket_t *connection)
+{
+    cat_bool_t ret = cat_socket_try_accept_impl(server, connection);
+
+    CAT_LOG_DEBUG(SOCKET, "try_accept(" CAT_SOCKET_ID_FMT ") = " CAT_SOCKET_ID_FMT  CAT_LOG_STRERRNO_FMT,
+        server->id, ret ? connection->id : CAT_SOCKET_INVALID_ID, CAT_LOG_STRERRNO_C(ret, cat_get_last_error_code()));
+    CAT_LOG_DEBUG_SOCKET_ESTABLISHED(connection, accepted, ret);
+
+    return ret;
+}
+
+CAT_API size_t cat_socket_try_accept_many(cat_socket_t *server, cat_socket_t **connections, size_t count)
+{
+    size_t n;
+
+    for (n = 0; n < count; n++) {
+        if (!cat_socket_try_accept(server, connections[n])) {
+            /* pending connections are drained or something went wrong,
+             * the error will be reported by the next accept() */
+            break;
+        }
+    }
+
+    return n;
+}
+
+CAT_API size_t cat_socket_accept_many(cat_socket_t *server, cat_socket_t **connections, size_t count, cat_timeout_t timeout)
+{
+    if (unlikely(count == 0)) {
+        return 0;
+    }
+    if (!cat_socket_accept_ex(server, connections[0], timeout)) {
+        return 0;
+    }
+    if (cat_socket_get_type(server) & CAT_SOCKET_TYPE_FLAG_IPC) {
+        /* handles come with messages, we can only accept one by one */
+        return 1;
+    }
+
+    return 1 + cat_socket_try_accept_many(server, connections + 1, count - 1);
+}
+
 CAT_API cat_bool_t cat_socket_accept_ex(cat_socket_t *server, cat_socket_t *connection, cat_timeout_t timeout)
 {
     CAT_LOG_DEBUG(SOCKET, "accept(" CAT_SOCKET_ID_FMT ", " CAT_TIMEOUT_FMT ") = "  CAT_LOG_UNFINISHED_STR,
@@ -1811,6 +1999,7 @@ static cat_bool_t cat_socket_internal_connect(
 {
     CAT_SOCKET_CHECK_INPUT_ADDRESS_REQUIRED(address, address_length, return cat_false);
     cat_socket_type_t type = socket_i->type;
+    cat_nsec_t start = cat_time_nsec();
     uv_connect_t *request;
     int error = 0;
 
@@ -1891,6 +2080,9 @@ static cat_bool_t cat_socket_internal_connect(
     {
         cat_socket_internal_on_connect_done(socket_i, address->sa_family);
     }
+    if (!is_try) {
+        cat_socket_internal_stats_on_connected(socket_i, start);
+    }
 
     return cat_true;
 }
@@ -2117,9 +2309,77 @@ CAT_API void cat_socket_crypto_options_init(cat_socket_crypto_options_t *options
     options->no_ticket = cat_false;
     options->no_compression = cat_false;
     options->no_client_ca_list = cat_false;
+    options->ktls = cat_false;
     options->context = NULL;
 }
 
+/* client sessions are cached by peer, and they can not be shared between connections with different verification settings */
+/* everything which decides whether a session can be reused,
+ * (passphrase is not included because it can not change the result with the same key file) */
+static char *cat_socket_ssl_get_settings(const cat_socket_crypto_options_t *options)
+{
+    int security_level = -1;
+    const char *alpn_protocols = NULL;
+
+#ifdef CAT_SSL_HAVE_SECURITY_LEVEL
+    security_level = options->security_level;
+#endif
+#ifdef CAT_SSL_HAVE_TLS_ALPN
+    alpn_protocols = options->alpn_protocols;
+#endif
+
+    return cat_sprintf("%s|%s|%s|%s|%u|%d|%d|%s|%s%s%s%s",
+        options->certificate != NULL ? options->certificate : "",
+        options->certificate_key != NULL ? options->certificate_key : "",
+        options->ca_file != NULL ? options->ca_file : "",
+        options->ca_path != NULL ? options->ca_path : "",
+        options->protocols, options->verify_depth, security_level,
+        alpn_protocols != NULL ? alpn_protocols : "",
+        options->verify_peer ? "v" : "", options->verify_peer_name ? "n" : "",
+        options->allow_self_signed ? "s" : "", options->no_compression ? "c" : "");
+}
+
+static void cat_socket_ssl_set_session_cache_key(cat_socket_t *socket, cat_ssl_t *ssl, const cat_socket_crypto_options_t *options)
+{
+    char address[CAT_SOCKADDR_MAX_PATH];
+    size_t address_length = sizeof(address);
+    const char *peer_name = options->peer_name;
+    char *settings, *key;
+
+    if (peer_name == NULL) {
+        if (!cat_socket_get_peer_address(socket, address, &address_length)) {
+            return;
+        }
+        peer_name = address;
+    }
+    settings = cat_socket_ssl_get_settings(options);
+    if (unlikely(settings == NULL)) {
+        return;
+    }
+    key = cat_sprintf("%s:%d|%s", peer_name, cat_socket_get_peer_port(socket), settings);
+    cat_free(settings);
+    if (unlikely(key == NULL)) {
+        return;
+    }
+    if (!cat_ssl_set_session_cache_key(ssl, key, strlen(key))) {
+        CAT_LOG_DEBUG(SOCKET, "Socket SSL set session cache key failed (%s)", cat_get_last_error_message());
+    }
+    cat_free(key);
+}
+
+static void cat_socket_ssl_set_session_id_context(cat_ssl_context_t *context, const cat_socket_crypto_options_t *options)
+{
+    char *settings = cat_socket_ssl_get_settings(options);
+
+    if (unlikely(settings == NULL)) {
+        return;
+    }
+    if (!cat_ssl_context_set_session_id_context(context, settings, strlen(settings))) {
+        CAT_LOG_DEBUG(SOCKET, "Socket SSL set session id context failed (%s)", cat_get_last_error_message());
+    }
+    cat_free(settings);
+}
+
 /* TODO: Support non-blocking SSL handshake? (just for PHP, stupid design) */
 
 static cat_bool_t cat_socket_enable_crypto_impl(cat_socket_t *socket, const cat_socket_crypto_options_t *options, cat_timeout_t timeout)
@@ -2228,6 +2488,11 @@ static cat_bool_t cat_socket_enable_crypto_impl(cat_socket_t *socket, const cat_
         }
     }
 #endif
+    if (!ioptions.is_client) {
+        CAT_PROTECT_LAST_ERROR_START() {
+            cat_socket_ssl_set_session_id_context(context, &ioptions);
+        } CAT_PROTECT_LAST_ERROR_END();
+    }
     /* create ssl connection */
     ssl = cat_ssl_create(NULL, context);
     if (use_tmp_context) {
@@ -2249,7 +2514,21 @@ static cat_bool_t cat_socket_enable_crypto_impl(cat_socket_t *socket, const cat_
     if (ioptions.is_client && ioptions.peer_name != NULL) {
         cat_ssl_set_sni_server_name(ssl, ioptions.peer_name);
     }
+    if (ioptions.is_client) {
+        CAT_PROTECT_LAST_ERROR_START() {
+            cat_socket_ssl_set_session_cache_key(socket, ssl, &ioptions);
+        } CAT_PROTECT_LAST_ERROR_END();
+    }
     ssl->allow_self_signed = ioptions.allow_self_signed;
+#ifdef CAT_SSL_HAVE_KTLS
+    if (ioptions.ktls) {
+        CAT_PROTECT_LAST_ERROR_START() {
+            if (!cat_ssl_prepare_ktls(ssl)) {
+                CAT_LOG_DEBUG(SOCKET, "Socket SSL kTLS is unavailable (%s)", cat_get_last_error_message());
+            }
+        } CAT_PROTECT_LAST_ERROR_END();
+    }
+#endif
 
     buffer = &ssl->read_buffer;
 
@@ -2325,6 +2604,16 @@ static cat_bool_t cat_socket_enable_crypto_impl(cat_socket_t *socket, const cat_
         }
     }
 
+#ifdef CAT_SSL_HAVE_KTLS
+    if (ioptions.ktls && ssl->ktls != NULL) {
+        CAT_PROTECT_LAST_ERROR_START() {
+            if (!cat_ssl_enable_ktls_send(ssl, cat_socket_internal_get_fd_fast(socket_i))) {
+                CAT_LOG_DEBUG(SOCKET, "Socket SSL kTLS is unavailable, fallback to user-space TLS (%s)", cat_get_last_error_message());
+            }
+        } CAT_PROTECT_LAST_ERROR_END();
+    }
+#endif
+
     socket_i->ssl = ssl;
 
     return cat_true;
@@ -2360,7 +2649,8 @@ static cat_bool_t cat_socket_enable_crypto_impl(cat_socket_t *socket, const cat_
     "allow_self_signed: %s, " \
     "no_ticket: %s, " \
     "no_compression: %s, " \
-    "no_client_ca_list: %s" \
+    "no_client_ca_list: %s, " \
+    "ktls: %s" \
     " }"
 
 #define CAT_SOCKET_CRYPTO_OPTIONS_C(options, protocols_str) \
@@ -2380,7 +2670,8 @@ static cat_bool_t cat_socket_enable_crypto_impl(cat_socket_t *socket, const cat_
     cat_bool_str(options.allow_self_signed), \
     cat_bool_str(options.no_ticket), \
     cat_bool_str(options.no_compression), \
-    cat_bool_str(options.no_client_ca_list)
+    cat_bool_str(options.no_client_ca_list), \
+    cat_bool_str(options.ktls)
 
 CAT_API cat_bool_t cat_socket_enable_crypto(cat_socket_t *socket, const cat_socket_crypto_options_t *options)
 {
@@ -2624,8 +2915,10 @@ static void cat_socket_read_callback(uv_stream_t *stream, ssize_t nread, const u
 
     /* 0 == EAGAIN */
     if (nread == 0) {
+        cat_socket_internal_stats_on_read(socket_i, CAT_EAGAIN);
         return;
     }
+    cat_socket_internal_stats_on_read(socket_i, nread);
 
     if (nread > 0) {
         context->nread += nread;
@@ -2663,8 +2956,10 @@ static void cat_socket_udp_recv_callback(uv_udp_t *udp, ssize_t nread, const uv_
 
     /* FIXME: flags & UV_UDP_PARTIAL */
     if (unlikely(nread == 0 && address == NULL)) {
+        cat_socket_internal_stats_on_read(socket_i, CAT_EAGAIN);
         return; // EAGAIN (if address is non-empty, it is a empty UDP packet)
     }
+    cat_socket_internal_stats_on_read(socket_i, nread);
     if (address != NULL) {
         cat_socklen_t address_length;
         switch (address->sa_family) {
@@ -2712,11 +3007,13 @@ static int cat_socket_internal_udg_wait_readable(cat_socket_internal_t *socket_i
             return cat_translate_sys_error(cat_sys_errno);
         }
     }
+    cat_nsec_t start = cat_time_nsec();
     socket_i->context.io.read.coroutine = CAT_COROUTINE_G(current);
     socket_i->io_flags |= CAT_SOCKET_IO_FLAG_READ;
     ret = cat_poll_one(socket_i->u.udg.readfd, POLLIN, NULL, timeout);
     socket_i->io_flags ^= CAT_SOCKET_IO_FLAG_READ;
     socket_i->context.io.read.coroutine = NULL;
+    cat_socket_internal_stats_on_read_wait_done(socket_i, start);
     if (ret == CAT_RET_OK) {
         return 0;
     } else if (ret == CAT_RET_NONE) {
@@ -2779,6 +3076,7 @@ static ssize_t cat_socket_internal_read_raw(
                 } else {
                     error = recvfrom(fd, buffer, size, 0, address, address_length);
                 }
+                cat_socket_internal_stats_on_read(socket_i, error >= 0 ? error : cat_translate_sys_error(cat_sys_errno));
                 if (error < 0) {
                     if (likely(cat_sys_errno == EAGAIN)) {
                         break;
@@ -2849,7 +3147,13 @@ static ssize_t cat_socket_internal_read_raw(
         } else {
             error = uv_udp_recv_start(&socket_i->u.udp, cat_socket_read_alloc_callback, cat_socket_udp_recv_callback);
         }
-        ret = error == 0 && cat_time_wait(timeout);
+        if (likely(error == 0)) {
+            cat_nsec_t start = cat_time_nsec();
+            ret = cat_time_wait(timeout);
+            cat_socket_internal_stats_on_read_wait_done(socket_i, start);
+        } else {
+            ret = cat_false;
+        }
         socket_i->io_flags ^= CAT_SOCKET_IO_FLAG_READ;
         socket_i->context.io.read.coroutine = NULL;
         socket_i->context.io.read.data.ptr = NULL;
@@ -2923,8 +3227,9 @@ static ssize_t cat_socket_internal_try_recv_raw(
                 continue;
             }
 #endif
-            return cat_translate_sys_error(cat_sys_errno);
+            nread = cat_translate_sys_error(cat_sys_errno);
         }
+        cat_socket_internal_stats_on_read(socket_i, nread);
         break;
     }
 
@@ -3188,6 +3493,7 @@ static cat_never_inline cat_bool_t cat_socket_internal_udg_write(
         msg.msg_flags = 0;
         do {
             error = sendmsg(fd, &msg, 0);
+            cat_socket_internal_stats_on_write(socket_i, error >= 0 ? error : cat_translate_sys_error(cat_sys_errno));
         } while (error < 0 && CAT_SOCKET_RETRY_ON_WRITE_ERROR(cat_sys_errno));
         if (unlikely(error < 0)) {
             if (CAT_SOCKET_IS_TRANSIENT_WRITE_ERROR(cat_sys_errno)) {
@@ -3197,7 +3503,9 @@ static cat_never_inline cat_bool_t cat_socket_internal_udg_write(
                         goto _syscall_error;
                     }
                 }
+                cat_nsec_t start = cat_time_nsec();
                 cat_ret_t poll_ret = cat_poll_one(socket_i->u.udg.writefd, POLLOUT, NULL, timeout);
+                cat_socket_internal_stats_on_write_wait_done(socket_i, start);
                 if (poll_ret == CAT_RET_OK) {
                     continue;
                 } else if (poll_ret == CAT_RET_NONE) {
@@ -3226,6 +3534,14 @@ static cat_never_inline cat_bool_t cat_socket_internal_udg_write(
 }
 #endif
 
+static cat_always_inline size_t cat_socket_internal_get_write_queue_size(const cat_socket_internal_t *socket_i)
+{
+    if ((socket_i->type & CAT_SOCKET_TYPE_UDP) == CAT_SOCKET_TYPE_UDP) {
+        return uv_udp_get_send_queue_size(&socket_i->u.udp);
+    }
+    return uv_stream_get_write_queue_size(&socket_i->u.stream);
+}
+
 static cat_bool_t cat_socket_internal_write_raw(
     cat_socket_internal_t *socket_i,
     const cat_socket_write_vector_t *vector, unsigned int vector_count,
@@ -3240,6 +3556,7 @@ static cat_bool_t cat_socket_internal_write_raw(
     cat_bool_t ret = cat_false;
     cat_socket_write_request_t *request;
     size_t context_size;
+    cat_bool_t was_queued;
     ssize_t error;
 
 #ifdef CAT_OS_UNIX_LIKE
@@ -3277,6 +3594,9 @@ static cat_bool_t cat_socket_internal_write_raw(
             socket_i->cache.write_request = request;
         }
     }
+    /* libuv tries to write immediately only if there is nothing queued,
+     * so we count it as a syscall, and it is EAGAIN if the data has to be queued */
+    was_queued = cat_socket_internal_get_write_queue_size(socket_i) != 0;
     if (!is_dgram) {
         error = uv_write2(
             &request->u.stream, &socket_i->u.stream,
@@ -3292,11 +3612,22 @@ static cat_bool_t cat_socket_internal_write_raw(
         );
     }
     if (likely(error == 0)) {
+        cat_bool_t is_queued = cat_socket_internal_get_write_queue_size(socket_i) != 0;
+        cat_nsec_t start = 0;
+        if (!was_queued) {
+            cat_socket_internal_stats_on_write(socket_i, is_queued ? CAT_EAGAIN : 0);
+        }
+        if (is_queued) {
+            start = cat_time_nsec();
+        }
         request->error = CAT_ECANCELED;
         request->u.coroutine = CAT_COROUTINE_G(current);
         socket_i->io_flags |= CAT_SOCKET_IO_FLAG_WRITE;
         cat_queue_push_back(&socket_i->context.io.write.coroutines, &CAT_COROUTINE_G(current)->waiter.node);
         ret = cat_time_wait(timeout);
+        if (is_queued) {
+            cat_socket_internal_stats_on_write_wait_done(socket_i, start);
+        }
         cat_queue_remove(&CAT_COROUTINE_G(current)->waiter.node);
         request->u.coroutine = NULL;
         error = request->error;
@@ -3323,6 +3654,8 @@ static cat_bool_t cat_socket_internal_write_raw(
         } else {
             cat_update_last_error_with_reason((cat_errno_t) error, "Socket write failed");
         }
+    } else {
+        CAT_SOCKET_INTERNAL_STATS_ADD(socket_i, bytes_written, cat_socket_write_vector_length(vector, vector_count));
     }
 
     _out:
@@ -3357,8 +3690,9 @@ static cat_never_inline ssize_t cat_socket_internal_udg_try_write(
     } while (nwrite < 0 && CAT_SOCKET_RETRY_ON_WRITE_ERROR(cat_sys_errno));
 
     if (unlikely(nwrite < 0)) {
-        return cat_translate_sys_error(cat_sys_errno);
+        nwrite = cat_translate_sys_error(cat_sys_errno);
     }
+    cat_socket_internal_stats_on_write(socket_i, nwrite);
     return nwrite;
 }
 #endif
@@ -3383,18 +3717,22 @@ static ssize_t cat_socket_internal_try_write_raw(
         return cat_socket_internal_udg_try_write(socket_i, vector, vector_count, address, address_length);
     }
 #endif
+    ssize_t nwrite;
     if (!is_dgram) {
-        return uv_try_write(
+        nwrite = uv_try_write(
             &socket_i->u.stream,
             (const uv_buf_t *) vector, vector_count
         );
     } else {
-        return uv_udp_try_send(
+        nwrite = uv_udp_try_send(
             &socket_i->u.udp,
             (const uv_buf_t *) vector, vector_count,
             address
         );
     }
+    cat_socket_internal_stats_on_write(socket_i, nwrite);
+
+    return nwrite;
 }
 
 #ifdef CAT_SSL
@@ -3553,6 +3891,14 @@ static ssize_t cat_socket_internal_try_write_encrypted(
 }
 #endif
 
+#ifdef CAT_SSL
+/* kernel encrypts outgoing records by itself if kTLS is enabled, so plain data can be written to it */
+static cat_always_inline cat_bool_t cat_socket_internal_write_needs_encryption(const cat_socket_internal_t *socket_i)
+{
+    return socket_i->ssl != NULL && !cat_ssl_is_ktls_send_enabled(socket_i->ssl);
+}
+#endif
+
 static cat_always_inline cat_bool_t cat_socket_internal_write(
     cat_socket_internal_t *socket_i,
     const cat_socket_write_vector_t *vector, unsigned int vector_count,
@@ -3563,7 +3909,7 @@ static cat_always_inline cat_bool_t cat_socket_internal_write(
 #ifdef CAT_SSL
     /** @thinking: shall we check and wait for previous hanging write coroutines here?
      * before previous write() are done (writable/POLLOUT), may SSL can not encrypt more data? */
-    if (socket_i->ssl != NULL) {
+    if (cat_socket_internal_write_needs_encryption(socket_i)) {
         return cat_socket_internal_write_encrypted(socket_i, vector, vector_count, address, address_length, timeout);
     }
 #endif
@@ -3577,81 +3923,407 @@ static cat_always_inline ssize_t cat_socket_internal_try_write(
 )
 {
 #ifdef CAT_SSL
-    if (socket_i->ssl != NULL) {
+    if (cat_socket_internal_write_needs_encryption(socket_i)) {
         return cat_socket_internal_try_write_encrypted(socket_i, vector, vector_count, address, address_length);
     }
 #endif
     return cat_socket_internal_try_write_raw(socket_i, vector, vector_count, address, address_length);
 }
 
-#define CAT_SOCKET_INTERNAL_IO_ESTABLISHED_CHECK_FOR_STREAM_SILENT(_socket_i, _failure) do { \
-    if (!(_socket_i->type & CAT_SOCKET_TYPE_FLAG_DGRAM)) { \
-        CAT_SOCKET_INTERNAL_ESTABLISHED_ONLY_SILENT(_socket_i, _failure); \
-    } \
-} while (0)
+/* write coalescing */
 
-#define CAT_SOCKET_INTERNAL_IO_ESTABLISHED_CHECK_FOR_STREAM(_socket_i, _failure) do { \
-    if (!(_socket_i->type & CAT_SOCKET_TYPE_FLAG_DGRAM)) { \
-        CAT_SOCKET_INTERNAL_ESTABLISHED_ONLY(_socket_i, _failure); \
-    } \
-} while (0)
+struct cat_socket_write_coalescing_s {
+    cat_buffer_t buffer;
+    size_t threshold;
+    /* flush buffered data at the end of the current round */
+    cat_event_io_defer_task_t *flush_task;
+#ifdef CAT_SSL
+    /* SSL write buffer is busy, retry it in the next round */
+    cat_event_loop_defer_task_t *retry_task;
+#endif
+    /* error of the deferred flush, it will be reported by the next write */
+    cat_errno_t error;
+};
 
-#define CAT_SOCKET_IO_CHECK_RAW(_socket, _socket_i, _io_flag, _failure) \
-    CAT_SOCKET_INTERNAL_GETTER_WITH_IO(_socket, _socket_i, _io_flag, _failure); \
-    CAT_SOCKET_INTERNAL_IO_ESTABLISHED_CHECK_FOR_STREAM(_socket_i, _failure) \
+typedef struct cat_socket_write_coalescing_request_s {
+    uv_write_t request;
+    /* data is owned by request until write is done */
+    cat_buffer_t buffer;
+} cat_socket_write_coalescing_request_t;
 
-#define CAT_SOCKET_IO_CHECK(_socket, _socket_i, _io_flag, _failure) \
-        CAT_SOCKET_IO_CHECK_RAW(_socket, _socket_i, _io_flag, _failure); \
-        do { \
-            if (unlikely((_socket_i->type & CAT_SOCKET_TYPE_IPCC) == CAT_SOCKET_TYPE_IPCC)) { \
-                cat_update_last_error(CAT_EMISUSE, "Socket IPC channel can not transfer user data"); \
-                _failure; \
-            } \
-        } while (0)
+static void cat_socket_write_coalescing_request_callback(uv_write_t *request, int status)
+{
+    cat_socket_write_coalescing_request_t *coalescing_request = cat_container_of(request, cat_socket_write_coalescing_request_t, request);
+    /* socket_i is still alive here, write requests are always done before the close callback */
+    cat_socket_internal_t *socket_i = cat_container_of(request->handle, cat_socket_internal_t, u.stream);
 
-#define CAT_SOCKET_TRY_IO_CHECK(_socket, _socket_i, _io_flag, _failure) \
-        CAT_SOCKET_INTERNAL_GETTER_WITH_IO_SILENT(_socket, _socket_i, _io_flag, _failure); \
-        CAT_SOCKET_INTERNAL_IO_ESTABLISHED_CHECK_FOR_STREAM_SILENT(_socket_i, _failure) \
+    if (unlikely(status != 0) && status != CAT_ECANCELED && socket_i->write_coalescing != NULL) {
+        socket_i->write_coalescing->error = status;
+    }
+    cat_buffer_close(&coalescing_request->buffer);
+    cat_free(coalescing_request);
+}
 
-static cat_always_inline ssize_t cat_socket_read_impl(cat_socket_t *socket, char *buffer, size_t size, cat_sockaddr_t *address, cat_socklen_t *address_length, cat_timeout_t timeout, cat_bool_t once)
+static cat_always_inline void cat_socket_write_coalescing_cancel_tasks(cat_socket_write_coalescing_t *coalescing)
 {
-    CAT_SOCKET_IO_CHECK(socket, socket_i, CAT_SOCKET_IO_FLAG_READ, return -1);
-    return cat_socket_internal_read(socket_i, buffer, size, address, address_length, timeout, once);
+    if (coalescing->flush_task != NULL) {
+        (void) cat_event_io_defer_task_close(coalescing->flush_task);
+        coalescing->flush_task = NULL;
+    }
+#ifdef CAT_SSL
+    if (coalescing->retry_task != NULL) {
+        (void) cat_event_loop_defer_task_close(coalescing->retry_task);
+        coalescing->retry_task = NULL;
+    }
+#endif
 }
 
-static cat_always_inline ssize_t cat_socket_try_recv_impl(cat_socket_t *socket, char *buffer, size_t size, cat_sockaddr_t *address, cat_socklen_t *address_length)
+static cat_always_inline cat_bool_t cat_socket_write_coalescing_check_error(cat_socket_write_coalescing_t *coalescing)
 {
-    CAT_SOCKET_TRY_IO_CHECK(socket, socket_i, CAT_SOCKET_IO_FLAG_READ, return error);
-    return cat_socket_internal_try_recv(socket_i, buffer, size, address, address_length);
+    cat_errno_t error = coalescing->error;
+
+    if (unlikely(error != 0)) {
+        coalescing->error = 0;
+        cat_update_last_error_with_reason(error, "Socket write failed when flushing coalesced data");
+        return cat_false;
+    }
+
+    return cat_true;
 }
 
-static cat_always_inline cat_bool_t cat_socket_write_impl(cat_socket_t *socket, const cat_socket_write_vector_t *vector, unsigned int vector_count, const cat_sockaddr_t *address, cat_socklen_t address_length, cat_timeout_t timeout)
+static void cat_socket_internal_write_coalescing_flush_nowait(cat_socket_internal_t *socket_i);
+
+static void cat_socket_write_coalescing_flush_callback(cat_event_io_defer_task_t *task, cat_data_t *data)
 {
-    CAT_SOCKET_IO_CHECK(socket, socket_i, CAT_SOCKET_IO_FLAG_NONE, return cat_false);
-    return cat_socket_internal_write(socket_i, vector, vector_count, address, address_length, timeout);
+    cat_socket_internal_t *socket_i = (cat_socket_internal_t *) data;
+
+    socket_i->write_coalescing->flush_task = NULL;
+    (void) cat_event_io_defer_task_close(task);
+    cat_socket_internal_write_coalescing_flush_nowait(socket_i);
 }
 
-static cat_always_inline ssize_t cat_socket_try_write_impl(cat_socket_t *socket, const cat_socket_write_vector_t *vector, unsigned int vector_count, const cat_sockaddr_t *address, cat_socklen_t address_length)
+#ifdef CAT_SSL
+static void cat_socket_write_coalescing_retry_callback(cat_event_loop_defer_task_t *task, cat_data_t *data)
 {
-    CAT_SOCKET_TRY_IO_CHECK(socket, socket_i, CAT_SOCKET_IO_FLAG_WRITE, return error == CAT_ELOCKED ? CAT_EAGAIN : error);
-    return cat_socket_internal_try_write(socket_i, vector, vector_count, address, address_length);
+    cat_socket_internal_t *socket_i = (cat_socket_internal_t *) data;
+
+    socket_i->write_coalescing->retry_task = NULL;
+    (void) cat_event_loop_defer_task_close(task);
+    cat_socket_internal_write_coalescing_flush_nowait(socket_i);
 }
+#endif
 
-#define CAT_SOCKET_READ_ADDRESS_CONTEXT(_address, _name, _name_length, _port) \
-    cat_sockaddr_info_t _address##_info; \
-    cat_sockaddr_t *_address; \
-    cat_socklen_t *_address##_length; do { \
-    \
-    if (unlikely((_name == NULL || _name_length == NULL || *_name_length == 0) && _port == NULL)) { \
-        _address = NULL; \
-        _address##_length = NULL; \
-        _address##_info.length = 0; \
-    } else { \
-        _address = &_address##_info.address.common; \
-        _address##_length = &_address##_info.length; \
-        _address##_info.length = sizeof(_address##_info.address); \
-    } \
-} while (0)
+/* it is called outside of coroutines, so it must never block,
+ * data which can not be written at once is queued on the stream */
+static void cat_socket_internal_write_coalescing_flush_nowait(cat_socket_internal_t *socket_i)
+{
+    cat_socket_write_coalescing_t *coalescing = socket_i->write_coalescing;
+    cat_buffer_t *buffer = &coalescing->buffer;
+    cat_socket_write_vector_t vector;
+    ssize_t n;
+
+    if (buffer->length == 0) {
+        return;
+    }
+    vector = cat_socket_write_vector_init(buffer->value, (cat_socket_vector_length_t) buffer->length);
+#ifdef CAT_SSL
+    if (cat_socket_internal_write_needs_encryption(socket_i)) {
+        /* encrypted data which can not be written at once is queued by SSL write buffer */
+        n = cat_socket_internal_try_write_encrypted(socket_i, &vector, 1, NULL, 0);
+        if (n == CAT_EAGAIN) {
+            if (coalescing->retry_task == NULL) {
+                coalescing->retry_task = cat_event_loop_defer_task_create(cat_socket_write_coalescing_retry_callback, socket_i);
+            }
+            return;
+        }
+        if (unlikely(n < 0)) {
+            coalescing->error = (cat_errno_t) n;
+        }
+        cat_buffer_clear(buffer);
+        return;
+    }
+#endif
+    n = cat_socket_internal_try_write_raw(socket_i, &vector, 1, NULL, 0);
+    if (n == CAT_EAGAIN) {
+        n = 0;
+    }
+    if (unlikely(n < 0)) {
+        coalescing->error = (cat_errno_t) n;
+    } else if ((size_t) n < buffer->length) {
+        /* the following writes will be queued after it */
+        cat_socket_write_coalescing_request_t *request;
+        uv_buf_t buf;
+        int error;
+        request = (cat_socket_write_coalescing_request_t *) cat_malloc(sizeof(*request));
+#if CAT_ALLOC_HANDLE_ERRORS
+        if (unlikely(request == NULL)) {
+            coalescing->error = cat_translate_sys_error(cat_sys_errno);
+            cat_buffer_clear(buffer);
+            return;
+        }
+#endif
+        request->buffer = *buffer;
+        cat_buffer_init(buffer);
+        buf.base = request->buffer.value + n;
+        buf.len = (cat_io_vector_length_t) (request->buffer.length - n);
+        error = uv_write(&request->request, &socket_i->u.stream, &buf, 1, cat_socket_write_coalescing_request_callback);
+        if (unlikely(error != 0)) {
+            coalescing->error = error;
+            cat_buffer_close(&request->buffer);
+            cat_free(request);
+        }
+        return;
+    }
+    cat_buffer_clear(buffer);
+}
+
+static cat_socket_write_vector_t *cat_socket_write_coalescing_vector_create(
+    const cat_buffer_t *buffered,
+    const cat_socket_write_vector_t *vector, unsigned int vector_count,
+    cat_socket_write_vector_t *storage, unsigned int storage_count
+)
+{
+    cat_socket_write_vector_t *full_vector = storage;
+
+    if (unlikely(vector_count >= storage_count)) {
+        full_vector = (cat_socket_write_vector_t *) cat_malloc(sizeof(*full_vector) * (vector_count + 1));
+#if CAT_ALLOC_HANDLE_ERRORS
+        if (unlikely(full_vector == NULL)) {
+            return NULL;
+        }
+#endif
+    }
+    full_vector[0] = cat_socket_write_vector_init(buffered->value, (cat_socket_vector_length_t) buffered->length);
+    if (vector_count > 0) {
+        memcpy(full_vector + 1, vector, sizeof(*vector) * vector_count);
+    }
+
+    return full_vector;
+}
+
+/* buffered data and the given data are written by one writev() */
+static cat_bool_t cat_socket_internal_write_with_buffered(
+    cat_socket_internal_t *socket_i,
+    const cat_socket_write_vector_t *vector, unsigned int vector_count,
+    cat_timeout_t timeout
+)
+{
+    cat_socket_write_coalescing_t *coalescing = socket_i->write_coalescing;
+    cat_socket_write_vector_t storage[8], *full_vector;
+    cat_buffer_t buffered;
+    cat_bool_t ret;
+
+    if (unlikely(!cat_socket_write_coalescing_check_error(coalescing))) {
+        return cat_false;
+    }
+    if (coalescing->buffer.length == 0) {
+        if (vector_count == 0) {
+            return cat_true;
+        }
+        return cat_socket_internal_write(socket_i, vector, vector_count, NULL, 0, timeout);
+    }
+    full_vector = cat_socket_write_coalescing_vector_create(&coalescing->buffer, vector, vector_count, storage, CAT_ARRAY_SIZE(storage));
+#if CAT_ALLOC_HANDLE_ERRORS
+    if (unlikely(full_vector == NULL)) {
+        cat_update_last_error_of_syscall("Malloc for write vector failed");
+        return cat_false;
+    }
+#endif
+    /* take over the buffered data, others may buffer new data while we are writing */
+    buffered = coalescing->buffer;
+    cat_buffer_init(&coalescing->buffer);
+    cat_socket_write_coalescing_cancel_tasks(coalescing);
+
+    ret = cat_socket_internal_write(socket_i, full_vector, vector_count + 1, NULL, 0, timeout);
+
+    if (full_vector != storage) {
+        cat_free(full_vector);
+    }
+    /* reuse the memory if nobody has buffered new data */
+    coalescing = socket_i->write_coalescing;
+    if (coalescing != NULL && coalescing->buffer.value == NULL) {
+        cat_buffer_clear(&buffered);
+        coalescing->buffer = buffered;
+    } else {
+        cat_buffer_close(&buffered);
+    }
+
+    return ret;
+}
+
+static cat_bool_t cat_socket_internal_coalesced_write(
+    cat_socket_internal_t *socket_i,
+    const cat_socket_write_vector_t *vector, unsigned int vector_count,
+    cat_timeout_t timeout
+)
+{
+    cat_socket_write_coalescing_t *coalescing = socket_i->write_coalescing;
+    cat_buffer_t *buffer = &coalescing->buffer;
+    size_t length = cat_socket_write_vector_length(vector, vector_count);
+    unsigned int i;
+
+    if (buffer->length + length >= coalescing->threshold) {
+        return cat_socket_internal_write_with_buffered(socket_i, vector, vector_count, timeout);
+    }
+    if (unlikely(!cat_socket_write_coalescing_check_error(coalescing))) {
+        return cat_false;
+    }
+    if (unlikely(!cat_buffer_prepare(buffer, length))) {
+        cat_update_last_error_of_syscall("Socket buffer data for write coalescing failed");
+        return cat_false;
+    }
+    for (i = 0; i < vector_count; i++) {
+        (void) cat_buffer_append(buffer, vector[i].base, vector[i].length);
+    }
+    if (coalescing->flush_task == NULL
+#ifdef CAT_SSL
+        && coalescing->retry_task == NULL
+#endif
+    ) {
+        coalescing->flush_task = cat_event_io_defer_task_create(cat_socket_write_coalescing_flush_callback, socket_i);
+    }
+
+    return cat_true;
+}
+
+static ssize_t cat_socket_internal_coalesced_try_write(
+    cat_socket_internal_t *socket_i,
+    const cat_socket_write_vector_t *vector, unsigned int vector_count
+)
+{
+    cat_socket_write_coalescing_t *coalescing = socket_i->write_coalescing;
+    cat_buffer_t *buffer = &coalescing->buffer;
+    size_t buffered_length = buffer->length;
+    cat_socket_write_vector_t storage[8], *full_vector;
+    ssize_t n;
+
+    if (unlikely(coalescing->error != 0)) {
+        n = coalescing->error;
+        coalescing->error = 0;
+        return n;
+    }
+    if (buffered_length == 0) {
+        return cat_socket_internal_try_write(socket_i, vector, vector_count, NULL, 0);
+    }
+    full_vector = cat_socket_write_coalescing_vector_create(buffer, vector, vector_count, storage, CAT_ARRAY_SIZE(storage));
+#if CAT_ALLOC_HANDLE_ERRORS
+    if (unlikely(full_vector == NULL)) {
+        return cat_translate_sys_error(cat_sys_errno);
+    }
+#endif
+    n = cat_socket_internal_try_write(socket_i, full_vector, vector_count + 1, NULL, 0);
+    if (full_vector != storage) {
+        cat_free(full_vector);
+    }
+    if (n < 0) {
+        return n;
+    }
+    if ((size_t) n < buffered_length) {
+        /* none of the given data has been written */
+        memmove(buffer->value, buffer->value + n, buffered_length - n);
+        cat_buffer_truncate(buffer, buffered_length - n);
+        return CAT_EAGAIN;
+    }
+    cat_buffer_clear(buffer);
+    cat_socket_write_coalescing_cancel_tasks(coalescing);
+
+    return n - buffered_length;
+}
+
+static void cat_socket_internal_write_coalescing_close(cat_socket_internal_t *socket_i, cat_bool_t unrecoverable_error)
+{
+    cat_socket_write_coalescing_t *coalescing = socket_i->write_coalescing;
+
+    cat_socket_write_coalescing_cancel_tasks(coalescing);
+    /* the last chance to write the buffered data, but it is not guaranteed,
+     * flush() should be called before close() if it matters */
+    if (!unrecoverable_error && coalescing->buffer.length > 0
+#ifdef CAT_SSL
+        && !cat_socket_internal_write_needs_encryption(socket_i)
+#endif
+    ) {
+        cat_socket_write_vector_t vector = cat_socket_write_vector_init(
+            coalescing->buffer.value, (cat_socket_vector_length_t) coalescing->buffer.length
+        );
+        (void) cat_socket_internal_try_write_raw(socket_i, &vector, 1, NULL, 0);
+    }
+    cat_buffer_clear(&coalescing->buffer);
+}
+
+#define CAT_SOCKET_INTERNAL_IO_ESTABLISHED_CHECK_FOR_STREAM_SILENT(_socket_i, _failure) do { \
+    if (!(_socket_i->type & CAT_SOCKET_TYPE_FLAG_DGRAM)) { \
+        CAT_SOCKET_INTERNAL_ESTABLISHED_ONLY_SILENT(_socket_i, _failure); \
+    } \
+} while (0)
+
+#define CAT_SOCKET_INTERNAL_IO_ESTABLISHED_CHECK_FOR_STREAM(_socket_i, _failure) do { \
+    if (!(_socket_i->type & CAT_SOCKET_TYPE_FLAG_DGRAM)) { \
+        CAT_SOCKET_INTERNAL_ESTABLISHED_ONLY(_socket_i, _failure); \
+    } \
+} while (0)
+
+#define CAT_SOCKET_IO_CHECK_RAW(_socket, _socket_i, _io_flag, _failure) \
+    CAT_SOCKET_INTERNAL_GETTER_WITH_IO(_socket, _socket_i, _io_flag, _failure); \
+    CAT_SOCKET_INTERNAL_IO_ESTABLISHED_CHECK_FOR_STREAM(_socket_i, _failure) \
+
+#define CAT_SOCKET_IO_CHECK(_socket, _socket_i, _io_flag, _failure) \
+        CAT_SOCKET_IO_CHECK_RAW(_socket, _socket_i, _io_flag, _failure); \
+        do { \
+            if (unlikely((_socket_i->type & CAT_SOCKET_TYPE_IPCC) == CAT_SOCKET_TYPE_IPCC)) { \
+                cat_update_last_error(CAT_EMISUSE, "Socket IPC channel can not transfer user data"); \
+                _failure; \
+            } \
+        } while (0)
+
+#define CAT_SOCKET_TRY_IO_CHECK(_socket, _socket_i, _io_flag, _failure) \
+        CAT_SOCKET_INTERNAL_GETTER_WITH_IO_SILENT(_socket, _socket_i, _io_flag, _failure); \
+        CAT_SOCKET_INTERNAL_IO_ESTABLISHED_CHECK_FOR_STREAM_SILENT(_socket_i, _failure) \
+
+static cat_always_inline ssize_t cat_socket_read_impl(cat_socket_t *socket, char *buffer, size_t size, cat_sockaddr_t *address, cat_socklen_t *address_length, cat_timeout_t timeout, cat_bool_t once)
+{
+    CAT_SOCKET_IO_CHECK(socket, socket_i, CAT_SOCKET_IO_FLAG_READ, return -1);
+    return cat_socket_internal_read(socket_i, buffer, size, address, address_length, timeout, once);
+}
+
+static cat_always_inline ssize_t cat_socket_try_recv_impl(cat_socket_t *socket, char *buffer, size_t size, cat_sockaddr_t *address, cat_socklen_t *address_length)
+{
+    CAT_SOCKET_TRY_IO_CHECK(socket, socket_i, CAT_SOCKET_IO_FLAG_READ, return error);
+    return cat_socket_internal_try_recv(socket_i, buffer, size, address, address_length);
+}
+
+static cat_always_inline cat_bool_t cat_socket_write_impl(cat_socket_t *socket, const cat_socket_write_vector_t *vector, unsigned int vector_count, const cat_sockaddr_t *address, cat_socklen_t address_length, cat_timeout_t timeout)
+{
+    CAT_SOCKET_IO_CHECK(socket, socket_i, CAT_SOCKET_IO_FLAG_NONE, return cat_false);
+    if (unlikely(socket_i->write_coalescing != NULL)) {
+        return cat_socket_internal_coalesced_write(socket_i, vector, vector_count, timeout);
+    }
+    return cat_socket_internal_write(socket_i, vector, vector_count, address, address_length, timeout);
+}
+
+static cat_always_inline ssize_t cat_socket_try_write_impl(cat_socket_t *socket, const cat_socket_write_vector_t *vector, unsigned int vector_count, const cat_sockaddr_t *address, cat_socklen_t address_length)
+{
+    CAT_SOCKET_TRY_IO_CHECK(socket, socket_i, CAT_SOCKET_IO_FLAG_WRITE, return error == CAT_ELOCKED ? CAT_EAGAIN : error);
+    if (unlikely(socket_i->write_coalescing != NULL)) {
+        return cat_socket_internal_coalesced_try_write(socket_i, vector, vector_count);
+    }
+    return cat_socket_internal_try_write(socket_i, vector, vector_count, address, address_length);
+}
+
+#define CAT_SOCKET_READ_ADDRESS_CONTEXT(_address, _name, _name_length, _port) \
+    cat_sockaddr_info_t _address##_info; \
+    cat_sockaddr_t *_address; \
+    cat_socklen_t *_address##_length; do { \
+    \
+    if (unlikely((_name == NULL || _name_length == NULL || *_name_length == 0) && _port == NULL)) { \
+        _address = NULL; \
+        _address##_length = NULL; \
+        _address##_info.length = 0; \
+    } else { \
+        _address = &_address##_info.address.common; \
+        _address##_length = &_address##_info.length; \
+        _address##_info.length = sizeof(_address##_info.address); \
+    } \
+} while (0)
 
 #define CAT_SOCKET_READ_ADDRESS_TO_NAME(_address, _name, _name_length, _port) do { \
     if (unlikely(_address##_info.length > sizeof(_address##_info.address))) { \
@@ -3734,6 +4406,10 @@ static cat_bool_t cat_socket_write_to_impl(cat_socket_t *socket, const cat_socke
     CAT_SOCKET_IO_CHECK(socket, socket_i, CAT_SOCKET_IO_FLAG_NONE, return cat_false);
     CAT_SOCKET_INTERNAL_SOLVE_WRITE_TO_ADDRESS(socket_i, name, name_length, port, address, address_length, return cat_false);
 
+    /* coalescing is only for stream sockets, the address makes no difference there */
+    if (unlikely(socket_i->write_coalescing != NULL)) {
+        return cat_socket_internal_coalesced_write(socket_i, vector, vector_count, timeout);
+    }
     return cat_socket_internal_write(socket_i, vector, vector_count, address, address_length, timeout);
 }
 
@@ -3742,6 +4418,9 @@ static ssize_t cat_socket_try_write_to_impl(cat_socket_t *socket, const cat_sock
     CAT_SOCKET_TRY_IO_CHECK(socket, socket_i, CAT_SOCKET_IO_FLAG_WRITE, return error == CAT_ELOCKED ? CAT_EAGAIN : error);
     CAT_SOCKET_INTERNAL_SOLVE_WRITE_TO_ADDRESS(socket_i, name, name_length, port, address, address_length, return cat_false);
 
+    if (unlikely(socket_i->write_coalescing != NULL)) {
+        return cat_socket_internal_coalesced_try_write(socket_i, vector, vector_count);
+    }
     return cat_socket_internal_try_write(socket_i, vector, vector_count, address, address_length);
 }
 
@@ -3808,6 +4487,209 @@ CAT_API ssize_t cat_socket_try_write(cat_socket_t *socket, const cat_socket_writ
     return n;
 }
 
+/* broadcast */
+
+typedef struct cat_socket_broadcast_context_s {
+    cat_coroutine_t *coroutine;
+    struct cat_socket_broadcast_request_s **requests;
+    cat_errno_t *errors;
+    size_t pending_count;
+    cat_bool_t waiting;
+} cat_socket_broadcast_context_t;
+
+typedef struct cat_socket_broadcast_request_s {
+    uv_write_t request;
+    /* it will be NULL if broadcaster has gone (e.g. timedout) */
+    cat_socket_broadcast_context_t *context;
+    size_t index;
+} cat_socket_broadcast_request_t;
+
+static void cat_socket_broadcast_write_callback(uv_write_t *request, int status)
+{
+    cat_socket_broadcast_request_t *broadcast_request = cat_container_of(request, cat_socket_broadcast_request_t, request);
+    cat_socket_broadcast_context_t *context = broadcast_request->context;
+
+    if (context != NULL) {
+        context->requests[broadcast_request->index] = NULL;
+        context->errors[broadcast_request->index] = status;
+        if (--context->pending_count == 0 && context->waiting) {
+            cat_coroutine_schedule(context->coroutine, SOCKET, "Broadcast");
+        }
+    }
+    cat_free(broadcast_request);
+}
+
+/* queue the remaining data which was not written by try_write() */
+static cat_errno_t cat_socket_broadcast_write_remaining(
+    cat_socket_t *socket, cat_socket_broadcast_context_t *context, size_t index,
+    const cat_socket_write_vector_t *vector, unsigned int vector_count, size_t offset
+)
+{
+    cat_socket_internal_t *socket_i = socket->internal;
+    cat_socket_broadcast_request_t *request;
+    cat_socket_write_vector_t *remaining_vector, remaining_vector_on_stack[8];
+    unsigned int remaining_vector_count = 0, i;
+    int error;
+
+    if (unlikely(vector_count > CAT_ARRAY_SIZE(remaining_vector_on_stack))) {
+        remaining_vector = (cat_socket_write_vector_t *) cat_malloc(sizeof(*remaining_vector) * vector_count);
+#if CAT_ALLOC_HANDLE_ERRORS
+        if (unlikely(remaining_vector == NULL)) {
+            return cat_translate_sys_error(cat_sys_errno);
+        }
+#endif
+    } else {
+        remaining_vector = remaining_vector_on_stack;
+    }
+    for (i = 0; i < vector_count; i++) {
+        if (offset >= vector[i].length) {
+            offset -= vector[i].length;
+            continue;
+        }
+        remaining_vector[remaining_vector_count].base = vector[i].base + offset;
+        remaining_vector[remaining_vector_count].length = (cat_io_vector_length_t) (vector[i].length - offset);
+        remaining_vector_count++;
+        offset = 0;
+    }
+    request = (cat_socket_broadcast_request_t *) cat_malloc(sizeof(*request));
+#if CAT_ALLOC_HANDLE_ERRORS
+    if (unlikely(request == NULL)) {
+        error = cat_translate_sys_error(cat_sys_errno);
+        goto _out;
+    }
+#endif
+    /* libuv copies the buffer descriptors and keeps the order with other writes on the stream,
+     * and try_write() always fails with EAGAIN on it until the queue is drained */
+    error = uv_write(
+        &request->request, &socket_i->u.stream,
+        (const uv_buf_t *) remaining_vector, remaining_vector_count,
+        cat_socket_broadcast_write_callback
+    );
+    if (unlikely(error != 0)) {
+        cat_free(request);
+        goto _out;
+    }
+    request->context = context;
+    request->index = index;
+    context->requests[index] = request;
+    context->pending_count++;
+
+    _out:
+    if (unlikely(remaining_vector != remaining_vector_on_stack)) {
+        cat_free(remaining_vector);
+    }
+    return error;
+}
+
+CAT_API size_t cat_socket_broadcast(cat_socket_t * const *sockets, size_t count, const cat_socket_write_vector_t *vector, unsigned int vector_count, cat_timeout_t timeout, cat_errno_t *errors)
+{
+    cat_socket_broadcast_context_t context;
+    size_t length = cat_io_vector_length((const cat_io_vector_t *) vector, vector_count);
+    size_t failure_count = 0, i;
+
+    CAT_LOG_DEBUG(SOCKET, "broadcast(%zu sockets, %zu bytes, " CAT_TIMEOUT_FMT ") = " CAT_LOG_UNFINISHED_STR,
+        count, length, timeout);
+
+    context.coroutine = CAT_COROUTINE_G(current);
+    context.requests = NULL;
+    context.errors = errors;
+    context.pending_count = 0;
+    context.waiting = cat_false;
+
+    /* fast path: most of sockets are writable, data is written without any copy or context switch */
+    for (i = 0; i < count; i++) {
+        cat_socket_t *socket = sockets[i];
+        cat_socket_internal_t *socket_i = socket->internal;
+        ssize_t n = cat_socket_try_write(socket, vector, vector_count);
+        if (likely(n >= 0 && (size_t) n == length)) {
+            errors[i] = 0;
+            continue;
+        }
+        if (n < 0 && n != CAT_EAGAIN) {
+            errors[i] = (cat_errno_t) n;
+            continue;
+        }
+        if (n < 0) {
+            n = 0;
+        }
+        /* slow path: it would block, we queue the remaining data on stream and wait for all of them together,
+         * and others (e.g. SSL/datagram sockets) fallback to the blocking write */
+        if (socket_i != NULL &&
+            !(socket_i->type & CAT_SOCKET_TYPE_FLAG_DGRAM)
+#ifdef CAT_SSL
+            && !cat_socket_internal_write_needs_encryption(socket_i)
+#endif
+            /* coalesced data which is still buffered must be written first */
+            && (socket_i->write_coalescing == NULL || socket_i->write_coalescing->buffer.length == 0)
+        ) {
+            if (unlikely(context.requests == NULL)) {
+                context.requests = (cat_socket_broadcast_request_t **) cat_malloc(sizeof(*context.requests) * count);
+#if CAT_ALLOC_HANDLE_ERRORS
+                if (unlikely(context.requests == NULL)) {
+                    errors[i] = cat_translate_sys_error(cat_sys_errno);
+                    continue;
+                }
+#endif
+                memset(context.requests, 0, sizeof(*context.requests) * count);
+            }
+            errors[i] = cat_socket_broadcast_write_remaining(socket, &context, i, vector, vector_count, (size_t) n);
+        } else {
+            /* mark it and write it later */
+            errors[i] = CAT_EAGAIN;
+        }
+    }
+
+    /* blocking writes (rare), queued writes are in progress at the same time */
+    for (i = 0; i < count; i++) {
+        if (errors[i] != CAT_EAGAIN || (context.requests != NULL && context.requests[i] != NULL)) {
+            continue;
+        }
+        cat_bool_t ret;
+        CAT_TIME_WAIT_START() {
+            ret = cat_socket_write_ex(sockets[i], vector, vector_count, timeout);
+        } CAT_TIME_WAIT_END(timeout);
+        errors[i] = ret ? 0 : cat_get_last_error_code();
+    }
+
+    /* wait for all queued writes */
+    if (context.pending_count > 0) {
+        cat_bool_t ret;
+        context.waiting = cat_true;
+        ret = cat_time_wait(timeout);
+        context.waiting = cat_false;
+        if (unlikely(!ret || context.pending_count > 0)) {
+            cat_errno_t error = !ret ? cat_get_last_error_code() : CAT_ECANCELED;
+            /* write requests are in progress, they can not be cancelled gracefully,
+             * so we must cancel them by socket_close(), like what socket_write() does */
+            for (i = 0; i < count; i++) {
+                cat_socket_broadcast_request_t *request = context.requests[i];
+                if (request == NULL) {
+                    continue;
+                }
+                request->context = NULL;
+                errors[i] = error;
+                if (sockets[i]->internal != NULL) {
+                    cat_socket_internal_unrecoverable_io_error(sockets[i]->internal);
+                }
+            }
+        }
+    }
+    if (context.requests != NULL) {
+        cat_free(context.requests);
+    }
+
+    for (i = 0; i < count; i++) {
+        if (errors[i] != 0) {
+            failure_count++;
+        }
+    }
+
+    CAT_LOG_DEBUG(SOCKET, "broadcast(%zu sockets, %zu bytes, " CAT_TIMEOUT_FMT ") = %zu failures",
+        count, length, timeout, failure_count);
+
+    return failure_count;
+}
+
 CAT_API cat_bool_t cat_socket_writeto(cat_socket_t *socket, const cat_socket_write_vector_t *vector, unsigned int vector_count, const cat_sockaddr_t *address, cat_socklen_t address_length)
 {
     return cat_socket_writeto_ex(socket, vector, vector_count, address, address_length, cat_socket_get_write_timeout_fast(socket));
@@ -4006,167 +4888,595 @@ CAT_API ssize_t cat_socket_recv_from_ex(cat_socket_t *socket, char *buffer, size
         cat_free(s);
     });
 
-    return n;
+    return n;
+}
+
+CAT_API ssize_t cat_socket_try_recv_from(cat_socket_t *socket, char *buffer, size_t size, char *name, size_t *name_length, int *port)
+{
+    ssize_t n = cat_socket_try_recv_from_impl(socket, buffer, size, name, name_length, port);
+
+    CAT_LOG_DEBUG_VA(SOCKET, {
+        char *s;
+        CAT_LOG_DEBUG_D(SOCKET, "try_recvfrom(" CAT_SOCKET_ID_FMT ", %s, %zu, \"%.*s\", %d) = " CAT_LOG_SSIZE_RET_FMT,
+            socket->id, cat_log_str_quote(buffer, n < 0 ? 0 : n, &s), size, (int) (name_length != NULL ? *name_length : 0), name, port != NULL ? *port : 0, CAT_LOG_SSIZE_RET_C(n));
+        cat_free(s);
+    });
+
+    return n;
+}
+
+CAT_API cat_bool_t cat_socket_send(cat_socket_t *socket, const char *buffer, size_t length)
+{
+    return cat_socket_send_ex(socket, buffer, length, cat_socket_get_write_timeout_fast(socket));
+}
+
+CAT_API cat_bool_t cat_socket_send_ex(cat_socket_t *socket, const char *buffer, size_t length, cat_timeout_t timeout)
+{
+    cat_socket_write_vector_t vector = cat_socket_write_vector_init(buffer, (cat_socket_vector_length_t) length);
+
+#ifdef CAT_ENABLE_DEBUG_LOG
+    char *buffer_quoted = NULL;
+#endif
+    CAT_LOG_DEBUG_VA(SOCKET, {
+        CAT_LOG_DEBUG_D(SOCKET, "send(" CAT_SOCKET_ID_FMT ", %s, %zu, " CAT_TIMEOUT_FMT ") = " CAT_LOG_UNFINISHED_STR,
+            socket->id, cat_log_str_quote(buffer, length, &buffer_quoted), length, timeout);
+    });
+
+    cat_bool_t ret = cat_socket_write_impl(socket, &vector, 1, NULL, 0, timeout);
+
+    CAT_LOG_DEBUG_VA(SOCKET, {
+        CAT_LOG_DEBUG_D(SOCKET, "send(" CAT_SOCKET_ID_FMT ", %s, %zu, " CAT_TIMEOUT_FMT ") = " CAT_LOG_BOOL_RET_FMT,
+            socket->id, buffer_quoted, length, timeout, CAT_LOG_BOOL_RET_C(ret));
+        cat_free(buffer_quoted);
+    });
+
+    return ret;
+}
+
+CAT_API ssize_t cat_socket_try_send(cat_socket_t *socket, const char *buffer, size_t length)
+{
+    cat_socket_write_vector_t vector = cat_socket_write_vector_init(buffer, (cat_socket_vector_length_t) length);
+
+    ssize_t n = cat_socket_try_write_impl(socket, &vector, 1, NULL, 0);
+
+    CAT_LOG_DEBUG_VA(SOCKET, {
+        char *s;
+        CAT_LOG_DEBUG_D(SOCKET, "try_send(" CAT_SOCKET_ID_FMT ", %s) = " CAT_LOG_SSIZE_RET_FMT,
+            socket->id, cat_log_str_quote(buffer, length, &s), CAT_LOG_SSIZE_RET_C(n));
+        cat_free(s);
+    });
+
+    return n;
+}
+
+CAT_API cat_bool_t cat_socket_sendto(cat_socket_t *socket, const char *buffer, size_t length, const cat_sockaddr_t *address, cat_socklen_t address_length)
+{
+    return cat_socket_sendto_ex(socket, buffer, length, address, address_length, cat_socket_get_write_timeout_fast(socket));
+}
+
+CAT_API cat_bool_t cat_socket_sendto_ex(cat_socket_t *socket, const char *buffer, size_t length, const cat_sockaddr_t *address, cat_socklen_t address_length, cat_timeout_t timeout)
+{
+    cat_socket_write_vector_t vector = cat_socket_write_vector_init(buffer, (cat_socket_vector_length_t) length);
+
+#ifdef CAT_ENABLE_DEBUG_LOG
+    char *buffer_quoted = NULL;
+    char name[CAT_SOCKADDR_MAX_PATH];
+    size_t name_length = sizeof(name);
+    int port = 0;
+#endif
+    CAT_LOG_DEBUG_VA(SOCKET, {
+        if (cat_sockaddr_to_name_silent(address, address_length, name, &name_length, &port) != 0) {
+            break;
+        }
+        CAT_LOG_DEBUG_D(SOCKET, "sendto(" CAT_SOCKET_ID_FMT ", %s, %zu, \"%.*s\", %d, " CAT_TIMEOUT_FMT ") = " CAT_LOG_UNFINISHED_STR,
+            socket->id, cat_log_str_quote(buffer, length, &buffer_quoted), length, (int) name_length, name, port, timeout);
+    });
+
+    cat_bool_t ret = cat_socket_write_impl(socket, &vector, 1, address, address_length, timeout);
+
+    CAT_LOG_DEBUG_VA(SOCKET, {
+        CAT_LOG_DEBUG_D(SOCKET, "sendto(" CAT_SOCKET_ID_FMT ", %s, %zu, \"%.*s\", %d, " CAT_TIMEOUT_FMT ") = " CAT_LOG_BOOL_RET_FMT,
+            socket->id, buffer_quoted, length, (int) name_length, name, port, timeout, CAT_LOG_BOOL_RET_C(ret));
+        cat_free(buffer_quoted);
+    });
+
+    return ret;
+}
+
+CAT_API ssize_t cat_socket_try_sendto(cat_socket_t *socket, const char *buffer, size_t length, const cat_sockaddr_t *address, cat_socklen_t address_length)
+{
+    cat_socket_write_vector_t vector = cat_socket_write_vector_init(buffer, (cat_socket_vector_length_t) length);
+
+    ssize_t n = cat_socket_try_write_impl(socket, &vector, 1, address, address_length);
+
+    CAT_LOG_DEBUG_VA(SOCKET, {
+        char *buffer_quoted;
+        char name[CAT_SOCKADDR_MAX_PATH];
+        size_t name_length = sizeof(name);
+        int port;
+        if (cat_sockaddr_to_name_silent(address, address_length, name, &name_length, &port) != 0) {
+            break;
+        }
+        CAT_LOG_DEBUG_D(SOCKET, "try_sendto(" CAT_SOCKET_ID_FMT ", %s, %zu, \"%.*s\", %d) = " CAT_LOG_SSIZE_RET_FMT,
+            socket->id, cat_log_str_quote(buffer, length, &buffer_quoted), length, (int) name_length, name, port, CAT_LOG_SSIZE_RET_C(n));
+        cat_free(buffer_quoted);
+    });
+
+    return n;
+}
+
+CAT_API cat_bool_t cat_socket_send_to(cat_socket_t *socket, const char *buffer, size_t length, const char *name, size_t name_length, int port)
+{
+    return cat_socket_send_to_ex(socket, buffer, length, name, name_length, port, cat_socket_get_write_timeout_fast(socket));
+}
+
+CAT_API cat_bool_t cat_socket_send_to_ex(cat_socket_t *socket, const char *buffer, size_t length, const char *name, size_t name_length, int port, cat_timeout_t timeout)
+{
+    cat_socket_write_vector_t vector = cat_socket_write_vector_init(buffer, (cat_socket_vector_length_t) length);
+
+#ifdef CAT_ENABLE_DEBUG_LOG
+    char *buffer_quoted = NULL;
+#endif
+    CAT_LOG_DEBUG_VA(SOCKET, {
+        CAT_LOG_DEBUG_D(SOCKET, "send_to(" CAT_SOCKET_ID_FMT ", %s, %zu, \"%.*s\", %d, " CAT_TIMEOUT_FMT ") = " CAT_LOG_UNFINISHED_STR,
+            socket->id, cat_log_str_quote(buffer, length, &buffer_quoted), length, (int) name_length, name, port, timeout);
+    });
+
+    cat_bool_t ret = cat_socket_write_to_impl(socket, &vector, 1, name, name_length, port, timeout);
+
+    CAT_LOG_DEBUG_VA(SOCKET, {
+        CAT_LOG_DEBUG_D(SOCKET, "send_to(" CAT_SOCKET_ID_FMT ", %s, %zu, \"%.*s\", %d, " CAT_TIMEOUT_FMT ") = " CAT_LOG_BOOL_RET_FMT,
+            socket->id, buffer_quoted, length, (int) name_length, name, port, timeout, CAT_LOG_BOOL_RET_C(ret));
+        cat_free(buffer_quoted);
+    });
+
+    return ret;
+}
+
+CAT_API ssize_t cat_socket_try_send_to(cat_socket_t *socket, const char *buffer, size_t length, const char *name, size_t name_length, int port)
+{
+    cat_socket_write_vector_t vector = cat_socket_write_vector_init(buffer, (cat_socket_vector_length_t) length);
+
+    ssize_t n = cat_socket_try_write_to_impl(socket, &vector, 1, name, name_length, port);
+
+    CAT_LOG_DEBUG_VA(SOCKET, {
+        char *buffer_quoted;
+        CAT_LOG_DEBUG_D(SOCKET, "try_send_to(" CAT_SOCKET_ID_FMT ", %s, %zu, \"%.*s\", %d) = " CAT_LOG_SSIZE_RET_FMT,
+            socket->id, cat_log_str_quote(buffer, length, &buffer_quoted), length, (int) name_length, name, port, CAT_LOG_SSIZE_RET_C(n));
+        cat_free(buffer_quoted);
+    });
+
+    return n;
+}
+
+/* batched datagram I/O */
+
+#ifdef CAT_OS_LINUX
+#define CAT_SOCKET_MMSG_BATCH_SIZE 64
+#endif
+
+static cat_always_inline cat_bool_t cat_socket_internal_support_inline_many(cat_socket_internal_t *socket_i)
+{
+    return !(socket_i->flags & CAT_SOCKET_INTERNAL_FLAG_NOT_SOCK);
+}
+
+/* it returns the count of received datagrams (0 means EAGAIN), or error code if none has been received */
+static ssize_t cat_socket_internal_try_recv_many(
+    cat_socket_internal_t *socket_i, cat_socket_fd_t fd,
+    cat_socket_datagram_t *datagrams, size_t count
+)
+{
+    size_t n = 0;
+#ifdef CAT_SOCKET_MMSG_BATCH_SIZE
+    struct mmsghdr messages[CAT_SOCKET_MMSG_BATCH_SIZE];
+    struct iovec iov[CAT_SOCKET_MMSG_BATCH_SIZE];
+
+    while (n < count) {
+        unsigned int batch_count = (unsigned int) CAT_MIN(count - n, CAT_SOCKET_MMSG_BATCH_SIZE);
+        unsigned int i;
+        int ret;
+        for (i = 0; i < batch_count; i++) {
+            cat_socket_datagram_t *datagram = &datagrams[n + i];
+            iov[i].iov_base = datagram->buffer;
+            iov[i].iov_len = datagram->size;
+            memset(&messages[i].msg_hdr, 0, sizeof(messages[i].msg_hdr));
+            messages[i].msg_hdr.msg_name = &datagram->address.address;
+            messages[i].msg_hdr.msg_namelen = sizeof(datagram->address.address);
+            messages[i].msg_hdr.msg_iov = &iov[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+        do {
+            ret = recvmmsg(fd, messages, batch_count, 0, NULL);
+        } while (unlikely(ret < 0 && errno == EINTR));
+        cat_socket_internal_stats_on_read(socket_i, ret < 0 ? cat_translate_sys_error(cat_sys_errno) : 0);
+        if (ret < 0) {
+            if (n == 0 && errno != EAGAIN) {
+                return cat_translate_sys_error(cat_sys_errno);
+            }
+            break;
+        }
+        for (i = 0; i < (unsigned int) ret; i++) {
+            cat_socket_datagram_t *datagram = &datagrams[n + i];
+            datagram->length = messages[i].msg_len;
+            datagram->truncated = (messages[i].msg_hdr.msg_flags & MSG_TRUNC) ? cat_true : cat_false;
+            CAT_SOCKET_INTERNAL_STATS_ADD(socket_i, bytes_read, datagram->length);
+            datagram->address.length = messages[i].msg_hdr.msg_namelen;
+            if (unlikely(datagram->address.length > sizeof(datagram->address.address))) {
+                datagram->address.length = 0;
+            }
+        }
+        n += ret;
+        if ((unsigned int) ret < batch_count) {
+            break;
+        }
+    }
+#elif defined(CAT_OS_UNIX_LIKE)
+    /* recvfrom() discards the rest of a large datagram silently, only recvmsg() tells us */
+    for (; n < count; n++) {
+        cat_socket_datagram_t *datagram = &datagrams[n];
+        struct msghdr message;
+        struct iovec iov;
+        ssize_t nread;
+        iov.iov_base = datagram->buffer;
+        iov.iov_len = datagram->size;
+        memset(&message, 0, sizeof(message));
+        message.msg_name = &datagram->address.address;
+        message.msg_namelen = sizeof(datagram->address.address);
+        message.msg_iov = &iov;
+        message.msg_iovlen = 1;
+        do {
+            nread = recvmsg(fd, &message, 0);
+        } while (unlikely(nread < 0 && errno == EINTR));
+        if (nread < 0) {
+            nread = cat_translate_sys_error(cat_sys_errno);
+        }
+        cat_socket_internal_stats_on_read(socket_i, nread);
+        if (nread < 0) {
+            if (n == 0 && nread != CAT_EAGAIN) {
+                return nread;
+            }
+            break;
+        }
+        datagram->length = nread;
+        datagram->truncated = (message.msg_flags & MSG_TRUNC) ? cat_true : cat_false;
+        datagram->address.length = message.msg_namelen;
+        if (unlikely(datagram->address.length > sizeof(datagram->address.address))) {
+            datagram->address.length = 0;
+        }
+    }
+#else
+    (void) fd;
+    for (; n < count; n++) {
+        cat_socket_datagram_t *datagram = &datagrams[n];
+        ssize_t nread;
+        datagram->address.length = sizeof(datagram->address.address);
+        nread = cat_socket_internal_try_recv_raw(
+            socket_i, datagram->buffer, datagram->size,
+            &datagram->address.address.common, &datagram->address.length
+        );
+        datagram->truncated = cat_false;
+        if (nread == CAT_EMSGSIZE) {
+            /* Windows fills the buffer and reports the truncation as an error */
+            nread = datagram->size;
+            datagram->truncated = cat_true;
+        }
+        if (nread < 0) {
+            if (n == 0 && nread != CAT_EAGAIN) {
+                return nread;
+            }
+            break;
+        }
+        datagram->length = nread;
+        if (unlikely(datagram->address.length > sizeof(datagram->address.address))) {
+            datagram->address.length = 0;
+        }
+    }
+#endif
+
+    return (ssize_t) n;
+}
+
+/* it returns the count of sent datagrams (0 means EAGAIN), or error code if none has been sent */
+static ssize_t cat_socket_internal_try_send_many(
+    cat_socket_internal_t *socket_i, cat_socket_fd_t fd,
+    const cat_socket_datagram_t *datagrams, size_t count
+)
+{
+    size_t n = 0;
+#ifdef CAT_SOCKET_MMSG_BATCH_SIZE
+    struct mmsghdr messages[CAT_SOCKET_MMSG_BATCH_SIZE];
+    struct iovec iov[CAT_SOCKET_MMSG_BATCH_SIZE];
+
+    /* keep the order with the queued sends */
+    if (((socket_i->type & CAT_SOCKET_TYPE_UDP) == CAT_SOCKET_TYPE_UDP) &&
+        uv_udp_get_send_queue_count(&socket_i->u.udp) != 0) {
+        return 0;
+    }
+    while (n < count) {
+        unsigned int batch_count = (unsigned int) CAT_MIN(count - n, CAT_SOCKET_MMSG_BATCH_SIZE);
+        unsigned int i;
+        int ret;
+        for (i = 0; i < batch_count; i++) {
+            const cat_socket_datagram_t *datagram = &datagrams[n + i];
+            iov[i].iov_base = datagram->buffer;
+            iov[i].iov_len = datagram->length;
+            memset(&messages[i].msg_hdr, 0, sizeof(messages[i].msg_hdr));
+            if (datagram->address.length > 0) {
+                messages[i].msg_hdr.msg_name = (void *) &datagram->address.address;
+                messages[i].msg_hdr.msg_namelen = datagram->address.length;
+            }
+            messages[i].msg_hdr.msg_iov = &iov[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+        do {
+            ret = sendmmsg(fd, messages, batch_count, 0);
+        } while (unlikely(ret < 0 && errno == EINTR));
+        cat_socket_internal_stats_on_write(socket_i, ret < 0 ? cat_translate_sys_error(cat_sys_errno) : 0);
+        if (ret < 0) {
+            if (n == 0 && errno != EAGAIN) {
+                return cat_translate_sys_error(cat_sys_errno);
+            }
+            break;
+        }
+        for (i = 0; i < (unsigned int) ret; i++) {
+            CAT_SOCKET_INTERNAL_STATS_ADD(socket_i, bytes_written, messages[i].msg_len);
+        }
+        n += ret;
+        if ((unsigned int) ret < batch_count) {
+            break;
+        }
+    }
+#else
+    (void) fd;
+    for (; n < count; n++) {
+        const cat_socket_datagram_t *datagram = &datagrams[n];
+        cat_socket_write_vector_t vector = cat_socket_write_vector_init(datagram->buffer, (cat_socket_vector_length_t) datagram->length);
+        ssize_t nwrite = cat_socket_internal_try_write_raw(
+            socket_i, &vector, 1,
+            datagram->address.length > 0 ? &datagram->address.address.common : NULL, datagram->address.length
+        );
+        if (nwrite < 0) {
+            if (n == 0 && nwrite != CAT_EAGAIN) {
+                return nwrite;
+            }
+            break;
+        }
+    }
+#endif
+
+    return (ssize_t) n;
+}
+
+static ssize_t cat_socket_recv_many_impl(cat_socket_t *socket, cat_socket_datagram_t *datagrams, size_t count, cat_timeout_t timeout)
+{
+    CAT_SOCKET_IO_CHECK(socket, socket_i, CAT_SOCKET_IO_FLAG_READ, return -1);
+    CAT_SOCKET_INTERNAL_WHICH_ONLY(socket_i, CAT_SOCKET_TYPE_FLAG_DGRAM, "Socket should be type of datagram", return -1);
+    cat_socket_datagram_t *datagram;
+    cat_socket_fd_t fd;
+    ssize_t n;
+
+    if (unlikely(count == 0)) {
+        cat_update_last_error(CAT_ENOBUFS, "Socket recv many failed");
+        return -1;
+    }
+
+    /* receive queued datagrams at once, in most cases, we do not need to wait at all,
+     * otherwise wait for the first one and then receive it together with the rest of them,
+     * so that every datagram goes through recvmmsg() and we know whether it is truncated */
+    while (1) {
+        cat_bool_t readable;
+        fd = cat_socket_internal_get_fd_fast(socket_i);
+        if (fd == CAT_SOCKET_INVALID_FD || !cat_socket_internal_support_inline_many(socket_i)) {
+            break;
+        }
+        n = cat_socket_internal_try_recv_many(socket_i, fd, datagrams, count);
+        if (n > 0) {
+            return n;
+        }
+        if (unlikely(n < 0)) {
+            cat_update_last_error_with_reason((cat_errno_t) n, "Socket recv many failed");
+            return -1;
+        }
+        CAT_TIME_WAIT_START() {
+            readable = cat_socket_internal_wait_readable(socket_i, timeout);
+        } CAT_TIME_WAIT_END(timeout);
+        if (unlikely(!readable)) {
+            cat_update_last_error_with_previous("Socket recv many failed");
+            return -1;
+        }
+    }
+
+    /* fd has not been created yet, it can only be received by the event loop,
+     * and libuv does not tell us whether it is truncated */
+    datagram = &datagrams[0];
+    datagram->truncated = cat_false;
+    datagram->address.length = sizeof(datagram->address.address);
+    n = cat_socket_internal_read(
+        socket_i, datagram->buffer, datagram->size,
+        &datagram->address.address.common, &datagram->address.length,
+        timeout, cat_true
+    );
+    if (unlikely(n < 0)) {
+        return -1;
+    }
+    datagram->length = n;
+    if (unlikely(datagram->address.length > sizeof(datagram->address.address))) {
+        datagram->address.length = 0;
+    }
+    if (count == 1) {
+        return 1;
+    }
+
+    /* and then receive the rest of them which have arrived together,
+     * error (if any) will be reported by the next call */
+    fd = cat_socket_internal_get_fd_fast(socket_i);
+    if (fd == CAT_SOCKET_INVALID_FD || !cat_socket_internal_support_inline_many(socket_i)) {
+        return 1;
+    }
+    n = cat_socket_internal_try_recv_many(socket_i, fd, datagrams + 1, count - 1);
+
+    return n > 0 ? n + 1 : 1;
 }
 
-CAT_API ssize_t cat_socket_try_recv_from(cat_socket_t *socket, char *buffer, size_t size, char *name, size_t *name_length, int *port)
+static size_t cat_socket_send_many_impl(cat_socket_t *socket, const cat_socket_datagram_t *datagrams, size_t count, cat_timeout_t timeout)
 {
-    ssize_t n = cat_socket_try_recv_from_impl(socket, buffer, size, name, name_length, port);
+    CAT_SOCKET_IO_CHECK(socket, socket_i, CAT_SOCKET_IO_FLAG_NONE, return 0);
+    CAT_SOCKET_INTERNAL_WHICH_ONLY(socket_i, CAT_SOCKET_TYPE_FLAG_DGRAM, "Socket should be type of datagram", return 0);
+    size_t n = 0;
 
-    CAT_LOG_DEBUG_VA(SOCKET, {
-        char *s;
-        CAT_LOG_DEBUG_D(SOCKET, "try_recvfrom(" CAT_SOCKET_ID_FMT ", %s, %zu, \"%.*s\", %d) = " CAT_LOG_SSIZE_RET_FMT,
-            socket->id, cat_log_str_quote(buffer, n < 0 ? 0 : n, &s), size, (int) (name_length != NULL ? *name_length : 0), name, port != NULL ? *port : 0, CAT_LOG_SSIZE_RET_C(n));
-        cat_free(s);
-    });
+    while (n < count) {
+        const cat_socket_datagram_t *datagram;
+        cat_socket_write_vector_t vector;
+        cat_socket_fd_t fd;
+
+        fd = cat_socket_internal_get_fd_fast(socket_i);
+        if (fd != CAT_SOCKET_INVALID_FD && cat_socket_internal_support_inline_many(socket_i)) {
+            ssize_t nsent = cat_socket_internal_try_send_many(socket_i, fd, datagrams + n, count - n);
+            if (unlikely(nsent < 0)) {
+                cat_update_last_error_with_reason((cat_errno_t) nsent, "Socket send many failed");
+                break;
+            }
+            if (nsent > 0) {
+                n += nsent;
+                continue;
+            }
+        }
+        /* it would block (or fd has not been created yet),
+         * send one and wait for it, then we can try again */
+        datagram = &datagrams[n];
+        vector = cat_socket_write_vector_init(datagram->buffer, (cat_socket_vector_length_t) datagram->length);
+        if (unlikely(!cat_socket_internal_write(
+            socket_i, &vector, 1,
+            datagram->address.length > 0 ? &datagram->address.address.common : NULL, datagram->address.length,
+            timeout
+        ))) {
+            break;
+        }
+        n++;
+    }
 
     return n;
 }
 
-CAT_API cat_bool_t cat_socket_send(cat_socket_t *socket, const char *buffer, size_t length)
+CAT_API ssize_t cat_socket_recv_many(cat_socket_t *socket, cat_socket_datagram_t *datagrams, size_t count)
 {
-    return cat_socket_send_ex(socket, buffer, length, cat_socket_get_write_timeout_fast(socket));
+    return cat_socket_recv_many_ex(socket, datagrams, count, cat_socket_get_read_timeout_fast(socket));
 }
 
-CAT_API cat_bool_t cat_socket_send_ex(cat_socket_t *socket, const char *buffer, size_t length, cat_timeout_t timeout)
+CAT_API ssize_t cat_socket_recv_many_ex(cat_socket_t *socket, cat_socket_datagram_t *datagrams, size_t count, cat_timeout_t timeout)
 {
-    cat_socket_write_vector_t vector = cat_socket_write_vector_init(buffer, (cat_socket_vector_length_t) length);
+    CAT_LOG_DEBUG(SOCKET, "recv_many(" CAT_SOCKET_ID_FMT ", %p, %zu, " CAT_TIMEOUT_FMT ") = " CAT_LOG_UNFINISHED_STR,
+        socket->id, datagrams, count, timeout);
 
-#ifdef CAT_ENABLE_DEBUG_LOG
-    char *buffer_quoted = NULL;
-#endif
-    CAT_LOG_DEBUG_VA(SOCKET, {
-        CAT_LOG_DEBUG_D(SOCKET, "send(" CAT_SOCKET_ID_FMT ", %s, %zu, " CAT_TIMEOUT_FMT ") = " CAT_LOG_UNFINISHED_STR,
-            socket->id, cat_log_str_quote(buffer, length, &buffer_quoted), length, timeout);
-    });
+    ssize_t n = cat_socket_recv_many_impl(socket, datagrams, count, timeout);
 
-    cat_bool_t ret = cat_socket_write_impl(socket, &vector, 1, NULL, 0, timeout);
+    CAT_LOG_DEBUG(SOCKET, "recv_many(" CAT_SOCKET_ID_FMT ", %p, %zu, " CAT_TIMEOUT_FMT ") = " CAT_LOG_SSIZE_RET_FMT,
+        socket->id, datagrams, count, timeout, CAT_LOG_SSIZE_RET_C(n));
 
-    CAT_LOG_DEBUG_VA(SOCKET, {
-        CAT_LOG_DEBUG_D(SOCKET, "send(" CAT_SOCKET_ID_FMT ", %s, %zu, " CAT_TIMEOUT_FMT ") = " CAT_LOG_BOOL_RET_FMT,
-            socket->id, buffer_quoted, length, timeout, CAT_LOG_BOOL_RET_C(ret));
-        cat_free(buffer_quoted);
-    });
+    return n;
+}
 
-    return ret;
+CAT_API size_t cat_socket_send_many(cat_socket_t *socket, const cat_socket_datagram_t *datagrams, size_t count)
+{
+    return cat_socket_send_many_ex(socket, datagrams, count, cat_socket_get_write_timeout_fast(socket));
 }
 
-CAT_API ssize_t cat_socket_try_send(cat_socket_t *socket, const char *buffer, size_t length)
+CAT_API size_t cat_socket_send_many_ex(cat_socket_t *socket, const cat_socket_datagram_t *datagrams, size_t count, cat_timeout_t timeout)
 {
-    cat_socket_write_vector_t vector = cat_socket_write_vector_init(buffer, (cat_socket_vector_length_t) length);
+    CAT_LOG_DEBUG(SOCKET, "send_many(" CAT_SOCKET_ID_FMT ", %p, %zu, " CAT_TIMEOUT_FMT ") = " CAT_LOG_UNFINISHED_STR,
+        socket->id, datagrams, count, timeout);
 
-    ssize_t n = cat_socket_try_write_impl(socket, &vector, 1, NULL, 0);
+    size_t n = cat_socket_send_many_impl(socket, datagrams, count, timeout);
 
-    CAT_LOG_DEBUG_VA(SOCKET, {
-        char *s;
-        CAT_LOG_DEBUG_D(SOCKET, "try_send(" CAT_SOCKET_ID_FMT ", %s) = " CAT_LOG_SSIZE_RET_FMT,
-            socket->id, cat_log_str_quote(buffer, length, &s), CAT_LOG_SSIZE_RET_C(n));
-        cat_free(s);
-    });
+    CAT_LOG_DEBUG(SOCKET, "send_many(" CAT_SOCKET_ID_FMT ", %p, %zu, " CAT_TIMEOUT_FMT ") = %zu",
+        socket->id, datagrams, count, timeout, n);
 
     return n;
 }
 
-CAT_API cat_bool_t cat_socket_sendto(cat_socket_t *socket, const char *buffer, size_t length, const cat_sockaddr_t *address, cat_socklen_t address_length)
-{
-    return cat_socket_sendto_ex(socket, buffer, length, address, address_length, cat_socket_get_write_timeout_fast(socket));
-}
+/* wait readable */
 
-CAT_API cat_bool_t cat_socket_sendto_ex(cat_socket_t *socket, const char *buffer, size_t length, const cat_sockaddr_t *address, cat_socklen_t address_length, cat_timeout_t timeout)
+static cat_bool_t cat_socket_internal_wait_readable(cat_socket_internal_t *socket_i, cat_timeout_t timeout)
 {
-    cat_socket_write_vector_t vector = cat_socket_write_vector_init(buffer, (cat_socket_vector_length_t) length);
+    CAT_SOCKET_INTERNAL_FD_GETTER(socket_i, fd, return cat_false);
+    char buffer;
+    ssize_t n;
+    cat_nsec_t start;
+    cat_ret_t ret;
 
-#ifdef CAT_ENABLE_DEBUG_LOG
-    char *buffer_quoted = NULL;
-    char name[CAT_SOCKADDR_MAX_PATH];
-    size_t name_length = sizeof(name);
-    int port = 0;
+#ifdef CAT_SSL
+    if (socket_i->ssl != NULL && cat_ssl_has_pending_data(socket_i->ssl)) {
+        return cat_true;
+    }
 #endif
-    CAT_LOG_DEBUG_VA(SOCKET, {
-        if (cat_sockaddr_to_name_silent(address, address_length, name, &name_length, &port) != 0) {
-            break;
-        }
-        CAT_LOG_DEBUG_D(SOCKET, "sendto(" CAT_SOCKET_ID_FMT ", %s, %zu, \"%.*s\", %d, " CAT_TIMEOUT_FMT ") = " CAT_LOG_UNFINISHED_STR,
-            socket->id, cat_log_str_quote(buffer, length, &buffer_quoted), length, (int) name_length, name, port, timeout);
-    });
-
-    cat_bool_t ret = cat_socket_write_impl(socket, &vector, 1, address, address_length, timeout);
-
-    CAT_LOG_DEBUG_VA(SOCKET, {
-        CAT_LOG_DEBUG_D(SOCKET, "sendto(" CAT_SOCKET_ID_FMT ", %s, %zu, \"%.*s\", %d, " CAT_TIMEOUT_FMT ") = " CAT_LOG_BOOL_RET_FMT,
-            socket->id, buffer_quoted, length, (int) name_length, name, port, timeout, CAT_LOG_BOOL_RET_C(ret));
-        cat_free(buffer_quoted);
-    });
-
-    return ret;
-}
 
-CAT_API ssize_t cat_socket_try_sendto(cat_socket_t *socket, const char *buffer, size_t length, const cat_sockaddr_t *address, cat_socklen_t address_length)
-{
-    cat_socket_write_vector_t vector = cat_socket_write_vector_init(buffer, (cat_socket_vector_length_t) length);
+    /* try to peek first, data (or EOF) may be already there */
+#ifdef CAT_OS_UNIX_LIKE
+    do {
+#endif
+        n = recv(fd, &buffer, 1, MSG_PEEK);
+#ifdef CAT_OS_UNIX_LIKE
+    } while (unlikely(n < 0 && errno == EINTR));
+#endif
+    /* peeked data is not counted in bytes_read */
+    cat_socket_internal_stats_on_read(socket_i, n >= 0 ? 0 : cat_translate_sys_error(cat_sys_errno));
+    if (n >= 0) {
+        return cat_true;
+    } else {
+        cat_errno_t error = cat_translate_sys_error(cat_sys_errno);
+        if (error == CAT_EAGAIN) {
+            if (timeout == 0) {
+                /* do not go through the event loop if we do not want to wait */
+                cat_update_last_error(CAT_ETIMEDOUT, "Socket wait readable timedout");
+                return cat_false;
+            }
+        } else if (error != CAT_ENOTSOCK) {
+            /* let the following read report the real error */
+            return cat_true;
+        }
+    }
 
-    ssize_t n = cat_socket_try_write_impl(socket, &vector, 1, address, address_length);
+    start = cat_time_nsec();
+    socket_i->context.io.read.coroutine = CAT_COROUTINE_G(current);
+    socket_i->io_flags |= CAT_SOCKET_IO_FLAG_READ;
+    ret = cat_poll_one(fd, POLLIN, NULL, timeout);
+    socket_i->io_flags ^= CAT_SOCKET_IO_FLAG_READ;
+    socket_i->context.io.read.coroutine = NULL;
+    cat_socket_internal_stats_on_read_wait_done(socket_i, start);
 
-    CAT_LOG_DEBUG_VA(SOCKET, {
-        char *buffer_quoted;
-        char name[CAT_SOCKADDR_MAX_PATH];
-        size_t name_length = sizeof(name);
-        int port;
-        if (cat_sockaddr_to_name_silent(address, address_length, name, &name_length, &port) != 0) {
-            break;
+    if (unlikely(ret != CAT_RET_OK)) {
+        if (ret == CAT_RET_NONE) {
+            cat_update_last_error(CAT_ETIMEDOUT, "Socket wait readable timedout");
+        } else {
+            cat_update_last_error_with_previous("Socket wait readable failed");
         }
-        CAT_LOG_DEBUG_D(SOCKET, "try_sendto(" CAT_SOCKET_ID_FMT ", %s, %zu, \"%.*s\", %d) = " CAT_LOG_SSIZE_RET_FMT,
-            socket->id, cat_log_str_quote(buffer, length, &buffer_quoted), length, (int) name_length, name, port, CAT_LOG_SSIZE_RET_C(n));
-        cat_free(buffer_quoted);
-    });
+        return cat_false;
+    }
 
-    return n;
+    return cat_true;
 }
 
-CAT_API cat_bool_t cat_socket_send_to(cat_socket_t *socket, const char *buffer, size_t length, const char *name, size_t name_length, int port)
+CAT_API cat_bool_t cat_socket_wait_readable(cat_socket_t *socket)
 {
-    return cat_socket_send_to_ex(socket, buffer, length, name, name_length, port, cat_socket_get_write_timeout_fast(socket));
+    return cat_socket_wait_readable_ex(socket, cat_socket_get_read_timeout_fast(socket));
 }
 
-CAT_API cat_bool_t cat_socket_send_to_ex(cat_socket_t *socket, const char *buffer, size_t length, const char *name, size_t name_length, int port, cat_timeout_t timeout)
+CAT_API cat_bool_t cat_socket_wait_readable_ex(cat_socket_t *socket, cat_timeout_t timeout)
 {
-    cat_socket_write_vector_t vector = cat_socket_write_vector_init(buffer, (cat_socket_vector_length_t) length);
+    CAT_SOCKET_IO_CHECK(socket, socket_i, CAT_SOCKET_IO_FLAG_READ, return cat_false);
+    cat_bool_t ret;
 
-#ifdef CAT_ENABLE_DEBUG_LOG
-    char *buffer_quoted = NULL;
-#endif
-    CAT_LOG_DEBUG_VA(SOCKET, {
-        CAT_LOG_DEBUG_D(SOCKET, "send_to(" CAT_SOCKET_ID_FMT ", %s, %zu, \"%.*s\", %d, " CAT_TIMEOUT_FMT ") = " CAT_LOG_UNFINISHED_STR,
-            socket->id, cat_log_str_quote(buffer, length, &buffer_quoted), length, (int) name_length, name, port, timeout);
-    });
+    CAT_LOG_DEBUG(SOCKET, "wait_readable(" CAT_SOCKET_ID_FMT ", " CAT_TIMEOUT_FMT ") = " CAT_LOG_UNFINISHED_STR,
+        socket->id, timeout);
 
-    cat_bool_t ret = cat_socket_write_to_impl(socket, &vector, 1, name, name_length, port, timeout);
+    ret = cat_socket_internal_wait_readable(socket_i, timeout);
 
-    CAT_LOG_DEBUG_VA(SOCKET, {
-        CAT_LOG_DEBUG_D(SOCKET, "send_to(" CAT_SOCKET_ID_FMT ", %s, %zu, \"%.*s\", %d, " CAT_TIMEOUT_FMT ") = " CAT_LOG_BOOL_RET_FMT,
-            socket->id, buffer_quoted, length, (int) name_length, name, port, timeout, CAT_LOG_BOOL_RET_C(ret));
-        cat_free(buffer_quoted);
-    });
+    CAT_LOG_DEBUG(SOCKET, "wait_readable(" CAT_SOCKET_ID_FMT ", " CAT_TIMEOUT_FMT ") = " CAT_LOG_BOOL_RET_FMT,
+        socket->id, timeout, CAT_LOG_BOOL_RET_C(ret));
 
     return ret;
 }
 
-CAT_API ssize_t cat_socket_try_send_to(cat_socket_t *socket, const char *buffer, size_t length, const char *name, size_t name_length, int port)
-{
-    cat_socket_write_vector_t vector = cat_socket_write_vector_init(buffer, (cat_socket_vector_length_t) length);
-
-    ssize_t n = cat_socket_try_write_to_impl(socket, &vector, 1, name, name_length, port);
-
-    CAT_LOG_DEBUG_VA(SOCKET, {
-        char *buffer_quoted;
-        CAT_LOG_DEBUG_D(SOCKET, "try_send_to(" CAT_SOCKET_ID_FMT ", %s, %zu, \"%.*s\", %d) = " CAT_LOG_SSIZE_RET_FMT,
-            socket->id, cat_log_str_quote(buffer, length, &buffer_quoted), length, (int) name_length, name, port, CAT_LOG_SSIZE_RET_C(n));
-        cat_free(buffer_quoted);
-    });
-
-    return n;
-}
-
 static ssize_t cat_socket_internal_peekfrom(
     const cat_socket_internal_t *socket_i,
     char *buffer, size_t size,
@@ -4357,6 +5667,12 @@ static cat_bool_t cat_socket_send_handle_impl(cat_socket_t *socket, cat_socket_t
         ihandle->options
     };
     cat_socket_write_vector_t vector = cat_socket_write_vector_init((char *) &handle_info, (cat_socket_vector_length_t) sizeof(handle_info));
+    /* the handle can not be coalesced, buffered data must be written before it */
+    if (unlikely(socket_i->write_coalescing != NULL) &&
+        unlikely(!cat_socket_internal_write_with_buffered(socket_i, NULL, 0, timeout))) {
+        cat_update_last_error_with_previous("Socket send handle failed when flush buffered data");
+        return cat_false;
+    }
     if (!cat_socket_internal_write_raw(socket_i, &vector, 1, NULL, 0, handle, timeout)) {
         cat_socket_internal_unrecoverable_io_error(socket_i);
         return cat_false;
@@ -4608,6 +5924,12 @@ static cat_always_inline ssize_t cat_socket_send_file_impl(cat_socket_t *socket,
     cat_file_t file;
     ssize_t written;
 
+    if (unlikely(socket_i->write_coalescing != NULL) &&
+        unlikely(!cat_socket_internal_write_with_buffered(socket_i, NULL, 0, timeout))) {
+        cat_update_last_error_with_previous("Socket sendfile failed when flush buffered data");
+        return -1;
+    }
+
     file = cat_fs_open(filename, CAT_FS_OPEN_FLAG_RDONLY);
     if (unlikely(file < 0)) {
         cat_update_last_error_with_previous("Socket sendfile failed when open file");
@@ -4616,7 +5938,7 @@ static cat_always_inline ssize_t cat_socket_send_file_impl(cat_socket_t *socket,
 
 #ifdef CAT_SOCKET_NATIVE_SENDFILE
 # ifdef CAT_SSL
-    if (!socket_i->ssl)
+    if (!cat_socket_internal_write_needs_encryption(socket_i))
 # endif
     {
         written = cat_socket_internal_native_sendfile(socket_i, file, offset, length, timeout);
@@ -4674,6 +5996,10 @@ static void cat_socket_close_callback(uv_handle_t *handle)
     }
 #endif
 
+    if (socket_i->write_coalescing != NULL) {
+        cat_buffer_close(&socket_i->write_coalescing->buffer);
+        cat_free(socket_i->write_coalescing);
+    }
     if (socket_i->cache.write_request != NULL) {
         cat_free(socket_i->cache.write_request);
     }
@@ -4744,9 +6070,17 @@ static void cat_socket_internal_close_impl(cat_socket_internal_t *socket_i, cat_
     if (socket_i->ssl != NULL &&
         cat_ssl_get_shutdown(socket_i->ssl) != (CAT_SSL_SENT_SHUTDOWN | CAT_SSL_RECEIVED_SHUTDOWN)) {
         cat_ssl_set_quiet_shutdown(socket_i->ssl, cat_true);
+        /* it is closed normally, OpenSSL would invalidate the session if shutdown was not sent */
+        if (!unrecoverable_error && cat_ssl_is_established(socket_i->ssl)) {
+            cat_ssl_set_shutdown(socket_i->ssl, CAT_SSL_SENT_SHUTDOWN | CAT_SSL_RECEIVED_SHUTDOWN);
+        }
     }
 #endif
 
+    if (socket_i->write_coalescing != NULL) {
+        cat_socket_internal_write_coalescing_close(socket_i, unrecoverable_error);
+    }
+
     /* cancel all IO operations */
     if (socket_i->io_flags == CAT_SOCKET_IO_FLAG_BIND) {
         cat_socket_io_cancel(socket_i->context.bind.coroutine, "bind");
@@ -4911,6 +6245,12 @@ CAT_API cat_bool_t cat_socket_has_crypto(const cat_socket_t *socket)
     return socket_i != NULL && socket_i->ssl != NULL;
 }
 
+CAT_API cat_bool_t cat_socket_is_ktls_send_enabled(const cat_socket_t *socket)
+{
+    cat_socket_internal_t *socket_i = socket->internal;
+    return socket_i != NULL && socket_i->ssl != NULL && cat_ssl_is_ktls_send_enabled(socket_i->ssl);
+}
+
 CAT_API cat_bool_t cat_socket_is_encrypted(const cat_socket_t *socket)
 {
     cat_socket_internal_t *socket_i = socket->internal;
@@ -5323,6 +6663,148 @@ CAT_API cat_bool_t cat_socket_set_udp_broadcast(cat_socket_t *socket, cat_bool_t
     return cat_true;
 }
 
+/* write coalescing */
+
+CAT_API cat_bool_t cat_socket_enable_write_coalescing(cat_socket_t *socket, size_t threshold)
+{
+    CAT_SOCKET_INTERNAL_GETTER(socket, socket_i, return cat_false);
+    CAT_SOCKET_INTERNAL_WHICH_ONLY(socket_i, CAT_SOCKET_TYPE_FLAG_STREAM, "Socket should be type of stream", return cat_false);
+    cat_socket_write_coalescing_t *coalescing = socket_i->write_coalescing;
+
+    if (threshold == 0) {
+        threshold = CAT_SOCKET_WRITE_COALESCING_DEFAULT_THRESHOLD;
+    }
+    if (coalescing == NULL) {
+        coalescing = (cat_socket_write_coalescing_t *) cat_malloc(sizeof(*coalescing));
+#if CAT_ALLOC_HANDLE_ERRORS
+        if (unlikely(coalescing == NULL)) {
+            cat_update_last_error_of_syscall("Malloc for socket write coalescing failed");
+            return cat_false;
+        }
+#endif
+        cat_buffer_init(&coalescing->buffer);
+        coalescing->flush_task = NULL;
+#ifdef CAT_SSL
+        coalescing->retry_task = NULL;
+#endif
+        coalescing->error = 0;
+        socket_i->write_coalescing = coalescing;
+    }
+    coalescing->threshold = threshold;
+
+    return cat_true;
+}
+
+CAT_API cat_bool_t cat_socket_disable_write_coalescing(cat_socket_t *socket)
+{
+    CAT_SOCKET_INTERNAL_GETTER(socket, socket_i, return cat_false);
+    cat_socket_write_coalescing_t *coalescing;
+
+    while (1) {
+        coalescing = socket_i->write_coalescing;
+        if (coalescing == NULL) {
+            return cat_true;
+        }
+        if (coalescing->buffer.length == 0) {
+            break;
+        }
+        /* others may buffer new data while we are flushing */
+        if (unlikely(!cat_socket_flush(socket))) {
+            return cat_false;
+        }
+    }
+    socket_i->write_coalescing = NULL;
+    cat_socket_write_coalescing_cancel_tasks(coalescing);
+    cat_buffer_close(&coalescing->buffer);
+    cat_free(coalescing);
+
+    return cat_true;
+}
+
+CAT_API cat_bool_t cat_socket_is_write_coalescing_enabled(const cat_socket_t *socket)
+{
+    CAT_SOCKET_INTERNAL_GETTER_SILENT(socket, socket_i, return cat_false);
+
+    return socket_i->write_coalescing != NULL;
+}
+
+CAT_API size_t cat_socket_get_write_coalescing_threshold(const cat_socket_t *socket)
+{
+    CAT_SOCKET_INTERNAL_GETTER_SILENT(socket, socket_i, return 0);
+
+    return socket_i->write_coalescing != NULL ? socket_i->write_coalescing->threshold : 0;
+}
+
+CAT_API size_t cat_socket_get_write_coalescing_buffered_size(const cat_socket_t *socket)
+{
+    CAT_SOCKET_INTERNAL_GETTER_SILENT(socket, socket_i, return 0);
+
+    return socket_i->write_coalescing != NULL ? socket_i->write_coalescing->buffer.length : 0;
+}
+
+/* stats */
+
+CAT_API cat_bool_t cat_socket_get_stats(const cat_socket_t *socket, cat_socket_stats_t *stats)
+{
+    CAT_SOCKET_INTERNAL_GETTER(socket, socket_i, return cat_false);
+
+    *stats = socket_i->stats;
+
+    return cat_true;
+}
+
+CAT_API void cat_socket_get_global_stats(cat_socket_stats_t *stats)
+{
+    *stats = CAT_SOCKET_G(stats);
+}
+
+CAT_API void cat_socket_reset_global_stats(void)
+{
+    memset(&CAT_SOCKET_G(stats), 0, sizeof(CAT_SOCKET_G(stats)));
+}
+
+CAT_API cat_nsec_t cat_socket_stats_get_latency_bucket_bound(size_t index)
+{
+    cat_nsec_t bound = CAT_SOCKET_STATS_LATENCY_BUCKET_MIN;
+
+    if (index >= CAT_SOCKET_STATS_LATENCY_BUCKET_COUNT - 1) {
+        return 0;
+    }
+    while (index-- > 0) {
+        bound *= 10;
+    }
+
+    return bound;
+}
+
+static cat_always_inline cat_bool_t cat_socket_flush_impl(cat_socket_t *socket, cat_timeout_t timeout)
+{
+    CAT_SOCKET_INTERNAL_GETTER(socket, socket_i, return cat_false);
+    cat_socket_write_coalescing_t *coalescing = socket_i->write_coalescing;
+
+    if (coalescing == NULL || (coalescing->buffer.length == 0 && coalescing->error == 0)) {
+        return cat_true;
+    }
+    CAT_SOCKET_INTERNAL_IO_ESTABLISHED_CHECK_FOR_STREAM(socket_i, return cat_false);
+
+    return cat_socket_internal_write_with_buffered(socket_i, NULL, 0, timeout);
+}
+
+CAT_API cat_bool_t cat_socket_flush(cat_socket_t *socket)
+{
+    return cat_socket_flush_ex(socket, cat_socket_get_write_timeout_fast(socket));
+}
+
+CAT_API cat_bool_t cat_socket_flush_ex(cat_socket_t *socket, cat_timeout_t timeout)
+{
+    cat_bool_t ret = cat_socket_flush_impl(socket, timeout);
+
+    CAT_LOG_DEBUG(SOCKET, "flush(" CAT_SOCKET_ID_FMT ", " CAT_TIMEOUT_FMT ") = " CAT_LOG_BOOL_RET_FMT,
+        socket->id, timeout, CAT_LOG_BOOL_RET_C(ret));
+
+    return ret;
+}
+
 /* helper */
 
 CAT_API int cat_socket_get_local_free_port(void)
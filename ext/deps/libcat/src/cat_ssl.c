@@ -19,6 +19,19 @@
 #include "cat_ssl.h"
 
 #ifdef CAT_SSL
+
+#include "cat_event.h"
+#include "cat_time.h"
+
+#if CAT_SSL_VERSION_NUMBER >= 0x30000000L
+#include <openssl/core_names.h>
+#endif
+
+#ifdef CAT_SSL_HAVE_KTLS
+#include <linux/tls.h>
+#include <netinet/tcp.h>
+#include <openssl/kdf.h>
+#endif
 /*
 This diagram shows how the read and write memory BIO's (rbio & wbio) are
 associated with the socket read and write respectively.  On the inbound flow
@@ -48,6 +61,10 @@ static void cat_ssl_handshake_log(cat_ssl_t *ssl);
 #define cat_ssl_handshake_log(ssl)
 #endif
 
+CAT_API CAT_GLOBALS_DECLARE(cat_ssl);
+
+CAT_GLOBALS_CTOR_DECLARE_SZ(cat_ssl)
+
 static int cat_ssl_index;
 static int cat_ssl_context_index;
 
@@ -113,9 +130,423 @@ CAT_API cat_bool_t cat_ssl_module_init(void)
         CAT_MODULE_ERROR(SSL, "SSL_CTX_get_ex_new_index() failed");
     }
 
+    CAT_GLOBALS_REGISTER(cat_ssl);
+
+    return cat_true;
+}
+
+CAT_API cat_bool_t cat_ssl_module_shutdown(void)
+{
+    CAT_GLOBALS_UNREGISTER(cat_ssl);
+
+    return cat_true;
+}
+
+CAT_API cat_bool_t cat_ssl_runtime_init(void)
+{
+    RB_INIT(&CAT_SSL_G(session_cache.tree));
+    cat_queue_init(&CAT_SSL_G(session_cache.lru));
+    CAT_SSL_G(session_cache.count) = 0;
+    CAT_SSL_G(session_cache.max_size) = CAT_SSL_SESSION_CACHE_DEFAULT_MAX_SIZE;
+    CAT_SSL_G(session_cache.ttl) = CAT_SSL_SESSION_CACHE_DEFAULT_TTL;
+    CAT_SSL_G(session_cache.hits) = 0;
+    CAT_SSL_G(session_cache.misses) = 0;
+    CAT_SSL_G(session_cache.shutdown_task_registered) = cat_false;
+    CAT_SSL_G(ticket_keys.count) = 0;
+    CAT_SSL_G(ticket_keys.user_defined) = cat_false;
+    CAT_SSL_G(ticket_keys.lifetime) = CAT_SSL_TICKET_KEY_DEFAULT_LIFETIME;
+    CAT_SSL_G(server_handshakes) = 0;
+    CAT_SSL_G(server_resumptions) = 0;
+    CAT_SSL_G(client_handshakes) = 0;
+    CAT_SSL_G(client_resumptions) = 0;
+
+    return cat_true;
+}
+
+/* session cache
+ * contexts are created for each connection, so the internal session cache and ticket keys of
+ * OpenSSL are useless, we maintain them here and share them between all connections */
+
+#define CAT_SSL_SESSION_CACHE_G(x) CAT_SSL_G(session_cache.x)
+
+static int cat_ssl_session_cache_entry_compare(cat_ssl_session_cache_entry_t *entry1, cat_ssl_session_cache_entry_t *entry2)
+{
+    if (entry1->type != entry2->type) {
+        return entry1->type < entry2->type ? -1 : 1;
+    }
+    if (entry1->key_length != entry2->key_length) {
+        return entry1->key_length < entry2->key_length ? -1 : 1;
+    }
+    return memcmp(entry1->key, entry2->key, entry1->key_length);
+}
+
+RB_GENERATE_STATIC(cat_ssl_session_cache_tree_s,
+                   cat_ssl_session_cache_entry_s, tree_entry,
+                   cat_ssl_session_cache_entry_compare);
+
+static cat_always_inline void cat_ssl_session_cache_entry_init_key(cat_ssl_session_cache_entry_t *entry, cat_ssl_session_cache_entry_type_t type, const unsigned char *key, size_t key_length)
+{
+    entry->type = type;
+    entry->key = key;
+    entry->key_length = key_length;
+}
+
+static void cat_ssl_session_cache_entry_free(cat_ssl_session_cache_entry_t *entry)
+{
+    RB_REMOVE(cat_ssl_session_cache_tree_s, &CAT_SSL_SESSION_CACHE_G(tree), entry);
+    cat_queue_remove(&entry->node);
+    CAT_SSL_SESSION_CACHE_G(count)--;
+    SSL_SESSION_free(entry->session);
+    cat_free(entry);
+}
+
+static void cat_ssl_session_cache_evict(size_t max_size)
+{
+    cat_ssl_session_cache_entry_t *entry;
+
+    while (CAT_SSL_SESSION_CACHE_G(count) > max_size) {
+        entry = cat_queue_front_data(&CAT_SSL_SESSION_CACHE_G(lru), cat_ssl_session_cache_entry_t, node);
+        cat_ssl_session_cache_entry_free(entry);
+    }
+}
+
+static void cat_ssl_session_cache_shutdown(cat_data_t *data)
+{
+    (void) data;
+
+    cat_ssl_session_cache_evict(0);
+    CAT_SSL_SESSION_CACHE_G(shutdown_task_registered) = cat_false;
+}
+
+CAT_API void cat_ssl_session_cache_set_max_size(size_t max_size)
+{
+    CAT_SSL_SESSION_CACHE_G(max_size) = max_size;
+    cat_ssl_session_cache_evict(max_size);
+}
+
+CAT_API void cat_ssl_session_cache_set_ttl(cat_msec_t ttl)
+{
+    CAT_SSL_SESSION_CACHE_G(ttl) = ttl;
+}
+
+CAT_API void cat_ssl_session_cache_get_info(cat_ssl_session_cache_info_t *info)
+{
+    info->count = CAT_SSL_SESSION_CACHE_G(count);
+    info->max_size = CAT_SSL_SESSION_CACHE_G(max_size);
+    info->ttl = CAT_SSL_SESSION_CACHE_G(ttl);
+    info->hits = CAT_SSL_SESSION_CACHE_G(hits);
+    info->misses = CAT_SSL_SESSION_CACHE_G(misses);
+    info->server_handshakes = CAT_SSL_G(server_handshakes);
+    info->server_resumptions = CAT_SSL_G(server_resumptions);
+    info->client_handshakes = CAT_SSL_G(client_handshakes);
+    info->client_resumptions = CAT_SSL_G(client_resumptions);
+    info->ticket_key_count = CAT_SSL_G(ticket_keys.count);
+    info->ticket_key_lifetime = CAT_SSL_G(ticket_keys.lifetime);
+}
+
+CAT_API void cat_ssl_session_cache_clear(void)
+{
+    cat_ssl_session_cache_evict(0);
+}
+
+static cat_ssl_session_cache_entry_t *cat_ssl_session_cache_find(cat_ssl_session_cache_entry_type_t type, const unsigned char *key, size_t key_length)
+{
+    cat_ssl_session_cache_entry_t lookup, *entry;
+
+    cat_ssl_session_cache_entry_init_key(&lookup, type, key, key_length);
+    entry = RB_FIND(cat_ssl_session_cache_tree_s, &CAT_SSL_SESSION_CACHE_G(tree), &lookup);
+    if (entry == NULL) {
+        CAT_SSL_SESSION_CACHE_G(misses)++;
+        return NULL;
+    }
+    if (entry->expires <= cat_time_msec_cached()
+#if CAT_SSL_VERSION_NUMBER >= 0x10101000L && !defined(LIBRESSL_VERSION_NUMBER)
+        || !SSL_SESSION_is_resumable(entry->session)
+#endif
+    ) {
+        cat_ssl_session_cache_entry_free(entry);
+        CAT_SSL_SESSION_CACHE_G(misses)++;
+        return NULL;
+    }
+    CAT_SSL_SESSION_CACHE_G(hits)++;
+    /* move it to the back of LRU queue */
+    cat_queue_remove(&entry->node);
+    cat_queue_push_back(&CAT_SSL_SESSION_CACHE_G(lru), &entry->node);
+
+    return entry;
+}
+
+/* return true if the session is owned by the cache */
+static cat_bool_t cat_ssl_session_cache_store(cat_ssl_session_cache_entry_type_t type, const unsigned char *key, size_t key_length, SSL_SESSION *session)
+{
+    cat_ssl_session_cache_entry_t lookup, *entry;
+
+    if (CAT_SSL_SESSION_CACHE_G(max_size) == 0 || key_length == 0) {
+        return cat_false;
+    }
+    if (unlikely(!CAT_SSL_SESSION_CACHE_G(shutdown_task_registered))) {
+        if (unlikely(cat_event_register_runtime_shutdown_task(cat_ssl_session_cache_shutdown, NULL) == NULL)) {
+            CAT_LOG_DEBUG(SSL, "SSL session cache register shutdown task failed, reason: %s", cat_get_last_error_message());
+            return cat_false;
+        }
+        CAT_SSL_SESSION_CACHE_G(shutdown_task_registered) = cat_true;
+    }
+    /* the newer one always wins (e.g. TLSv1.3 tickets should not be reused) */
+    cat_ssl_session_cache_entry_init_key(&lookup, type, key, key_length);
+    entry = RB_FIND(cat_ssl_session_cache_tree_s, &CAT_SSL_SESSION_CACHE_G(tree), &lookup);
+    if (entry != NULL) {
+        cat_ssl_session_cache_entry_free(entry);
+    }
+    entry = (cat_ssl_session_cache_entry_t *) cat_malloc(sizeof(*entry) + key_length);
+#if CAT_ALLOC_HANDLE_ERRORS
+    if (unlikely(entry == NULL)) {
+        CAT_LOG_DEBUG(SSL, "Malloc for SSL session cache entry failed");
+        return cat_false;
+    }
+#endif
+    /* key is stored after the entry */
+    cat_ssl_session_cache_entry_init_key(entry, type, memcpy(entry + 1, key, key_length), key_length);
+    entry->session = session;
+    entry->expires = cat_time_msec_cached() + CAT_SSL_SESSION_CACHE_G(ttl);
+    RB_INSERT(cat_ssl_session_cache_tree_s, &CAT_SSL_SESSION_CACHE_G(tree), entry);
+    cat_queue_push_back(&CAT_SSL_SESSION_CACHE_G(lru), &entry->node);
+    CAT_SSL_SESSION_CACHE_G(count)++;
+    cat_ssl_session_cache_evict(CAT_SSL_SESSION_CACHE_G(max_size));
+
     return cat_true;
 }
 
+static int cat_ssl_new_session_callback(cat_ssl_connection_t *connection, SSL_SESSION *session)
+{
+    cat_ssl_t *ssl = cat_ssl_get_from_connection(connection);
+    cat_bool_t owned;
+
+    if (SSL_is_server(connection)) {
+        const unsigned char *id;
+        unsigned int id_length;
+        id = SSL_SESSION_get_id(session, &id_length);
+        owned = cat_ssl_session_cache_store(CAT_SSL_SESSION_CACHE_ENTRY_SERVER, id, id_length, session);
+    } else {
+        owned = cat_ssl_session_cache_store(
+            CAT_SSL_SESSION_CACHE_ENTRY_CLIENT,
+            (const unsigned char *) ssl->session_cache_key.value, ssl->session_cache_key.length,
+            session
+        );
+    }
+    CAT_LOG_DEBUG(SSL, "SSL new session %p of %p is %s", session, ssl, owned ? "cached" : "dropped");
+
+    /* return 1 means that we have taken the reference */
+    return owned ? 1 : 0;
+}
+
+#if CAT_SSL_VERSION_NUMBER >= 0x10100003L
+static SSL_SESSION *cat_ssl_get_session_callback(cat_ssl_connection_t *connection, const unsigned char *id, int id_length, int *copy)
+#else
+static SSL_SESSION *cat_ssl_get_session_callback(cat_ssl_connection_t *connection, unsigned char *id, int id_length, int *copy)
+#endif
+{
+    cat_ssl_session_cache_entry_t *entry;
+    (void) connection;
+
+    entry = cat_ssl_session_cache_find(CAT_SSL_SESSION_CACHE_ENTRY_SERVER, id, id_length);
+    if (entry == NULL) {
+        return NULL;
+    }
+    /* let OpenSSL increase the reference count */
+    *copy = 1;
+
+    return entry->session;
+}
+
+static void cat_ssl_remove_session_callback(cat_ssl_ctx_t *ctx, SSL_SESSION *session)
+{
+    cat_ssl_session_cache_entry_t lookup, *entry;
+    const unsigned char *id;
+    unsigned int id_length;
+    (void) ctx;
+
+    id = SSL_SESSION_get_id(session, &id_length);
+    cat_ssl_session_cache_entry_init_key(&lookup, CAT_SSL_SESSION_CACHE_ENTRY_SERVER, id, id_length);
+    entry = RB_FIND(cat_ssl_session_cache_tree_s, &CAT_SSL_SESSION_CACHE_G(tree), &lookup);
+    if (entry != NULL && entry->session == session) {
+        cat_ssl_session_cache_entry_free(entry);
+    }
+}
+
+CAT_API cat_bool_t cat_ssl_set_session_cache_key(cat_ssl_t *ssl, const char *key, size_t key_length)
+{
+    cat_ssl_session_cache_entry_t *entry;
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int digest_length;
+
+    /* keys may contain the whole configuration, so we only keep their digests */
+    if (unlikely(EVP_Digest(key, key_length, digest, &digest_length, EVP_sha256(), NULL) != 1)) {
+        cat_ssl_update_last_error(CAT_ESSL, "SSL session cache key digest failed");
+        return cat_false;
+    }
+    cat_string_close(&ssl->session_cache_key);
+    if (unlikely(!cat_string_create(&ssl->session_cache_key, (const char *) digest, digest_length))) {
+        cat_update_last_error_of_syscall("Malloc for SSL session cache key failed");
+        return cat_false;
+    }
+    entry = cat_ssl_session_cache_find(CAT_SSL_SESSION_CACHE_ENTRY_CLIENT, digest, digest_length);
+    if (entry == NULL) {
+        return cat_true;
+    }
+    CAT_LOG_DEBUG(SSL, "SSL_set_session(%p, %p)", ssl, entry->session);
+    if (unlikely(SSL_set_session(ssl->connection, entry->session) != 1)) {
+        /* just do a full handshake */
+        ERR_clear_error();
+        cat_ssl_session_cache_entry_free(entry);
+    }
+
+    return cat_true;
+}
+
+CAT_API cat_bool_t cat_ssl_is_session_reused(const cat_ssl_t *ssl)
+{
+    return SSL_session_reused(ssl->connection);
+}
+
+/* ticket keys */
+
+#define CAT_SSL_TICKET_KEYS_G(x) CAT_SSL_G(ticket_keys.x)
+
+CAT_API cat_bool_t cat_ssl_set_ticket_keys(const char *keys, size_t count)
+{
+    cat_ssl_ticket_key_t *key;
+    cat_msec_t now = cat_time_msec_cached();
+    size_t n;
+
+    if (unlikely(count > CAT_SSL_TICKET_KEYS_MAX)) {
+        cat_update_last_error(CAT_EINVAL, "SSL ticket keys count must be less than or equal to %d", CAT_SSL_TICKET_KEYS_MAX);
+        return cat_false;
+    }
+    for (n = 0; n < count; n++) {
+        key = &CAT_SSL_TICKET_KEYS_G(keys)[n];
+        memcpy(key->name, keys, sizeof(key->name));
+        keys += sizeof(key->name);
+        memcpy(key->hmac_secret, keys, sizeof(key->hmac_secret));
+        keys += sizeof(key->hmac_secret);
+        memcpy(key->aes_key, keys, sizeof(key->aes_key));
+        keys += sizeof(key->aes_key);
+        key->created = now;
+    }
+    CAT_SSL_TICKET_KEYS_G(count) = count;
+    CAT_SSL_TICKET_KEYS_G(user_defined) = count > 0;
+
+    return cat_true;
+}
+
+CAT_API void cat_ssl_set_ticket_key_lifetime(cat_msec_t lifetime)
+{
+    CAT_SSL_TICKET_KEYS_G(lifetime) = lifetime;
+}
+
+static const cat_ssl_ticket_key_t *cat_ssl_ticket_keys_get_encryption_key(void)
+{
+    cat_ssl_ticket_key_t *keys = CAT_SSL_TICKET_KEYS_G(keys);
+    cat_msec_t now;
+
+    if (CAT_SSL_TICKET_KEYS_G(user_defined)) {
+        return &keys[0];
+    }
+    now = cat_time_msec_cached();
+    if (CAT_SSL_TICKET_KEYS_G(count) == 0 || now - keys[0].created >= CAT_SSL_TICKET_KEYS_G(lifetime)) {
+        /* rotate: previous keys are still used to decrypt until they are dropped */
+        memmove(&keys[1], &keys[0], sizeof(keys[0]) * (CAT_SSL_TICKET_KEYS_MAX - 1));
+        if (unlikely(RAND_bytes(keys[0].name, sizeof(keys[0].name)) != 1 ||
+                     RAND_bytes(keys[0].hmac_secret, sizeof(keys[0].hmac_secret)) != 1 ||
+                     RAND_bytes(keys[0].aes_key, sizeof(keys[0].aes_key)) != 1)) {
+            memmove(&keys[0], &keys[1], sizeof(keys[0]) * (CAT_SSL_TICKET_KEYS_MAX - 1));
+            return NULL;
+        }
+        keys[0].created = now;
+        if (CAT_SSL_TICKET_KEYS_G(count) < CAT_SSL_TICKET_KEYS_MAX) {
+            CAT_SSL_TICKET_KEYS_G(count)++;
+        }
+        CAT_LOG_DEBUG(SSL, "SSL ticket key rotated, %zu keys available", CAT_SSL_TICKET_KEYS_G(count));
+    }
+
+    return &keys[0];
+}
+
+#if CAT_SSL_VERSION_NUMBER >= 0x30000000L
+typedef EVP_MAC_CTX cat_ssl_ticket_hmac_ctx_t;
+#else
+typedef HMAC_CTX cat_ssl_ticket_hmac_ctx_t;
+#endif
+
+static int cat_ssl_ticket_hmac_init(cat_ssl_ticket_hmac_ctx_t *hctx, const cat_ssl_ticket_key_t *key)
+{
+#if CAT_SSL_VERSION_NUMBER >= 0x30000000L
+    OSSL_PARAM params[2];
+
+    params[0] = OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, (char *) "SHA256", 0);
+    params[1] = OSSL_PARAM_construct_end();
+
+    return EVP_MAC_init(hctx, key->hmac_secret, sizeof(key->hmac_secret), params);
+#elif CAT_SSL_VERSION_NUMBER >= 0x10000000L
+    return HMAC_Init_ex(hctx, key->hmac_secret, sizeof(key->hmac_secret), EVP_sha256(), NULL);
+#else
+    HMAC_Init_ex(hctx, key->hmac_secret, sizeof(key->hmac_secret), EVP_sha256(), NULL);
+    return 1;
+#endif
+}
+
+static int cat_ssl_ticket_key_callback(
+    cat_ssl_connection_t *connection, unsigned char *name, unsigned char *iv,
+    EVP_CIPHER_CTX *ectx, cat_ssl_ticket_hmac_ctx_t *hctx, int enc
+)
+{
+    const EVP_CIPHER *cipher = EVP_aes_256_cbc();
+    const cat_ssl_ticket_key_t *key;
+    size_t n;
+    (void) connection;
+
+    if (enc == 1) {
+        /* encrypt session ticket */
+        key = cat_ssl_ticket_keys_get_encryption_key();
+        if (unlikely(key == NULL)) {
+            CAT_LOG_DEBUG(SSL, "SSL ticket key generation failed");
+            return -1;
+        }
+        if (unlikely(RAND_bytes(iv, EVP_CIPHER_iv_length(cipher)) != 1)) {
+            return -1;
+        }
+        if (unlikely(EVP_EncryptInit_ex(ectx, cipher, NULL, key->aes_key, iv) != 1)) {
+            return -1;
+        }
+        if (unlikely(cat_ssl_ticket_hmac_init(hctx, key) != 1)) {
+            return -1;
+        }
+        memcpy(name, key->name, CAT_SSL_TICKET_KEY_NAME_LENGTH);
+        return 1;
+    }
+
+    /* decrypt session ticket */
+    for (n = 0; n < CAT_SSL_TICKET_KEYS_G(count); n++) {
+        key = &CAT_SSL_TICKET_KEYS_G(keys)[n];
+        if (memcmp(name, key->name, CAT_SSL_TICKET_KEY_NAME_LENGTH) == 0) {
+            break;
+        }
+    }
+    if (n == CAT_SSL_TICKET_KEYS_G(count)) {
+        CAT_LOG_DEBUG(SSL, "SSL ticket key not found");
+        /* full handshake and issue a new ticket */
+        return 0;
+    }
+    if (unlikely(cat_ssl_ticket_hmac_init(hctx, key) != 1)) {
+        return -1;
+    }
+    if (unlikely(EVP_DecryptInit_ex(ectx, cipher, NULL, key->aes_key, iv) != 1)) {
+        return -1;
+    }
+
+    /* renew the ticket if it was encrypted by an old key */
+    return n == 0 ? 1 : 2;
+}
+
 CAT_API cat_ssl_context_t *cat_ssl_context_create(cat_ssl_method_t method, cat_ssl_protocols_t protocols)
 {
     cat_ssl_context_t *context;
@@ -139,6 +570,9 @@ CAT_API cat_ssl_context_t *cat_ssl_context_create(cat_ssl_method_t method, cat_s
 #endif
     CAT_REF_INIT(context);
     context->ctx = ctx;
+#ifdef CAT_SSL_HAVE_KTLS
+    context->ktls_previous_keylog_callback = NULL;
+#endif
 
 #ifdef CAT_DEBUG
     /* link context to SSL_CTX */
@@ -212,6 +646,19 @@ CAT_API cat_ssl_context_t *cat_ssl_context_create(cat_ssl_method_t method, cat_s
     SSL_CTX_set_read_ahead(ctx, 1);
     SSL_CTX_set_info_callback(ctx, cat_ssl_info_callback);
 
+    /* use the shared session cache and ticket keys */
+    SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_BOTH | SSL_SESS_CACHE_NO_INTERNAL);
+    SSL_CTX_sess_set_new_cb(ctx, cat_ssl_new_session_callback);
+    SSL_CTX_sess_set_get_cb(ctx, cat_ssl_get_session_callback);
+    SSL_CTX_sess_set_remove_cb(ctx, cat_ssl_remove_session_callback);
+    SSL_CTX_set_timeout(ctx, (long) (CAT_SSL_SESSION_CACHE_G(ttl) / 1000));
+    SSL_CTX_set_session_id_context(ctx, (const unsigned char *) "libcat", sizeof("libcat") - 1);
+#if CAT_SSL_VERSION_NUMBER >= 0x30000000L
+    SSL_CTX_set_tlsext_ticket_key_evp_cb(ctx, cat_ssl_ticket_key_callback);
+#else
+    SSL_CTX_set_tlsext_ticket_key_cb(ctx, cat_ssl_ticket_key_callback);
+#endif
+
     /* init extra info */
     cat_string_init(&context->passphrase);
     cat_string_init(&context->alpn);
@@ -485,9 +932,66 @@ CAT_API cat_bool_t cat_ssl_context_set_certificate(cat_ssl_context_t *context, c
         cat_ssl_update_last_error(CAT_ESSL, "SSL private key does not match certificate");
         return cat_false;
     }
+#if CAT_SSL_VERSION_NUMBER >= 0x10002000L
+    do {
+        /* sessions can only be resumed by servers with the same certificate */
+        unsigned char digest[EVP_MAX_MD_SIZE];
+        unsigned int digest_length;
+        X509 *x509 = SSL_CTX_get0_certificate(ctx);
+        if (x509 != NULL && X509_digest(x509, EVP_sha1(), digest, &digest_length) == 1) {
+            SSL_CTX_set_session_id_context(ctx, digest, digest_length);
+        }
+    } while (0);
+#endif
     return cat_true;
 }
 
+CAT_API cat_bool_t cat_ssl_context_set_session_id_context(cat_ssl_context_t *context, const char *settings, size_t settings_length)
+{
+    cat_ssl_ctx_t *ctx = context->ctx;
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int digest_length = 0;
+    EVP_MD_CTX *md_ctx;
+    cat_bool_t ret = cat_false;
+
+    md_ctx = EVP_MD_CTX_create();
+    if (unlikely(md_ctx == NULL)) {
+        cat_ssl_update_last_error(CAT_ESSL, "EVP_MD_CTX_create() failed");
+        return cat_false;
+    }
+    if (EVP_DigestInit_ex(md_ctx, EVP_sha256(), NULL) != 1) {
+        goto _error;
+    }
+#if CAT_SSL_VERSION_NUMBER >= 0x10002000L
+    do {
+        unsigned char certificate_digest[EVP_MAX_MD_SIZE];
+        unsigned int certificate_digest_length;
+        X509 *x509 = SSL_CTX_get0_certificate(ctx);
+        if (x509 != NULL && X509_digest(x509, EVP_sha1(), certificate_digest, &certificate_digest_length) == 1) {
+            if (EVP_DigestUpdate(md_ctx, certificate_digest, certificate_digest_length) != 1) {
+                goto _error;
+            }
+        }
+    } while (0);
+#endif
+    if (EVP_DigestUpdate(md_ctx, settings, settings_length) != 1 ||
+        EVP_DigestFinal_ex(md_ctx, digest, &digest_length) != 1) {
+        goto _error;
+    }
+    CAT_LOG_DEBUG(SSL, "SSL_CTX_set_session_id_context(%p, %u bytes)", context, digest_length);
+    if (SSL_CTX_set_session_id_context(ctx, digest, CAT_MIN(digest_length, SSL_MAX_SID_CTX_LENGTH)) != 1) {
+        goto _error;
+    }
+    ret = cat_true;
+
+    if (0) {
+        _error:
+        cat_ssl_update_last_error(CAT_ESSL, "SSL set session id context failed");
+    }
+    EVP_MD_CTX_destroy(md_ctx);
+    return ret;
+}
+
 CAT_API void cat_ssl_context_set_verify_depth(cat_ssl_context_t *context, int depth)
 {
     CAT_LOG_DEBUG(SSL, "SSL_CTX_set_verify_depth(%p, %d)", context, depth);
@@ -744,6 +1248,10 @@ CAT_API cat_ssl_t *cat_ssl_create(cat_ssl_t *ssl, cat_ssl_context_t *context)
     ssl->connection = connection;
     ssl->context = context;
     ssl->allow_self_signed = cat_false;
+#ifdef CAT_SSL_HAVE_KTLS
+    ssl->ktls = NULL;
+#endif
+    cat_string_init(&ssl->session_cache_key);
 
     return ssl;
 
@@ -767,8 +1275,18 @@ CAT_API cat_ssl_t *cat_ssl_create(cat_ssl_t *ssl, cat_ssl_context_t *context)
     return NULL;
 }
 
+#ifdef CAT_SSL_HAVE_KTLS
+static void cat_ssl_ktls_free(cat_ssl_t *ssl);
+#endif
+
 CAT_API void cat_ssl_close(cat_ssl_t *ssl)
 {
+#ifdef CAT_SSL_HAVE_KTLS
+    if (ssl->ktls != NULL) {
+        cat_ssl_ktls_free(ssl);
+    }
+#endif
+    cat_string_close(&ssl->session_cache_key);
     cat_buffer_close(&ssl->write_buffer);
     cat_buffer_close(&ssl->read_buffer);
     /* ibio will be free'd by SSL_free */
@@ -865,6 +1383,13 @@ CAT_API cat_ssl_ret_t cat_ssl_handshake(cat_ssl_t *ssl)
     CAT_LOG_DEBUG(SSL, "SSL_do_handshake(%p): %d", ssl, n);
     if (n == 1) {
         ssl->flags |= CAT_SSL_FLAG_HANDSHAKE_OK;
+        if (SSL_is_server(connection)) {
+            CAT_SSL_G(server_handshakes)++;
+            CAT_SSL_G(server_resumptions) += !!SSL_session_reused(connection);
+        } else {
+            CAT_SSL_G(client_handshakes)++;
+            CAT_SSL_G(client_resumptions) += !!SSL_session_reused(connection);
+        }
         CAT_LOG_DEBUG_VA(SSL, {
             cat_ssl_handshake_log(ssl);
         });
@@ -1362,6 +1887,388 @@ CAT_API cat_bool_t cat_ssl_decrypt(cat_ssl_t *ssl, char *out, size_t *out_length
     return ret;
 }
 
+CAT_API cat_bool_t cat_ssl_has_pending_data(const cat_ssl_t *ssl)
+{
+    if (ssl->read_buffer.length != 0) {
+        return cat_true;
+    }
+    if (BIO_ctrl_pending(SSL_get_rbio(ssl->connection)) != 0) {
+        return cat_true;
+    }
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+    return SSL_has_pending(ssl->connection);
+#else
+    return SSL_pending(ssl->connection) > 0;
+#endif
+}
+
+#ifdef CAT_SSL_HAVE_KTLS
+#ifndef SOL_TLS
+#define SOL_TLS 282
+#endif
+#ifndef TCP_ULP
+#define TCP_ULP 31
+#endif
+
+struct cat_ssl_ktls_s {
+    /* sequence number of the next record we will send,
+     * OpenSSL does not expose it, so we count records by msg callback */
+    uint64_t send_sequence;
+    cat_bool_t send_sequence_tracked;
+    /* TLSv1.3 application traffic secret of our side, it comes from keylog callback */
+    size_t send_secret_length;
+    unsigned char send_secret[EVP_MAX_MD_SIZE];
+};
+
+typedef union cat_ssl_ktls_crypto_info_u {
+    struct tls_crypto_info info;
+    struct tls12_crypto_info_aes_gcm_128 aes_gcm_128;
+#ifdef TLS_CIPHER_AES_GCM_256
+    struct tls12_crypto_info_aes_gcm_256 aes_gcm_256;
+#endif
+#ifdef TLS_CIPHER_CHACHA20_POLY1305
+    struct tls12_crypto_info_chacha20_poly1305 chacha20_poly1305;
+#endif
+} cat_ssl_ktls_crypto_info_t;
+
+static void cat_ssl_ktls_message_callback(int write_p, int version, int content_type, const void *buf, size_t len, SSL *connection, void *arg)
+{
+    cat_ssl_ktls_t *ktls = (cat_ssl_ktls_t *) arg;
+
+    (void) version;
+    if (!write_p) {
+        return;
+    }
+    if (content_type == SSL3_RT_HEADER) {
+        if (ktls->send_sequence_tracked) {
+            ktls->send_sequence++;
+        }
+    } else if (content_type == SSL3_RT_HANDSHAKE && len > 0 && *((const unsigned char *) buf) == SSL3_MT_FINISHED) {
+        /* records after our Finished are protected by the application keys,
+         * TLSv1.3 starts a new sequence for them,
+         * and in TLSv1.2 Finished itself is the first record after ChangeCipherSpec */
+        ktls->send_sequence = SSL_version(connection) == TLS1_3_VERSION ? 0 : 1;
+        ktls->send_sequence_tracked = cat_true;
+    }
+}
+
+static void cat_ssl_ktls_keylog_callback(const cat_ssl_connection_t *connection, const char *line)
+{
+    cat_ssl_t *ssl = cat_ssl_get_from_connection(connection);
+    cat_ssl_ktls_t *ktls;
+    const char *label;
+    size_t label_length, length, i;
+
+    if (ssl == NULL) {
+        return;
+    }
+    if (ssl->context->ktls_previous_keylog_callback != NULL) {
+        ssl->context->ktls_previous_keylog_callback(connection, line);
+    }
+    /* only connections which have required kTLS capture the secret */
+    if ((ktls = ssl->ktls) == NULL) {
+        return;
+    }
+    label = SSL_is_server((SSL *) connection) ? "SERVER_TRAFFIC_SECRET_0 " : "CLIENT_TRAFFIC_SECRET_0 ";
+    label_length = strlen(label);
+    if (strncmp(line, label, label_length) != 0) {
+        return;
+    }
+    /* skip client random */
+    line = strchr(line + label_length, ' ');
+    if (line == NULL) {
+        return;
+    }
+    line++;
+    length = strlen(line) / 2;
+    if (length > sizeof(ktls->send_secret)) {
+        return;
+    }
+    for (i = 0; i < length; i++) {
+        int high = OPENSSL_hexchar2int((unsigned char) line[i * 2]);
+        int low = OPENSSL_hexchar2int((unsigned char) line[i * 2 + 1]);
+        if (unlikely(high < 0 || low < 0)) {
+            return;
+        }
+        ktls->send_secret[i] = (unsigned char) ((high << 4) | low);
+    }
+    ktls->send_secret_length = length;
+}
+
+CAT_API cat_bool_t cat_ssl_prepare_ktls(cat_ssl_t *ssl)
+{
+    cat_ssl_connection_t *connection = ssl->connection;
+    cat_ssl_ctx_t *ctx = SSL_get_SSL_CTX(connection);
+    SSL_CTX_keylog_cb_func keylog_callback;
+    cat_ssl_ktls_t *ktls;
+
+    if (ssl->ktls != NULL) {
+        return cat_true;
+    }
+
+    ktls = (cat_ssl_ktls_t *) cat_malloc(sizeof(*ktls));
+#if CAT_ALLOC_HANDLE_ERRORS
+    if (unlikely(ktls == NULL)) {
+        cat_update_last_error_of_syscall("Malloc for SSL kTLS failed");
+        return cat_false;
+    }
+#endif
+    memset(ktls, 0, sizeof(*ktls));
+
+    SSL_set_msg_callback(connection, cat_ssl_ktls_message_callback);
+    SSL_set_msg_callback_arg(connection, ktls);
+    /* OpenSSL only provides the keylog callback on SSL_CTX (no SSL-level setter),
+     * so it is hooked once per context, and dispatches by the per-SSL kTLS state,
+     * the previous callback is preserved and still called for every connection */
+    keylog_callback = SSL_CTX_get_keylog_callback(ctx);
+    if (keylog_callback != cat_ssl_ktls_keylog_callback) {
+        CAT_ASSERT(ssl->context->ctx == ctx);
+        ssl->context->ktls_previous_keylog_callback = keylog_callback;
+        SSL_CTX_set_keylog_callback(ctx, cat_ssl_ktls_keylog_callback);
+    }
+#ifdef SSL_OP_NO_RENEGOTIATION
+    /* kernel can not follow the new keys */
+    SSL_set_options(connection, SSL_OP_NO_RENEGOTIATION);
+#endif
+    ssl->ktls = ktls;
+
+    return cat_true;
+}
+
+static void cat_ssl_ktls_free(cat_ssl_t *ssl)
+{
+    cat_ssl_ktls_t *ktls = ssl->ktls;
+
+    SSL_set_msg_callback(ssl->connection, NULL);
+    SSL_set_msg_callback_arg(ssl->connection, NULL);
+    OPENSSL_cleanse(ktls, sizeof(*ktls));
+    cat_free(ktls);
+    ssl->ktls = NULL;
+}
+
+/* HKDF-Expand-Label() with empty context (RFC 8446 section 7.1) */
+static cat_bool_t cat_ssl_ktls_expand_label(const EVP_MD *md, const unsigned char *secret, size_t secret_length, const char *label, unsigned char *out, size_t out_length)
+{
+    static const char prefix[] = "tls13 ";
+    unsigned char info[2 + 1 + sizeof(prefix) - 1 + 8 + 1];
+    size_t label_length = strlen(label), info_length = 0, length = out_length;
+    EVP_PKEY_CTX *pctx;
+    cat_bool_t ret = cat_false;
+
+    CAT_ASSERT(label_length <= 8);
+    info[info_length++] = (unsigned char) (out_length >> 8);
+    info[info_length++] = (unsigned char) out_length;
+    info[info_length++] = (unsigned char) (sizeof(prefix) - 1 + label_length);
+    memcpy(info + info_length, prefix, sizeof(prefix) - 1);
+    info_length += sizeof(prefix) - 1;
+    memcpy(info + info_length, label, label_length);
+    info_length += label_length;
+    info[info_length++] = 0;
+
+    pctx = EVP_PKEY_CTX_new_id(EVP_PKEY_HKDF, NULL);
+    if (unlikely(pctx == NULL)) {
+        return cat_false;
+    }
+    if (EVP_PKEY_derive_init(pctx) > 0 &&
+        EVP_PKEY_CTX_hkdf_mode(pctx, EVP_PKEY_HKDEF_MODE_EXPAND_ONLY) > 0 &&
+        EVP_PKEY_CTX_set_hkdf_md(pctx, md) > 0 &&
+        EVP_PKEY_CTX_set1_hkdf_key(pctx, secret, (int) secret_length) > 0 &&
+        EVP_PKEY_CTX_add1_hkdf_info(pctx, info, (int) info_length) > 0 &&
+        EVP_PKEY_derive(pctx, out, &length) > 0) {
+        ret = length == out_length;
+    }
+    EVP_PKEY_CTX_free(pctx);
+
+    return ret;
+}
+
+/* TLSv1.2 key_block = PRF(master_secret, "key expansion", server_random + client_random) (RFC 5246 section 6.3) */
+static cat_bool_t cat_ssl_ktls_key_block(cat_ssl_connection_t *connection, const EVP_MD *md, unsigned char *out, size_t out_length)
+{
+    static const char label[] = "key expansion";
+    unsigned char master_key[SSL_MAX_MASTER_KEY_LENGTH];
+    unsigned char client_random[SSL3_RANDOM_SIZE], server_random[SSL3_RANDOM_SIZE];
+    size_t master_key_length, length = out_length;
+    EVP_PKEY_CTX *pctx;
+    cat_bool_t ret = cat_false;
+
+    master_key_length = SSL_SESSION_get_master_key(SSL_get_session(connection), master_key, sizeof(master_key));
+    if (unlikely(master_key_length == 0 ||
+        SSL_get_client_random(connection, client_random, sizeof(client_random)) != sizeof(client_random) ||
+        SSL_get_server_random(connection, server_random, sizeof(server_random)) != sizeof(server_random))) {
+        goto _out;
+    }
+    pctx = EVP_PKEY_CTX_new_id(EVP_PKEY_TLS1_PRF, NULL);
+    if (unlikely(pctx == NULL)) {
+        goto _out;
+    }
+    if (EVP_PKEY_derive_init(pctx) > 0 &&
+        EVP_PKEY_CTX_set_tls1_prf_md(pctx, md) > 0 &&
+        EVP_PKEY_CTX_set1_tls1_prf_secret(pctx, master_key, (int) master_key_length) > 0 &&
+        EVP_PKEY_CTX_add1_tls1_prf_seed(pctx, (const unsigned char *) label, (int) sizeof(label) - 1) > 0 &&
+        EVP_PKEY_CTX_add1_tls1_prf_seed(pctx, server_random, (int) sizeof(server_random)) > 0 &&
+        EVP_PKEY_CTX_add1_tls1_prf_seed(pctx, client_random, (int) sizeof(client_random)) > 0 &&
+        EVP_PKEY_derive(pctx, out, &length) > 0) {
+        ret = length == out_length;
+    }
+    EVP_PKEY_CTX_free(pctx);
+
+    _out:
+    OPENSSL_cleanse(master_key, sizeof(master_key));
+    return ret;
+}
+
+CAT_API cat_bool_t cat_ssl_enable_ktls_send(cat_ssl_t *ssl, cat_os_socket_t fd)
+{
+    cat_ssl_connection_t *connection = ssl->connection;
+    cat_ssl_ktls_t *ktls = ssl->ktls;
+    const SSL_CIPHER *cipher;
+    const EVP_MD *md;
+    cat_ssl_ktls_crypto_info_t crypto_info;
+    unsigned char *iv, *key, *salt, *rec_seq;
+    size_t iv_length, key_length, salt_length, crypto_info_length;
+    /* client_write_key + server_write_key + client_write_IV + server_write_IV, or key + iv (TLSv1.3) */
+    unsigned char key_block[(32 + 12) * 2];
+    unsigned char *write_key, *write_iv;
+    uint64_t sequence;
+    int i;
+    cat_bool_t ret = cat_false;
+
+    if (ssl->flags & CAT_SSL_FLAG_KTLS_SEND) {
+        return cat_true;
+    }
+    if (unlikely(ktls == NULL || !cat_ssl_is_established(ssl) || !ktls->send_sequence_tracked)) {
+        cat_update_last_error(CAT_EINVAL, "SSL kTLS was not prepared before handshake");
+        return cat_false;
+    }
+    if (unlikely(BIO_ctrl_pending(ssl->nbio) != 0 || ssl->write_buffer.length != 0)) {
+        cat_update_last_error(CAT_EAGAIN, "SSL has pending encrypted data which was not sent");
+        return cat_false;
+    }
+
+    memset(&crypto_info, 0, sizeof(crypto_info));
+    switch (SSL_version(connection)) {
+        case TLS1_2_VERSION:
+            crypto_info.info.version = TLS_1_2_VERSION;
+            break;
+#ifdef TLS_1_3_VERSION
+        case TLS1_3_VERSION:
+            crypto_info.info.version = TLS_1_3_VERSION;
+            break;
+#endif
+        default:
+            cat_update_last_error(CAT_ENOTSUP, "SSL kTLS does not support %s", SSL_get_version(connection));
+            return cat_false;
+    }
+    cipher = SSL_get_current_cipher(connection);
+    switch (SSL_CIPHER_get_cipher_nid(cipher)) {
+#define CAT_SSL_KTLS_CIPHER_CASE(nid, name, NAME) \
+        case nid: \
+            crypto_info.info.cipher_type = TLS_CIPHER_##NAME; \
+            iv = crypto_info.name.iv; \
+            iv_length = TLS_CIPHER_##NAME##_IV_SIZE; \
+            key = crypto_info.name.key; \
+            key_length = TLS_CIPHER_##NAME##_KEY_SIZE; \
+            salt = crypto_info.name.salt; \
+            salt_length = TLS_CIPHER_##NAME##_SALT_SIZE; \
+            rec_seq = crypto_info.name.rec_seq; \
+            crypto_info_length = sizeof(crypto_info.name); \
+            break;
+        CAT_SSL_KTLS_CIPHER_CASE(NID_aes_128_gcm, aes_gcm_128, AES_GCM_128)
+#ifdef TLS_CIPHER_AES_GCM_256
+        CAT_SSL_KTLS_CIPHER_CASE(NID_aes_256_gcm, aes_gcm_256, AES_GCM_256)
+#endif
+#ifdef TLS_CIPHER_CHACHA20_POLY1305
+        CAT_SSL_KTLS_CIPHER_CASE(NID_chacha20_poly1305, chacha20_poly1305, CHACHA20_POLY1305)
+#endif
+#undef CAT_SSL_KTLS_CIPHER_CASE
+        default:
+            cat_update_last_error(CAT_ENOTSUP, "SSL kTLS does not support cipher %s", SSL_CIPHER_get_name(cipher));
+            return cat_false;
+    }
+    md = SSL_CIPHER_get_handshake_digest(cipher);
+    if (unlikely(md == NULL)) {
+        cat_ssl_update_last_error(CAT_ESSL, "SSL kTLS can not get digest of cipher %s", SSL_CIPHER_get_name(cipher));
+        return cat_false;
+    }
+    sequence = ktls->send_sequence;
+
+    if (crypto_info.info.version == TLS_1_2_VERSION) {
+        /* IV in key block is salt of GCM (implicit nonce), or the whole IV of ChaCha20-Poly1305 */
+        size_t fixed_iv_length = salt_length != 0 ? salt_length : iv_length;
+        if (unlikely(!cat_ssl_ktls_key_block(connection, md, key_block, (key_length + fixed_iv_length) * 2))) {
+            cat_ssl_update_last_error(CAT_ESSL, "SSL kTLS can not derive TLSv1.2 key block");
+            goto _out;
+        }
+        if (SSL_is_server(connection)) {
+            write_key = key_block + key_length;
+            write_iv = key_block + key_length * 2 + fixed_iv_length;
+        } else {
+            write_key = key_block;
+            write_iv = key_block + key_length * 2;
+        }
+        memcpy(key, write_key, key_length);
+        if (salt_length != 0) {
+            memcpy(salt, write_iv, salt_length);
+            /* explicit nonce, kernel increases it for each record, sequence number is a unique start */
+            for (i = (int) iv_length - 1; i >= 0; i--) {
+                iv[i] = (unsigned char) (sequence >> ((iv_length - 1 - i) * 8));
+            }
+        } else {
+            memcpy(iv, write_iv, iv_length);
+        }
+    } else {
+        if (unlikely(ktls->send_secret_length == 0)) {
+            cat_update_last_error(CAT_EINVAL, "SSL kTLS did not get TLSv1.3 traffic secret");
+            goto _out;
+        }
+        write_key = key_block;
+        write_iv = key_block + key_length;
+        if (unlikely(
+            !cat_ssl_ktls_expand_label(md, ktls->send_secret, ktls->send_secret_length, "key", write_key, key_length) ||
+            !cat_ssl_ktls_expand_label(md, ktls->send_secret, ktls->send_secret_length, "iv", write_iv, salt_length + iv_length)
+        )) {
+            cat_ssl_update_last_error(CAT_ESSL, "SSL kTLS can not derive TLSv1.3 traffic keys");
+            goto _out;
+        }
+        memcpy(key, write_key, key_length);
+        memcpy(salt, write_iv, salt_length);
+        memcpy(iv, write_iv + salt_length, iv_length);
+    }
+    for (i = TLS_CIPHER_AES_GCM_128_REC_SEQ_SIZE - 1; i >= 0; i--) {
+        rec_seq[i] = (unsigned char) sequence;
+        sequence >>= 8;
+    }
+
+    if (unlikely(setsockopt(fd, SOL_TCP, TCP_ULP, "tls", sizeof("tls")) != 0)) {
+        cat_update_last_error_of_syscall("SSL kTLS setsockopt(TCP_ULP) failed");
+        goto _out;
+    }
+    /* socket still works as usual if it fails, because no TLS context is installed */
+    if (unlikely(setsockopt(fd, SOL_TLS, TLS_TX, &crypto_info, (socklen_t) crypto_info_length) != 0)) {
+        cat_update_last_error_of_syscall("SSL kTLS setsockopt(TLS_TX) failed");
+        goto _out;
+    }
+    CAT_LOG_DEBUG(SSL, "SSL(%p) kTLS send enabled (%s, %s, sequence=%" PRIu64 ")",
+        ssl, SSL_get_version(connection), SSL_CIPHER_get_name(cipher), ktls->send_sequence);
+    ssl->flags |= CAT_SSL_FLAG_KTLS_SEND;
+    ret = cat_true;
+
+    _out:
+    OPENSSL_cleanse(&crypto_info, sizeof(crypto_info));
+    OPENSSL_cleanse(key_block, sizeof(key_block));
+    /* secret is useless from now on */
+    OPENSSL_cleanse(ktls->send_secret, sizeof(ktls->send_secret));
+    ktls->send_secret_length = 0;
+    return ret;
+}
+#endif
+
+CAT_API cat_bool_t cat_ssl_is_ktls_send_enabled(const cat_ssl_t *ssl)
+{
+    return !!(ssl->flags & CAT_SSL_FLAG_KTLS_SEND);
+}
+
 CAT_API cat_ssl_shutdown_masks_t cat_ssl_get_shutdown(const cat_ssl_t *ssl)
 {
     return SSL_get_shutdown(ssl->connection);
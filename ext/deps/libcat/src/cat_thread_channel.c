@@ -0,0 +1,410 @@
+/*
+  +--------------------------------------------------------------------------+
+  | libcat                                                                   |
+  +--------------------------------------------------------------------------+
+  | Licensed under the Apache License, Version 2.0 (the "License");          |
+  | you may not use this file except in compliance with the License.         |
+  | You may obtain a copy of the License at                                  |
+  | http://www.apache.org/licenses/LICENSE-2.0                               |
+  | Unless required by applicable law or agreed to in writing, software      |
+  | distributed under the License is distributed on an "AS IS" BASIS,        |
+  | WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. |
+  | See the License for the specific language governing permissions and      |
+  | limitations under the License. See accompanying LICENSE file.            |
+  +--------------------------------------------------------------------------+
+  | Author: Twosee <twosee@php.net>                                          |
+  +--------------------------------------------------------------------------+
+ */
+
+#include "cat_thread_channel.h"
+#include "cat_async.h"
+#include "cat_atomic.h"
+#include "cat_time.h"
+
+#define CAT_THREAD_CHANNEL_CACHE_LINE_SIZE 64
+
+/* data of the cell is placed after the sequence */
+#define CAT_THREAD_CHANNEL_CELL_DATA_OFFSET CAT_MEMORY_ALIGNED_SIZE_EX(sizeof(cat_atomic_uint32_t), sizeof(uint64_t))
+
+typedef struct cat_thread_channel_waiter_s {
+    cat_queue_node_t node;
+    cat_async_t *async;
+    /* it was removed from the queue and the async was notified by the peer */
+    cat_bool_t notified;
+} cat_thread_channel_waiter_t;
+
+struct cat_thread_channel_s {
+    cat_atomic_uint32_t tail;
+    char padding1[CAT_THREAD_CHANNEL_CACHE_LINE_SIZE - sizeof(cat_atomic_uint32_t)];
+    cat_atomic_uint32_t head;
+    char padding2[CAT_THREAD_CHANNEL_CACHE_LINE_SIZE - sizeof(cat_atomic_uint32_t)];
+    /* peers take the mutex only if there are waiters */
+    cat_atomic_uint32_t producer_count;
+    cat_atomic_uint32_t consumer_count;
+    cat_atomic_bool_t closed;
+    cat_atomic_uint32_t refcount;
+    /* protects waiter queues */
+    uv_mutex_t mutex;
+    cat_queue_t producers;
+    cat_queue_t consumers;
+    cat_thread_channel_size_t capacity;
+    size_t data_size;
+    size_t cell_size;
+    cat_thread_channel_data_dtor_t dtor;
+    char *cells;
+};
+
+static cat_always_inline cat_atomic_uint32_t *cat_thread_channel_get_cell(cat_thread_channel_t *channel, uint32_t position)
+{
+    return (cat_atomic_uint32_t *) (channel->cells + ((size_t) (position & (channel->capacity - 1)) * channel->cell_size));
+}
+
+static cat_always_inline void *cat_thread_channel_get_cell_data(cat_atomic_uint32_t *sequence)
+{
+    return ((char *) sequence) + CAT_THREAD_CHANNEL_CELL_DATA_OFFSET;
+}
+
+static cat_bool_t cat_thread_channel_enqueue(cat_thread_channel_t *channel, const void *data)
+{
+    cat_atomic_uint32_t *sequence;
+    uint32_t position = cat_atomic_uint32_load(&channel->tail);
+
+    while (1) {
+        int32_t diff;
+        sequence = cat_thread_channel_get_cell(channel, position);
+        diff = (int32_t) (cat_atomic_uint32_load(sequence) - position);
+        if (diff == 0) {
+            if (cat_atomic_uint32_compare_exchange_weak(&channel->tail, &position, position + 1)) {
+                break;
+            }
+        } else if (diff < 0) {
+            /* full */
+            return cat_false;
+        } else {
+            position = cat_atomic_uint32_load(&channel->tail);
+        }
+    }
+    memcpy(cat_thread_channel_get_cell_data(sequence), data, channel->data_size);
+    cat_atomic_uint32_store(sequence, position + 1);
+
+    return cat_true;
+}
+
+static cat_bool_t cat_thread_channel_dequeue(cat_thread_channel_t *channel, void *data)
+{
+    cat_atomic_uint32_t *sequence;
+    uint32_t position = cat_atomic_uint32_load(&channel->head);
+
+    while (1) {
+        int32_t diff;
+        sequence = cat_thread_channel_get_cell(channel, position);
+        diff = (int32_t) (cat_atomic_uint32_load(sequence) - (position + 1));
+        if (diff == 0) {
+            if (cat_atomic_uint32_compare_exchange_weak(&channel->head, &position, position + 1)) {
+                break;
+            }
+        } else if (diff < 0) {
+            /* empty */
+            return cat_false;
+        } else {
+            position = cat_atomic_uint32_load(&channel->head);
+        }
+    }
+    memcpy(data, cat_thread_channel_get_cell_data(sequence), channel->data_size);
+    cat_atomic_uint32_store(sequence, position + channel->capacity);
+
+    return cat_true;
+}
+
+/* wake up one of the waiters, it may be called in any thread */
+static void cat_thread_channel_notify(cat_thread_channel_t *channel, cat_queue_t *waiters, cat_atomic_uint32_t *waiter_count)
+{
+    cat_thread_channel_waiter_t *waiter;
+
+    if (cat_atomic_uint32_load(waiter_count) == 0) {
+        return;
+    }
+    uv_mutex_lock(&channel->mutex);
+    waiter = cat_queue_front_data(waiters, cat_thread_channel_waiter_t, node);
+    if (waiter != NULL) {
+        cat_queue_remove(&waiter->node);
+        (void) cat_atomic_uint32_fetch_sub(waiter_count, 1);
+        waiter->notified = cat_true;
+        /* notify it with lock held, waiter may return as soon as it sees the flag */
+        (void) cat_async_notify(waiter->async);
+    }
+    uv_mutex_unlock(&channel->mutex);
+}
+
+static void cat_thread_channel_notify_all(cat_thread_channel_t *channel, cat_queue_t *waiters, cat_atomic_uint32_t *waiter_count)
+{
+    cat_thread_channel_waiter_t *waiter;
+
+    uv_mutex_lock(&channel->mutex);
+    while ((waiter = cat_queue_front_data(waiters, cat_thread_channel_waiter_t, node))) {
+        cat_queue_remove(&waiter->node);
+        (void) cat_atomic_uint32_fetch_sub(waiter_count, 1);
+        waiter->notified = cat_true;
+        (void) cat_async_notify(waiter->async);
+    }
+    uv_mutex_unlock(&channel->mutex);
+}
+
+CAT_API cat_thread_channel_t *cat_thread_channel_create(cat_thread_channel_size_t capacity, size_t data_size, cat_thread_channel_data_dtor_t dtor)
+{
+    cat_thread_channel_t *channel;
+    cat_thread_channel_size_t size;
+    uint32_t n;
+    int error;
+
+    if (unlikely(capacity == 0 || capacity > CAT_THREAD_CHANNEL_SIZE_MAX)) {
+        cat_update_last_error(CAT_EINVAL, "Thread channel capacity should be in range [1, " CAT_THREAD_CHANNEL_SIZE_FMT "]", CAT_THREAD_CHANNEL_SIZE_MAX);
+        return NULL;
+    }
+    if (unlikely(data_size == 0)) {
+        cat_update_last_error(CAT_EINVAL, "Thread channel data size can not be 0");
+        return NULL;
+    }
+    /* sequence of a filled cell (position + 1) equals to the next position of
+     * a single-cell ring, so that it would never be full, at least 2 cells are required */
+    for (size = 2; size < capacity; size <<= 1);
+
+    /* it may be released in another thread, so we must use the system allocator */
+    channel = (cat_thread_channel_t *) cat_sys_malloc(sizeof(*channel));
+#if CAT_SYS_ALLOC_HANDLE_ERRORS
+    if (unlikely(channel == NULL)) {
+        cat_update_last_error_of_syscall("Malloc for thread channel failed");
+        return NULL;
+    }
+#endif
+    channel->capacity = size;
+    channel->data_size = data_size;
+    channel->cell_size = CAT_MEMORY_ALIGNED_SIZE_EX(CAT_THREAD_CHANNEL_CELL_DATA_OFFSET + data_size, sizeof(uint64_t));
+    channel->dtor = dtor;
+    channel->cells = (char *) cat_sys_malloc(channel->cell_size * size);
+#if CAT_SYS_ALLOC_HANDLE_ERRORS
+    if (unlikely(channel->cells == NULL)) {
+        cat_update_last_error_of_syscall("Malloc for thread channel storage failed");
+        cat_sys_free(channel);
+        return NULL;
+    }
+#endif
+    error = uv_mutex_init(&channel->mutex);
+    if (unlikely(error != 0)) {
+        cat_update_last_error_with_reason(error, "Thread channel mutex init failed");
+        cat_sys_free(channel->cells);
+        cat_sys_free(channel);
+        return NULL;
+    }
+    for (n = 0; n < size; n++) {
+        cat_atomic_uint32_init(cat_thread_channel_get_cell(channel, n), n);
+    }
+    cat_atomic_uint32_init(&channel->tail, 0);
+    cat_atomic_uint32_init(&channel->head, 0);
+    cat_atomic_uint32_init(&channel->producer_count, 0);
+    cat_atomic_uint32_init(&channel->consumer_count, 0);
+    cat_atomic_bool_init(&channel->closed, cat_false);
+    cat_atomic_uint32_init(&channel->refcount, 1);
+    cat_queue_init(&channel->producers);
+    cat_queue_init(&channel->consumers);
+
+    return channel;
+}
+
+CAT_API cat_thread_channel_t *cat_thread_channel_add_ref(cat_thread_channel_t *channel)
+{
+    (void) cat_atomic_uint32_fetch_add(&channel->refcount, 1);
+
+    return channel;
+}
+
+CAT_API void cat_thread_channel_release(cat_thread_channel_t *channel)
+{
+    if (cat_atomic_uint32_fetch_sub(&channel->refcount, 1) != 1) {
+        return;
+    }
+    CAT_ASSERT(cat_queue_empty(&channel->producers) && cat_queue_empty(&channel->consumers));
+    if (channel->dtor != NULL) {
+        /* the last reference may be released by a thread whose runtime has been shut down */
+        void *data = cat_sys_malloc(channel->data_size);
+#if CAT_SYS_ALLOC_HANDLE_ERRORS
+        if (likely(data != NULL))
+#endif
+        {
+            while (cat_thread_channel_dequeue(channel, data)) {
+                channel->dtor(data);
+            }
+            cat_sys_free(data);
+        }
+    }
+    uv_mutex_destroy(&channel->mutex);
+    cat_sys_free(channel->cells);
+    cat_sys_free(channel);
+}
+
+CAT_API cat_bool_t cat_thread_channel_try_push(cat_thread_channel_t *channel, const void *data)
+{
+    if (unlikely(cat_atomic_bool_load(&channel->closed))) {
+        return cat_false;
+    }
+    if (!cat_thread_channel_enqueue(channel, data)) {
+        return cat_false;
+    }
+    cat_thread_channel_notify(channel, &channel->consumers, &channel->consumer_count);
+
+    return cat_true;
+}
+
+CAT_API cat_bool_t cat_thread_channel_try_pop(cat_thread_channel_t *channel, void *data)
+{
+    if (!cat_thread_channel_dequeue(channel, data)) {
+        return cat_false;
+    }
+    cat_thread_channel_notify(channel, &channel->producers, &channel->producer_count);
+
+    return cat_true;
+}
+
+/* remove the waiter if it has not been notified yet, and release its async */
+static void cat_thread_channel_cancel_waiter(
+    cat_thread_channel_t *channel, cat_thread_channel_waiter_t *waiter,
+    cat_queue_t *waiters, cat_atomic_uint32_t *waiter_count, cat_bool_t waited
+)
+{
+    cat_bool_t notified;
+
+    uv_mutex_lock(&channel->mutex);
+    notified = waiter->notified;
+    if (!notified) {
+        cat_queue_remove(&waiter->node);
+        (void) cat_atomic_uint32_fetch_sub(waiter_count, 1);
+    }
+    uv_mutex_unlock(&channel->mutex);
+
+    if (!waited) {
+        if (!notified) {
+            (void) cat_async_close(waiter->async, NULL);
+        } else {
+            /* it will be closed when the notification arrives */
+            (void) cat_async_cleanup(waiter->async, NULL);
+        }
+    } else {
+        /* async is in closing, it is closed in its callback, so we must trigger it if no one will do */
+        if (!notified) {
+            (void) cat_async_notify(waiter->async);
+        } else {
+            /* we took the notification but give up, pass it to the next one */
+            cat_thread_channel_notify(channel, waiters, waiter_count);
+        }
+    }
+}
+
+static cat_bool_t cat_thread_channel_wait(cat_thread_channel_t *channel, void *data, cat_bool_t push, cat_timeout_t timeout)
+{
+    cat_queue_t *waiters = push ? &channel->producers : &channel->consumers;
+    cat_atomic_uint32_t *waiter_count = push ? &channel->producer_count : &channel->consumer_count;
+    const char *name = push ? "consumer" : "producer";
+    cat_msec_t deadline = timeout > 0 ? cat_time_msec() + timeout : 0;
+
+    while (1) {
+        cat_thread_channel_waiter_t waiter;
+        cat_bool_t ret;
+
+        if (push ?
+            cat_thread_channel_try_push(channel, data) :
+            cat_thread_channel_try_pop(channel, data)) {
+            return cat_true;
+        }
+        if (unlikely(cat_atomic_bool_load(&channel->closed))) {
+            cat_update_last_error(CAT_ECLOSED, "Thread channel has been closed");
+            return cat_false;
+        }
+        if (unlikely(timeout == 0)) {
+            cat_update_last_error(CAT_ETIMEDOUT, "Thread channel wait %s timed out", name);
+            return cat_false;
+        }
+        waiter.async = cat_async_create(NULL);
+        if (unlikely(waiter.async == NULL)) {
+            cat_update_last_error_with_previous("Thread channel wait %s failed", name);
+            return cat_false;
+        }
+        waiter.notified = cat_false;
+        uv_mutex_lock(&channel->mutex);
+        if (unlikely(cat_atomic_bool_load(&channel->closed))) {
+            uv_mutex_unlock(&channel->mutex);
+            (void) cat_async_close(waiter.async, NULL);
+            continue;
+        }
+        cat_queue_push_back(waiters, &waiter.node);
+        (void) cat_atomic_uint32_fetch_add(waiter_count, 1);
+        uv_mutex_unlock(&channel->mutex);
+        /* check it again after the waiter is visible to peers, or we may miss the notification */
+        if (push ?
+            cat_thread_channel_try_push(channel, data) :
+            cat_thread_channel_try_pop(channel, data)) {
+            cat_thread_channel_cancel_waiter(channel, &waiter, waiters, waiter_count, cat_false);
+            return cat_true;
+        }
+        ret = cat_async_wait_and_close(waiter.async, NULL, timeout);
+        if (unlikely(!ret)) {
+            cat_thread_channel_cancel_waiter(channel, &waiter, waiters, waiter_count, cat_true);
+            cat_update_last_error_with_previous("Thread channel wait %s failed", name);
+            return cat_false;
+        }
+        CAT_ASSERT(waiter.notified);
+        /* other coroutines may take it first, try again */
+        if (timeout > 0) {
+            cat_msec_t now = cat_time_msec();
+            timeout = now < deadline ? (cat_timeout_t) (deadline - now) : 0;
+        }
+    }
+}
+
+CAT_API cat_bool_t cat_thread_channel_push(cat_thread_channel_t *channel, const void *data, cat_timeout_t timeout)
+{
+    return cat_thread_channel_wait(channel, (void *) data, cat_true, timeout);
+}
+
+CAT_API cat_bool_t cat_thread_channel_pop(cat_thread_channel_t *channel, void *data, cat_timeout_t timeout)
+{
+    return cat_thread_channel_wait(channel, data, cat_false, timeout);
+}
+
+CAT_API void cat_thread_channel_close(cat_thread_channel_t *channel)
+{
+    cat_bool_t closed = cat_false;
+
+    if (!cat_atomic_bool_compare_exchange_strong(&channel->closed, &closed, cat_true)) {
+        return;
+    }
+    cat_thread_channel_notify_all(channel, &channel->producers, &channel->producer_count);
+    cat_thread_channel_notify_all(channel, &channel->consumers, &channel->consumer_count);
+}
+
+CAT_API cat_thread_channel_size_t cat_thread_channel_get_capacity(const cat_thread_channel_t *channel)
+{
+    return channel->capacity;
+}
+
+CAT_API cat_thread_channel_size_t cat_thread_channel_get_length(const cat_thread_channel_t *channel)
+{
+    uint32_t head = cat_atomic_uint32_load(&channel->head);
+    uint32_t tail = cat_atomic_uint32_load(&channel->tail);
+    int32_t length = (int32_t) (tail - head);
+
+    /* head may be loaded before concurrent pops */
+    if (length < 0) {
+        return 0;
+    }
+    return CAT_MIN((cat_thread_channel_size_t) length, channel->capacity);
+}
+
+CAT_API size_t cat_thread_channel_get_data_size(const cat_thread_channel_t *channel)
+{
+    return channel->data_size;
+}
+
+CAT_API cat_bool_t cat_thread_channel_is_closed(const cat_thread_channel_t *channel)
+{
+    return cat_atomic_bool_load(&channel->closed);
+}
@@ -104,55 +104,252 @@ CAT_API char *cat_time_format_msec(cat_msec_t msec)
 #undef SECOND
 }
 
-typedef union {
+/* timing wheel */
+
+typedef struct cat_timer_s {
+    cat_queue_node_t node;
+    cat_msec_t expires;
     cat_coroutine_t *coroutine;
-    uv_handle_t handle;
-    uv_timer_t timer;
 } cat_timer_t;
 
-static void cat_timer_callback(uv_timer_t* handle)
+static void cat_time_wheel_callback(uv_timer_t *handle);
+
+static void cat_time_wheel_close(cat_data_t *data)
 {
-    cat_timer_t *timer = (cat_timer_t *) handle;
-    cat_coroutine_t *coroutine = timer->coroutine;
+    cat_time_wheel_t *wheel = &CAT_TIME_G(wheel);
+    (void) data;
 
-    timer->coroutine = NULL;
-    cat_coroutine_schedule(coroutine, TIME, "Timer");
+    CAT_ASSERT(wheel->count == 0 && "Time wheel should be empty");
+    uv_close((uv_handle_t *) &wheel->timer, NULL);
+    wheel->initialized = cat_false;
+}
+
+static void cat_time_wheel_init(cat_time_wheel_t *wheel)
+{
+    size_t level, n;
+
+    (void) uv_timer_init(&CAT_EVENT_G(loop), &wheel->timer);
+    wheel->timer.flags |= UV_HANDLE_INTERNAL;
+    wheel->running = cat_false;
+    wheel->time = CAT_EVENT_G(loop).time;
+    wheel->due = 0;
+    wheel->count = 0;
+    for (n = 0; n < CAT_TIME_WHEEL_ROOT_SIZE; n++) {
+        cat_queue_init(&wheel->root[n]);
+    }
+    for (level = 0; level < CAT_TIME_WHEEL_NODE_LEVELS; level++) {
+        for (n = 0; n < CAT_TIME_WHEEL_NODE_SIZE; n++) {
+            cat_queue_init(&wheel->nodes[level][n]);
+        }
+    }
+    /* the wheel is bound to the event loop, close it with the loop */
+    (void) cat_event_register_runtime_shutdown_task(cat_time_wheel_close, NULL);
+    wheel->initialized = cat_true;
 }
 
-static void cat_timer_close_callback(uv_handle_t *handle)
+static cat_always_inline size_t cat_time_wheel_node_index(cat_msec_t time, size_t level)
 {
-    cat_timer_t *timer = cat_container_of(handle, cat_timer_t, handle);
-    cat_free(timer);
+    return (size_t) ((time >> (CAT_TIME_WHEEL_ROOT_BITS + level * CAT_TIME_WHEEL_NODE_BITS)) & CAT_TIME_WHEEL_NODE_MASK);
 }
 
-static cat_timer_t *cat_timer_wait(cat_msec_t msec)
+static void cat_time_wheel_insert(cat_time_wheel_t *wheel, cat_timer_t *timer)
 {
+    cat_msec_t expires = timer->expires;
+    cat_msec_t delta = expires - wheel->time;
+    cat_queue_t *slot;
+
+    if (unlikely(expires < wheel->time)) {
+        /* already expired, trigger it on the next tick */
+        slot = &wheel->root[wheel->time & CAT_TIME_WHEEL_ROOT_MASK];
+    } else if (delta < CAT_TIME_WHEEL_ROOT_SIZE) {
+        slot = &wheel->root[expires & CAT_TIME_WHEEL_ROOT_MASK];
+    } else {
+        size_t level;
+        if (unlikely(delta > CAT_TIME_WHEEL_MAX_TIMEOUT)) {
+            /* it will be re-inserted when it is cascaded to the root */
+            expires = wheel->time + CAT_TIME_WHEEL_MAX_TIMEOUT;
+            delta = CAT_TIME_WHEEL_MAX_TIMEOUT;
+        }
+        for (level = 0; level < CAT_TIME_WHEEL_NODE_LEVELS - 1; level++) {
+            if (delta < (((cat_msec_t) 1) << (CAT_TIME_WHEEL_ROOT_BITS + (level + 1) * CAT_TIME_WHEEL_NODE_BITS))) {
+                break;
+            }
+        }
+        slot = &wheel->nodes[level][cat_time_wheel_node_index(expires, level)];
+    }
+    cat_queue_push_back(slot, &timer->node);
+}
+
+/* move all timers in the slot of the node level to the lower levels,
+ * return the index of the slot, zero means the upper level also needs to be cascaded */
+static size_t cat_time_wheel_cascade(cat_time_wheel_t *wheel, size_t level)
+{
+    size_t index = cat_time_wheel_node_index(wheel->time, level);
+    cat_queue_t *slot = &wheel->nodes[level][index];
+    cat_queue_t timers;
     cat_timer_t *timer;
-    cat_bool_t ret;
 
-    timer = (cat_timer_t *) cat_malloc(sizeof(*timer));;
-#if CAT_ALLOC_HANDLE_ERRORS
-    if (unlikely(timer == NULL)) {
-        cat_update_last_error_of_syscall("Malloc for timer failed");
-        return NULL;
+    if (cat_queue_empty(slot)) {
+        return index;
+    }
+    /* take all timers out of the slot first, they may be put back to the same level */
+    cat_queue_init(&timers);
+    cat_queue_next(&timers) = cat_queue_next(slot);
+    cat_queue_prev(&timers) = cat_queue_prev(slot);
+    cat_queue_next_prev(&timers) = &timers;
+    cat_queue_prev_next(&timers) = &timers;
+    cat_queue_init(slot);
+    while ((timer = cat_queue_front_data(&timers, cat_timer_t, node))) {
+        cat_queue_remove(&timer->node);
+        cat_time_wheel_insert(wheel, timer);
     }
-#endif
 
-    (void) uv_timer_init(&CAT_EVENT_G(loop), &timer->timer);
-    (void) uv_timer_start(&timer->timer, cat_timer_callback, msec, 0);
+    return index;
+}
+
+static void cat_time_wheel_run(cat_time_wheel_t *wheel, cat_msec_t now)
+{
+    wheel->running = cat_true;
+    while (wheel->time <= now && wheel->count > 0) {
+        size_t index = (size_t) (wheel->time & CAT_TIME_WHEEL_ROOT_MASK);
+        cat_queue_t *slot;
+        cat_timer_t *timer;
+        if (index == 0) {
+            size_t level;
+            for (level = 0; level < CAT_TIME_WHEEL_NODE_LEVELS; level++) {
+                if (cat_time_wheel_cascade(wheel, level) != 0) {
+                    break;
+                }
+            }
+        }
+        slot = &wheel->root[index];
+        wheel->time++;
+        /* Notice: scheduled coroutine may arm or cancel other timers,
+         * so we always fetch the front one of the slot */
+        while ((timer = cat_queue_front_data(slot, cat_timer_t, node))) {
+            cat_coroutine_t *coroutine = timer->coroutine;
+            cat_queue_remove(&timer->node);
+            wheel->count--;
+            timer->coroutine = NULL;
+            cat_coroutine_schedule(coroutine, TIME, "Timer");
+        }
+    }
+    if (wheel->count == 0) {
+        /* nothing in the wheel, we can jump to now directly */
+        wheel->time = now + 1;
+    }
+    wheel->running = cat_false;
+}
+
+static void cat_time_wheel_update(cat_time_wheel_t *wheel)
+{
+    cat_msec_t now = CAT_EVENT_G(loop).time;
+    cat_msec_t due;
+    size_t index, n;
+
+    if (wheel->count == 0) {
+        (void) uv_timer_stop(&wheel->timer);
+        return;
+    }
+    /* find the first non-empty slot of the root level before the next cascade,
+     * if the next tick is the cascade one, it is due right now */
+    index = (size_t) (wheel->time & CAT_TIME_WHEEL_ROOT_MASK);
+    due = wheel->time;
+    if (index != 0) {
+        due = (wheel->time | CAT_TIME_WHEEL_ROOT_MASK) + 1;
+        for (n = index; n < CAT_TIME_WHEEL_ROOT_SIZE; n++) {
+            if (!cat_queue_empty(&wheel->root[n])) {
+                due = wheel->time + (n - index);
+                break;
+            }
+        }
+    }
+    wheel->due = due;
+    (void) uv_timer_start(&wheel->timer, cat_time_wheel_callback, due > now ? due - now : 0, 0);
+}
+
+static void cat_time_wheel_callback(uv_timer_t *handle)
+{
+    cat_time_wheel_t *wheel = cat_container_of(handle, cat_time_wheel_t, timer);
+
+    cat_time_wheel_run(wheel, handle->loop->time);
+    cat_time_wheel_update(wheel);
+}
+
+static void cat_time_wheel_add(cat_time_wheel_t *wheel, cat_timer_t *timer, cat_msec_t msec)
+{
+    cat_msec_t now = CAT_EVENT_G(loop).time;
+
+    if (unlikely(!wheel->initialized)) {
+        cat_time_wheel_init(wheel);
+    }
+    if (wheel->count == 0 && !wheel->running) {
+        /* the wheel may have been idle for a long time */
+        wheel->time = now;
+    }
+    timer->expires = now + msec;
+    if (unlikely(timer->expires < now)) {
+        timer->expires = (cat_msec_t) -1;
+    }
+    cat_time_wheel_insert(wheel, timer);
+    wheel->count++;
+    if (!wheel->running && (wheel->count == 1 || timer->expires < wheel->due)) {
+        cat_time_wheel_update(wheel);
+    }
+}
+
+static void cat_time_wheel_remove(cat_time_wheel_t *wheel, cat_timer_t *timer)
+{
+    cat_queue_remove(&timer->node);
+    wheel->count--;
+    if (wheel->count == 0 && !wheel->running) {
+        /* no more timers, loop need not to be kept alive */
+        (void) uv_timer_stop(&wheel->timer);
+    }
+}
+
+CAT_API CAT_GLOBALS_DECLARE(cat_time);
+
+CAT_GLOBALS_CTOR_DECLARE_SZ(cat_time)
+
+CAT_API cat_bool_t cat_time_module_init(void)
+{
+    CAT_GLOBALS_REGISTER(cat_time);
+
+    CAT_TIME_G(wheel).initialized = cat_false;
+
+    return cat_true;
+}
+
+CAT_API cat_bool_t cat_time_module_shutdown(void)
+{
+    CAT_GLOBALS_UNREGISTER(cat_time);
+
+    return cat_true;
+}
+
+/* return false if yield failed, timer->coroutine is NULL if it was timed out */
+static cat_bool_t cat_timer_wait(cat_timer_t *timer, cat_msec_t msec)
+{
+    cat_time_wheel_t *wheel = &CAT_TIME_G(wheel);
+    cat_bool_t ret;
 
     timer->coroutine = CAT_COROUTINE_G(current);
+    cat_time_wheel_add(wheel, timer, msec);
 
     ret = cat_coroutine_yield(NULL, NULL);
 
-    uv_close(&timer->handle, cat_timer_close_callback);
+    if (timer->coroutine != NULL) {
+        /* canceled (or yield failed) */
+        cat_time_wheel_remove(wheel, timer);
+    }
 
     if (unlikely(!ret)) {
         cat_update_last_error_with_previous("Time sleep failed");
-        return NULL;
+        return cat_false;
     }
 
-    return timer;
+    return cat_true;
 }
 
 static void cat_time_wait_0_callback(cat_event_loop_defer_task_t *task, cat_data_t *data)
@@ -191,11 +388,11 @@ static cat_always_inline cat_bool_t cat_time_wait_impl(cat_timeout_t timeout)
         }
         return cat_true;
     } else {
-        cat_timer_t *timer = cat_timer_wait(timeout);
-        if (unlikely(timer == NULL)) {
+        cat_timer_t timer;
+        if (unlikely(!cat_timer_wait(&timer, timeout))) {
             return cat_false;
         }
-        if (unlikely(timer->coroutine == NULL)) {
+        if (unlikely(timer.coroutine == NULL)) {
             cat_update_last_error(CAT_ETIMEDOUT, "Timed out for " CAT_TIMEOUT_FMT " ms", timeout);
             return cat_false;
         }
@@ -222,11 +419,11 @@ static cat_always_inline cat_ret_t cat_time_delay_impl(cat_timeout_t timeout)
     } else if (timeout == 0) {
         return cat_time_delay_0();
     } else {
-        cat_timer_t *timer = cat_timer_wait(timeout);
-        if (unlikely(timer == NULL)) {
+        cat_timer_t timer;
+        if (unlikely(!cat_timer_wait(&timer, timeout))) {
             return CAT_RET_ERROR;
         }
-        if (timer->coroutine == NULL) {
+        if (timer.coroutine == NULL) {
             return CAT_RET_OK;
         }
     }
@@ -251,22 +448,20 @@ static cat_always_inline cat_msec_t cat_time_msleep_impl(cat_msec_t msec)
         (void) cat_time_delay_0();
         // even if error, the number of seconds left to sleep is always 0...
     } else {
-        cat_timer_t *timer;
-
-        timer = cat_timer_wait(msec);
+        cat_timer_t timer;
 
-        if (unlikely(timer == NULL)) {
+        if (unlikely(!cat_timer_wait(&timer, msec))) {
             return msec;
         }
 
-        if (unlikely(timer->coroutine != NULL)) {
+        if (unlikely(timer.coroutine != NULL)) {
             cat_update_last_error(CAT_ECANCELED, "Time waiter has been canceled");
-            if (unlikely(timer->timer.timeout <= CAT_EVENT_G(loop).time)) {
+            if (unlikely(timer.expires <= CAT_EVENT_G(loop).time)) {
                 /* blocking IO lead it to be negative or 0
                 * we can not know the real reserve time */
                 return msec;
             }
-            return timer->timer.timeout - CAT_EVENT_G(loop).time;
+            return timer.expires - CAT_EVENT_G(loop).time;
         }
     }
 
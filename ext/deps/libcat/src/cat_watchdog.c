@@ -20,6 +20,8 @@
 
 CAT_API CAT_GLOBALS_DECLARE(cat_watchdog);
 
+CAT_GLOBALS_CTOR_DECLARE_SZ(cat_watchdog)
+
 static cat_timeout_t cat_watchdog_align_quantum(cat_timeout_t quantum)
 {
     if (quantum <= 0) {
@@ -17,6 +17,7 @@
  */
 
 #include "cat_websocket.h"
+#include "cat_atomic.h"
 
 CAT_API const char* cat_websocket_opcode_get_name(cat_websocket_opcode_t opcode)
 {
@@ -213,6 +214,248 @@ static void cat_websocket_mask2(const char *from, char *to, uint64_t length, con
     }
 }
 
+/* SIMD kernels, they are selected at runtime by CPU detection on x86,
+ * NEON is a part of the baseline on aarch64, so it is selected at compile time */
+
+#if (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)) && \
+    (defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER))
+# define CAT_WEBSOCKET_MASK_X86 1
+# include <immintrin.h>
+# if defined(_MSC_VER) && !defined(__clang__)
+#  include <intrin.h>
+#  define CAT_WEBSOCKET_MASK_TARGET(features)
+# else
+#  define CAT_WEBSOCKET_MASK_TARGET(features) __attribute__((target(features)))
+# endif
+#elif defined(__aarch64__) || defined(_M_ARM64) || (defined(__ARM_NEON) && defined(__ARM_ARCH) && __ARM_ARCH >= 7)
+# define CAT_WEBSOCKET_MASK_NEON 1
+# include <arm_neon.h>
+#endif
+
+/* the masking key which starts at the index, as it is in memory */
+static cat_always_inline uint32_t cat_websocket_masking_key_rotate(const char *masking_key, uint64_t index)
+{
+    char rotated_masking_key[CAT_WEBSOCKET_MASKING_KEY_LENGTH];
+    uint32_t masking_key_u32;
+    uint8_t i;
+
+    for (i = 0; i < CAT_WEBSOCKET_MASKING_KEY_LENGTH; i++) {
+        rotated_masking_key[i] = masking_key[(index + i) & (CAT_WEBSOCKET_MASKING_KEY_LENGTH - 1)];
+    }
+    memcpy(&masking_key_u32, rotated_masking_key, sizeof(masking_key_u32));
+
+    return masking_key_u32;
+}
+
+/* Kernels align the destination with scalar steps first (only if there is enough data),
+ * and the vector width is a multiple of the masking key length,
+ * so the rotated masking key stays valid for the whole vector loop,
+ * and the remaining tail is handled by scalar steps again. */
+#define CAT_WEBSOCKET_MASK_KERNEL_HEAD(width) \
+    const char *to_end = to + length; \
+    if (length >= (width) * 2) { \
+        for (; ((uintptr_t) to & ((width) - 1)) != 0; from++, to++, index++) { \
+            *to = *from ^ masking_key[index & (CAT_WEBSOCKET_MASKING_KEY_LENGTH - 1)]; \
+        } \
+    }
+
+#define CAT_WEBSOCKET_MASK_KERNEL_TAIL() \
+    for (; to < to_end; index++, to++, from++) { \
+        *to = *from ^ masking_key[index & (CAT_WEBSOCKET_MASKING_KEY_LENGTH - 1)]; \
+    }
+
+#ifdef CAT_WEBSOCKET_MASK_X86
+static CAT_WEBSOCKET_MASK_TARGET("sse2") void cat_websocket_mask_sse2(const char *from, char *to, uint64_t length, const char *masking_key, uint64_t index)
+{
+    CAT_WEBSOCKET_MASK_KERNEL_HEAD(16);
+    if ((uint64_t) (to_end - to) >= 16) {
+        const __m128i masking_key_m128 = _mm_set1_epi32((int) cat_websocket_masking_key_rotate(masking_key, index));
+        for (; to_end - to >= 64; from += 64, to += 64) {
+            __m128i data0 = _mm_loadu_si128((const __m128i *) (from + 0));
+            __m128i data1 = _mm_loadu_si128((const __m128i *) (from + 16));
+            __m128i data2 = _mm_loadu_si128((const __m128i *) (from + 32));
+            __m128i data3 = _mm_loadu_si128((const __m128i *) (from + 48));
+            _mm_storeu_si128((__m128i *) (to + 0), _mm_xor_si128(data0, masking_key_m128));
+            _mm_storeu_si128((__m128i *) (to + 16), _mm_xor_si128(data1, masking_key_m128));
+            _mm_storeu_si128((__m128i *) (to + 32), _mm_xor_si128(data2, masking_key_m128));
+            _mm_storeu_si128((__m128i *) (to + 48), _mm_xor_si128(data3, masking_key_m128));
+        }
+        for (; to_end - to >= 16; from += 16, to += 16) {
+            __m128i data = _mm_loadu_si128((const __m128i *) from);
+            _mm_storeu_si128((__m128i *) to, _mm_xor_si128(data, masking_key_m128));
+        }
+    }
+    CAT_WEBSOCKET_MASK_KERNEL_TAIL();
+}
+
+static CAT_WEBSOCKET_MASK_TARGET("avx2") void cat_websocket_mask_avx2(const char *from, char *to, uint64_t length, const char *masking_key, uint64_t index)
+{
+    CAT_WEBSOCKET_MASK_KERNEL_HEAD(32);
+    if ((uint64_t) (to_end - to) >= 32) {
+        const __m256i masking_key_m256 = _mm256_set1_epi32((int) cat_websocket_masking_key_rotate(masking_key, index));
+        for (; to_end - to >= 128; from += 128, to += 128) {
+            __m256i data0 = _mm256_loadu_si256((const __m256i *) (from + 0));
+            __m256i data1 = _mm256_loadu_si256((const __m256i *) (from + 32));
+            __m256i data2 = _mm256_loadu_si256((const __m256i *) (from + 64));
+            __m256i data3 = _mm256_loadu_si256((const __m256i *) (from + 96));
+            _mm256_storeu_si256((__m256i *) (to + 0), _mm256_xor_si256(data0, masking_key_m256));
+            _mm256_storeu_si256((__m256i *) (to + 32), _mm256_xor_si256(data1, masking_key_m256));
+            _mm256_storeu_si256((__m256i *) (to + 64), _mm256_xor_si256(data2, masking_key_m256));
+            _mm256_storeu_si256((__m256i *) (to + 96), _mm256_xor_si256(data3, masking_key_m256));
+        }
+        for (; to_end - to >= 32; from += 32, to += 32) {
+            __m256i data = _mm256_loadu_si256((const __m256i *) from);
+            _mm256_storeu_si256((__m256i *) to, _mm256_xor_si256(data, masking_key_m256));
+        }
+        if (to_end - to >= 16) {
+            __m128i data = _mm_loadu_si128((const __m128i *) from);
+            _mm_storeu_si128((__m128i *) to, _mm_xor_si128(data, _mm256_castsi256_si128(masking_key_m256)));
+            from += 16;
+            to += 16;
+        }
+    }
+    CAT_WEBSOCKET_MASK_KERNEL_TAIL();
+}
+
+static cat_bool_t cat_websocket_cpu_supports_sse2(void)
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    return cat_true; /* it is a part of the baseline of x86_64 */
+#elif defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+#else
+    return __builtin_cpu_supports("sse2") != 0;
+#endif
+}
+
+static cat_bool_t cat_websocket_cpu_supports_avx2(void)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return cat_false;
+    }
+    __cpuid(info, 1);
+    /* OSXSAVE and AVX, then check whether OS saves the YMM state */
+    if ((info[2] & ((1 << 27) | (1 << 28))) != ((1 << 27) | (1 << 28)) ||
+        (_xgetbv(0) & 0x6) != 0x6) {
+        return cat_false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+#endif /* CAT_WEBSOCKET_MASK_X86 */
+
+#ifdef CAT_WEBSOCKET_MASK_NEON
+static void cat_websocket_mask_neon(const char *from, char *to, uint64_t length, const char *masking_key, uint64_t index)
+{
+    CAT_WEBSOCKET_MASK_KERNEL_HEAD(16);
+    if ((uint64_t) (to_end - to) >= 16) {
+        const uint8x16_t masking_key_u8x16 = vreinterpretq_u8_u32(vdupq_n_u32(cat_websocket_masking_key_rotate(masking_key, index)));
+        for (; to_end - to >= 64; from += 64, to += 64) {
+            uint8x16_t data0 = vld1q_u8((const uint8_t *) (from + 0));
+            uint8x16_t data1 = vld1q_u8((const uint8_t *) (from + 16));
+            uint8x16_t data2 = vld1q_u8((const uint8_t *) (from + 32));
+            uint8x16_t data3 = vld1q_u8((const uint8_t *) (from + 48));
+            vst1q_u8((uint8_t *) (to + 0), veorq_u8(data0, masking_key_u8x16));
+            vst1q_u8((uint8_t *) (to + 16), veorq_u8(data1, masking_key_u8x16));
+            vst1q_u8((uint8_t *) (to + 32), veorq_u8(data2, masking_key_u8x16));
+            vst1q_u8((uint8_t *) (to + 48), veorq_u8(data3, masking_key_u8x16));
+        }
+        for (; to_end - to >= 16; from += 16, to += 16) {
+            uint8x16_t data = vld1q_u8((const uint8_t *) from);
+            vst1q_u8((uint8_t *) to, veorq_u8(data, masking_key_u8x16));
+        }
+    }
+    CAT_WEBSOCKET_MASK_KERNEL_TAIL();
+}
+#endif /* CAT_WEBSOCKET_MASK_NEON */
+
+#undef CAT_WEBSOCKET_MASK_KERNEL_HEAD
+#undef CAT_WEBSOCKET_MASK_KERNEL_TAIL
+
+/* the detected kernel is selected once per process, and the forced one is
+ * stored atomically (AUTO means not forced), so that threads never race on it */
+static uv_once_t cat_websocket_mask_kernel_detect_once = UV_ONCE_INIT;
+static cat_websocket_mask_kernel_t cat_websocket_mask_kernel_detected = CAT_WEBSOCKET_MASK_KERNEL_SCALAR;
+static cat_atomic_uint32_t cat_websocket_mask_kernel_forced = { CAT_WEBSOCKET_MASK_KERNEL_AUTO };
+
+CAT_API const char *cat_websocket_mask_kernel_get_name(cat_websocket_mask_kernel_t kernel)
+{
+    switch (kernel) {
+#define CAT_WEBSOCKET_MASK_KERNEL_NAME_GEN(name, value, description) case CAT_WEBSOCKET_MASK_KERNEL_##name: return description;
+        CAT_WEBSOCKET_MASK_KERNEL_MAP(CAT_WEBSOCKET_MASK_KERNEL_NAME_GEN)
+#undef CAT_WEBSOCKET_MASK_KERNEL_NAME_GEN
+    }
+    return "unknown";
+}
+
+CAT_API cat_bool_t cat_websocket_mask_kernel_is_supported(cat_websocket_mask_kernel_t kernel)
+{
+    switch (kernel) {
+        case CAT_WEBSOCKET_MASK_KERNEL_AUTO:
+        case CAT_WEBSOCKET_MASK_KERNEL_SCALAR:
+            return cat_true;
+#ifdef CAT_WEBSOCKET_MASK_X86
+        case CAT_WEBSOCKET_MASK_KERNEL_SSE2:
+            return cat_websocket_cpu_supports_sse2();
+        case CAT_WEBSOCKET_MASK_KERNEL_AVX2:
+            return cat_websocket_cpu_supports_avx2();
+#endif
+#ifdef CAT_WEBSOCKET_MASK_NEON
+        case CAT_WEBSOCKET_MASK_KERNEL_NEON:
+            return cat_true;
+#endif
+        default:
+            return cat_false;
+    }
+}
+
+static void cat_websocket_mask_kernel_detect(void)
+{
+    cat_websocket_mask_kernel_t kernel = CAT_WEBSOCKET_MASK_KERNEL_SCALAR;
+#ifdef CAT_WEBSOCKET_MASK_X86
+    if (cat_websocket_cpu_supports_avx2()) {
+        kernel = CAT_WEBSOCKET_MASK_KERNEL_AVX2;
+    } else if (cat_websocket_cpu_supports_sse2()) {
+        kernel = CAT_WEBSOCKET_MASK_KERNEL_SSE2;
+    }
+#endif
+#ifdef CAT_WEBSOCKET_MASK_NEON
+    kernel = CAT_WEBSOCKET_MASK_KERNEL_NEON;
+#endif
+    cat_websocket_mask_kernel_detected = kernel;
+}
+
+CAT_API cat_websocket_mask_kernel_t cat_websocket_get_mask_kernel(void)
+{
+    cat_websocket_mask_kernel_t kernel = (cat_websocket_mask_kernel_t) cat_atomic_uint32_load(&cat_websocket_mask_kernel_forced);
+
+    if (kernel == CAT_WEBSOCKET_MASK_KERNEL_AUTO) {
+        uv_once(&cat_websocket_mask_kernel_detect_once, cat_websocket_mask_kernel_detect);
+        kernel = cat_websocket_mask_kernel_detected;
+    }
+
+    return kernel;
+}
+
+CAT_API cat_bool_t cat_websocket_set_mask_kernel(cat_websocket_mask_kernel_t kernel)
+{
+    if (unlikely(!cat_websocket_mask_kernel_is_supported(kernel))) {
+        cat_update_last_error(CAT_ENOTSUP, "WebSocket mask kernel \"%s\" is not supported on this platform", cat_websocket_mask_kernel_get_name(kernel));
+        return cat_false;
+    }
+    cat_atomic_uint32_store(&cat_websocket_mask_kernel_forced, (uint32_t) kernel);
+
+    return cat_true;
+}
+
 CAT_API void cat_websocket_mask(const char *from, char *to, uint64_t length, const char *masking_key)
 {
     cat_websocket_mask_ex(from, to, length, masking_key, 0);
@@ -225,18 +468,37 @@ CAT_API void cat_websocket_unmask(char *data, uint64_t length, const char *maski
 
 CAT_API void cat_websocket_mask_ex(const char *from, char *to, uint64_t length, const char *masking_key, uint64_t index)
 {
-    cat_bool_t masking_key_is_empty = masking_key == NULL || memcmp(masking_key, CAT_STRS(CAT_WEBSOCKET_EMPTY_MASKING_KEY)) == 0;
+    cat_bool_t masking_key_is_empty = masking_key == NULL || memcmp(masking_key, CAT_WEBSOCKET_EMPTY_MASKING_KEY, CAT_WEBSOCKET_MASKING_KEY_LENGTH) == 0;
 
-    if (from == to) {
-        if (!masking_key_is_empty) {
-            cat_websocket_mask1(to, length, masking_key, index);
-        }
-    } else {
-        if (masking_key_is_empty) {
+    if (masking_key_is_empty) {
+        if (from != to) {
             memmove(to, from, length);
-        } else {
-            cat_websocket_mask2(from, to, length, masking_key, index);
         }
+        return;
+    }
+    if (length >= CAT_WEBSOCKET_MASK_SIMD_MIN_LENGTH) {
+        switch (cat_websocket_get_mask_kernel()) {
+#ifdef CAT_WEBSOCKET_MASK_X86
+            case CAT_WEBSOCKET_MASK_KERNEL_SSE2:
+                cat_websocket_mask_sse2(from, to, length, masking_key, index);
+                return;
+            case CAT_WEBSOCKET_MASK_KERNEL_AVX2:
+                cat_websocket_mask_avx2(from, to, length, masking_key, index);
+                return;
+#endif
+#ifdef CAT_WEBSOCKET_MASK_NEON
+            case CAT_WEBSOCKET_MASK_KERNEL_NEON:
+                cat_websocket_mask_neon(from, to, length, masking_key, index);
+                return;
+#endif
+            default:
+                break;
+        }
+    }
+    if (from == to) {
+        cat_websocket_mask1(to, length, masking_key, index);
+    } else {
+        cat_websocket_mask2(from, to, length, masking_key, index);
     }
 }
 
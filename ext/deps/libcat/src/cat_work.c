@@ -20,6 +20,19 @@
 #include "cat_coroutine.h"
 #include "cat_event.h"
 #include "cat_time.h"
+#include "cat_env.h"
+
+#ifdef CAT_IDE_HELPER
+#include "uv-common.h"
+#else
+#include "../deps/libuv/src/uv-common.h"
+#endif
+
+CAT_API CAT_GLOBALS_DECLARE(cat_work);
+
+CAT_GLOBALS_CTOR_DECLARE_SZ(cat_work)
+
+/* libuv thread pool (fallback) */
 
 typedef struct cat_work_context_s {
     union {
@@ -54,7 +67,7 @@ static void cat_work_after_done(uv_work_t *request, int status)
     cat_free(context);
 }
 
-CAT_API cat_bool_t cat_work(cat_work_kind_t kind, cat_work_function_t function, cat_work_cleanup_callback_t cleanup, cat_data_t *data, cat_timeout_t timeout)
+static cat_bool_t cat_work_on_loop(cat_work_kind_t kind, cat_work_function_t function, cat_work_cleanup_callback_t cleanup, cat_data_t *data, cat_timeout_t timeout)
 {
     cat_work_context_t *context = (cat_work_context_t *) cat_malloc(sizeof(*context));
     cat_bool_t ret;
@@ -88,3 +101,729 @@ CAT_API cat_bool_t cat_work(cat_work_kind_t kind, cat_work_function_t function,
 
     return cat_true;
 }
+
+/* executor
+ * A process-wide pool of worker threads, every worker owns a bounded lock-free
+ * (Vyukov MPMC) queue per lane, works are distributed to them in round-robin,
+ * and idle workers steal works from the queues of others.
+ * Lanes are served by priority (FS > DNS > CPU), and the number of running
+ * DNS and CPU works is limited, so that they can not starve the FS lane.
+ * Results are sent back to the event loop which submitted the work by an uv_async_t. */
+
+#define CAT_WORK_EXECUTOR_CACHE_LINE_SIZE 64
+
+enum cat_work_task_state_e {
+    CAT_WORK_TASK_STATE_QUEUED,
+    CAT_WORK_TASK_STATE_RUNNING,
+    CAT_WORK_TASK_STATE_CANCELED,
+};
+
+enum cat_work_executor_state_e {
+    CAT_WORK_EXECUTOR_STATE_NONE,
+    CAT_WORK_EXECUTOR_STATE_RUNNING,
+    CAT_WORK_EXECUTOR_STATE_UNAVAILABLE,
+};
+
+typedef struct cat_work_task_s {
+    /* node of overflow queue or completed queue */
+    cat_queue_node_t node;
+    cat_work_runtime_t *runtime;
+    cat_coroutine_t *coroutine;
+    cat_work_function_t function;
+    cat_work_cleanup_callback_t cleanup;
+    cat_data_t *data;
+    cat_work_kind_t kind;
+    cat_atomic_uint32_t state;
+    int status;
+    cat_nsec_t queued_time;
+} cat_work_task_t;
+
+struct cat_work_runtime_s {
+    uv_async_t async;
+    uv_mutex_t mutex;
+    cat_queue_t completed_tasks;
+    /* only accessed on the event loop thread */
+    size_t pending_count;
+    cat_bool_t closing;
+};
+
+typedef struct cat_work_queue_cell_s {
+    cat_atomic_uint32_t sequence;
+    cat_work_task_t *task;
+} cat_work_queue_cell_t;
+
+typedef struct cat_work_queue_s {
+    cat_atomic_uint32_t tail;
+    char padding1[CAT_WORK_EXECUTOR_CACHE_LINE_SIZE - sizeof(cat_atomic_uint32_t)];
+    cat_atomic_uint32_t head;
+    char padding2[CAT_WORK_EXECUTOR_CACHE_LINE_SIZE - sizeof(cat_atomic_uint32_t)];
+    cat_work_queue_cell_t cells[CAT_WORK_EXECUTOR_QUEUE_SIZE];
+} cat_work_queue_t;
+
+typedef struct cat_work_worker_s {
+    cat_work_queue_t queues[CAT_WORK_KIND_COUNT];
+    uv_thread_t thread;
+    uint32_t id;
+} cat_work_worker_t;
+
+typedef struct cat_work_lane_s {
+    cat_atomic_uint64_t submitted;
+    cat_atomic_uint64_t completed;
+    cat_atomic_uint64_t canceled;
+    cat_atomic_uint64_t stolen;
+    cat_atomic_uint64_t overflowed;
+    cat_atomic_uint64_t wait_time;
+    cat_atomic_uint64_t run_time;
+    cat_atomic_uint32_t queued;
+    cat_atomic_uint32_t max_queued;
+    cat_atomic_uint32_t running;
+    cat_atomic_uint32_t max_running;
+    uint32_t running_limit;
+    /* protected by executor mutex */
+    cat_atomic_uint32_t overflow_count;
+    cat_queue_t overflow_tasks;
+} cat_work_lane_t;
+
+typedef struct cat_work_executor_s {
+    cat_atomic_uint32_t state;
+    cat_work_worker_t *workers;
+    uint32_t count;
+    cat_atomic_uint32_t next;
+    /* it is increased on every submission, workers never sleep if it was changed during the scan */
+    cat_atomic_uint32_t generation;
+    cat_atomic_uint32_t idle_count;
+    cat_atomic_bool_t stop;
+    uv_mutex_t mutex;
+    uv_cond_t cond;
+    cat_work_lane_t lanes[CAT_WORK_KIND_COUNT];
+} cat_work_executor_t;
+
+static cat_work_executor_t cat_work_executor;
+/* set by cat_work_set_thread_count(), 0 means it was not configured */
+static cat_atomic_uint32_t cat_work_executor_configured_count;
+static uv_mutex_t cat_work_executor_start_mutex;
+static uv_once_t cat_work_executor_once = UV_ONCE_INIT;
+
+static const cat_work_kind_t cat_work_lane_priorities[CAT_WORK_KIND_COUNT] = {
+    CAT_WORK_KIND_FS,
+    CAT_WORK_KIND_DNS,
+    CAT_WORK_KIND_CPU,
+};
+
+static cat_always_inline void cat_work_atomic_uint32_update_max(cat_atomic_uint32_t *max, uint32_t value)
+{
+    uint32_t current = cat_atomic_uint32_load(max);
+
+    while (value > current && !cat_atomic_uint32_compare_exchange_weak(max, &current, value));
+}
+
+static void cat_work_queue_init(cat_work_queue_t *queue)
+{
+    uint32_t n;
+
+    for (n = 0; n < CAT_WORK_EXECUTOR_QUEUE_SIZE; n++) {
+        cat_atomic_uint32_init(&queue->cells[n].sequence, n);
+        queue->cells[n].task = NULL;
+    }
+    cat_atomic_uint32_init(&queue->tail, 0);
+    cat_atomic_uint32_init(&queue->head, 0);
+}
+
+static cat_bool_t cat_work_queue_push(cat_work_queue_t *queue, cat_work_task_t *task)
+{
+    cat_work_queue_cell_t *cell;
+    uint32_t position = cat_atomic_uint32_load(&queue->tail);
+
+    while (1) {
+        int32_t diff;
+        cell = &queue->cells[position & (CAT_WORK_EXECUTOR_QUEUE_SIZE - 1)];
+        diff = (int32_t) (cat_atomic_uint32_load(&cell->sequence) - position);
+        if (diff == 0) {
+            if (cat_atomic_uint32_compare_exchange_weak(&queue->tail, &position, position + 1)) {
+                break;
+            }
+        } else if (diff < 0) {
+            /* full */
+            return cat_false;
+        } else {
+            position = cat_atomic_uint32_load(&queue->tail);
+        }
+    }
+    cell->task = task;
+    cat_atomic_uint32_store(&cell->sequence, position + 1);
+
+    return cat_true;
+}
+
+static cat_work_task_t *cat_work_queue_pop(cat_work_queue_t *queue)
+{
+    cat_work_queue_cell_t *cell;
+    cat_work_task_t *task;
+    uint32_t position = cat_atomic_uint32_load(&queue->head);
+
+    while (1) {
+        int32_t diff;
+        cell = &queue->cells[position & (CAT_WORK_EXECUTOR_QUEUE_SIZE - 1)];
+        diff = (int32_t) (cat_atomic_uint32_load(&cell->sequence) - (position + 1));
+        if (diff == 0) {
+            if (cat_atomic_uint32_compare_exchange_weak(&queue->head, &position, position + 1)) {
+                break;
+            }
+        } else if (diff < 0) {
+            /* empty */
+            return NULL;
+        } else {
+            position = cat_atomic_uint32_load(&queue->head);
+        }
+    }
+    task = cell->task;
+    cat_atomic_uint32_store(&cell->sequence, position + CAT_WORK_EXECUTOR_QUEUE_SIZE);
+
+    return task;
+}
+
+static void cat_work_runtime_complete(cat_work_task_t *task)
+{
+    cat_work_runtime_t *runtime = task->runtime;
+
+    uv_mutex_lock(&runtime->mutex);
+    cat_queue_push_back(&runtime->completed_tasks, &task->node);
+    /* send it with lock held, runtime may be released as soon as the task is done */
+    (void) uv_async_send(&runtime->async);
+    uv_mutex_unlock(&runtime->mutex);
+}
+
+static cat_work_task_t *cat_work_executor_take(cat_work_executor_t *executor, cat_work_worker_t *worker)
+{
+    size_t n;
+
+    for (n = 0; n < CAT_WORK_KIND_COUNT; n++) {
+        cat_work_kind_t kind = cat_work_lane_priorities[n];
+        cat_work_lane_t *lane = &executor->lanes[kind];
+        cat_work_task_t *task;
+        uint32_t running, i;
+
+        if (cat_atomic_uint32_load(&lane->queued) == 0) {
+            continue;
+        }
+        /* reserve a running slot of the lane before taking */
+        running = cat_atomic_uint32_fetch_add(&lane->running, 1);
+        if (running >= lane->running_limit) {
+            (void) cat_atomic_uint32_fetch_sub(&lane->running, 1);
+            continue;
+        }
+        task = cat_work_queue_pop(&worker->queues[kind]);
+        if (task == NULL) {
+            for (i = 1; i < executor->count; i++) {
+                cat_work_worker_t *victim = &executor->workers[(worker->id + i) % executor->count];
+                task = cat_work_queue_pop(&victim->queues[kind]);
+                if (task != NULL) {
+                    (void) cat_atomic_uint64_fetch_add(&lane->stolen, 1);
+                    break;
+                }
+            }
+        }
+        if (task == NULL && cat_atomic_uint32_load(&lane->overflow_count) != 0) {
+            uv_mutex_lock(&executor->mutex);
+            task = cat_queue_front_data(&lane->overflow_tasks, cat_work_task_t, node);
+            if (task != NULL) {
+                cat_queue_remove(&task->node);
+                (void) cat_atomic_uint32_fetch_sub(&lane->overflow_count, 1);
+            }
+            uv_mutex_unlock(&executor->mutex);
+        }
+        if (task != NULL) {
+            (void) cat_atomic_uint32_fetch_sub(&lane->queued, 1);
+            cat_work_atomic_uint32_update_max(&lane->max_running, running + 1);
+            return task;
+        }
+        (void) cat_atomic_uint32_fetch_sub(&lane->running, 1);
+    }
+
+    return NULL;
+}
+
+static void cat_work_executor_run(cat_work_executor_t *executor, cat_work_task_t *task)
+{
+    cat_work_lane_t *lane = &executor->lanes[task->kind];
+    cat_nsec_t start = cat_time_nsec();
+    uint32_t state = CAT_WORK_TASK_STATE_QUEUED;
+
+    (void) cat_atomic_uint64_fetch_add(&lane->wait_time, start - task->queued_time);
+    if (cat_atomic_uint32_compare_exchange_strong(&task->state, &state, CAT_WORK_TASK_STATE_RUNNING)) {
+        task->function(task->data);
+        task->status = 0;
+        (void) cat_atomic_uint64_fetch_add(&lane->run_time, cat_time_nsec() - start);
+        (void) cat_atomic_uint64_fetch_add(&lane->completed, 1);
+    } else {
+        /* it was canceled by the waiter */
+        task->status = CAT_ECANCELED;
+        (void) cat_atomic_uint64_fetch_add(&lane->canceled, 1);
+    }
+    (void) cat_atomic_uint32_fetch_sub(&lane->running, 1);
+
+    cat_work_runtime_complete(task);
+}
+
+static void cat_work_executor_loop(void *arg)
+{
+    cat_work_worker_t *worker = (cat_work_worker_t *) arg;
+    cat_work_executor_t *executor = &cat_work_executor;
+
+    while (1) {
+        uint32_t generation = cat_atomic_uint32_load(&executor->generation);
+        cat_work_task_t *task = cat_work_executor_take(executor, worker);
+        if (task != NULL) {
+            cat_work_executor_run(executor, task);
+            continue;
+        }
+        uv_mutex_lock(&executor->mutex);
+        if (cat_atomic_bool_load(&executor->stop)) {
+            uv_mutex_unlock(&executor->mutex);
+            break;
+        }
+        (void) cat_atomic_uint32_fetch_add(&executor->idle_count, 1);
+        if (cat_atomic_uint32_load(&executor->generation) == generation) {
+            uv_cond_wait(&executor->cond, &executor->mutex);
+        }
+        (void) cat_atomic_uint32_fetch_sub(&executor->idle_count, 1);
+        uv_mutex_unlock(&executor->mutex);
+    }
+}
+
+static void cat_work_executor_submit(cat_work_executor_t *executor, cat_work_task_t *task)
+{
+    cat_work_lane_t *lane = &executor->lanes[task->kind];
+    uint32_t index, n;
+
+    (void) cat_atomic_uint64_fetch_add(&lane->submitted, 1);
+    /* count it before pushing, so that it never underflows */
+    cat_work_atomic_uint32_update_max(&lane->max_queued, cat_atomic_uint32_fetch_add(&lane->queued, 1) + 1);
+    task->queued_time = cat_time_nsec();
+
+    index = cat_atomic_uint32_fetch_add(&executor->next, 1);
+    for (n = 0; n < executor->count; n++) {
+        cat_work_worker_t *worker = &executor->workers[(index + n) % executor->count];
+        if (cat_work_queue_push(&worker->queues[task->kind], task)) {
+            goto _notify;
+        }
+    }
+    /* all lock-free queues are full */
+    (void) cat_atomic_uint64_fetch_add(&lane->overflowed, 1);
+    uv_mutex_lock(&executor->mutex);
+    cat_queue_push_back(&lane->overflow_tasks, &task->node);
+    (void) cat_atomic_uint32_fetch_add(&lane->overflow_count, 1);
+    uv_mutex_unlock(&executor->mutex);
+
+    _notify:
+    (void) cat_atomic_uint32_fetch_add(&executor->generation, 1);
+    if (cat_atomic_uint32_load(&executor->idle_count) != 0) {
+        uv_mutex_lock(&executor->mutex);
+        uv_cond_signal(&executor->cond);
+        uv_mutex_unlock(&executor->mutex);
+    }
+}
+
+static uint32_t cat_work_executor_get_configured_thread_count(void)
+{
+    int count = (int) cat_atomic_uint32_load(&cat_work_executor_configured_count);
+
+    if (count == 0) {
+        count = cat_env_get_i("CAT_WORK_THREADS", CAT_WORK_EXECUTOR_DEFAULT_THREADS);
+    }
+    if (count <= 0) {
+        /* at least 2 threads, so that the FS lane is always available */
+        count = (int) uv_available_parallelism();
+        if (count < 2) {
+            count = 2;
+        }
+    }
+    if (count > CAT_WORK_EXECUTOR_MAX_THREADS) {
+        count = CAT_WORK_EXECUTOR_MAX_THREADS;
+    }
+
+    return (uint32_t) count;
+}
+
+static void cat_work_executor_stop(cat_work_executor_t *executor, uint32_t count)
+{
+    uint32_t n;
+
+    cat_atomic_bool_store(&executor->stop, cat_true);
+    uv_mutex_lock(&executor->mutex);
+    uv_cond_broadcast(&executor->cond);
+    uv_mutex_unlock(&executor->mutex);
+    for (n = 0; n < count; n++) {
+        (void) uv_thread_join(&executor->workers[n].thread);
+    }
+    uv_cond_destroy(&executor->cond);
+    uv_mutex_destroy(&executor->mutex);
+    cat_free(executor->workers);
+    executor->workers = NULL;
+    executor->count = 0;
+}
+
+static cat_bool_t cat_work_executor_start(cat_work_executor_t *executor)
+{
+    uv_thread_options_t options;
+    uint32_t count = cat_work_executor_get_configured_thread_count();
+    uint32_t n;
+    int error;
+
+    executor->workers = (cat_work_worker_t *) cat_malloc(sizeof(*executor->workers) * count);
+#if CAT_ALLOC_HANDLE_ERRORS
+    if (unlikely(executor->workers == NULL)) {
+        cat_update_last_error_of_syscall("Malloc for work executor workers failed");
+        return cat_false;
+    }
+#endif
+    error = uv_mutex_init(&executor->mutex);
+    if (error != 0) {
+        cat_update_last_error_with_reason(error, "Work executor init mutex failed");
+        goto _mutex_init_failed;
+    }
+    error = uv_cond_init(&executor->cond);
+    if (error != 0) {
+        cat_update_last_error_with_reason(error, "Work executor init cond failed");
+        goto _cond_init_failed;
+    }
+    executor->count = count;
+    cat_atomic_uint32_init(&executor->next, 0);
+    cat_atomic_uint32_init(&executor->generation, 0);
+    cat_atomic_uint32_init(&executor->idle_count, 0);
+    cat_atomic_bool_init(&executor->stop, cat_false);
+    for (n = 0; n < CAT_WORK_KIND_COUNT; n++) {
+        cat_work_lane_t *lane = &executor->lanes[n];
+        cat_atomic_uint64_init(&lane->submitted, 0);
+        cat_atomic_uint64_init(&lane->completed, 0);
+        cat_atomic_uint64_init(&lane->canceled, 0);
+        cat_atomic_uint64_init(&lane->stolen, 0);
+        cat_atomic_uint64_init(&lane->overflowed, 0);
+        cat_atomic_uint64_init(&lane->wait_time, 0);
+        cat_atomic_uint64_init(&lane->run_time, 0);
+        cat_atomic_uint32_init(&lane->queued, 0);
+        cat_atomic_uint32_init(&lane->max_queued, 0);
+        cat_atomic_uint32_init(&lane->running, 0);
+        cat_atomic_uint32_init(&lane->max_running, 0);
+        cat_atomic_uint32_init(&lane->overflow_count, 0);
+        cat_queue_init(&lane->overflow_tasks);
+    }
+    executor->lanes[CAT_WORK_KIND_FS].running_limit = count;
+    executor->lanes[CAT_WORK_KIND_DNS].running_limit = (count + 1) / 2;
+    executor->lanes[CAT_WORK_KIND_CPU].running_limit = count - 1;
+    for (n = 0; n < CAT_WORK_KIND_COUNT; n++) {
+        if (executor->lanes[n].running_limit == 0) {
+            executor->lanes[n].running_limit = 1;
+        }
+    }
+
+    options.flags = UV_THREAD_HAS_STACK_SIZE;
+    options.stack_size = CAT_COROUTINE_RECOMMENDED_STACK_SIZE;
+    for (n = 0; n < count; n++) {
+        cat_work_worker_t *worker = &executor->workers[n];
+        size_t i;
+        for (i = 0; i < CAT_WORK_KIND_COUNT; i++) {
+            cat_work_queue_init(&worker->queues[i]);
+        }
+        worker->id = n;
+        error = uv_thread_create_ex(&worker->thread, &options, cat_work_executor_loop, worker);
+        if (error != 0) {
+            cat_update_last_error_with_reason(error, "Work executor create thread failed");
+            cat_work_executor_stop(executor, n);
+            return cat_false;
+        }
+    }
+
+    return cat_true;
+
+    _cond_init_failed:
+    uv_mutex_destroy(&executor->mutex);
+    _mutex_init_failed:
+    cat_free(executor->workers);
+    executor->workers = NULL;
+    return cat_false;
+}
+
+#ifndef CAT_OS_WIN
+static void cat_work_executor_reset(void)
+{
+    /* threads do not exist in the child process,
+     * leak them and start a new executor on demand */
+    cat_atomic_uint32_store(&cat_work_executor.state, CAT_WORK_EXECUTOR_STATE_NONE);
+    cat_work_executor.workers = NULL;
+    cat_work_executor.count = 0;
+    (void) uv_mutex_init(&cat_work_executor_start_mutex);
+}
+#endif
+
+static void cat_work_executor_init_once(void)
+{
+    cat_atomic_uint32_init(&cat_work_executor.state, CAT_WORK_EXECUTOR_STATE_NONE);
+    if (uv_mutex_init(&cat_work_executor_start_mutex) != 0) {
+        abort();
+    }
+#ifndef CAT_OS_WIN
+    if (pthread_atfork(NULL, NULL, &cat_work_executor_reset) != 0) {
+        abort();
+    }
+#endif
+}
+
+static cat_work_executor_t *cat_work_executor_get(void)
+{
+    cat_work_executor_t *executor = &cat_work_executor;
+    uint32_t state;
+
+    uv_once(&cat_work_executor_once, cat_work_executor_init_once);
+    state = cat_atomic_uint32_load(&executor->state);
+    if (likely(state == CAT_WORK_EXECUTOR_STATE_RUNNING)) {
+        return executor;
+    }
+    if (state == CAT_WORK_EXECUTOR_STATE_UNAVAILABLE) {
+        return NULL;
+    }
+    uv_mutex_lock(&cat_work_executor_start_mutex);
+    state = cat_atomic_uint32_load(&executor->state);
+    if (state == CAT_WORK_EXECUTOR_STATE_NONE) {
+        if (cat_work_executor_start(executor)) {
+            state = CAT_WORK_EXECUTOR_STATE_RUNNING;
+        } else {
+            CAT_WARN_WITH_LAST(WORK, "Work executor is unavailable, fallback to the thread pool of event loop");
+            state = CAT_WORK_EXECUTOR_STATE_UNAVAILABLE;
+        }
+        cat_atomic_uint32_store(&executor->state, state);
+    }
+    uv_mutex_unlock(&cat_work_executor_start_mutex);
+
+    return state == CAT_WORK_EXECUTOR_STATE_RUNNING ? executor : NULL;
+}
+
+static void cat_work_runtime_close_callback(uv_handle_t *handle)
+{
+    cat_work_runtime_t *runtime = cat_container_of(handle, cat_work_runtime_t, async);
+
+    uv_mutex_destroy(&runtime->mutex);
+    if (CAT_WORK_G(runtime) == runtime) {
+        CAT_WORK_G(runtime) = NULL;
+    }
+    cat_free(runtime);
+}
+
+static void cat_work_runtime_callback(uv_async_t *handle)
+{
+    cat_work_runtime_t *runtime = cat_container_of(handle, cat_work_runtime_t, async);
+    cat_queue_t tasks;
+    cat_work_task_t *task;
+
+    cat_queue_init(&tasks);
+    uv_mutex_lock(&runtime->mutex);
+    if (!cat_queue_empty(&runtime->completed_tasks)) {
+        cat_queue_t *front = cat_queue_next(&runtime->completed_tasks);
+        cat_queue_t *back = cat_queue_prev(&runtime->completed_tasks);
+        cat_queue_next(&tasks) = front;
+        cat_queue_prev(front) = &tasks;
+        cat_queue_prev(&tasks) = back;
+        cat_queue_next(back) = &tasks;
+        cat_queue_init(&runtime->completed_tasks);
+    }
+    uv_mutex_unlock(&runtime->mutex);
+
+    while ((task = cat_queue_front_data(&tasks, cat_work_task_t, node))) {
+        cat_queue_remove(&task->node);
+        runtime->pending_count--;
+        if (likely(task->coroutine != NULL)) {
+            cat_coroutine_schedule(task->coroutine, WORK, "Work");
+        }
+        if (task->cleanup != NULL) {
+            task->cleanup(task->data);
+        }
+        cat_free(task);
+    }
+
+    if (runtime->pending_count == 0) {
+        if (unlikely(runtime->closing)) {
+            uv_close((uv_handle_t *) &runtime->async, cat_work_runtime_close_callback);
+        } else {
+            /* do not keep the event loop alive if there is no work */
+            uv_unref((uv_handle_t *) &runtime->async);
+        }
+    }
+}
+
+static void cat_work_runtime_shutdown(cat_data_t *data)
+{
+    cat_work_runtime_t *runtime = CAT_WORK_G(runtime);
+    (void) data;
+
+    if (runtime->pending_count == 0) {
+        uv_close((uv_handle_t *) &runtime->async, cat_work_runtime_close_callback);
+    } else {
+        /* close it after the last work is done */
+        runtime->closing = cat_true;
+    }
+}
+
+static cat_work_runtime_t *cat_work_runtime_get(void)
+{
+    cat_work_runtime_t *runtime = CAT_WORK_G(runtime);
+    int error;
+
+    if (likely(runtime != NULL)) {
+        return !runtime->closing ? runtime : NULL;
+    }
+    runtime = (cat_work_runtime_t *) cat_malloc(sizeof(*runtime));
+#if CAT_ALLOC_HANDLE_ERRORS
+    if (unlikely(runtime == NULL)) {
+        return NULL;
+    }
+#endif
+    error = uv_mutex_init(&runtime->mutex);
+    if (unlikely(error != 0)) {
+        cat_free(runtime);
+        return NULL;
+    }
+    error = uv_async_init(&CAT_EVENT_G(loop), &runtime->async, cat_work_runtime_callback);
+    if (unlikely(error != 0)) {
+        uv_mutex_destroy(&runtime->mutex);
+        cat_free(runtime);
+        return NULL;
+    }
+    runtime->async.flags |= UV_HANDLE_INTERNAL;
+    uv_unref((uv_handle_t *) &runtime->async);
+    cat_queue_init(&runtime->completed_tasks);
+    runtime->pending_count = 0;
+    runtime->closing = cat_false;
+    if (unlikely(cat_event_register_runtime_shutdown_task(cat_work_runtime_shutdown, NULL) == NULL)) {
+        uv_close((uv_handle_t *) &runtime->async, cat_work_runtime_close_callback);
+        return NULL;
+    }
+    CAT_WORK_G(runtime) = runtime;
+
+    return runtime;
+}
+
+CAT_API cat_bool_t cat_work_module_init(void)
+{
+    CAT_GLOBALS_REGISTER(cat_work);
+
+    CAT_WORK_G(runtime) = NULL;
+
+    return cat_true;
+}
+
+CAT_API cat_bool_t cat_work_module_shutdown(void)
+{
+    cat_work_executor_t *executor = &cat_work_executor;
+
+    uv_once(&cat_work_executor_once, cat_work_executor_init_once);
+    uv_mutex_lock(&cat_work_executor_start_mutex);
+    if (cat_atomic_uint32_load(&executor->state) == CAT_WORK_EXECUTOR_STATE_RUNNING) {
+        cat_work_executor_stop(executor, executor->count);
+    }
+    cat_atomic_uint32_store(&executor->state, CAT_WORK_EXECUTOR_STATE_NONE);
+    uv_mutex_unlock(&cat_work_executor_start_mutex);
+
+    CAT_GLOBALS_UNREGISTER(cat_work);
+
+    return cat_true;
+}
+
+CAT_API cat_bool_t cat_work(cat_work_kind_t kind, cat_work_function_t function, cat_work_cleanup_callback_t cleanup, cat_data_t *data, cat_timeout_t timeout)
+{
+    cat_work_executor_t *executor = cat_work_executor_get();
+    cat_work_runtime_t *runtime;
+    cat_work_task_t *task;
+    uint32_t state;
+    cat_bool_t ret;
+
+    CAT_ASSERT(kind >= 0 && kind < CAT_WORK_KIND_COUNT);
+    if (unlikely(executor == NULL || (runtime = cat_work_runtime_get()) == NULL)) {
+        return cat_work_on_loop(kind, function, cleanup, data, timeout);
+    }
+    task = (cat_work_task_t *) cat_malloc(sizeof(*task));
+#if CAT_ALLOC_HANDLE_ERRORS
+    if (unlikely(task == NULL)) {
+        cat_update_last_error_of_syscall("Malloc for work task failed");
+        if (cleanup != NULL) {
+            cleanup(data);
+        }
+        return cat_false;
+    }
+#endif
+    task->runtime = runtime;
+    task->coroutine = CAT_COROUTINE_G(current);
+    task->function = function;
+    task->cleanup = cleanup;
+    task->data = data;
+    task->kind = kind;
+    cat_atomic_uint32_init(&task->state, CAT_WORK_TASK_STATE_QUEUED);
+    task->status = CAT_ECANCELED;
+    if (runtime->pending_count++ == 0) {
+        uv_ref((uv_handle_t *) &runtime->async);
+    }
+    cat_work_executor_submit(executor, task);
+    ret = cat_time_wait(timeout);
+    task->coroutine = NULL;
+    if (unlikely(!ret)) {
+        cat_update_last_error_with_previous("Work wait failed");
+        /* it will be skipped if it has not been started yet */
+        state = CAT_WORK_TASK_STATE_QUEUED;
+        (void) cat_atomic_uint32_compare_exchange_strong(&task->state, &state, CAT_WORK_TASK_STATE_CANCELED);
+        return cat_false;
+    }
+    if (unlikely(task->status != 0)) {
+        cat_update_last_error_with_reason(task->status, "Work failed");
+        return cat_false;
+    }
+
+    return cat_true;
+}
+
+CAT_API void cat_work_set_thread_count(uint32_t count)
+{
+    if (count > CAT_WORK_EXECUTOR_MAX_THREADS) {
+        count = CAT_WORK_EXECUTOR_MAX_THREADS;
+    }
+    cat_atomic_uint32_store(&cat_work_executor_configured_count, count);
+}
+
+CAT_API uint32_t cat_work_get_thread_count(void)
+{
+    cat_work_executor_t *executor = &cat_work_executor;
+
+    uv_once(&cat_work_executor_once, cat_work_executor_init_once);
+    if (cat_atomic_uint32_load(&executor->state) != CAT_WORK_EXECUTOR_STATE_RUNNING) {
+        return 0;
+    }
+
+    return executor->count;
+}
+
+CAT_API cat_bool_t cat_work_get_stats(cat_work_kind_t kind, cat_work_stats_t *stats)
+{
+    cat_work_executor_t *executor = &cat_work_executor;
+    cat_work_lane_t *lane;
+
+    if (unlikely(kind < 0 || kind >= CAT_WORK_KIND_COUNT)) {
+        cat_update_last_error(CAT_EINVAL, "Unknown work kind %d", (int) kind);
+        return cat_false;
+    }
+    memset(stats, 0, sizeof(*stats));
+    if (cat_work_get_thread_count() == 0) {
+        return cat_true;
+    }
+    lane = &executor->lanes[kind];
+    stats->submitted = cat_atomic_uint64_load(&lane->submitted);
+    stats->completed = cat_atomic_uint64_load(&lane->completed);
+    stats->canceled = cat_atomic_uint64_load(&lane->canceled);
+    stats->stolen = cat_atomic_uint64_load(&lane->stolen);
+    stats->overflowed = cat_atomic_uint64_load(&lane->overflowed);
+    stats->wait_time = cat_atomic_uint64_load(&lane->wait_time);
+    stats->run_time = cat_atomic_uint64_load(&lane->run_time);
+    stats->queued = cat_atomic_uint32_load(&lane->queued);
+    stats->max_queued = cat_atomic_uint32_load(&lane->max_queued);
+    stats->running = cat_atomic_uint32_load(&lane->running);
+    stats->max_running = cat_atomic_uint32_load(&lane->max_running);
+
+    return cat_true;
+}
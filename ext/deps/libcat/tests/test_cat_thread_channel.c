@@ -0,0 +1,377 @@
+/*
+  +--------------------------------------------------------------------------+
+  | libcat                                                                   |
+  +--------------------------------------------------------------------------+
+  | Licensed under the Apache License, Version 2.0 (the "License");          |
+  | you may not use this file except in compliance with the License.         |
+  | You may obtain a copy of the License at                                  |
+  | http://www.apache.org/licenses/LICENSE-2.0                               |
+  | Unless required by applicable law or agreed to in writing, software      |
+  | distributed under the License is distributed on an "AS IS" BASIS,        |
+  | WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. |
+  | See the License for the specific language governing permissions and      |
+  | limitations under the License. See accompanying LICENSE file.            |
+  +--------------------------------------------------------------------------+
+  | Author: Twosee <twosee@php.net>                                          |
+  +--------------------------------------------------------------------------+
+ */
+
+/* Standalone test of cat_thread_channel, every thread runs its own event loop,
+ * so that libcat must be built with CAT_USE_THREAD_LOCAL (or CAT_USE_THREAD_KEY), e.g.:
+ *   cc -DCAT_USE_THREAD_LOCAL -Iinclude -Ideps/libuv/include \
+ *      tests/test_cat_thread_channel.c libcat.a -lpthread -ldl -lrt -o test_cat_thread_channel
+ * it exits with non-zero status on failure. */
+
+#include "cat_api.h"
+#include "cat_thread_channel.h"
+#include "cat_time.h"
+
+#ifndef CAT_THREAD_SAFE
+#error "test_cat_thread_channel requires thread-safe libcat (CAT_USE_THREAD_LOCAL or CAT_USE_THREAD_KEY)"
+#endif
+
+#define TEST_PRODUCERS 4
+#define TEST_CONSUMERS 4
+#define TEST_ITEMS_PER_PRODUCER 20000
+#define TEST_CAPACITY 4
+
+static int test_failures = 0;
+
+#define TEST_EXPECT(condition) do { \
+    if (!(condition)) { \
+        fprintf(stderr, "%s:%d: expectation failed: %s\n", __FILE__, __LINE__, #condition); \
+        test_failures++; \
+    } \
+} while (0)
+
+typedef struct test_item_s {
+    uint32_t producer;
+    uint32_t sequence;
+} test_item_t;
+
+typedef struct test_worker_s {
+    uv_thread_t thread;
+    uint32_t id;
+    cat_thread_channel_t *channel;
+    /* results */
+    uint64_t count;
+    uint64_t sum;
+    cat_bool_t ordered;
+    int error;
+} test_worker_t;
+
+/* every thread has its own runtime and event loop */
+static void test_thread_enter(void)
+{
+    cat_bool_t ret = cat_runtime_init_all() && cat_run(CAT_RUN_EASY);
+    if (!ret) {
+        fprintf(stderr, "runtime init failed\n");
+        abort();
+    }
+}
+
+static void test_thread_leave(void)
+{
+    (void) cat_stop();
+    (void) cat_runtime_shutdown_all();
+}
+
+static void test_producer(void *arg)
+{
+    test_worker_t *worker = (test_worker_t *) arg;
+    uint32_t n;
+
+    test_thread_enter();
+    for (n = 0; n < TEST_ITEMS_PER_PRODUCER; n++) {
+        test_item_t item = { worker->id, n };
+        if (!cat_thread_channel_push(worker->channel, &item, -1)) {
+            worker->error = cat_get_last_error_code();
+            break;
+        }
+        worker->count++;
+        worker->sum += n;
+    }
+    test_thread_leave();
+}
+
+static void test_consumer(void *arg)
+{
+    test_worker_t *worker = (test_worker_t *) arg;
+    uint32_t last[TEST_PRODUCERS];
+    cat_bool_t seen[TEST_PRODUCERS] = { cat_false };
+    test_item_t item;
+
+    test_thread_enter();
+    worker->ordered = cat_true;
+    /* pop until the channel is closed and drained */
+    while (cat_thread_channel_pop(worker->channel, &item, -1)) {
+        if (item.producer >= TEST_PRODUCERS) {
+            worker->ordered = cat_false;
+            continue;
+        }
+        /* items of the same producer are popped in order by every consumer */
+        if (seen[item.producer] && item.sequence <= last[item.producer]) {
+            worker->ordered = cat_false;
+        }
+        seen[item.producer] = cat_true;
+        last[item.producer] = item.sequence;
+        worker->count++;
+        worker->sum += item.sequence;
+    }
+    worker->error = cat_get_last_error_code();
+    test_thread_leave();
+}
+
+static void test_blocked_push(void *arg)
+{
+    test_worker_t *worker = (test_worker_t *) arg;
+    test_item_t item = { worker->id, 0 };
+
+    test_thread_enter();
+    if (!cat_thread_channel_push(worker->channel, &item, -1)) {
+        worker->error = cat_get_last_error_code();
+    }
+    test_thread_leave();
+}
+
+static void test_blocked_pop(void *arg)
+{
+    test_worker_t *worker = (test_worker_t *) arg;
+    test_item_t item;
+
+    test_thread_enter();
+    if (!cat_thread_channel_pop(worker->channel, &item, -1)) {
+        worker->error = cat_get_last_error_code();
+    }
+    test_thread_leave();
+}
+
+static uint32_t test_destructed = 0;
+
+static void test_dtor(void *data)
+{
+    TEST_EXPECT(((test_item_t *) data)->producer == 0);
+    test_destructed++;
+}
+
+static void test_basic(void)
+{
+    cat_thread_channel_t *channel;
+    test_item_t item;
+    uint32_t n, next;
+
+    TEST_EXPECT(cat_thread_channel_create(0, sizeof(item), NULL) == NULL);
+    TEST_EXPECT(cat_thread_channel_create(CAT_THREAD_CHANNEL_SIZE_MAX + 1, sizeof(item), NULL) == NULL);
+    TEST_EXPECT(cat_thread_channel_create(1, 0, NULL) == NULL);
+
+    /* capacity is rounded up to power of two, a single-cell ring can not tell full from empty */
+    channel = cat_thread_channel_create(1, sizeof(item), NULL);
+    TEST_EXPECT(channel != NULL);
+    TEST_EXPECT(cat_thread_channel_get_capacity(channel) == 2);
+    for (n = 0; n < 2; n++) {
+        item.sequence = n;
+        TEST_EXPECT(cat_thread_channel_try_push(channel, &item));
+    }
+    TEST_EXPECT(!cat_thread_channel_try_push(channel, &item));
+    for (n = 0; n < 2; n++) {
+        TEST_EXPECT(cat_thread_channel_try_pop(channel, &item));
+        TEST_EXPECT(item.sequence == n);
+    }
+    TEST_EXPECT(!cat_thread_channel_try_pop(channel, &item));
+    cat_thread_channel_release(channel);
+    channel = cat_thread_channel_create(3, sizeof(item), NULL);
+    TEST_EXPECT(channel != NULL);
+    TEST_EXPECT(cat_thread_channel_get_capacity(channel) == 4);
+    TEST_EXPECT(cat_thread_channel_get_data_size(channel) == sizeof(item));
+
+    /* the ring buffer wraps around many times, FIFO order is kept */
+    for (n = 0; n < 1000; n++) {
+        uint32_t i;
+        for (i = 0; i < 4; i++) {
+            item.producer = 0;
+            item.sequence = n * 4 + i;
+            TEST_EXPECT(cat_thread_channel_try_push(channel, &item));
+        }
+        TEST_EXPECT(!cat_thread_channel_try_push(channel, &item));
+        TEST_EXPECT(cat_thread_channel_get_length(channel) == 4);
+        for (i = 0; i < 4; i++) {
+            TEST_EXPECT(cat_thread_channel_try_pop(channel, &item));
+            TEST_EXPECT(item.sequence == n * 4 + i);
+        }
+        TEST_EXPECT(!cat_thread_channel_try_pop(channel, &item));
+        TEST_EXPECT(cat_thread_channel_get_length(channel) == 0);
+    }
+    /* head and tail move at different paces, so they are not aligned with the buffer */
+    next = 0;
+    for (n = 0; n < 1000; n++) {
+        item.sequence = n;
+        TEST_EXPECT(cat_thread_channel_try_push(channel, &item));
+        if (n % 3 != 0) {
+            TEST_EXPECT(cat_thread_channel_try_pop(channel, &item));
+            TEST_EXPECT(item.sequence == next++);
+        }
+        TEST_EXPECT(cat_thread_channel_get_length(channel) == n + 1 - next);
+        if (cat_thread_channel_get_length(channel) == 4) {
+            while (cat_thread_channel_try_pop(channel, &item)) {
+                TEST_EXPECT(item.sequence == next++);
+            }
+        }
+    }
+
+    /* wait with timeout */
+    while (cat_thread_channel_try_pop(channel, &item));
+    TEST_EXPECT(!cat_thread_channel_pop(channel, &item, 10));
+    TEST_EXPECT(cat_get_last_error_code() == CAT_ETIMEDOUT);
+    for (n = 0; n < 4; n++) {
+        TEST_EXPECT(cat_thread_channel_try_push(channel, &item));
+    }
+    TEST_EXPECT(!cat_thread_channel_push(channel, &item, 10));
+    TEST_EXPECT(cat_get_last_error_code() == CAT_ETIMEDOUT);
+
+    /* remaining data can be popped after close, but nothing can be pushed */
+    cat_thread_channel_close(channel);
+    TEST_EXPECT(cat_thread_channel_is_closed(channel));
+    TEST_EXPECT(!cat_thread_channel_try_push(channel, &item));
+    TEST_EXPECT(!cat_thread_channel_push(channel, &item, -1));
+    TEST_EXPECT(cat_get_last_error_code() == CAT_ECLOSED);
+    for (n = 0; n < 4; n++) {
+        TEST_EXPECT(cat_thread_channel_pop(channel, &item, -1));
+    }
+    TEST_EXPECT(!cat_thread_channel_pop(channel, &item, -1));
+    TEST_EXPECT(cat_get_last_error_code() == CAT_ECLOSED);
+    cat_thread_channel_release(channel);
+}
+
+static void test_dtor_on_release(void)
+{
+    cat_thread_channel_t *channel = cat_thread_channel_create(4, sizeof(test_item_t), test_dtor);
+    test_item_t item = { 0, 0 };
+    uint32_t n;
+
+    TEST_EXPECT(channel != NULL);
+    for (n = 0; n < 3; n++) {
+        TEST_EXPECT(cat_thread_channel_try_push(channel, &item));
+    }
+    TEST_EXPECT(cat_thread_channel_try_pop(channel, &item));
+    cat_thread_channel_add_ref(channel);
+    cat_thread_channel_release(channel);
+    TEST_EXPECT(test_destructed == 0);
+    TEST_EXPECT(cat_thread_channel_get_length(channel) == 2);
+    /* the last release destructs the remaining items */
+    cat_thread_channel_release(channel);
+    TEST_EXPECT(test_destructed == 2);
+}
+
+static void test_mpmc(void)
+{
+    test_worker_t producers[TEST_PRODUCERS], consumers[TEST_CONSUMERS];
+    cat_thread_channel_t *channel;
+    uint64_t produced = 0, produced_sum = 0, consumed = 0, consumed_sum = 0;
+    uint32_t n;
+
+    /* small capacity, so that both sides wait for each other frequently */
+    channel = cat_thread_channel_create(TEST_CAPACITY, sizeof(test_item_t), NULL);
+    TEST_EXPECT(channel != NULL);
+    memset(producers, 0, sizeof(producers));
+    memset(consumers, 0, sizeof(consumers));
+    for (n = 0; n < TEST_CONSUMERS; n++) {
+        consumers[n].id = n;
+        consumers[n].channel = cat_thread_channel_add_ref(channel);
+        TEST_EXPECT(uv_thread_create(&consumers[n].thread, test_consumer, &consumers[n]) == 0);
+    }
+    for (n = 0; n < TEST_PRODUCERS; n++) {
+        producers[n].id = n;
+        producers[n].channel = cat_thread_channel_add_ref(channel);
+        TEST_EXPECT(uv_thread_create(&producers[n].thread, test_producer, &producers[n]) == 0);
+    }
+    for (n = 0; n < TEST_PRODUCERS; n++) {
+        TEST_EXPECT(uv_thread_join(&producers[n].thread) == 0);
+        TEST_EXPECT(producers[n].error == 0);
+        produced += producers[n].count;
+        produced_sum += producers[n].sum;
+        cat_thread_channel_release(producers[n].channel);
+    }
+    /* consumers drain the remaining items and exit */
+    cat_thread_channel_close(channel);
+    for (n = 0; n < TEST_CONSUMERS; n++) {
+        TEST_EXPECT(uv_thread_join(&consumers[n].thread) == 0);
+        TEST_EXPECT(consumers[n].error == CAT_ECLOSED);
+        TEST_EXPECT(consumers[n].ordered);
+        consumed += consumers[n].count;
+        consumed_sum += consumers[n].sum;
+        cat_thread_channel_release(consumers[n].channel);
+    }
+    TEST_EXPECT(produced == (uint64_t) TEST_PRODUCERS * TEST_ITEMS_PER_PRODUCER);
+    TEST_EXPECT(consumed == produced);
+    TEST_EXPECT(consumed_sum == produced_sum);
+    TEST_EXPECT(cat_thread_channel_get_length(channel) == 0);
+    cat_thread_channel_release(channel);
+}
+
+static void test_close_wakes_up_waiters(void)
+{
+    test_worker_t pushers[TEST_PRODUCERS], poppers[TEST_CONSUMERS];
+    cat_thread_channel_t *full_channel, *empty_channel;
+    test_item_t item = { 0, 0 };
+    uint32_t n;
+
+    full_channel = cat_thread_channel_create(TEST_CAPACITY, sizeof(test_item_t), NULL);
+    empty_channel = cat_thread_channel_create(TEST_CAPACITY, sizeof(test_item_t), NULL);
+    TEST_EXPECT(full_channel != NULL && empty_channel != NULL);
+    for (n = 0; n < TEST_CAPACITY; n++) {
+        TEST_EXPECT(cat_thread_channel_try_push(full_channel, &item));
+    }
+    memset(pushers, 0, sizeof(pushers));
+    memset(poppers, 0, sizeof(poppers));
+    for (n = 0; n < TEST_PRODUCERS; n++) {
+        pushers[n].id = n;
+        pushers[n].channel = full_channel;
+        TEST_EXPECT(uv_thread_create(&pushers[n].thread, test_blocked_push, &pushers[n]) == 0);
+    }
+    for (n = 0; n < TEST_CONSUMERS; n++) {
+        poppers[n].id = n;
+        poppers[n].channel = empty_channel;
+        TEST_EXPECT(uv_thread_create(&poppers[n].thread, test_blocked_pop, &poppers[n]) == 0);
+    }
+    /* let them block */
+    (void) cat_time_msleep(100);
+    cat_thread_channel_close(full_channel);
+    cat_thread_channel_close(empty_channel);
+    for (n = 0; n < TEST_PRODUCERS; n++) {
+        TEST_EXPECT(uv_thread_join(&pushers[n].thread) == 0);
+        TEST_EXPECT(pushers[n].error == CAT_ECLOSED);
+    }
+    for (n = 0; n < TEST_CONSUMERS; n++) {
+        TEST_EXPECT(uv_thread_join(&poppers[n].thread) == 0);
+        TEST_EXPECT(poppers[n].error == CAT_ECLOSED);
+    }
+    /* items pushed before close are still there, and nothing was pushed by the waiters */
+    TEST_EXPECT(cat_thread_channel_get_length(full_channel) == TEST_CAPACITY);
+    for (n = 0; n < TEST_CAPACITY; n++) {
+        TEST_EXPECT(cat_thread_channel_try_pop(full_channel, &item));
+    }
+    TEST_EXPECT(!cat_thread_channel_try_pop(full_channel, &item));
+    cat_thread_channel_release(full_channel);
+    cat_thread_channel_release(empty_channel);
+}
+
+int main(void)
+{
+    if (!cat_init_all() || !cat_run(CAT_RUN_EASY)) {
+        fprintf(stderr, "init failed\n");
+        return 1;
+    }
+    test_basic();
+    test_dtor_on_release();
+    test_mpmc();
+    test_close_wakes_up_waiters();
+    (void) cat_stop();
+    (void) cat_shutdown_all();
+
+    if (test_failures != 0) {
+        fprintf(stderr, "%d expectation(s) failed\n", test_failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -67,6 +67,13 @@ typedef struct cat_globals_info_s {
 #define CAT_GLOBALS_INFO(name) name##_globals_info
 #define CAT_GLOBALS_DECLARE(name) cat_globals_info_t CAT_GLOBALS_INFO(name)
 
+/* TSRM allocates globals of new threads by malloc() */
+#define CAT_GLOBALS_CTOR_DECLARE_SZ(name) \
+static void CAT_GLOBALS_CTOR(name)(void *globals) \
+{ \
+    memset(globals, 0, sizeof(CAT_GLOBALS_TYPE(name))); \
+}
+
 #ifdef CAT_TSRMG_FAST
 # if ZEND_ENABLE_STATIC_TSRMLS_CACHE
 #  define CAT_GLOBALS_BULK(name) TSRMG_FAST_BULK_STATIC(CAT_GLOBALS_INFO(name).offset, CAT_GLOBALS_TYPE(name) *)
@@ -74,7 +81,7 @@ typedef struct cat_globals_info_s {
 #  define CAT_GLOBALS_BULK(name) TSRMG_FAST_BULK(CAT_GLOBALS_INFO(name).offset, CAT_GLOBALS_TYPE(name) *)
 # endif
 # define CAT_GLOBALS_REGISTER(name) do { \
-    ts_allocate_fast_id(&CAT_GLOBALS_INFO(name).id, &CAT_GLOBALS_INFO(name).offset, sizeof(CAT_GLOBALS_TYPE(name)), NULL, NULL); \
+    ts_allocate_fast_id(&CAT_GLOBALS_INFO(name).id, &CAT_GLOBALS_INFO(name).offset, sizeof(CAT_GLOBALS_TYPE(name)), CAT_GLOBALS_CTOR(name), NULL); \
     CAT_GLOBALS_BZERO(name); \
 } while (0)
 
@@ -86,7 +93,7 @@ typedef struct cat_globals_info_s {
 #  define CAT_GLOBALS_BULK(name) TSRMG_BULK(CAT_GLOBALS_INFO(name).id, CAT_GLOBALS_TYPE(name) *)
 # endif
 # define CAT_GLOBALS_REGISTER(name) do { \
-    ts_allocate_id(&CAT_GLOBALS_INFO(name).id, sizeof(CAT_GLOBALS_TYPE(name)), NULL, NULL); \
+    ts_allocate_id(&CAT_GLOBALS_INFO(name).id, sizeof(CAT_GLOBALS_TYPE(name)), CAT_GLOBALS_CTOR(name), NULL); \
     CAT_GLOBALS_BZERO(name); \
 } while (0)
 #endif /* CAT_TSRMG_FAST */
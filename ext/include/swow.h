@@ -71,8 +71,18 @@ ZEND_BEGIN_MODULE_GLOBALS(swow)
     struct {
         bool enable;
         bool async_file;
+        bool io_uring;
         bool async_tty;
         zend_long async_threads;
+        zend_long work_threads;
+        zend_long coroutine_stack_pool_size;
+        bool coroutine_stack_pool_trim;
+        zend_long buffer_pool_size;
+        zend_long dns_cache_size;
+        zend_long dns_cache_ttl;
+        zend_long dns_cache_negative_ttl;
+        zend_long ssl_session_cache_size;
+        zend_long ssl_session_cache_ttl;
     } ini;
 ZEND_END_MODULE_GLOBALS(swow)
 
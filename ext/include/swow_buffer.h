@@ -47,9 +47,49 @@ typedef struct swow_buffer_s {
     zend_object std;
 } swow_buffer_t;
 
+/* pool */
+
+/* size classes are powers of 2 (4K, 8K, 16K, 32K, 64K) */
+#define SWOW_BUFFER_POOL_MIN_SIZE             (4 * 1024)
+#define SWOW_BUFFER_POOL_NUM_CLASSES          5
+#define SWOW_BUFFER_POOL_DEFAULT_MAX_COUNT    256
+
+typedef struct swow_buffer_pool_info_s {
+    size_t max_count;
+    size_t count;
+    size_t size;
+    uint64_t hits;
+    uint64_t misses;
+} swow_buffer_pool_info_t;
+
+/* globals */
+
+CAT_GLOBALS_STRUCT_BEGIN(swow_buffer) {
+    struct {
+        /* cached strings are linked through their value */
+        zend_string *free_lists[SWOW_BUFFER_POOL_NUM_CLASSES];
+        size_t counts[SWOW_BUFFER_POOL_NUM_CLASSES];
+        size_t max_count;
+        uint64_t hits;
+        uint64_t misses;
+    } pool;
+} CAT_GLOBALS_STRUCT_END(swow_buffer);
+
+extern SWOW_API CAT_GLOBALS_DECLARE(swow_buffer);
+
+#define SWOW_BUFFER_G(x) CAT_GLOBALS_GET(swow_buffer, x)
+
 /* loader */
 
 zend_result swow_buffer_module_init(INIT_FUNC_ARGS);
+zend_result swow_buffer_module_shutdown(INIT_FUNC_ARGS);
+zend_result swow_buffer_runtime_init(INIT_FUNC_ARGS);
+zend_result swow_buffer_runtime_shutdown(INIT_FUNC_ARGS);
+
+/* pool */
+
+SWOW_API void swow_buffer_pool_get_info(swow_buffer_pool_info_t *info);
+SWOW_API void swow_buffer_pool_clear(void);
 
 /* helper */
 
@@ -26,6 +26,7 @@ extern "C" {
 #include "swow_coroutine.h"
 
 #include "cat_event.h"
+#include "cat_work.h"
 
 extern SWOW_API zend_class_entry *swow_event_ce;
 extern SWOW_API zend_object_handlers swow_event_handlers;
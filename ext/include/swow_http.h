@@ -26,6 +26,8 @@ extern "C" {
 
 #include "cat_http.h"
 
+#include "zend_smart_str.h"
+
 extern SWOW_API zend_class_entry *swow_http_http_ce;
 
 extern SWOW_API zend_class_entry *swow_http_status_ce;
@@ -34,12 +36,36 @@ extern SWOW_API zend_class_entry *swow_http_parser_ce;
 extern SWOW_API zend_object_handlers swow_http_parser_handlers;
 extern SWOW_API zend_class_entry *swow_http_parser_exception_ce;
 
+/* message head collected by executeHead() */
+typedef struct swow_http_parser_head_s {
+    /* uri or reason phrase */
+    smart_str line;
+    smart_str header_name;
+    smart_str header_value;
+    /* array<string, string[]> */
+    zval headers;
+    /* array<string, string> (lower-case name => name) */
+    zval header_names;
+    bool has_header_value;
+    bool completed;
+} swow_http_parser_head_t;
+
 typedef struct swow_http_parser_s {
     cat_http_parser_t parser;
     size_t data_offset;
+    swow_http_parser_head_t head;
     zend_object std;
 } swow_http_parser_t;
 
+/* head */
+
+SWOW_API void swow_http_parser_head_init(swow_http_parser_head_t *head);
+SWOW_API void swow_http_parser_head_close(swow_http_parser_head_t *head);
+
+/* parse the request/status line and header fields until HEADERS_COMPLETE or more data is needed,
+ * parser->parsed_length is the total length of all parsed data */
+SWOW_API cat_bool_t swow_http_parser_execute_head(cat_http_parser_t *parser, swow_http_parser_head_t *head, const char *data, size_t length);
+
 /* loader */
 
 zend_result swow_http_module_init(INIT_FUNC_ARGS);
@@ -0,0 +1,106 @@
+/*
+  +--------------------------------------------------------------------------+
+  | Swow                                                                     |
+  +--------------------------------------------------------------------------+
+  | Licensed under the Apache License, Version 2.0 (the "License");          |
+  | you may not use this file except in compliance with the License.         |
+  | You may obtain a copy of the License at                                  |
+  | http://www.apache.org/licenses/LICENSE-2.0                               |
+  | Unless required by applicable law or agreed to in writing, software      |
+  | distributed under the License is distributed on an "AS IS" BASIS,        |
+  | WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. |
+  | See the License for the specific language governing permissions and      |
+  | limitations under the License. See accompanying LICENSE file.            |
+  +--------------------------------------------------------------------------+
+  | Author: Twosee <twosee@php.net>                                          |
+  +--------------------------------------------------------------------------+
+ */
+
+#ifndef SWOW_HTTP_SERVER_H
+#define SWOW_HTTP_SERVER_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "swow.h"
+#include "swow_http.h"
+#include "swow_socket.h"
+
+#define SWOW_HTTP_SERVER_DEFAULT_MAX_HEADER_LENGTH  8192
+#define SWOW_HTTP_SERVER_DEFAULT_MAX_CONTENT_LENGTH (8 * 1024 * 1024)
+
+/* responses of pipelined requests are collected until it reaches this size and then sent at once,
+ * bodies larger than it are written together with the collected data by writev() instead of being copied */
+#define SWOW_HTTP_SERVER_OUTPUT_FLUSH_SIZE (16 * 1024)
+
+/* accept() is retried after it (in milliseconds) when there are too many open files */
+#define SWOW_HTTP_SERVER_ACCEPT_RETRY_INTERVAL 100
+
+extern SWOW_API zend_class_entry *swow_http_server_ce;
+extern SWOW_API zend_object_handlers swow_http_server_handlers;
+
+extern SWOW_API zend_class_entry *swow_http_server_request_ce;
+extern SWOW_API zend_object_handlers swow_http_server_request_handlers;
+
+typedef struct swow_http_server_s {
+    /* listening Swow\Socket */
+    zval z_socket;
+    swow_fcall_storage_t handler;
+    size_t max_header_length;
+    size_t max_content_length;
+    zend_object std;
+} swow_http_server_t;
+
+typedef struct swow_http_server_connection_s {
+    swow_http_server_t *server;
+    cat_socket_t *socket;
+    cat_http_parser_t parser;
+    swow_http_parser_head_t head;
+    char *buffer;
+    size_t buffer_size;
+    size_t buffer_length;
+    size_t parsed_offset;
+    size_t header_length;
+    smart_str body;
+    /* responses which have not been sent yet */
+    smart_str output;
+    bool keep_alive;
+} swow_http_server_connection_t;
+
+typedef struct swow_http_server_request_s {
+    /* it is only available while the handler is running */
+    swow_http_server_connection_t *connection;
+    cat_http_method_t method;
+    uint8_t major_version;
+    uint8_t minor_version;
+    bool keep_alive;
+    bool responded;
+    zend_string *uri;
+    /* array<string, string[]> */
+    zval headers;
+    /* array<string, string> (lower-case name => name) */
+    zval header_names;
+    zend_string *body;
+    zend_object std;
+} swow_http_server_request_t;
+
+/* loader */
+
+zend_result swow_http_server_module_init(INIT_FUNC_ARGS);
+
+/* helper */
+
+static zend_always_inline swow_http_server_t *swow_http_server_get_from_object(zend_object *object)
+{
+    return cat_container_of(object, swow_http_server_t, std);
+}
+
+static zend_always_inline swow_http_server_request_t *swow_http_server_request_get_from_object(zend_object *object)
+{
+    return cat_container_of(object, swow_http_server_request_t, std);
+}
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* SWOW_HTTP_SERVER_H */
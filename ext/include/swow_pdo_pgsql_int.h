@@ -209,4 +209,6 @@ void swow_pdo_pgsql_close_lob_streams(pdo_dbh_t *dbh);
 
 #endif
 
+int swow_pdo_pgsql_get_value(PGresult *res, int row, int column, Oid pgsql_type, zval *result);
+
 #endif /* PHP_PDO_PGSQL_INT_H */
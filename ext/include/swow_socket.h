@@ -31,6 +31,9 @@ extern SWOW_API zend_object_handlers swow_socket_handlers;
 
 extern SWOW_API zend_class_entry *swow_socket_exception_ce;
 
+/* initial size of the array returned by acceptMany(), it grows if more connections are pending */
+#define SWOW_SOCKET_ACCEPT_MANY_INITIAL_SIZE 16
+
 typedef struct swow_socket_s {
     cat_socket_t socket;
     zend_object std;
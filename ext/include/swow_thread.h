@@ -0,0 +1,116 @@
+/*
+  +--------------------------------------------------------------------------+
+  | Swow                                                                     |
+  +--------------------------------------------------------------------------+
+  | Licensed under the Apache License, Version 2.0 (the "License");          |
+  | you may not use this file except in compliance with the License.         |
+  | You may obtain a copy of the License at                                  |
+  | http://www.apache.org/licenses/LICENSE-2.0                               |
+  | Unless required by applicable law or agreed to in writing, software      |
+  | distributed under the License is distributed on an "AS IS" BASIS,        |
+  | WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. |
+  | See the License for the specific language governing permissions and      |
+  | limitations under the License. See accompanying LICENSE file.            |
+  +--------------------------------------------------------------------------+
+  | Author: Twosee <twosee@php.net>                                          |
+  +--------------------------------------------------------------------------+
+ */
+
+#ifndef SWOW_THREAD_H
+#define SWOW_THREAD_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "swow.h"
+
+#include "cat_atomic.h"
+#include "cat_thread_channel.h"
+
+extern SWOW_API zend_class_entry *swow_thread_ce;
+extern SWOW_API zend_object_handlers swow_thread_handlers;
+extern SWOW_API zend_class_entry *swow_thread_exception_ce;
+
+extern SWOW_API zend_class_entry *swow_thread_channel_ce;
+extern SWOW_API zend_object_handlers swow_thread_channel_handlers;
+
+/* max time to wait for running (detached) threads on module shutdown in milliseconds */
+#define SWOW_THREAD_SHUTDOWN_TIMEOUT 3000
+
+/* data is serialized and copied to the memory which is not bound to any thread */
+typedef struct swow_thread_payload_s {
+    char *data;
+    size_t length;
+    /* thread channels are carried out-of-band, data only contains their indexes,
+     * every one holds a reference until it is adopted by the unserialized channel */
+    cat_thread_channel_t **channels;
+    uint32_t channel_count;
+    /* data is an error message */
+    cat_bool_t failed;
+} swow_thread_payload_t;
+
+/* globals */
+
+CAT_GLOBALS_STRUCT_BEGIN(swow_thread) {
+    /* 0 is the main thread */
+    uint32_t id;
+    /* payload which is being (un)serialized, thread channels can only be transferred with it */
+    swow_thread_payload_t *transfer;
+} CAT_GLOBALS_STRUCT_END(swow_thread);
+
+extern SWOW_API CAT_GLOBALS_DECLARE(swow_thread);
+
+#define SWOW_THREAD_G(x) CAT_GLOBALS_GET(swow_thread, x)
+
+typedef enum swow_thread_state_e {
+    SWOW_THREAD_STATE_NONE,
+    SWOW_THREAD_STATE_RUNNING,
+    /* a coroutine is waiting for its result */
+    SWOW_THREAD_STATE_JOINING,
+    SWOW_THREAD_STATE_JOINED,
+    SWOW_THREAD_STATE_DETACHED,
+} swow_thread_state_t;
+
+/* it is shared by the thread object and the thread itself */
+typedef struct swow_thread_context_s {
+    cat_atomic_uint32_t refcount;
+    uint32_t id;
+    uv_thread_t thread;
+    /* [callable, arguments] */
+    swow_thread_payload_t input;
+    /* result is pushed when the thread exits */
+    cat_thread_channel_t *result;
+} swow_thread_context_t;
+
+typedef struct swow_thread_s {
+    swow_thread_context_t *context;
+    swow_thread_state_t state;
+    zend_object std;
+} swow_thread_t;
+
+typedef struct swow_thread_channel_s {
+    cat_thread_channel_t *channel;
+    zend_object std;
+} swow_thread_channel_t;
+
+/* loader */
+
+zend_result swow_thread_module_init(INIT_FUNC_ARGS);
+zend_result swow_thread_module_shutdown(INIT_FUNC_ARGS);
+
+/* helper */
+
+static zend_always_inline swow_thread_t *swow_thread_get_from_object(zend_object *object)
+{
+    return cat_container_of(object, swow_thread_t, std);
+}
+
+static zend_always_inline swow_thread_channel_t *swow_thread_channel_get_from_object(zend_object *object)
+{
+    return cat_container_of(object, swow_thread_channel_t, std);
+}
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* SWOW_THREAD_H */
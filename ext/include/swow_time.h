@@ -27,6 +27,7 @@ extern "C" {
 #include "cat_time.h"
 
 zend_result swow_time_module_init(INIT_FUNC_ARGS);
+zend_result swow_time_module_shutdown(INIT_FUNC_ARGS);
 
 #ifdef __cplusplus
 }
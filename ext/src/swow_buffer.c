@@ -23,6 +23,10 @@ SWOW_API zend_object_handlers swow_buffer_handlers;
 
 SWOW_API zend_class_entry *swow_buffer_exception_ce;
 
+SWOW_API CAT_GLOBALS_DECLARE(swow_buffer);
+
+CAT_GLOBALS_CTOR_DECLARE_SZ(swow_buffer)
+
 #define VECTOR_POSITION_FMT "[%u][%u] "
 #define VECTOR_POSTION_C    vector_index, arg_num - 1
 #define ZEND_LONG_ARG_FMT   "($%s = " ZEND_LONG_FMT ") "
@@ -229,6 +233,118 @@ SWOW_API void swow_buffer_update(swow_buffer_t *s_buffer, size_t length)
     ZSTR_VAL(string)[ZSTR_LEN(string) = (buffer->length = length)] = '\0';
 }
 
+/* pool */
+
+static zend_always_inline int swow_buffer_pool_get_class(size_t size)
+{
+    size_t class_size = SWOW_BUFFER_POOL_MIN_SIZE;
+    int i;
+
+    for (i = 0; i < SWOW_BUFFER_POOL_NUM_CLASSES; i++, class_size <<= 1) {
+        if (size == class_size) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+static zend_always_inline zend_string **swow_buffer_pool_get_next(zend_string *string)
+{
+    return (zend_string **) ZSTR_VAL(string);
+}
+
+static zend_string *swow_buffer_pool_pop(size_t size)
+{
+    int i = swow_buffer_pool_get_class(size);
+    zend_string *string;
+
+    if (i < 0) {
+        return NULL;
+    }
+    string = SWOW_BUFFER_G(pool.free_lists)[i];
+    if (string == NULL) {
+        SWOW_BUFFER_G(pool.misses)++;
+        return NULL;
+    }
+    SWOW_BUFFER_G(pool.free_lists)[i] = *swow_buffer_pool_get_next(string);
+    SWOW_BUFFER_G(pool.counts)[i]--;
+    SWOW_BUFFER_G(pool.hits)++;
+    /* flags (e.g. IS_STR_VALID_UTF8) may have been set when it was shared */
+    GC_SET_REFCOUNT(string, 1);
+    GC_TYPE_INFO(string) = GC_STRING;
+    zend_string_forget_hash_val(string);
+
+    return string;
+}
+
+static bool swow_buffer_pool_push(zend_string *string, size_t size)
+{
+    int i;
+
+    /* strings freed after runtime shutdown (e.g. by the object store destructor)
+     * would never be released if we cached them */
+    if (UNEXPECTED(SWOW_G(runtime_state) != SWOW_RUNTIME_STATE_RUNNING)) {
+        return false;
+    }
+    /* only the strings exclusively owned by the buffer can be reused */
+    if (GC_REFCOUNT(string) != 1 || ZSTR_IS_INTERNED(string) || (GC_FLAGS(string) & IS_STR_PERSISTENT)) {
+        return false;
+    }
+    i = swow_buffer_pool_get_class(size);
+    if (i < 0 || SWOW_BUFFER_G(pool.counts)[i] >= SWOW_BUFFER_G(pool.max_count)) {
+        return false;
+    }
+    *swow_buffer_pool_get_next(string) = SWOW_BUFFER_G(pool.free_lists)[i];
+    SWOW_BUFFER_G(pool.free_lists)[i] = string;
+    SWOW_BUFFER_G(pool.counts)[i]++;
+
+    return true;
+}
+
+SWOW_API void swow_buffer_pool_get_info(swow_buffer_pool_info_t *info)
+{
+    size_t class_size = SWOW_BUFFER_POOL_MIN_SIZE;
+    int i;
+
+    info->max_count = SWOW_BUFFER_G(pool.max_count);
+    info->count = 0;
+    info->size = 0;
+    for (i = 0; i < SWOW_BUFFER_POOL_NUM_CLASSES; i++, class_size <<= 1) {
+        info->count += SWOW_BUFFER_G(pool.counts)[i];
+        info->size += SWOW_BUFFER_G(pool.counts)[i] * class_size;
+    }
+    info->hits = SWOW_BUFFER_G(pool.hits);
+    info->misses = SWOW_BUFFER_G(pool.misses);
+}
+
+SWOW_API void swow_buffer_pool_clear(void)
+{
+    int i;
+
+    for (i = 0; i < SWOW_BUFFER_POOL_NUM_CLASSES; i++) {
+        zend_string *string = SWOW_BUFFER_G(pool.free_lists)[i];
+        while (string != NULL) {
+            zend_string *next = *swow_buffer_pool_get_next(string);
+            efree(string);
+            string = next;
+        }
+        SWOW_BUFFER_G(pool.free_lists)[i] = NULL;
+        SWOW_BUFFER_G(pool.counts)[i] = 0;
+    }
+}
+
+/* it is the same as cat_buffer_close(), but gives the memory back to the pool if possible,
+ * the size of value is only known here, the allocator free function does not get it */
+static void swow_buffer_release(cat_buffer_t *buffer)
+{
+    if (buffer->value != NULL && swow_buffer_pool_push(swow_buffer_get_string_from_handle(buffer), buffer->size)) {
+        cat_buffer_init(buffer);
+        return;
+    }
+    cat_buffer_close(buffer);
+}
+
 static zend_always_inline void swow_buffer_reset(swow_buffer_t *s_buffer)
 {
     ZEND_ASSERT(s_buffer->locker == NULL);
@@ -236,7 +352,7 @@ static zend_always_inline void swow_buffer_reset(swow_buffer_t *s_buffer)
 
 static zend_always_inline void swow_buffer_close(swow_buffer_t *s_buffer)
 {
-    cat_buffer_close(&s_buffer->buffer);
+    swow_buffer_release(&s_buffer->buffer);
     swow_buffer_reset(s_buffer);
 }
 
@@ -254,7 +370,7 @@ static void swow_buffer_free_object(zend_object *object)
 {
     swow_buffer_t *s_buffer = swow_buffer_get_from_object(object);
 
-    cat_buffer_close(&s_buffer->buffer);
+    swow_buffer_release(&s_buffer->buffer);
 
     zend_object_std_dtor(&s_buffer->std);
 }
@@ -309,6 +425,34 @@ static PHP_METHOD(Swow_Buffer, alignSize)
     RETURN_LONG(size);
 }
 
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Buffer_getPoolStats, 0, 0, IS_ARRAY, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Buffer, getPoolStats)
+{
+    swow_buffer_pool_info_t info;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    swow_buffer_pool_get_info(&info);
+
+    array_init(return_value);
+    add_assoc_long(return_value, "max_count", info.max_count);
+    add_assoc_long(return_value, "count", info.count);
+    add_assoc_long(return_value, "size", info.size);
+    add_assoc_long(return_value, "hits", info.hits);
+    add_assoc_long(return_value, "misses", info.misses);
+}
+
+#define arginfo_class_Swow_Buffer_clearPool arginfo_class_Swow_Buffer_mallocTrim
+
+static PHP_METHOD(Swow_Buffer, clearPool)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    swow_buffer_pool_clear();
+}
+
 static PHP_METHOD_EX(Swow_Buffer, create)
 {
     SWOW_BUFFER_GETTER(s_buffer, buffer);
@@ -923,6 +1067,8 @@ static PHP_METHOD(Swow_Buffer, __unserialize)
 
 static const zend_function_entry swow_buffer_methods[] = {
     PHP_ME(Swow_Buffer, alignSize,         arginfo_class_Swow_Buffer_alignSize,         ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Buffer, getPoolStats,      arginfo_class_Swow_Buffer_getPoolStats,      ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Buffer, clearPool,         arginfo_class_Swow_Buffer_clearPool,         ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
     PHP_ME(Swow_Buffer, __construct,       arginfo_class_Swow_Buffer___construct,       ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Buffer, alloc,             arginfo_class_Swow_Buffer_alloc,             ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Buffer, getSize,           arginfo_class_Swow_Buffer_getSize,           ZEND_ACC_PUBLIC)
@@ -991,7 +1137,11 @@ static zend_result swow_buffer_cast_object(zend_object *object, zval *result, in
 
 static char *swow_buffer_alloc_standard(size_t size)
 {
-    zend_string *string = zend_string_alloc(size, 0);
+    zend_string *string = swow_buffer_pool_pop(size);
+
+    if (string == NULL) {
+        string = zend_string_alloc(size, 0);
+    }
 
     ZSTR_VAL(string)[ZSTR_LEN(string) = 0] = '\0';
 
@@ -1058,6 +1208,8 @@ SWOW_API const cat_buffer_allocator_t swow_buffer_allocator = {
 
 zend_result swow_buffer_module_init(INIT_FUNC_ARGS)
 {
+    CAT_GLOBALS_REGISTER(swow_buffer);
+
     if (unlikely(!cat_buffer_module_init())) {
         return FAILURE;
     }
@@ -1086,3 +1238,28 @@ zend_result swow_buffer_module_init(INIT_FUNC_ARGS)
 
     return SUCCESS;
 }
+
+zend_result swow_buffer_module_shutdown(INIT_FUNC_ARGS)
+{
+    CAT_GLOBALS_UNREGISTER(swow_buffer);
+
+    return SUCCESS;
+}
+
+zend_result swow_buffer_runtime_init(INIT_FUNC_ARGS)
+{
+    memset(SWOW_BUFFER_G(pool.free_lists), 0, sizeof(SWOW_BUFFER_G(pool.free_lists)));
+    memset(SWOW_BUFFER_G(pool.counts), 0, sizeof(SWOW_BUFFER_G(pool.counts)));
+    SWOW_BUFFER_G(pool.max_count) = SWOW_G(ini.buffer_pool_size) > 0 ? (size_t) SWOW_G(ini.buffer_pool_size) : 0;
+    SWOW_BUFFER_G(pool.hits) = 0;
+    SWOW_BUFFER_G(pool.misses) = 0;
+
+    return SUCCESS;
+}
+
+zend_result swow_buffer_runtime_shutdown(INIT_FUNC_ARGS)
+{
+    swow_buffer_pool_clear();
+
+    return SUCCESS;
+}
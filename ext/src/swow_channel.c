@@ -169,6 +169,101 @@ static PHP_METHOD(Swow_Channel, pop)
     }
 }
 
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Channel_pushMany, 0, 1, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO(0, items, IS_ARRAY, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 0, "-1")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Channel, pushMany)
+{
+    SWOW_CHANNEL_GETTER_CONSTRUCTED(s_channel, channel);
+    HashTable *items;
+    zend_long timeout = -1;
+    zval *z_items, *z_item;
+    uint32_t count, n = 0;
+    size_t pushed;
+
+    ZEND_PARSE_PARAMETERS_START(1, 2)
+        Z_PARAM_ARRAY_HT(items)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(timeout)
+    ZEND_PARSE_PARAMETERS_END();
+
+    count = zend_hash_num_elements(items);
+    if (count == 0) {
+        RETURN_LONG(0);
+    }
+
+    z_items = (zval *) emalloc(sizeof(*z_items) * count);
+    ZEND_HASH_FOREACH_VAL(items, z_item) {
+        ZVAL_COPY(&z_items[n], z_item);
+        n++;
+    } ZEND_HASH_FOREACH_END();
+
+    pushed = cat_channel_push_many(channel, z_items, count, timeout);
+
+    /* release the rest which have not been pushed */
+    for (n = (uint32_t) pushed; n < count; n++) {
+        zval_ptr_dtor(&z_items[n]);
+    }
+    efree(z_items);
+
+    if (UNEXPECTED(pushed == 0)) {
+        swow_throw_exception_with_last(swow_channel_exception_ce);
+        RETURN_THROWS();
+    }
+
+    RETURN_LONG((zend_long) pushed);
+}
+
+#define SWOW_CHANNEL_POP_MANY_MIN_PREALLOCATED_COUNT 64
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Channel_popMany, 0, 1, IS_ARRAY, 0)
+    ZEND_ARG_TYPE_INFO(0, max, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 0, "-1")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Channel, popMany)
+{
+    SWOW_CHANNEL_GETTER_CONSTRUCTED(s_channel, channel);
+    zend_long max;
+    zend_long timeout = -1;
+    zval *z_items;
+    size_t count, popped, n;
+
+    ZEND_PARSE_PARAMETERS_START(1, 2)
+        Z_PARAM_LONG(max)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(timeout)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (UNEXPECTED(max <= 0)) {
+        zend_argument_value_error(1, "must be greater than 0");
+        RETURN_THROWS();
+    }
+
+    /* all stored ones can be popped at once, otherwise it is enough for most cases */
+    count = MAX(cat_channel_get_length(channel), SWOW_CHANNEL_POP_MANY_MIN_PREALLOCATED_COUNT);
+    if ((zend_ulong) max < count) {
+        count = (size_t) max;
+    }
+    z_items = (zval *) emalloc(sizeof(*z_items) * count);
+
+    popped = cat_channel_pop_many(channel, z_items, count, timeout);
+
+    if (UNEXPECTED(popped == 0)) {
+        efree(z_items);
+        swow_throw_exception_with_last(swow_channel_exception_ce);
+        RETURN_THROWS();
+    }
+
+    array_init_size(return_value, (uint32_t) popped);
+    for (n = 0; n < popped; n++) {
+        add_next_index_zval(return_value, &z_items[n]);
+    }
+    efree(z_items);
+}
+
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Channel_close, 0, 0, IS_VOID, 0)
 ZEND_END_ARG_INFO()
 
@@ -317,6 +412,8 @@ static const zend_function_entry swow_channel_methods[] = {
     PHP_ME(Swow_Channel, __construct,  arginfo_class_Swow_Channel___construct,  ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Channel, push,         arginfo_class_Swow_Channel_push,         ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Channel, pop,          arginfo_class_Swow_Channel_pop,          ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Channel, pushMany,     arginfo_class_Swow_Channel_pushMany,     ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Channel, popMany,      arginfo_class_Swow_Channel_popMany,      ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Channel, close,        arginfo_class_Swow_Channel_close,        ZEND_ACC_PUBLIC)
     /* status */
     PHP_ME(Swow_Channel, getCapacity,  arginfo_class_Swow_Channel_getCapacity,  ZEND_ACC_PUBLIC)
@@ -345,9 +442,9 @@ static HashTable *swow_channel_get_gc(zend_object *object, zval **gc_data, int *
 
     zend_get_gc_buffer *zgc_buffer = zend_get_gc_buffer_create();
 
-    CAT_QUEUE_FOREACH_DATA_START(&channel->u.buffered.storage, cat_channel_bucket_t, node, bucket) {
-        zend_get_gc_buffer_add_zval(zgc_buffer, (zval *) bucket->data);
-    } CAT_QUEUE_FOREACH_DATA_END();
+    CAT_CHANNEL_STORAGE_FOREACH_DATA_START(channel, data) {
+        zend_get_gc_buffer_add_zval(zgc_buffer, (zval *) data);
+    } CAT_CHANNEL_STORAGE_FOREACH_DATA_END();
 
     zend_get_gc_buffer_use(zgc_buffer, gc_data, gc_count);
 
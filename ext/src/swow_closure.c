@@ -26,6 +26,8 @@
 
 SWOW_API CAT_GLOBALS_DECLARE(swow_closure);
 
+CAT_GLOBALS_CTOR_DECLARE_SZ(swow_closure)
+
 typedef struct swow_closure_s {
     zend_object       std;
     zend_function     func;
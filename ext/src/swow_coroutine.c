@@ -62,6 +62,8 @@ static zend_function swow_coroutine_internal_function;
 
 SWOW_API CAT_GLOBALS_DECLARE(swow_coroutine);
 
+CAT_GLOBALS_CTOR_DECLARE_SZ(swow_coroutine)
+
 #define SWOW_COROUTINE_SHOULD_BE_IN_EXECUTING(s_coroutine, update_last_error, failure) do { \
     if (UNEXPECTED(!swow_coroutine_is_executing(s_coroutine))) { \
         if (update_last_error) { \
@@ -2122,6 +2124,26 @@ static PHP_METHOD(Swow_Coroutine, count)
     RETURN_LONG(zend_hash_num_elements(SWOW_COROUTINE_G(map)));
 }
 
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Coroutine_getStackPoolStats, 0, 0, IS_ARRAY, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Coroutine, getStackPoolStats)
+{
+    cat_coroutine_stack_pool_info_t info;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    cat_coroutine_get_stack_pool_info(&info);
+
+    array_init(return_value);
+    add_assoc_long(return_value, "max_count", info.max_count);
+    add_assoc_bool(return_value, "trim", info.trim);
+    add_assoc_long(return_value, "count", info.count);
+    add_assoc_long(return_value, "size", info.size);
+    add_assoc_long(return_value, "hits", info.hits);
+    add_assoc_long(return_value, "misses", info.misses);
+}
+
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Coroutine_get, 0, 1, IS_STATIC, 1)
     ZEND_ARG_TYPE_INFO(0, id, IS_LONG, 0)
 ZEND_END_ARG_INFO()
@@ -2257,6 +2279,7 @@ static const zend_function_entry swow_coroutine_methods[] = {
     PHP_ME(Swow_Coroutine, kill,                    arginfo_class_Swow_Coroutine_kill,                    ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Coroutine, killAll,                 arginfo_class_Swow_Coroutine_killAll,                 ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
     PHP_ME(Swow_Coroutine, count,                   arginfo_class_Swow_Coroutine_count,                   ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Coroutine, getStackPoolStats,       arginfo_class_Swow_Coroutine_getStackPoolStats,       ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
     PHP_ME(Swow_Coroutine, get,                     arginfo_class_Swow_Coroutine_get,                     ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
     PHP_ME(Swow_Coroutine, getAll,                  arginfo_class_Swow_Coroutine_getAll,                  ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
     /* magic */
@@ -2725,6 +2748,9 @@ zend_result swow_coroutine_runtime_init(INIT_FUNC_ARGS)
         swow_coroutine_jump_standard
     );
 
+    cat_coroutine_set_stack_pool_max_count(SWOW_G(ini.coroutine_stack_pool_size) > 0 ? (size_t) SWOW_G(ini.coroutine_stack_pool_size) : 0);
+    cat_coroutine_set_stack_pool_trim(SWOW_G(ini.coroutine_stack_pool_trim));
+
     SWOW_COROUTINE_G(default_stack_page_size) = SWOW_COROUTINE_DEFAULT_STACK_PAGE_SIZE; /* TODO: get php.ini */
     SWOW_COROUTINE_G(classic_error_handler) = cat_false; /* TODO: get php.ini */
     SWOW_COROUTINE_G(exception_error_severity) = E_ERROR; /* TODO: get php.ini */
@@ -495,6 +495,8 @@ static const zend_function_entry swow_debug_functions[] = {
 
 SWOW_API CAT_GLOBALS_DECLARE(swow_debug);
 
+CAT_GLOBALS_CTOR_DECLARE_SZ(swow_debug)
+
 static bool is_zend_compile_extended_info_checked = false;
 static bool is_zend_ext_stmt_handler_hooked = false;
 static user_opcode_handler_t original_zend_ext_stmt_handler = NULL;
@@ -130,5 +130,9 @@ zend_result swow_dns_runtime_init(INIT_FUNC_ARGS)
         af_constants_checked = true;
     }
 
+    cat_dns_cache_set_max_size(SWOW_G(ini.dns_cache_size) > 0 ? (size_t) SWOW_G(ini.dns_cache_size) : 0);
+    cat_dns_cache_set_ttl(SWOW_G(ini.dns_cache_ttl) > 0 ? (cat_msec_t) SWOW_G(ini.dns_cache_ttl) : 0);
+    cat_dns_cache_set_negative_ttl(SWOW_G(ini.dns_cache_negative_ttl) > 0 ? (cat_msec_t) SWOW_G(ini.dns_cache_negative_ttl) : 0);
+
     return SUCCESS;
 }
@@ -86,11 +86,19 @@ zend_result swow_event_module_init(INIT_FUNC_ARGS)
         return FAILURE;
     }
 
+    if (!cat_work_module_init()) {
+        return FAILURE;
+    }
+
     return SUCCESS;
 }
 
 zend_result swow_event_module_shutdown(INIT_FUNC_ARGS)
 {
+    if (!cat_work_module_shutdown()) {
+        return FAILURE;
+    }
+
     if (!cat_event_module_shutdown()) {
         return FAILURE;
     }
@@ -240,7 +240,7 @@ static inline int swow_fs_fstat(int fd, zend_stat_t *statbuf)
     data->ret = -1;
     data->fd = fd;
     data->statbuf = statbuf;
-    if (!cat_work(CAT_WORK_KIND_FAST_IO, _swow_fs_fstat_cb, cat_free_function, data, CAT_TIMEOUT_FOREVER)) {
+    if (!cat_work(CAT_WORK_KIND_FS, _swow_fs_fstat_cb, cat_free_function, data, CAT_TIMEOUT_FOREVER)) {
         data->ret = -1;
     }
     UPDATE_ERRNO_FROM_CAT();
@@ -273,7 +273,7 @@ static inline int swow_fs_stat_mock(const char *path, zend_stat_t *statbuf, int
     data->len = pathw_len;
     data->statbuf = statbuf;
     data->use_lstat = use_lstat;
-    if (!cat_work(CAT_WORK_KIND_FAST_IO, _swow_fs_stat_ex_cb, _swow_fs_stat_ex_free, data, CAT_TIMEOUT_FOREVER)) {
+    if (!cat_work(CAT_WORK_KIND_FS, _swow_fs_stat_ex_cb, _swow_fs_stat_ex_free, data, CAT_TIMEOUT_FOREVER)) {
         data->ret = -1;
     }
     UPDATE_ERRNO_FROM_CAT();
@@ -424,7 +424,7 @@ static inline int swow_fs_open(const char *path, int flags, ...)
     }
 
     data->error = errno;
-    if (!cat_work(CAT_WORK_KIND_FAST_IO, _swow_fs_open_cb, _swow_fs_open_free, data, CAT_TIMEOUT_FOREVER)) {
+    if (!cat_work(CAT_WORK_KIND_FS, _swow_fs_open_cb, _swow_fs_open_free, data, CAT_TIMEOUT_FOREVER)) {
         UPDATE_ERRNO_FROM_CAT();
         data->ret = -1;
     }
@@ -54,16 +54,203 @@ static const zend_function_entry swow_http_status_methods[] = {
 
 /* Parser */
 
+/* common header names are interned (with their lower-case names),
+ * so that we need not allocate them for every message */
+#define SWOW_HTTP_KNOWN_HEADER_NAME_MAP(XX) \
+    XX("Host") \
+    XX("Connection") \
+    XX("Keep-Alive") \
+    XX("Upgrade") \
+    XX("User-Agent") \
+    XX("Accept") \
+    XX("Accept-Encoding") \
+    XX("Accept-Language") \
+    XX("Accept-Ranges") \
+    XX("Authorization") \
+    XX("Cache-Control") \
+    XX("Pragma") \
+    XX("Content-Type") \
+    XX("Content-Length") \
+    XX("Content-Encoding") \
+    XX("Content-Disposition") \
+    XX("Transfer-Encoding") \
+    XX("Cookie") \
+    XX("Set-Cookie") \
+    XX("Origin") \
+    XX("Referer") \
+    XX("Date") \
+    XX("Server") \
+    XX("Location") \
+    XX("Expires") \
+    XX("Last-Modified") \
+    XX("ETag") \
+    XX("If-Modified-Since") \
+    XX("If-None-Match") \
+    XX("Range") \
+    XX("Vary") \
+    XX("X-Forwarded-For") \
+    XX("X-Forwarded-Proto") \
+    XX("X-Real-IP") \
+    XX("X-Requested-With") \
+    XX("Sec-WebSocket-Key") \
+    XX("Sec-WebSocket-Version") \
+    XX("Sec-WebSocket-Accept") \
+    XX("Sec-WebSocket-Protocol") \
+    XX("Sec-WebSocket-Extensions") \
+
+static const char *swow_http_known_header_name_strings[] = {
+#define SWOW_HTTP_KNOWN_HEADER_NAME_GEN(name) name,
+    SWOW_HTTP_KNOWN_HEADER_NAME_MAP(SWOW_HTTP_KNOWN_HEADER_NAME_GEN)
+#undef SWOW_HTTP_KNOWN_HEADER_NAME_GEN
+};
+
+#define SWOW_HTTP_KNOWN_HEADER_NAME_COUNT (sizeof(swow_http_known_header_name_strings) / sizeof(*swow_http_known_header_name_strings))
+
+/* [name, lower-case name] */
+static zend_string *swow_http_known_header_names[SWOW_HTTP_KNOWN_HEADER_NAME_COUNT][2];
+
+static void swow_http_known_header_names_init(void)
+{
+    char lower_name[64];
+    size_t n;
+
+    for (n = 0; n < SWOW_HTTP_KNOWN_HEADER_NAME_COUNT; n++) {
+        const char *name = swow_http_known_header_name_strings[n];
+        size_t name_length = strlen(name);
+        ZEND_ASSERT(name_length < sizeof(lower_name));
+        zend_str_tolower_copy(lower_name, name, name_length);
+        swow_http_known_header_names[n][0] = zend_string_init_interned(name, name_length, 1);
+        swow_http_known_header_names[n][1] = zend_string_init_interned(lower_name, name_length, 1);
+    }
+}
+
+static zend_always_inline bool swow_http_find_known_header_name(const char *name, size_t name_length, zend_string **header_name, zend_string **lower_header_name)
+{
+    size_t n;
+
+    for (n = 0; n < SWOW_HTTP_KNOWN_HEADER_NAME_COUNT; n++) {
+        zend_string *known_name = swow_http_known_header_names[n][0];
+        zend_string *known_lower_name = swow_http_known_header_names[n][1];
+        if (ZSTR_LEN(known_name) != name_length) {
+            continue;
+        }
+        if (memcmp(ZSTR_VAL(known_name), name, name_length) == 0) {
+            *header_name = known_name;
+            *lower_header_name = known_lower_name;
+            return true;
+        }
+        if (memcmp(ZSTR_VAL(known_lower_name), name, name_length) == 0) {
+            *header_name = known_lower_name;
+            *lower_header_name = known_lower_name;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static zend_always_inline const char *swow_http_smart_str_value(const smart_str *str)
+{
+    return str->s != NULL ? ZSTR_VAL(str->s) : "";
+}
+
+static zend_always_inline size_t swow_http_smart_str_length(const smart_str *str)
+{
+    return str->s != NULL ? ZSTR_LEN(str->s) : 0;
+}
+
+static zend_always_inline void swow_http_smart_str_truncate(smart_str *str)
+{
+    /* keep the memory for the next one */
+    if (str->s != NULL) {
+        ZSTR_LEN(str->s) = 0;
+    }
+}
+
+SWOW_API void swow_http_parser_head_init(swow_http_parser_head_t *head)
+{
+    memset(&head->line, 0, sizeof(head->line));
+    memset(&head->header_name, 0, sizeof(head->header_name));
+    memset(&head->header_value, 0, sizeof(head->header_value));
+    ZVAL_UNDEF(&head->headers);
+    ZVAL_UNDEF(&head->header_names);
+    head->has_header_value = false;
+    head->completed = false;
+}
+
+SWOW_API void swow_http_parser_head_close(swow_http_parser_head_t *head)
+{
+    smart_str_free(&head->line);
+    smart_str_free(&head->header_name);
+    smart_str_free(&head->header_value);
+    zval_ptr_dtor(&head->headers);
+    zval_ptr_dtor(&head->header_names);
+    swow_http_parser_head_init(head);
+}
+
+static void swow_http_parser_head_add_header(swow_http_parser_head_t *head)
+{
+    const char *name = swow_http_smart_str_value(&head->header_name);
+    size_t name_length = swow_http_smart_str_length(&head->header_name);
+    size_t value_length = swow_http_smart_str_length(&head->header_value);
+    zend_string *header_name, *lower_header_name;
+    zval *z_header_values, z_tmp;
+
+    if (!swow_http_find_known_header_name(name, name_length, &header_name, &lower_header_name)) {
+        header_name = zend_string_init(name, name_length, 0);
+        lower_header_name = zend_string_tolower(header_name);
+    }
+    if (Z_TYPE(head->headers) == IS_UNDEF) {
+        array_init(&head->headers);
+        array_init(&head->header_names);
+    } else {
+        /* they may have been shared with user space by getHead() */
+        SEPARATE_ARRAY(&head->headers);
+        SEPARATE_ARRAY(&head->header_names);
+    }
+    /* $headers[$headerName][] = $headerValue */
+    z_header_values = zend_symtable_find(Z_ARRVAL(head->headers), header_name);
+    if (z_header_values == NULL) {
+        array_init_size(&z_tmp, 1);
+        z_header_values = zend_symtable_update(Z_ARRVAL(head->headers), header_name, &z_tmp);
+    } else {
+        SEPARATE_ARRAY(z_header_values);
+    }
+    if (value_length == 0) {
+        add_next_index_str(z_header_values, ZSTR_EMPTY_ALLOC());
+    } else {
+        add_next_index_stringl(z_header_values, ZSTR_VAL(head->header_value.s), value_length);
+    }
+    /* $headerNames[strtolower($headerName)] = $headerName */
+    ZVAL_STR(&z_tmp, header_name);
+    zend_symtable_update(Z_ARRVAL(head->header_names), lower_header_name, &z_tmp);
+    zend_string_release(lower_header_name);
+
+    swow_http_smart_str_truncate(&head->header_name);
+    swow_http_smart_str_truncate(&head->header_value);
+    head->has_header_value = false;
+}
+
 static zend_object *swow_http_parser_create_object(zend_class_entry *ce)
 {
     swow_http_parser_t *s_parser = swow_object_alloc(swow_http_parser_t, ce, swow_http_parser_handlers);
 
     cat_http_parser_init(&s_parser->parser);
     s_parser->data_offset = 0;
+    swow_http_parser_head_init(&s_parser->head);
 
     return &s_parser->std;
 }
 
+static void swow_http_parser_free_object(zend_object *object)
+{
+    swow_http_parser_t *s_parser = swow_http_parser_get_from_object(object);
+
+    swow_http_parser_head_close(&s_parser->head);
+
+    zend_object_std_dtor(&s_parser->std);
+}
+
 #define getThisParser() (swow_http_parser_get_from_object(Z_OBJ_P(ZEND_THIS)))
 
 #define SWOW_HTTP_PARSER_GETTER(_sparser, _parser) \
@@ -185,6 +372,144 @@ static PHP_METHOD(Swow_Http_Parser, execute)
     RETURN_LONG(parser->parsed_length);
 }
 
+#define SWOW_HTTP_PARSER_HEAD_EVENTS ( \
+    CAT_HTTP_PARSER_EVENT_URL | \
+    CAT_HTTP_PARSER_EVENT_STATUS | \
+    CAT_HTTP_PARSER_EVENT_HEADER_FIELD | \
+    CAT_HTTP_PARSER_EVENT_HEADER_VALUE | \
+    CAT_HTTP_PARSER_EVENT_HEADERS_COMPLETE \
+)
+
+SWOW_API cat_bool_t swow_http_parser_execute_head(cat_http_parser_t *parser, swow_http_parser_head_t *head, const char *data, size_t length)
+{
+    cat_http_parser_events_t events;
+    size_t parsed_length = 0;
+    cat_bool_t ret;
+
+    if (head->completed) {
+        /* head of the next message */
+        swow_http_parser_head_close(head);
+    }
+
+    /* collect all head events here instead of returning them one by one */
+    events = cat_http_parser_get_events(parser);
+    cat_http_parser_set_events(parser, events | SWOW_HTTP_PARSER_HEAD_EVENTS);
+    while (1) {
+        ret = cat_http_parser_execute(parser, data + parsed_length, length - parsed_length);
+        if (unlikely(!ret)) {
+            break;
+        }
+        parsed_length += parser->parsed_length;
+        switch (parser->event) {
+            case CAT_HTTP_PARSER_EVENT_URL:
+            case CAT_HTTP_PARSER_EVENT_STATUS:
+                smart_str_appendl(&head->line, parser->data, parser->data_length);
+                continue;
+            case CAT_HTTP_PARSER_EVENT_HEADER_FIELD:
+                /* data of the same field or value may be split into several events */
+                if (head->has_header_value) {
+                    swow_http_parser_head_add_header(head);
+                }
+                smart_str_appendl(&head->header_name, parser->data, parser->data_length);
+                continue;
+            case CAT_HTTP_PARSER_EVENT_HEADER_VALUE:
+                smart_str_appendl(&head->header_value, parser->data, parser->data_length);
+                head->has_header_value = true;
+                continue;
+            case CAT_HTTP_PARSER_EVENT_HEADERS_COMPLETE:
+                if (head->has_header_value) {
+                    swow_http_parser_head_add_header(head);
+                }
+                head->completed = true;
+                break;
+            case CAT_HTTP_PARSER_EVENT_NONE:
+                /* need more data */
+                break;
+            default:
+                /* events subscribed by user (e.g. MESSAGE_BEGIN), skip them */
+                continue;
+        }
+        break;
+    }
+    cat_http_parser_set_events(parser, events);
+
+    if (likely(ret)) {
+        parser->parsed_length = parsed_length;
+    }
+
+    return ret;
+}
+
+#define arginfo_class_Swow_Http_Parser_executeHead arginfo_class_Swow_Http_Parser_execute
+
+static PHP_METHOD(Swow_Http_Parser, executeHead)
+{
+    SWOW_HTTP_PARSER_GETTER(s_parser, parser);
+    zend_string *string;
+    zend_long start = 0;
+    zend_long length = -1;
+    const char *ptr;
+    cat_bool_t ret;
+
+    ZEND_PARSE_PARAMETERS_START(1, 3)
+        SWOW_PARAM_STRINGABLE_EXPECT_BUFFER_FOR_READING(string)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(start)
+        Z_PARAM_LONG(length)
+    ZEND_PARSE_PARAMETERS_END();
+
+    /* check args and initialize */
+    ptr = swow_string_get_readable_space(string, start, &length, 1);
+
+    if (UNEXPECTED(ptr == NULL)) {
+        RETURN_THROWS();
+    }
+
+    ret = swow_http_parser_execute_head(parser, &s_parser->head, ptr, length);
+
+    if (UNEXPECTED(!ret)) {
+        swow_throw_exception_with_last(swow_http_parser_exception_ce);
+        RETURN_THROWS();
+    }
+
+    s_parser->data_offset = parser->data - ZSTR_VAL(string);
+
+    RETURN_LONG(parser->parsed_length);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Http_Parser_getHead, 0, 0, IS_ARRAY, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Http_Parser, getHead)
+{
+    SWOW_HTTP_PARSER_GETTER(s_parser, parser);
+    swow_http_parser_head_t *head = &s_parser->head;
+    zval z_tmp;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    array_init_size(return_value, 5);
+    ZVAL_STRINGL_FAST(&z_tmp, swow_http_smart_str_value(&head->line), swow_http_smart_str_length(&head->line));
+    if (cat_http_parser_get_type(parser) == CAT_HTTP_PARSER_TYPE_RESPONSE) {
+        add_assoc_long_ex(return_value, ZEND_STRL("status_code"), cat_http_parser_get_status_code(parser));
+        add_assoc_zval_ex(return_value, ZEND_STRL("reason_phrase"), &z_tmp);
+    } else {
+        add_assoc_string_ex(return_value, ZEND_STRL("method"), cat_http_parser_get_method_name(parser));
+        add_assoc_zval_ex(return_value, ZEND_STRL("uri"), &z_tmp);
+    }
+    add_assoc_string_ex(return_value, ZEND_STRL("protocol_version"), cat_http_parser_get_protocol_version(parser));
+    if (Z_TYPE(head->headers) != IS_UNDEF) {
+        Z_ADDREF(head->headers);
+        add_assoc_zval_ex(return_value, ZEND_STRL("headers"), &head->headers);
+        Z_ADDREF(head->header_names);
+        add_assoc_zval_ex(return_value, ZEND_STRL("header_names"), &head->header_names);
+    } else {
+        ZVAL_EMPTY_ARRAY(&z_tmp);
+        add_assoc_zval_ex(return_value, ZEND_STRL("headers"), &z_tmp);
+        add_assoc_zval_ex(return_value, ZEND_STRL("header_names"), &z_tmp);
+    }
+}
+
 #define arginfo_class_Swow_Http_Parser_getEvent arginfo_class_Swow_Http_Parser_getType
 
 static PHP_METHOD(Swow_Http_Parser, getEvent)
@@ -437,6 +762,7 @@ static PHP_METHOD(Swow_Http_Parser, reset)
 
     cat_http_parser_reset(parser);
     s_parser->data_offset = 0;
+    swow_http_parser_head_close(&s_parser->head);
 
     RETURN_THIS();
 }
@@ -463,6 +789,8 @@ static const zend_function_entry swow_http_parser_methods[] = {
     PHP_ME(Swow_Http_Parser, getEvents,             arginfo_class_Swow_Http_Parser_getEvents,             ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Http_Parser, setEvents,             arginfo_class_Swow_Http_Parser_setEvents,             ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Http_Parser, execute,               arginfo_class_Swow_Http_Parser_execute,               ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Http_Parser, executeHead,           arginfo_class_Swow_Http_Parser_executeHead,           ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Http_Parser, getHead,               arginfo_class_Swow_Http_Parser_getHead,               ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Http_Parser, getEvent,              arginfo_class_Swow_Http_Parser_getEvent,              ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Http_Parser, getEventName,          arginfo_class_Swow_Http_Parser_getEventName,          ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Http_Parser, getPreviousEvent,      arginfo_class_Swow_Http_Parser_getPreviousEvent,      ZEND_ACC_PUBLIC)
@@ -740,7 +1068,7 @@ zend_result swow_http_module_init(INIT_FUNC_ARGS)
         "Swow\\Http\\Parser", NULL, swow_http_parser_methods,
         &swow_http_parser_handlers, NULL,
         cat_false, cat_false,
-        swow_http_parser_create_object, NULL,
+        swow_http_parser_create_object, swow_http_parser_free_object,
         XtOffsetOf(swow_http_parser_t, std)
     );
     zend_declare_class_constant_long(swow_http_parser_ce, ZEND_STRL("TYPE_BOTH"), CAT_HTTP_PARSER_TYPE_BOTH);
@@ -754,6 +1082,7 @@ zend_result swow_http_module_init(INIT_FUNC_ARGS)
 #undef SWOW_HTTP_PARSER_EVENT_GEN
     zend_declare_class_constant_long(swow_http_parser_ce, ZEND_STRL("EVENTS_NONE"), CAT_HTTP_PARSER_EVENTS_NONE);
     zend_declare_class_constant_long(swow_http_parser_ce, ZEND_STRL("EVENTS_ALL"), CAT_HTTP_PARSER_EVENTS_ALL);
+    swow_http_known_header_names_init();
     /* Parser\\Exception */
     swow_http_parser_exception_ce = swow_register_internal_class(
         "Swow\\Http\\ParserException", swow_exception_ce, NULL, NULL, NULL, cat_true, cat_true, NULL, NULL, 0
@@ -0,0 +1,949 @@
+/*
+  +--------------------------------------------------------------------------+
+  | Swow                                                                     |
+  +--------------------------------------------------------------------------+
+  | Licensed under the Apache License, Version 2.0 (the "License");          |
+  | you may not use this file except in compliance with the License.         |
+  | You may obtain a copy of the License at                                  |
+  | http://www.apache.org/licenses/LICENSE-2.0                               |
+  | Unless required by applicable law or agreed to in writing, software      |
+  | distributed under the License is distributed on an "AS IS" BASIS,        |
+  | WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. |
+  | See the License for the specific language governing permissions and      |
+  | limitations under the License. See accompanying LICENSE file.            |
+  +--------------------------------------------------------------------------+
+  | Author: Twosee <twosee@php.net>                                          |
+  +--------------------------------------------------------------------------+
+ */
+
+#include "swow_http_server.h"
+
+#include "swow_coroutine.h"
+
+#include "cat_buffer.h"
+#include "cat_time.h"
+
+SWOW_API zend_class_entry *swow_http_server_ce;
+SWOW_API zend_object_handlers swow_http_server_handlers;
+
+SWOW_API zend_class_entry *swow_http_server_request_ce;
+SWOW_API zend_object_handlers swow_http_server_request_handlers;
+
+/* Request */
+
+static zend_always_inline void swow_http_server_request_init(swow_http_server_request_t *request)
+{
+    request->connection = NULL;
+    request->method = CAT_HTTP_METHOD_GET;
+    request->major_version = 1;
+    request->minor_version = 1;
+    request->keep_alive = false;
+    request->responded = false;
+    request->uri = ZSTR_EMPTY_ALLOC();
+    ZVAL_EMPTY_ARRAY(&request->headers);
+    ZVAL_EMPTY_ARRAY(&request->header_names);
+    request->body = ZSTR_EMPTY_ALLOC();
+}
+
+static zend_always_inline void swow_http_server_request_clean(swow_http_server_request_t *request)
+{
+    zend_string_release(request->uri);
+    zval_ptr_dtor(&request->headers);
+    zval_ptr_dtor(&request->header_names);
+    zend_string_release(request->body);
+}
+
+static zend_object *swow_http_server_request_create_object(zend_class_entry *ce)
+{
+    swow_http_server_request_t *request = swow_object_alloc(swow_http_server_request_t, ce, swow_http_server_request_handlers);
+
+    swow_http_server_request_init(request);
+
+    return &request->std;
+}
+
+static void swow_http_server_request_free_object(zend_object *object)
+{
+    swow_http_server_request_t *request = swow_http_server_request_get_from_object(object);
+
+    swow_http_server_request_clean(request);
+
+    zend_object_std_dtor(&request->std);
+}
+
+static zend_always_inline bool swow_http_server_is_valid_header_name(const zend_string *header_name)
+{
+    const char *p = ZSTR_VAL(header_name), *pe = p + ZSTR_LEN(header_name);
+
+    if (UNEXPECTED(p == pe)) {
+        return false;
+    }
+    for (; p < pe; p++) {
+        switch (*p) {
+            case '\r':
+            case '\n':
+            case '\0':
+            case ':':
+            case ' ':
+            case '\t':
+                return false;
+        }
+    }
+
+    return true;
+}
+
+static zend_always_inline bool swow_http_server_is_valid_header_value(const zend_string *header_value)
+{
+    const char *p = ZSTR_VAL(header_value), *pe = p + ZSTR_LEN(header_value);
+
+    for (; p < pe; p++) {
+        if (UNEXPECTED(*p == '\r' || *p == '\n' || *p == '\0')) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* it returns false if the value may inject something into the response */
+static zend_always_inline bool swow_http_server_append_header(smart_str *output, zend_string *header_name, zval *z_header_value)
+{
+    zend_string *header_value, *tmp_header_value;
+
+    if (ZVAL_IS_NULL(z_header_value)) {
+        return true;
+    }
+    header_value = zval_get_tmp_string(z_header_value, &tmp_header_value);
+    if (UNEXPECTED(!swow_http_server_is_valid_header_value(header_value))) {
+        zend_tmp_string_release(tmp_header_value);
+        return false;
+    }
+    smart_str_append(output, header_name);
+    smart_str_appendl(output, ": ", CAT_STRLEN(": "));
+    smart_str_append(output, header_value);
+    smart_str_appendl(output, "\r\n", CAT_STRLEN("\r\n"));
+    zend_tmp_string_release(tmp_header_value);
+
+    return true;
+}
+
+static zend_always_inline bool swow_http_server_is_connection_close(zval *z_header_value)
+{
+    return Z_TYPE_P(z_header_value) == IS_STRING &&
+           zend_string_equals_literal_ci(Z_STR_P(z_header_value), "close");
+}
+
+static zend_always_inline size_t swow_http_server_get_output_length(const swow_http_server_connection_t *connection)
+{
+    return connection->output.s != NULL ? ZSTR_LEN(connection->output.s) : 0;
+}
+
+static bool swow_http_server_connection_flush(swow_http_server_connection_t *connection)
+{
+    size_t length = swow_http_server_get_output_length(connection);
+    cat_bool_t ret;
+
+    if (length == 0) {
+        return true;
+    }
+    ret = cat_socket_send(connection->socket, ZSTR_VAL(connection->output.s), length);
+    /* keep the memory for the next responses */
+    ZSTR_LEN(connection->output.s) = 0;
+
+    return ret;
+}
+
+/* the head is packed to the output, and the body is also appended to it unless it is large,
+ * if there is an invalid header, nothing is appended and ValueError is thrown */
+static bool swow_http_server_connection_respond(
+    swow_http_server_connection_t *connection, swow_http_server_request_t *request,
+    zend_long status_code, zend_string *body, HashTable *headers
+)
+{
+    smart_str *output = &connection->output;
+    size_t output_length = swow_http_server_get_output_length(connection);
+    bool keep_alive = request->keep_alive;
+    size_t body_length = ZSTR_LEN(body);
+    /* 1xx, 204 and 304 responses never have a body, so they must not announce one either */
+    bool has_body = status_code >= 200 &&
+        status_code != CAT_HTTP_STATUS_NO_CONTENT &&
+        status_code != CAT_HTTP_STATUS_NOT_MODIFIED;
+    zend_string *header_name;
+    zval *z_header_value;
+
+    smart_str_appendl(output, "HTTP/1.1 ", CAT_STRLEN("HTTP/1.1 "));
+    smart_str_append_long(output, status_code);
+    smart_str_appendc(output, ' ');
+    smart_str_appends(output, cat_http_status_get_reason((cat_http_status_code_t) status_code));
+    smart_str_appendl(output, "\r\n", CAT_STRLEN("\r\n"));
+    if (headers != NULL) {
+        ZEND_HASH_FOREACH_STR_KEY_VAL(headers, header_name, z_header_value) {
+            if (UNEXPECTED(header_name == NULL)) {
+                continue;
+            }
+            ZVAL_DEREF(z_header_value);
+            if (UNEXPECTED(!swow_http_server_is_valid_header_name(header_name))) {
+                zend_argument_value_error(3, "must not contain an invalid header name");
+                goto _invalid_header;
+            }
+            /* message framing is always managed by server,
+             * Transfer-Encoding would make clients ignore the Content-Length we send */
+            if (zend_string_equals_literal_ci(header_name, "Content-Length") ||
+                zend_string_equals_literal_ci(header_name, "Transfer-Encoding")) {
+                continue;
+            }
+            if (zend_string_equals_literal_ci(header_name, "Connection")) {
+                if (Z_TYPE_P(z_header_value) != IS_ARRAY) {
+                    keep_alive = keep_alive && !swow_http_server_is_connection_close(z_header_value);
+                } else {
+                    ZEND_HASH_FOREACH_VAL(Z_ARR_P(z_header_value), z_header_value) {
+                        keep_alive = keep_alive && !swow_http_server_is_connection_close(z_header_value);
+                    } ZEND_HASH_FOREACH_END();
+                }
+                continue;
+            }
+            if (Z_TYPE_P(z_header_value) != IS_ARRAY) {
+                if (UNEXPECTED(!swow_http_server_append_header(output, header_name, z_header_value))) {
+                    goto _invalid_header_value;
+                }
+            } else {
+                ZEND_HASH_FOREACH_VAL(Z_ARR_P(z_header_value), z_header_value) {
+                    if (UNEXPECTED(!swow_http_server_append_header(output, header_name, z_header_value))) {
+                        goto _invalid_header_value;
+                    }
+                } ZEND_HASH_FOREACH_END();
+            }
+        } ZEND_HASH_FOREACH_END();
+    }
+    if (0) {
+        _invalid_header_value:
+        zend_argument_value_error(3, "must not contain CR, LF or NUL characters in header values");
+        _invalid_header:
+        /* drop the partial head, responses before it are still valid */
+        ZSTR_LEN(output->s) = output_length;
+        return false;
+    }
+    if (has_body) {
+        smart_str_appendl(output, "Content-Length: ", CAT_STRLEN("Content-Length: "));
+        smart_str_append_unsigned(output, body_length);
+        smart_str_appendl(output, "\r\n", CAT_STRLEN("\r\n"));
+    }
+    if (keep_alive) {
+        smart_str_appendl(output, "Connection: keep-alive\r\n\r\n", CAT_STRLEN("Connection: keep-alive\r\n\r\n"));
+    } else {
+        smart_str_appendl(output, "Connection: close\r\n\r\n", CAT_STRLEN("Connection: close\r\n\r\n"));
+    }
+    request->responded = true;
+    connection->keep_alive = keep_alive;
+
+    if (!has_body || request->method == CAT_HTTP_METHOD_HEAD || body_length == 0) {
+        return true;
+    }
+    if (body_length < SWOW_HTTP_SERVER_OUTPUT_FLUSH_SIZE) {
+        smart_str_append(output, body);
+        return true;
+    } else {
+        const cat_socket_write_vector_t vector[2] = {
+            cat_socket_write_vector_init(ZSTR_VAL(output->s), ZSTR_LEN(output->s)),
+            cat_socket_write_vector_init(ZSTR_VAL(body), body_length),
+        };
+        cat_bool_t ret = cat_socket_write(connection->socket, vector, CAT_ARRAY_SIZE(vector));
+        ZSTR_LEN(output->s) = 0;
+        return ret;
+    }
+}
+
+static void swow_http_server_connection_respond_error(swow_http_server_connection_t *connection, cat_http_status_code_t status_code)
+{
+    const char *reason = cat_http_status_get_reason(status_code);
+    swow_http_server_request_t request;
+    zend_string *body;
+
+    /* it is not a valid request, respond to a dummy one and close the connection */
+    request.method = CAT_HTTP_METHOD_GET;
+    request.keep_alive = false;
+    body = zend_string_init(reason, strlen(reason), 0);
+    (void) swow_http_server_connection_respond(connection, &request, status_code, body, NULL);
+    zend_string_release(body);
+}
+
+#define getThisRequest() (swow_http_server_request_get_from_object(Z_OBJ_P(ZEND_THIS)))
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Http_Server_Request_getMethod, 0, 0, IS_STRING, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Http_Server_Request, getMethod)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_STRING(cat_http_method_get_name(getThisRequest()->method));
+}
+
+#define arginfo_class_Swow_Http_Server_Request_getUri arginfo_class_Swow_Http_Server_Request_getMethod
+
+static PHP_METHOD(Swow_Http_Server_Request, getUri)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_STR_COPY(getThisRequest()->uri);
+}
+
+#define arginfo_class_Swow_Http_Server_Request_getProtocolVersion arginfo_class_Swow_Http_Server_Request_getMethod
+
+static PHP_METHOD(Swow_Http_Server_Request, getProtocolVersion)
+{
+    swow_http_server_request_t *request = getThisRequest();
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_STR(zend_strpprintf(0, "%u.%u", request->major_version, request->minor_version));
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Http_Server_Request_getHeaders, 0, 0, IS_ARRAY, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Http_Server_Request, getHeaders)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_COPY(&getThisRequest()->headers);
+}
+
+#define arginfo_class_Swow_Http_Server_Request_getHeaderNames arginfo_class_Swow_Http_Server_Request_getHeaders
+
+static PHP_METHOD(Swow_Http_Server_Request, getHeaderNames)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_COPY(&getThisRequest()->header_names);
+}
+
+static zval *swow_http_server_request_find_header(swow_http_server_request_t *request, zend_string *name)
+{
+    zend_string *lower_name = zend_string_tolower(name);
+    zval *z_header_name = zend_symtable_find(Z_ARRVAL(request->header_names), lower_name);
+    zend_string_release(lower_name);
+
+    if (z_header_name == NULL) {
+        return NULL;
+    }
+
+    return zend_symtable_find(Z_ARRVAL(request->headers), Z_STR_P(z_header_name));
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Http_Server_Request_hasHeader, 0, 1, _IS_BOOL, 0)
+    ZEND_ARG_TYPE_INFO(0, name, IS_STRING, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Http_Server_Request, hasHeader)
+{
+    zend_string *name;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_STR(name)
+    ZEND_PARSE_PARAMETERS_END();
+
+    RETURN_BOOL(swow_http_server_request_find_header(getThisRequest(), name) != NULL);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Http_Server_Request_getHeader, 0, 1, IS_STRING, 0)
+    ZEND_ARG_TYPE_INFO(0, name, IS_STRING, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Http_Server_Request, getHeader)
+{
+    zend_string *name;
+    zval *z_header_values, *z_header_value;
+    smart_str str = {0};
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_STR(name)
+    ZEND_PARSE_PARAMETERS_END();
+
+    z_header_values = swow_http_server_request_find_header(getThisRequest(), name);
+    if (z_header_values == NULL) {
+        RETURN_EMPTY_STRING();
+    }
+    if (zend_hash_num_elements(Z_ARRVAL_P(z_header_values)) == 1) {
+        RETURN_COPY(zend_hash_index_find(Z_ARRVAL_P(z_header_values), 0));
+    }
+    /* multiple values are joined by comma */
+    ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(z_header_values), z_header_value) {
+        if (str.s != NULL) {
+            smart_str_appendl(&str, ", ", CAT_STRLEN(", "));
+        }
+        smart_str_append(&str, Z_STR_P(z_header_value));
+    } ZEND_HASH_FOREACH_END();
+
+    RETURN_STR(smart_str_extract(&str));
+}
+
+#define arginfo_class_Swow_Http_Server_Request_getBody arginfo_class_Swow_Http_Server_Request_getMethod
+
+static PHP_METHOD(Swow_Http_Server_Request, getBody)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_STR_COPY(getThisRequest()->body);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Http_Server_Request_shouldKeepAlive, 0, 0, _IS_BOOL, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Http_Server_Request, shouldKeepAlive)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_BOOL(getThisRequest()->keep_alive);
+}
+
+#define arginfo_class_Swow_Http_Server_Request_isResponded arginfo_class_Swow_Http_Server_Request_shouldKeepAlive
+
+static PHP_METHOD(Swow_Http_Server_Request, isResponded)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_BOOL(getThisRequest()->responded);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Http_Server_Request_respond, 0, 0, IS_VOID, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, statusCode, IS_LONG, 0, "Swow\\Http\\Status::OK")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, body, IS_STRING, 0, "\'\'")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, headers, IS_ARRAY, 0, "[]")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Http_Server_Request, respond)
+{
+    swow_http_server_request_t *request = getThisRequest();
+    zend_long status_code = CAT_HTTP_STATUS_OK;
+    zend_string *body = zend_empty_string;
+    HashTable *headers = NULL;
+
+    ZEND_PARSE_PARAMETERS_START(0, 3)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(status_code)
+        Z_PARAM_STR(body)
+        Z_PARAM_ARRAY_HT(headers)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (UNEXPECTED(status_code < 100 || status_code > 999)) {
+        zend_argument_value_error(1, "must be a valid HTTP status code");
+        RETURN_THROWS();
+    }
+    if (UNEXPECTED(request->responded)) {
+        zend_throw_error(NULL, "Request has already been responded");
+        RETURN_THROWS();
+    }
+    if (UNEXPECTED(request->connection == NULL)) {
+        zend_throw_error(NULL, "Request can only be responded in the handler");
+        RETURN_THROWS();
+    }
+
+    if (UNEXPECTED(!swow_http_server_connection_respond(request->connection, request, status_code, body, headers))) {
+        if (EG(exception) == NULL) {
+            swow_throw_exception_with_last(swow_socket_exception_ce);
+        }
+        RETURN_THROWS();
+    }
+}
+
+static const zend_function_entry swow_http_server_request_methods[] = {
+    PHP_ME(Swow_Http_Server_Request, getMethod,          arginfo_class_Swow_Http_Server_Request_getMethod,          ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Http_Server_Request, getUri,             arginfo_class_Swow_Http_Server_Request_getUri,             ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Http_Server_Request, getProtocolVersion, arginfo_class_Swow_Http_Server_Request_getProtocolVersion, ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Http_Server_Request, getHeaders,         arginfo_class_Swow_Http_Server_Request_getHeaders,         ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Http_Server_Request, getHeaderNames,     arginfo_class_Swow_Http_Server_Request_getHeaderNames,     ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Http_Server_Request, hasHeader,          arginfo_class_Swow_Http_Server_Request_hasHeader,          ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Http_Server_Request, getHeader,          arginfo_class_Swow_Http_Server_Request_getHeader,          ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Http_Server_Request, getBody,            arginfo_class_Swow_Http_Server_Request_getBody,            ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Http_Server_Request, shouldKeepAlive,    arginfo_class_Swow_Http_Server_Request_shouldKeepAlive,    ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Http_Server_Request, isResponded,        arginfo_class_Swow_Http_Server_Request_isResponded,        ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Http_Server_Request, respond,            arginfo_class_Swow_Http_Server_Request_respond,            ZEND_ACC_PUBLIC)
+    PHP_FE_END
+};
+
+/* Server */
+
+static zend_object *swow_http_server_create_object(zend_class_entry *ce)
+{
+    swow_http_server_t *server = swow_object_alloc(swow_http_server_t, ce, swow_http_server_handlers);
+
+    ZVAL_NULL(&server->z_socket);
+    ZVAL_UNDEF(&server->handler.z_callable);
+    server->max_header_length = SWOW_HTTP_SERVER_DEFAULT_MAX_HEADER_LENGTH;
+    server->max_content_length = SWOW_HTTP_SERVER_DEFAULT_MAX_CONTENT_LENGTH;
+
+    return &server->std;
+}
+
+static void swow_http_server_free_object(zend_object *object)
+{
+    swow_http_server_t *server = swow_http_server_get_from_object(object);
+
+    zval_ptr_dtor(&server->z_socket);
+    if (swow_fcall_storage_is_available(&server->handler)) {
+        swow_fcall_storage_release(&server->handler);
+    }
+
+    zend_object_std_dtor(&server->std);
+}
+
+static HashTable *swow_http_server_get_gc(zend_object *object, zval **gc_data, int *gc_count)
+{
+    swow_http_server_t *server = swow_http_server_get_from_object(object);
+    zend_get_gc_buffer *zgc_buffer = zend_get_gc_buffer_create();
+
+    zend_get_gc_buffer_add_zval(zgc_buffer, &server->z_socket);
+    if (swow_fcall_storage_is_available(&server->handler)) {
+        zend_get_gc_buffer_add_zval(zgc_buffer, &server->handler.z_callable);
+    }
+    zend_get_gc_buffer_use(zgc_buffer, gc_data, gc_count);
+
+    return zend_std_get_properties(object);
+}
+
+/* it calls the handler with the request just parsed, the request object is reused if nobody holds it */
+static bool swow_http_server_connection_dispatch(swow_http_server_connection_t *connection, zval *z_request)
+{
+    swow_http_server_t *server = connection->server;
+    cat_http_parser_t *parser = &connection->parser;
+    swow_http_parser_head_t *head = &connection->head;
+    swow_http_server_request_t *request;
+    zval retval;
+
+    if (Z_TYPE_P(z_request) == IS_OBJECT && GC_REFCOUNT(Z_OBJ_P(z_request)) == 1) {
+        request = swow_http_server_request_get_from_object(Z_OBJ_P(z_request));
+        swow_http_server_request_clean(request);
+    } else {
+        zval_ptr_dtor(z_request);
+        ZVAL_OBJ(z_request, swow_object_create(swow_http_server_request_ce));
+        request = swow_http_server_request_get_from_object(Z_OBJ_P(z_request));
+    }
+    request->method = cat_http_parser_get_method(parser);
+    request->major_version = cat_http_parser_get_major_version(parser);
+    request->minor_version = cat_http_parser_get_minor_version(parser);
+    request->keep_alive = cat_http_parser_should_keep_alive(parser);
+    request->responded = false;
+    request->uri = smart_str_extract(&head->line);
+    if (Z_TYPE(head->headers) != IS_UNDEF) {
+        ZVAL_COPY_VALUE(&request->headers, &head->headers);
+        ZVAL_COPY_VALUE(&request->header_names, &head->header_names);
+        ZVAL_UNDEF(&head->headers);
+        ZVAL_UNDEF(&head->header_names);
+    } else {
+        ZVAL_EMPTY_ARRAY(&request->headers);
+        ZVAL_EMPTY_ARRAY(&request->header_names);
+    }
+    request->body = smart_str_extract(&connection->body);
+    swow_http_parser_head_close(head);
+    connection->header_length = 0;
+    connection->keep_alive = request->keep_alive;
+
+    request->connection = connection;
+    swow_call_known_fcc(&server->handler.fcc, &retval, 1, z_request, NULL);
+    request->connection = NULL;
+
+    if (UNEXPECTED(EG(exception) != NULL)) {
+        /* nothing of this response has been sent yet */
+        if (!request->responded) {
+            swow_http_server_connection_respond_error(connection, CAT_HTTP_STATUS_INTERNAL_SERVER_ERROR);
+        }
+        connection->keep_alive = false;
+        /* a failed handler only closes its own connection, exit and kill still stop the coroutine */
+        if (!zend_is_unwind_exit(EG(exception)) &&
+            !(swow_coroutine_get_current()->coroutine.flags & SWOW_COROUTINE_FLAG_KILLED)) {
+            zend_exception_error(EG(exception), E_WARNING);
+        }
+        return false;
+    }
+    if (!request->responded) {
+        /* handler may return the body of response directly */
+        zend_string *body = Z_TYPE(retval) == IS_STRING ? Z_STR(retval) : zend_empty_string;
+        if (UNEXPECTED(!swow_http_server_connection_respond(connection, request, CAT_HTTP_STATUS_OK, body, NULL))) {
+            zval_ptr_dtor(&retval);
+            return false;
+        }
+    }
+    zval_ptr_dtor(&retval);
+
+    if (swow_http_server_get_output_length(connection) >= SWOW_HTTP_SERVER_OUTPUT_FLUSH_SIZE) {
+        return swow_http_server_connection_flush(connection);
+    }
+
+    return true;
+}
+
+static void swow_http_server_handle_connection(swow_http_server_t *server, cat_socket_t *socket)
+{
+    swow_http_server_connection_t connection;
+    cat_http_parser_t *parser = &connection.parser;
+    swow_http_parser_head_t *head = &connection.head;
+    cat_http_status_code_t error_status_code = CAT_HTTP_STATUS_BAD_REQUEST;
+    zval z_request;
+    ssize_t n;
+
+    connection.server = server;
+    connection.socket = socket;
+    cat_http_parser_init(parser);
+    cat_http_parser_set_type(parser, CAT_HTTP_PARSER_TYPE_REQUEST);
+    cat_http_parser_set_events(parser, CAT_HTTP_PARSER_EVENT_BODY | CAT_HTTP_PARSER_EVENT_MESSAGE_COMPLETE);
+    swow_http_parser_head_init(head);
+    connection.buffer_size = CAT_BUFFER_COMMON_SIZE;
+    connection.buffer = NULL;
+    connection.buffer_length = 0;
+    connection.parsed_offset = 0;
+    connection.header_length = 0;
+    memset(&connection.body, 0, sizeof(connection.body));
+    memset(&connection.output, 0, sizeof(connection.output));
+    connection.keep_alive = true;
+    ZVAL_NULL(&z_request);
+
+    while (1) {
+        if (connection.buffer == NULL) {
+            /* wait without the buffer, so that idle keep-alive connections do not hold it */
+            if (!cat_socket_wait_readable(socket)) {
+                goto _close;
+            }
+            connection.buffer = (char *) emalloc(connection.buffer_size);
+        }
+        n = cat_socket_recv(socket, connection.buffer, connection.buffer_size);
+        if (n <= 0) {
+            /* closed by peer or error occurred */
+            goto _close;
+        }
+        connection.buffer_length = n;
+        connection.parsed_offset = 0;
+        /* parse all requests we have (they may be pipelined) */
+        while (1) {
+            const char *data = connection.buffer + connection.parsed_offset;
+            size_t length = connection.buffer_length - connection.parsed_offset;
+            if (!head->completed) {
+                if (UNEXPECTED(!swow_http_parser_execute_head(parser, head, data, length))) {
+                    error_status_code = CAT_HTTP_STATUS_BAD_REQUEST;
+                    goto _error;
+                }
+                connection.parsed_offset += parser->parsed_length;
+                connection.header_length += parser->parsed_length;
+                if (UNEXPECTED(connection.header_length > server->max_header_length)) {
+                    /* nothing of header fields has been received, so the uri is too long */
+                    error_status_code = (Z_TYPE(head->headers) == IS_UNDEF && head->header_name.s == NULL) ?
+                        CAT_HTTP_STATUS_REQUEST_URI_TOO_LARGE :
+                        CAT_HTTP_STATUS_REQUEST_HEADER_FIELDS_TOO_LARGE;
+                    goto _error;
+                }
+                if (parser->event == CAT_HTTP_PARSER_EVENT_NONE) {
+                    break;
+                }
+                ZEND_ASSERT(parser->event == CAT_HTTP_PARSER_EVENT_HEADERS_COMPLETE);
+                if (!cat_http_parser_is_chunked(parser)) {
+                    uint64_t content_length = cat_http_parser_get_content_length(parser);
+                    if (UNEXPECTED(content_length > server->max_content_length)) {
+                        error_status_code = CAT_HTTP_STATUS_REQUEST_ENTITY_TOO_LARGE;
+                        goto _error;
+                    }
+                    if (content_length > 0) {
+                        smart_str_alloc(&connection.body, content_length, 0);
+                    }
+                }
+                continue;
+            }
+            if (UNEXPECTED(!cat_http_parser_execute(parser, data, length))) {
+                error_status_code = CAT_HTTP_STATUS_BAD_REQUEST;
+                goto _error;
+            }
+            connection.parsed_offset += parser->parsed_length;
+            if (parser->event == CAT_HTTP_PARSER_EVENT_BODY) {
+                if (UNEXPECTED((connection.body.s != NULL ? ZSTR_LEN(connection.body.s) : 0) + parser->data_length > server->max_content_length)) {
+                    error_status_code = CAT_HTTP_STATUS_REQUEST_ENTITY_TOO_LARGE;
+                    goto _error;
+                }
+                smart_str_appendl(&connection.body, parser->data, parser->data_length);
+                continue;
+            }
+            if (parser->event == CAT_HTTP_PARSER_EVENT_NONE) {
+                break;
+            }
+            ZEND_ASSERT(parser->event == CAT_HTTP_PARSER_EVENT_MESSAGE_COMPLETE);
+            if (UNEXPECTED(!swow_http_server_connection_dispatch(&connection, &z_request))) {
+                goto _close;
+            }
+            if (!connection.keep_alive) {
+                goto _close;
+            }
+        }
+        /* all data has been consumed by parser */
+        ZEND_ASSERT(connection.parsed_offset == connection.buffer_length);
+        if (UNEXPECTED(!swow_http_server_connection_flush(&connection))) {
+            goto _close;
+        }
+        if (!cat_socket_wait_readable_ex(socket, 0)) {
+            /* no more data for now, the buffer is released until the next one comes */
+            efree(connection.buffer);
+            connection.buffer = NULL;
+        }
+    }
+
+    _error:
+    swow_http_server_connection_respond_error(&connection, error_status_code);
+    _close:
+    (void) swow_http_server_connection_flush(&connection);
+    if (cat_socket_is_available(socket)) {
+        cat_socket_close(socket);
+    }
+    zval_ptr_dtor(&z_request);
+    smart_str_free(&connection.body);
+    smart_str_free(&connection.output);
+    swow_http_parser_head_close(head);
+    if (connection.buffer != NULL) {
+        efree(connection.buffer);
+    }
+}
+
+#define getThisServer() (swow_http_server_get_from_object(Z_OBJ_P(ZEND_THIS)))
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_class_Swow_Http_Server___construct, 0, 0, 1)
+    ZEND_ARG_OBJ_INFO(0, socket, Swow\\Socket, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Http_Server, __construct)
+{
+    swow_http_server_t *server = getThisServer();
+    zval *z_socket;
+
+    if (UNEXPECTED(Z_TYPE(server->z_socket) != IS_NULL)) {
+        zend_throw_error(NULL, "%s can be constructed only once", ZEND_THIS_NAME);
+        RETURN_THROWS();
+    }
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_OBJECT_OF_CLASS(z_socket, swow_socket_ce)
+    ZEND_PARSE_PARAMETERS_END();
+
+    ZVAL_COPY(&server->z_socket, z_socket);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_OBJ_INFO_EX(arginfo_class_Swow_Http_Server_getSocket, 0, 0, Swow\\Socket, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Http_Server, getSocket)
+{
+    swow_http_server_t *server = getThisServer();
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    if (UNEXPECTED(Z_TYPE(server->z_socket) == IS_NULL)) {
+        zend_throw_error(NULL, "%s has not been constructed", ZEND_THIS_NAME);
+        RETURN_THROWS();
+    }
+
+    RETURN_COPY(&server->z_socket);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Http_Server_getMaxHeaderLength, 0, 0, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Http_Server, getMaxHeaderLength)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_LONG((zend_long) getThisServer()->max_header_length);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Http_Server_setMaxHeaderLength, 0, 1, IS_STATIC, 0)
+    ZEND_ARG_TYPE_INFO(0, maxHeaderLength, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Http_Server, setMaxHeaderLength)
+{
+    zend_long max_header_length;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_LONG(max_header_length)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (UNEXPECTED(max_header_length <= 0)) {
+        zend_argument_value_error(1, "must be greater than 0");
+        RETURN_THROWS();
+    }
+
+    getThisServer()->max_header_length = (size_t) max_header_length;
+
+    RETURN_THIS();
+}
+
+#define arginfo_class_Swow_Http_Server_getMaxContentLength arginfo_class_Swow_Http_Server_getMaxHeaderLength
+
+static PHP_METHOD(Swow_Http_Server, getMaxContentLength)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_LONG((zend_long) getThisServer()->max_content_length);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Http_Server_setMaxContentLength, 0, 1, IS_STATIC, 0)
+    ZEND_ARG_TYPE_INFO(0, maxContentLength, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Http_Server, setMaxContentLength)
+{
+    zend_long max_content_length;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_LONG(max_content_length)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (UNEXPECTED(max_content_length < 0)) {
+        zend_argument_value_error(1, "must be greater than or equal to 0");
+        RETURN_THROWS();
+    }
+
+    getThisServer()->max_content_length = (size_t) max_content_length;
+
+    RETURN_THIS();
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Http_Server_serve, 0, 1, IS_VOID, 0)
+    ZEND_ARG_TYPE_INFO(0, handler, IS_CALLABLE, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Http_Server, serve)
+{
+    swow_http_server_t *server = getThisServer();
+    swow_fcall_storage_t handler;
+    zend_function *connection_handler;
+    swow_socket_t *s_socket;
+    cat_socket_t *socket;
+    cat_socket_type_t type;
+    zval z_connection_handler;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        SWOW_PARAM_FCALL(handler)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (UNEXPECTED(Z_TYPE(server->z_socket) == IS_NULL)) {
+        zend_throw_error(NULL, "%s has not been constructed", ZEND_THIS_NAME);
+        RETURN_THROWS();
+    }
+    s_socket = swow_socket_get_from_object(Z_OBJ(server->z_socket));
+    socket = &s_socket->socket;
+    type = cat_socket_get_simple_type(socket);
+
+    /* connections which are being handled will use the new handler for the next requests */
+    if (swow_fcall_storage_is_available(&server->handler)) {
+        swow_fcall_storage_release(&server->handler);
+    }
+    {
+        zval z_handler;
+        ZVAL_PTR(&z_handler, &handler);
+        (void) swow_fcall_storage_create(&server->handler, &z_handler);
+    }
+
+    /* every connection runs in its own coroutine */
+    connection_handler = (zend_function *) zend_hash_str_find_ptr(&swow_http_server_ce->function_table, ZEND_STRL("handleconnection"));
+    ZEND_ASSERT(connection_handler != NULL);
+    zend_create_fake_closure(&z_connection_handler, connection_handler, swow_http_server_ce, swow_http_server_ce, ZEND_THIS);
+
+    while (1) {
+        swow_socket_t *s_connection;
+        swow_coroutine_t *s_coroutine;
+        zval z_connection;
+        cat_bool_t ret;
+
+        s_connection = swow_socket_get_from_object(swow_object_create(Z_OBJCE(server->z_socket)));
+        ZVAL_OBJ(&z_connection, &s_connection->std);
+        ret = cat_socket_create(&s_connection->socket, type) != NULL &&
+              cat_socket_accept(socket, &s_connection->socket);
+        if (UNEXPECTED(!ret)) {
+            cat_errno_t error = cat_get_last_error_code();
+            zval_ptr_dtor(&z_connection);
+            if (!cat_socket_is_available(socket)) {
+                /* server socket has been closed, stop serving */
+                break;
+            }
+            if (error == CAT_ECONNABORTED) {
+                /* only the pending connection is gone */
+                continue;
+            }
+            if (error == CAT_EMFILE || error == CAT_ENFILE) {
+                /* wait for some connections to be closed */
+                (void) cat_time_msleep(SWOW_HTTP_SERVER_ACCEPT_RETRY_INTERVAL);
+                if (UNEXPECTED(EG(exception) != NULL)) {
+                    break;
+                }
+                continue;
+            }
+            swow_throw_exception_with_last(swow_socket_exception_ce);
+            break;
+        }
+        s_coroutine = swow_coroutine_create(&z_connection_handler);
+        if (UNEXPECTED(s_coroutine == NULL)) {
+            zval_ptr_dtor(&z_connection);
+            swow_throw_exception_with_last(swow_coroutine_exception_ce);
+            break;
+        }
+        if (UNEXPECTED(!swow_coroutine_resume(s_coroutine, &z_connection, NULL))) {
+            zval_ptr_dtor(&z_connection);
+            swow_coroutine_close(s_coroutine);
+            swow_throw_exception_with_last(swow_coroutine_exception_ce);
+            break;
+        }
+        zval_ptr_dtor(&z_connection);
+        swow_coroutine_close(s_coroutine);
+    }
+
+    zval_ptr_dtor(&z_connection_handler);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Http_Server_handleConnection, 0, 1, IS_VOID, 0)
+    ZEND_ARG_OBJ_INFO(0, connection, Swow\\Socket, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Http_Server, handleConnection)
+{
+    zval *z_connection;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_OBJECT_OF_CLASS(z_connection, swow_socket_ce)
+    ZEND_PARSE_PARAMETERS_END();
+
+    swow_http_server_handle_connection(getThisServer(), &swow_socket_get_from_object(Z_OBJ_P(z_connection))->socket);
+}
+
+static const zend_function_entry swow_http_server_methods[] = {
+    PHP_ME(Swow_Http_Server, __construct,         arginfo_class_Swow_Http_Server___construct,         ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Http_Server, getSocket,           arginfo_class_Swow_Http_Server_getSocket,           ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Http_Server, getMaxHeaderLength,  arginfo_class_Swow_Http_Server_getMaxHeaderLength,  ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Http_Server, setMaxHeaderLength,  arginfo_class_Swow_Http_Server_setMaxHeaderLength,  ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Http_Server, getMaxContentLength, arginfo_class_Swow_Http_Server_getMaxContentLength, ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Http_Server, setMaxContentLength, arginfo_class_Swow_Http_Server_setMaxContentLength, ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Http_Server, serve,               arginfo_class_Swow_Http_Server_serve,               ZEND_ACC_PUBLIC)
+    /* entry of connection coroutines */
+    PHP_ME(Swow_Http_Server, handleConnection,    arginfo_class_Swow_Http_Server_handleConnection,    ZEND_ACC_PRIVATE)
+    PHP_FE_END
+};
+
+zend_result swow_http_server_module_init(INIT_FUNC_ARGS)
+{
+    swow_http_server_ce = swow_register_internal_class(
+        "Swow\\Http\\Server", NULL, swow_http_server_methods,
+        &swow_http_server_handlers, NULL,
+        cat_false, cat_false,
+        swow_http_server_create_object, swow_http_server_free_object,
+        XtOffsetOf(swow_http_server_t, std)
+    );
+    swow_http_server_handlers.get_gc = swow_http_server_get_gc;
+    zend_declare_class_constant_long(swow_http_server_ce, ZEND_STRL("DEFAULT_MAX_HEADER_LENGTH"), SWOW_HTTP_SERVER_DEFAULT_MAX_HEADER_LENGTH);
+    zend_declare_class_constant_long(swow_http_server_ce, ZEND_STRL("DEFAULT_MAX_CONTENT_LENGTH"), SWOW_HTTP_SERVER_DEFAULT_MAX_CONTENT_LENGTH);
+
+    swow_http_server_request_ce = swow_register_internal_class(
+        "Swow\\Http\\Server\\Request", NULL, swow_http_server_request_methods,
+        &swow_http_server_request_handlers, NULL,
+        cat_false, cat_false,
+        swow_http_server_request_create_object, swow_http_server_request_free_object,
+        XtOffsetOf(swow_http_server_request_t, std)
+    );
+    swow_http_server_request_ce->ce_flags |= ZEND_ACC_FINAL;
+
+    return SUCCESS;
+}
@@ -25,6 +25,7 @@
 #include "swow_defer.h"
 #include "swow_coroutine.h"
 #include "swow_channel.h"
+#include "swow_thread.h"
 #include "swow_sync.h"
 #include "swow_event.h"
 #include "swow_time.h"
@@ -37,6 +38,7 @@
 #include "swow_closure.h"
 #include "swow_ipaddress.h"
 #include "swow_http.h"
+#include "swow_http_server.h"
 #include "swow_websocket.h"
 #include "swow_proc_open.h"
 
@@ -119,8 +121,18 @@ static ZEND_INI_MH(swow_OnUpdateBool_only_when_startup)
 PHP_INI_BEGIN()
 STD_ZEND_INI_BOOLEAN("swow.enable", "On", PHP_INI_ALL, swow_OnUpdateBool_only_when_startup, ini.enable, zend_swow_globals, swow_globals)
 STD_PHP_INI_ENTRY("swow.async_threads", "0", PHP_INI_ALL, swow_OnUpdateLong_only_when_startup, ini.async_threads, zend_swow_globals, swow_globals)
+STD_PHP_INI_ENTRY("swow.work_threads", "0", PHP_INI_ALL, swow_OnUpdateLong_only_when_startup, ini.work_threads, zend_swow_globals, swow_globals)
 STD_ZEND_INI_BOOLEAN("swow.async_file", "On", PHP_INI_ALL, swow_OnUpdateBool_only_when_startup, ini.async_file, zend_swow_globals, swow_globals)
+STD_ZEND_INI_BOOLEAN("swow.io_uring", "On", PHP_INI_ALL, swow_OnUpdateBool_only_when_startup, ini.io_uring, zend_swow_globals, swow_globals)
 STD_ZEND_INI_BOOLEAN("swow.async_tty", "On", PHP_INI_ALL, swow_OnUpdateBool_only_when_startup, ini.async_tty, zend_swow_globals, swow_globals)
+STD_PHP_INI_ENTRY("swow.coroutine_stack_pool_size", "64", PHP_INI_ALL, swow_OnUpdateLong_only_when_startup, ini.coroutine_stack_pool_size, zend_swow_globals, swow_globals)
+STD_ZEND_INI_BOOLEAN("swow.coroutine_stack_pool_trim", "Off", PHP_INI_ALL, swow_OnUpdateBool_only_when_startup, ini.coroutine_stack_pool_trim, zend_swow_globals, swow_globals)
+STD_PHP_INI_ENTRY("swow.buffer_pool_size", "256", PHP_INI_ALL, swow_OnUpdateLong_only_when_startup, ini.buffer_pool_size, zend_swow_globals, swow_globals)
+STD_PHP_INI_ENTRY("swow.dns_cache_size", "0", PHP_INI_ALL, swow_OnUpdateLong_only_when_startup, ini.dns_cache_size, zend_swow_globals, swow_globals)
+STD_PHP_INI_ENTRY("swow.dns_cache_ttl", "30000", PHP_INI_ALL, swow_OnUpdateLong_only_when_startup, ini.dns_cache_ttl, zend_swow_globals, swow_globals)
+STD_PHP_INI_ENTRY("swow.dns_cache_negative_ttl", "1000", PHP_INI_ALL, swow_OnUpdateLong_only_when_startup, ini.dns_cache_negative_ttl, zend_swow_globals, swow_globals)
+STD_PHP_INI_ENTRY("swow.ssl_session_cache_size", "1024", PHP_INI_ALL, swow_OnUpdateLong_only_when_startup, ini.ssl_session_cache_size, zend_swow_globals, swow_globals)
+STD_PHP_INI_ENTRY("swow.ssl_session_cache_ttl", "300000", PHP_INI_ALL, swow_OnUpdateLong_only_when_startup, ini.ssl_session_cache_ttl, zend_swow_globals, swow_globals)
 #ifdef CAT_HAVE_CURL
 PHP_INI_ENTRY("curl.cainfo", "", PHP_INI_SYSTEM, NULL)
 #endif
@@ -131,8 +143,20 @@ static void swow_globals_ctor(zend_swow_globals *g)
     g->runtime_state = SWOW_RUNTIME_STATE_NONE;
     g->ini.enable = true;
     g->ini.async_threads = 0;
+    g->ini.work_threads = CAT_WORK_EXECUTOR_DEFAULT_THREADS;
     g->ini.async_file = true;
+    g->ini.io_uring = true;
     g->ini.async_tty = true;
+    g->ini.coroutine_stack_pool_size = CAT_COROUTINE_STACK_POOL_DEFAULT_MAX_COUNT;
+    g->ini.coroutine_stack_pool_trim = false;
+    g->ini.buffer_pool_size = SWOW_BUFFER_POOL_DEFAULT_MAX_COUNT;
+    g->ini.dns_cache_size = CAT_DNS_CACHE_DEFAULT_MAX_SIZE;
+    g->ini.dns_cache_ttl = CAT_DNS_CACHE_DEFAULT_TTL;
+    g->ini.dns_cache_negative_ttl = CAT_DNS_CACHE_DEFAULT_NEGATIVE_TTL;
+#ifdef CAT_SSL
+    g->ini.ssl_session_cache_size = CAT_SSL_SESSION_CACHE_DEFAULT_MAX_SIZE;
+    g->ini.ssl_session_cache_ttl = CAT_SSL_SESSION_CACHE_DEFAULT_TTL;
+#endif
 }
 
 /* {{{ PHP_MINIT_FUNCTION
@@ -159,6 +183,12 @@ PHP_MINIT_FUNCTION(swow)
         char buffer[sizeof("1024")];
         (void) uv_os_setenv("CAT_TPS", zend_print_ulong_to_buf(buffer + sizeof(buffer) - 1, SWOW_G(ini.async_threads)));
     }
+    if (SWOW_G(ini.work_threads) > 0) {
+        if (SWOW_G(ini.work_threads) > CAT_WORK_EXECUTOR_MAX_THREADS) {
+            SWOW_G(ini.work_threads) = CAT_WORK_EXECUTOR_MAX_THREADS;
+        }
+        cat_work_set_thread_count((uint32_t) SWOW_G(ini.work_threads));
+    }
 
     /* Conflict extensions check */
     if (zend_hash_str_find_ptr(&module_registry, ZEND_STRL("swoole"))) {
@@ -214,6 +244,7 @@ PHP_MINIT_FUNCTION(swow)
         swow_defer_module_init,
         swow_coroutine_module_init,
         swow_channel_module_init,
+        swow_thread_module_init,
         swow_sync_module_init,
         swow_event_module_init,
         swow_time_module_init,
@@ -226,6 +257,7 @@ PHP_MINIT_FUNCTION(swow)
         swow_closure_module_init,
         swow_ipaddress_init,
         swow_http_module_init,
+        swow_http_server_module_init,
         swow_websocket_module_init,
 #ifdef CAT_OS_WAIT
         swow_proc_open_module_init,
@@ -261,6 +293,7 @@ PHP_MSHUTDOWN_FUNCTION(swow)
     }
 
     static const swow_shutdown_function_t mshutdown_functions[] = {
+        swow_thread_module_shutdown,
 #ifdef CAT_HAVE_PQ
         swow_pgsql_module_shutdown,
 #endif
@@ -274,6 +307,8 @@ PHP_MSHUTDOWN_FUNCTION(swow)
         swow_watchdog_module_shutdown,
         swow_stream_module_shutdown,
         swow_socket_module_shutdown,
+        swow_buffer_module_shutdown,
+        swow_time_module_shutdown,
         swow_event_module_shutdown,
         swow_coroutine_module_shutdown,
         swow_debug_module_shutdown,
@@ -315,6 +350,7 @@ PHP_RINIT_FUNCTION(swow)
         swow_debug_runtime_init,
         swow_coroutine_runtime_init,
         swow_event_runtime_init,
+        swow_buffer_runtime_init,
         swow_socket_runtime_init,
         swow_dns_runtime_init,
         swow_stream_runtime_init,
@@ -362,6 +398,7 @@ PHP_RSHUTDOWN_FUNCTION(swow)
 #endif
         swow_watchdog_runtime_shutdown,
         swow_stream_runtime_shutdown,
+        swow_buffer_runtime_shutdown,
         swow_event_runtime_shutdown,
         swow_coroutine_runtime_shutdown,
         swow_debug_runtime_shutdown,
@@ -624,6 +661,11 @@ static PHP_METHOD(Swow_Extension, isBuiltWith)
         ret = true;
     }
 #endif
+#ifdef CAT_SSL_HAVE_KTLS
+    else if (zend_string_equals_literal_ci(lib, "ktls")) {
+        ret = true;
+    }
+#endif
 #ifdef CAT_HAVE_CURL
     else if (zend_string_equals_literal_ci(lib, "curl")) {
         ret = true;
@@ -634,12 +676,73 @@ static PHP_METHOD(Swow_Extension, isBuiltWith)
         ret = true;
     }
 #endif
+#ifdef CAT_FS_IO_URING
+    else if (zend_string_equals_literal_ci(lib, "io_uring")) {
+        ret = true;
+    }
+#endif
+#ifdef CAT_COROUTINE_USE_STACK_POOL
+    else if (zend_string_equals_literal_ci(lib, "coroutine_stack_pool")) {
+        ret = true;
+    }
+#endif
 
     RETURN_BOOL(ret);
 }
 
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Extension_getWorkStats, 0, 0, IS_ARRAY, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Extension, getWorkStats)
+{
+    static const struct {
+        const char *name;
+        cat_work_kind_t kind;
+    } lanes[] = {
+        { "fs", CAT_WORK_KIND_FS },
+        { "dns", CAT_WORK_KIND_DNS },
+        { "cpu", CAT_WORK_KIND_CPU },
+    };
+    size_t n;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    array_init(return_value);
+    add_assoc_long(return_value, "threads", cat_work_get_thread_count());
+    for (n = 0; n < CAT_ARRAY_SIZE(lanes); n++) {
+        cat_work_stats_t stats;
+        zval z_stats;
+        (void) cat_work_get_stats(lanes[n].kind, &stats);
+        array_init(&z_stats);
+        add_assoc_long(&z_stats, "submitted", (zend_long) stats.submitted);
+        add_assoc_long(&z_stats, "completed", (zend_long) stats.completed);
+        add_assoc_long(&z_stats, "canceled", (zend_long) stats.canceled);
+        add_assoc_long(&z_stats, "stolen", (zend_long) stats.stolen);
+        add_assoc_long(&z_stats, "overflowed", (zend_long) stats.overflowed);
+        add_assoc_long(&z_stats, "wait_time", (zend_long) stats.wait_time);
+        add_assoc_long(&z_stats, "run_time", (zend_long) stats.run_time);
+        add_assoc_long(&z_stats, "queued", stats.queued);
+        add_assoc_long(&z_stats, "max_queued", stats.max_queued);
+        add_assoc_long(&z_stats, "running", stats.running);
+        add_assoc_long(&z_stats, "max_running", stats.max_running);
+        add_assoc_zval(return_value, lanes[n].name, &z_stats);
+    }
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Extension_getFsBackend, 0, 0, IS_STRING, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Extension, getFsBackend)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_STRING(cat_fs_backend_get_name(cat_fs_get_backend()));
+}
+
 static const zend_function_entry swow_extension_methods[] = {
     PHP_ME(Swow_Extension, isBuiltWith, arginfo_class_Swow_Extension_isBuiltWith, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Extension, getWorkStats, arginfo_class_Swow_Extension_getWorkStats, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Extension, getFsBackend, arginfo_class_Swow_Extension_getFsBackend, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
     PHP_FE_END
 };
 
@@ -2604,6 +2604,188 @@ cleanup:
 
 #endif
 
+/* {{{ Execute queries in one round trip (pipeline mode of libpq >= 14) and return their results */
+PHP_METHOD(PDO_PGSql_Ext, pgsqlExecBatch)
+{
+    pdo_dbh_t *dbh;
+    pdo_pgsql_db_handle *H;
+    HashTable *queries_ht;
+    zend_long result_type = PDO_FETCH_USE_DEFAULT;
+    cat_pq_query_t *queries;
+    PGresult **results;
+    HashTable strings;
+    zval *z_query, *z_param;
+    zend_string *str;
+    uint32_t count, i = 0;
+    bool in_trans;
+    cat_bool_t ret;
+
+    ZEND_PARSE_PARAMETERS_START(1, 2)
+        Z_PARAM_ARRAY_HT(queries_ht)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(result_type)
+    ZEND_PARSE_PARAMETERS_END();
+
+    dbh = Z_PDO_DBH_P(ZEND_THIS);
+    PDO_CONSTRUCT_CHECK;
+    PDO_DBH_CLEAR_ERR();
+
+    if (result_type == PDO_FETCH_USE_DEFAULT) {
+        result_type = dbh->default_fetch_type;
+    }
+
+    if (result_type != PDO_FETCH_BOTH && result_type != PDO_FETCH_ASSOC && result_type != PDO_FETCH_NUM) {
+        zend_argument_value_error(2, "must be one of PDO::FETCH_BOTH, PDO::FETCH_ASSOC, or PDO::FETCH_NUM");
+        RETURN_THROWS();
+    }
+
+    count = zend_hash_num_elements(queries_ht);
+    if (count == 0) {
+        RETURN_EMPTY_ARRAY();
+    }
+
+    H = (pdo_pgsql_db_handle *)dbh->driver_data;
+
+    /* every query is either "sql" or ["sql", [params...]], strings are held until results are collected */
+    queries = (cat_pq_query_t *) ecalloc(count, sizeof(*queries));
+    zend_hash_init(&strings, 0, NULL, ZVAL_PTR_DTOR, 0);
+    ZEND_HASH_FOREACH_VAL(queries_ht, z_query) {
+        cat_pq_query_t *query = &queries[i];
+        HashTable *params_ht = NULL;
+        zval *z_command = z_query;
+        zval z_tmp;
+
+        ZVAL_DEREF(z_query);
+        if (Z_TYPE_P(z_query) == IS_ARRAY) {
+            zval *z_params;
+            z_command = zend_hash_index_find(Z_ARRVAL_P(z_query), 0);
+            z_params = zend_hash_index_find(Z_ARRVAL_P(z_query), 1);
+            if (z_params != NULL) {
+                ZVAL_DEREF(z_params);
+                if (Z_TYPE_P(z_params) != IS_ARRAY) {
+                    zend_argument_type_error(1, "params of query #%u must be of type array, %s given", i, zend_zval_type_name(z_params));
+                    goto _arg_error;
+                }
+                params_ht = Z_ARRVAL_P(z_params);
+            }
+        }
+        if (z_command != NULL) {
+            ZVAL_DEREF(z_command);
+        }
+        if (z_command == NULL || Z_TYPE_P(z_command) != IS_STRING) {
+            zend_argument_type_error(1, "query #%u must be a string or an array of [string $query, array $params]", i);
+            goto _arg_error;
+        }
+        query->command = Z_STRVAL_P(z_command);
+        if (params_ht != NULL && zend_hash_num_elements(params_ht) > 0) {
+            const char **param_values;
+            int n = 0;
+            query->n_params = (int) zend_hash_num_elements(params_ht);
+            param_values = (const char **) ecalloc(query->n_params, sizeof(*param_values));
+            query->param_values = param_values;
+            ZEND_HASH_FOREACH_VAL(params_ht, z_param) {
+                ZVAL_DEREF(z_param);
+                if (Z_TYPE_P(z_param) == IS_NULL) {
+                    param_values[n++] = NULL;
+                    continue;
+                }
+                if (Z_TYPE_P(z_param) == IS_FALSE || Z_TYPE_P(z_param) == IS_TRUE) {
+                    param_values[n++] = Z_TYPE_P(z_param) == IS_TRUE ? "t" : "f";
+                    continue;
+                }
+                str = zval_try_get_string(z_param);
+                if (UNEXPECTED(str == NULL)) {
+                    goto _arg_error;
+                }
+                ZVAL_STR(&z_tmp, str);
+                zend_hash_next_index_insert_new(&strings, &z_tmp);
+                param_values[n++] = Z_STRVAL(z_tmp);
+            } ZEND_HASH_FOREACH_END();
+        }
+        i++;
+    } ZEND_HASH_FOREACH_END();
+
+    in_trans = pgsql_handle_in_transaction(dbh);
+
+    results = (PGresult **) emalloc(count * sizeof(*results));
+    ret = cat_pq_exec_batch(H->server, queries, count, results);
+
+    if (!ret) {
+        pdo_pgsql_error(dbh, PGRES_FATAL_ERROR, NULL);
+        PDO_HANDLE_DBH_ERR();
+        RETVAL_FALSE;
+        goto _out;
+    }
+
+    array_init_size(return_value, count);
+    for (i = 0; i < count; i++) {
+        PGresult *res = results[i];
+        ExecStatusType status = res != NULL ? PQresultStatus(res) : PGRES_FATAL_ERROR;
+        zval z_result;
+
+        if (status == PGRES_TUPLES_OK) {
+            int n_rows = PQntuples(res), n_fields = PQnfields(res), row, field;
+            array_init_size(&z_result, n_rows);
+            for (row = 0; row < n_rows; row++) {
+                zval z_row, z_value;
+                array_init_size(&z_row, n_fields);
+                for (field = 0; field < n_fields; field++) {
+                    if (UNEXPECTED(!swow_pdo_pgsql_get_value(res, row, field, PQftype(res, field), &z_value))) {
+                        zval_ptr_dtor(&z_row);
+                        zval_ptr_dtor(&z_result);
+                        pdo_pgsql_error_msg(dbh, PGRES_FATAL_ERROR, "Failed to unescape bytea value");
+                        PDO_HANDLE_DBH_ERR();
+                        zval_ptr_dtor(return_value);
+                        RETVAL_FALSE;
+                        goto _clear;
+                    }
+                    if (result_type == PDO_FETCH_BOTH) {
+                        Z_TRY_ADDREF(z_value);
+                    }
+                    if (result_type == PDO_FETCH_ASSOC || result_type == PDO_FETCH_BOTH) {
+                        add_assoc_zval(&z_row, PQfname(res, field), &z_value);
+                    }
+                    if (result_type == PDO_FETCH_NUM || result_type == PDO_FETCH_BOTH) {
+                        add_index_zval(&z_row, field, &z_value);
+                    }
+                }
+                add_next_index_zval(&z_result, &z_row);
+            }
+        } else if (status == PGRES_COMMAND_OK || status == PGRES_EMPTY_QUERY) {
+            H->pgoid = PQoidValue(res);
+            ZVAL_LONG(&z_result, ZEND_STRTOL(PQcmdTuples(res), NULL, 10));
+        } else {
+            /* the first failed query aborts the rest */
+            pdo_pgsql_error(dbh, status, res != NULL ? pdo_pgsql_sqlstate(res) : NULL);
+            PDO_HANDLE_DBH_ERR();
+            zval_ptr_dtor(return_value);
+            RETVAL_FALSE;
+            break;
+        }
+        add_next_index_zval(return_value, &z_result);
+    }
+
+    _clear:
+    for (i = 0; i < count; i++) {
+        PQclear(results[i]);
+    }
+    if (in_trans && !pgsql_handle_in_transaction(dbh)) {
+        swow_pdo_pgsql_close_lob_streams(dbh);
+    }
+
+    _out:
+    efree(results);
+    _arg_error:
+    for (i = 0; i < count; i++) {
+        if (queries[i].param_values != NULL) {
+            efree((void *) queries[i].param_values);
+        }
+    }
+    efree(queries);
+    zend_hash_destroy(&strings);
+}
+/* }}} */
+
 const pdo_driver_t swow_pdo_pgsql_driver = {
     PDO_DRIVER_HEADER(pgsql),
     pdo_pgsql_handle_factory
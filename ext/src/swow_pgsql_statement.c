@@ -1211,69 +1211,23 @@ static int pgsql_stmt_get_col(pdo_stmt_t *stmt, int colno, zval *result, enum pd
     }
 
     /* We have already increased count by 1 in pgsql_stmt_fetch() */
-    if (PQgetisnull(S->result, S->current_row - 1, colno)) { /* Check if we got NULL */
-        ZVAL_NULL(result);
-    } else {
-        char *ptr = PQgetvalue(S->result, S->current_row - 1, colno);
-        size_t len = PQgetlength(S->result, S->current_row - 1, colno);
-
-        switch (S->cols[colno].pgsql_type) {
-            case BOOLOID:
-                ZVAL_BOOL(result, *ptr == 't');
-                break;
-
-            case INT2OID:
-            case INT4OID:
-#if SIZEOF_ZEND_LONG >= 8
-            case INT8OID:
-#endif
-                ZVAL_LONG(result, ZEND_ATOL(ptr));
-                break;
-
-            case OIDOID: {
-                char *end_ptr;
-                Oid oid = (Oid)strtoul(ptr, &end_ptr, 10);
-                if (type && *type == PDO_PARAM_LOB) {
-                    /* If column was bound as LOB, return a stream. */
-                    int loid = lo_open(S->H->server, oid, INV_READ);
-                    if (loid >= 0) {
-                        php_stream *stream = swow_pdo_pgsql_create_lob_stream(&stmt->database_object_handle, loid, oid);
-                        if (stream) {
-                            php_stream_to_zval(stream, result);
-                            return 1;
-                        }
-                    }
-                    return 0;
-                } else {
-                    /* Otherwise return OID as integer. */
-                    ZVAL_LONG(result, oid);
-                }
-                break;
-            }
-
-            case BYTEAOID: {
-                size_t tmp_len;
-                char *tmp_ptr = (char *)PQunescapeBytea((unsigned char *) ptr, &tmp_len);
-                if (!tmp_ptr) {
-                    /* PQunescapeBytea returned an error */
-                    return 0;
-                }
-
-                zend_string *str = zend_string_init(tmp_ptr, tmp_len, 0);
-                php_stream *stream = php_stream_memory_open(TEMP_STREAM_READONLY, str);
+    if (S->cols[colno].pgsql_type == OIDOID && type && *type == PDO_PARAM_LOB &&
+        !PQgetisnull(S->result, S->current_row - 1, colno)) {
+        /* If column was bound as LOB, return a stream. */
+        char *end_ptr;
+        Oid oid = (Oid)strtoul(PQgetvalue(S->result, S->current_row - 1, colno), &end_ptr, 10);
+        int loid = lo_open(S->H->server, oid, INV_READ);
+        if (loid >= 0) {
+            php_stream *stream = swow_pdo_pgsql_create_lob_stream(&stmt->database_object_handle, loid, oid);
+            if (stream) {
                 php_stream_to_zval(stream, result);
-                zend_string_release(str);
-                PQfreemem(tmp_ptr);
-                break;
+                return 1;
             }
-
-            default:
-                ZVAL_STRINGL_FAST(result, ptr, len);
-                break;
         }
+        return 0;
     }
 
-    return 1;
+    return swow_pdo_pgsql_get_value(S->result, S->current_row - 1, colno, S->cols[colno].pgsql_type, result);
 }
 
 static zend_always_inline char * pdo_pgsql_translate_oid_to_table(Oid oid, PGconn *conn)
@@ -1414,4 +1368,68 @@ const struct pdo_stmt_methods swow_pgsql_stmt_methods = {
 };
 #endif
 
+/* value is converted by its type as the statement (PHP >= 8.1) fetches it, it is also used by pgsqlExecBatch() */
+int swow_pdo_pgsql_get_value(PGresult *res, int row, int column, Oid pgsql_type, zval *result)
+{
+    char *ptr;
+    size_t len;
+
+    if (PQgetisnull(res, row, column)) {
+        ZVAL_NULL(result);
+        return 1;
+    }
+    ptr = PQgetvalue(res, row, column);
+    len = PQgetlength(res, row, column);
+
+    switch (pgsql_type) {
+        case BOOLOID:
+            ZVAL_BOOL(result, *ptr == 't');
+            break;
+
+        case INT2OID:
+        case INT4OID:
+#if SIZEOF_ZEND_LONG >= 8
+        case INT8OID:
+#endif
+            ZVAL_LONG(result, ZEND_STRTOL(ptr, NULL, 10));
+            break;
+
+        case OIDOID: {
+            char *end_ptr;
+            Oid oid = (Oid)strtoul(ptr, &end_ptr, 10);
+            ZVAL_LONG(result, oid);
+            break;
+        }
+
+        case BYTEAOID: {
+            size_t tmp_len;
+            char *tmp_ptr = (char *)PQunescapeBytea((unsigned char *) ptr, &tmp_len);
+            if (!tmp_ptr) {
+                /* PQunescapeBytea returned an error */
+                return 0;
+            }
+
+#if PHP_VERSION_ID >= 80100
+            zend_string *str = zend_string_init(tmp_ptr, tmp_len, 0);
+            php_stream *stream = php_stream_memory_open(TEMP_STREAM_READONLY, str);
+            zend_string_release(str);
+#else
+            /* memory stream of PHP 8.0 does not copy the read-only data */
+            php_stream *stream = php_stream_memory_create(TEMP_STREAM_DEFAULT);
+            php_stream_write(stream, tmp_ptr, tmp_len);
+            php_stream_seek(stream, 0, SEEK_SET);
+#endif
+            php_stream_to_zval(stream, result);
+            PQfreemem(tmp_ptr);
+            break;
+        }
+
+        default:
+            ZVAL_STRINGL_FAST(result, ptr, len);
+            break;
+    }
+
+    return 1;
+}
+
 #endif /* CAT_PQ */
@@ -394,6 +394,309 @@ SWOW_SOCKET_TIMEOUT_API_GEN(Write,         write);
 
 #undef SWOW_SOCKET_TIMEOUT_API_GEN
 
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_setGlobalDnsCacheSize, 0, 1, IS_VOID, 0)
+    ZEND_ARG_TYPE_INFO(0, size, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, setGlobalDnsCacheSize)
+{
+    zend_long size;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_LONG(size)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (UNEXPECTED(size < 0)) {
+        zend_argument_value_error(1, "must be greater than or equal to 0");
+        RETURN_THROWS();
+    }
+
+    cat_dns_cache_set_max_size((size_t) size);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_setGlobalDnsCacheTtl, 0, 1, IS_VOID, 0)
+    ZEND_ARG_TYPE_INFO(0, ttl, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+#define SWOW_SOCKET_DNS_CACHE_TTL_API_GEN(Type, type) \
+static PHP_METHOD(Swow_Socket, setGlobalDnsCache##Type) \
+{ \
+    zend_long ttl; \
+    \
+    ZEND_PARSE_PARAMETERS_START(1, 1) \
+        Z_PARAM_LONG(ttl) \
+    ZEND_PARSE_PARAMETERS_END(); \
+    \
+    if (UNEXPECTED(ttl < 0)) { \
+        zend_argument_value_error(1, "must be greater than or equal to 0"); \
+        RETURN_THROWS(); \
+    } \
+    \
+    cat_dns_cache_set_##type((cat_msec_t) ttl); \
+}
+
+SWOW_SOCKET_DNS_CACHE_TTL_API_GEN(Ttl,                 ttl);
+SWOW_SOCKET_DNS_CACHE_TTL_API_GEN(NegativeTtl, negative_ttl);
+
+#undef SWOW_SOCKET_DNS_CACHE_TTL_API_GEN
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_getDnsCacheStats, 0, 0, IS_ARRAY, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, getDnsCacheStats)
+{
+    cat_dns_cache_info_t info;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    cat_dns_cache_get_info(&info);
+
+    array_init(return_value);
+    add_assoc_long(return_value, "size", info.max_size);
+    add_assoc_long(return_value, "ttl", info.ttl);
+    add_assoc_long(return_value, "negative_ttl", info.negative_ttl);
+    add_assoc_long(return_value, "count", info.count);
+    add_assoc_long(return_value, "hits", info.hits);
+    add_assoc_long(return_value, "misses", info.misses);
+    add_assoc_long(return_value, "coalesced", info.coalesced);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_clearDnsCache, 0, 0, IS_VOID, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, clearDnsCache)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    cat_dns_cache_clear();
+}
+
+static const char *swow_socket_stats_latency_bucket_names[CAT_SOCKET_STATS_LATENCY_BUCKET_COUNT] = {
+    "<100us", "<1ms", "<10ms", "<100ms", "<1s", ">=1s"
+};
+
+static void swow_socket_stats_latency_to_array(zval *zlatency, const uint64_t *latency)
+{
+    size_t i;
+
+    array_init_size(zlatency, CAT_SOCKET_STATS_LATENCY_BUCKET_COUNT);
+    for (i = 0; i < CAT_SOCKET_STATS_LATENCY_BUCKET_COUNT; i++) {
+        add_assoc_long(zlatency, swow_socket_stats_latency_bucket_names[i], (zend_long) latency[i]);
+    }
+}
+
+static void swow_socket_stats_to_array(zval *zstats, const cat_socket_stats_t *stats)
+{
+    zval zlatency;
+
+    array_init(zstats);
+    add_assoc_long(zstats, "bytes_read", (zend_long) stats->bytes_read);
+    add_assoc_long(zstats, "bytes_written", (zend_long) stats->bytes_written);
+    add_assoc_long(zstats, "read_syscalls", (zend_long) stats->read_syscalls);
+    add_assoc_long(zstats, "write_syscalls", (zend_long) stats->write_syscalls);
+    add_assoc_long(zstats, "read_eagains", (zend_long) stats->read_eagains);
+    add_assoc_long(zstats, "write_eagains", (zend_long) stats->write_eagains);
+    add_assoc_long(zstats, "read_wait_time", (zend_long) stats->read_wait_time);
+    add_assoc_long(zstats, "write_wait_time", (zend_long) stats->write_wait_time);
+    swow_socket_stats_latency_to_array(&zlatency, stats->accept_latency);
+    add_assoc_zval(zstats, "accept_latency", &zlatency);
+    swow_socket_stats_latency_to_array(&zlatency, stats->connect_latency);
+    add_assoc_zval(zstats, "connect_latency", &zlatency);
+}
+
+#define arginfo_class_Swow_Socket_getGlobalStats arginfo_class_Swow_Socket_getDnsCacheStats
+
+static PHP_METHOD(Swow_Socket, getGlobalStats)
+{
+    cat_socket_stats_t stats;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    cat_socket_get_global_stats(&stats);
+
+    swow_socket_stats_to_array(return_value, &stats);
+}
+
+#define arginfo_class_Swow_Socket_resetGlobalStats arginfo_class_Swow_Socket_clearDnsCache
+
+static PHP_METHOD(Swow_Socket, resetGlobalStats)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    cat_socket_reset_global_stats();
+}
+
+#ifndef CAT_SSL
+#define SWOW_SOCKET_SSL_NOT_ENABLED() do { \
+    zend_throw_error(NULL, "SSL support is not enabled, " \
+        "`--enable-" SWOW_MODULE_NAME_LC "-ssl` must be configured while compiling %s extension", SWOW_MODULE_NAME); \
+    RETURN_THROWS(); \
+} while (0)
+#endif
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_setGlobalSslSessionCacheSize, 0, 1, IS_VOID, 0)
+    ZEND_ARG_TYPE_INFO(0, size, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, setGlobalSslSessionCacheSize)
+{
+    zend_long size;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_LONG(size)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (UNEXPECTED(size < 0)) {
+        zend_argument_value_error(1, "must be greater than or equal to 0");
+        RETURN_THROWS();
+    }
+
+#ifdef CAT_SSL
+    cat_ssl_session_cache_set_max_size((size_t) size);
+#else
+    SWOW_SOCKET_SSL_NOT_ENABLED();
+#endif
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_setGlobalSslSessionCacheTtl, 0, 1, IS_VOID, 0)
+    ZEND_ARG_TYPE_INFO(0, ttl, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, setGlobalSslSessionCacheTtl)
+{
+    zend_long ttl;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_LONG(ttl)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (UNEXPECTED(ttl < 0)) {
+        zend_argument_value_error(1, "must be greater than or equal to 0");
+        RETURN_THROWS();
+    }
+
+#ifdef CAT_SSL
+    cat_ssl_session_cache_set_ttl((cat_msec_t) ttl);
+#else
+    SWOW_SOCKET_SSL_NOT_ENABLED();
+#endif
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_setGlobalSslTicketKeys, 0, 1, IS_VOID, 0)
+    ZEND_ARG_TYPE_INFO(0, keys, IS_ARRAY, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, setGlobalSslTicketKeys)
+{
+    HashTable *keys;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_ARRAY_HT(keys)
+    ZEND_PARSE_PARAMETERS_END();
+
+#ifdef CAT_SSL
+    char buffer[CAT_SSL_TICKET_KEY_LENGTH * CAT_SSL_TICKET_KEYS_MAX];
+    uint32_t count = 0;
+    zval *ztmp;
+
+    if (UNEXPECTED(zend_hash_num_elements(keys) > CAT_SSL_TICKET_KEYS_MAX)) {
+        zend_argument_value_error(1, "can not contain more than %d keys", CAT_SSL_TICKET_KEYS_MAX);
+        RETURN_THROWS();
+    }
+    ZEND_HASH_FOREACH_VAL(keys, ztmp) {
+        if (UNEXPECTED(Z_TYPE_P(ztmp) != IS_STRING)) {
+            zend_argument_type_error(1, "must be an array of strings, %s given in array", zend_zval_type_name(ztmp));
+            RETURN_THROWS();
+        }
+        if (UNEXPECTED(Z_STRLEN_P(ztmp) != CAT_SSL_TICKET_KEY_LENGTH)) {
+            zend_argument_value_error(1, "keys must be %d bytes long, %zu bytes key given", CAT_SSL_TICKET_KEY_LENGTH, Z_STRLEN_P(ztmp));
+            RETURN_THROWS();
+        }
+        memcpy(buffer + count * CAT_SSL_TICKET_KEY_LENGTH, Z_STRVAL_P(ztmp), CAT_SSL_TICKET_KEY_LENGTH);
+        count++;
+    } ZEND_HASH_FOREACH_END();
+
+    if (UNEXPECTED(!cat_ssl_set_ticket_keys(buffer, count))) {
+        swow_throw_exception_with_last(swow_socket_exception_ce);
+        RETURN_THROWS();
+    }
+#else
+    (void) keys;
+    SWOW_SOCKET_SSL_NOT_ENABLED();
+#endif
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_setGlobalSslTicketKeyLifetime, 0, 1, IS_VOID, 0)
+    ZEND_ARG_TYPE_INFO(0, lifetime, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, setGlobalSslTicketKeyLifetime)
+{
+    zend_long lifetime;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_LONG(lifetime)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (UNEXPECTED(lifetime < 0)) {
+        zend_argument_value_error(1, "must be greater than or equal to 0");
+        RETURN_THROWS();
+    }
+
+#ifdef CAT_SSL
+    cat_ssl_set_ticket_key_lifetime((cat_msec_t) lifetime);
+#else
+    SWOW_SOCKET_SSL_NOT_ENABLED();
+#endif
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_getSslSessionCacheStats, 0, 0, IS_ARRAY, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, getSslSessionCacheStats)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+#ifdef CAT_SSL
+    cat_ssl_session_cache_info_t info;
+
+    cat_ssl_session_cache_get_info(&info);
+
+    array_init(return_value);
+    add_assoc_long(return_value, "size", info.max_size);
+    add_assoc_long(return_value, "ttl", info.ttl);
+    add_assoc_long(return_value, "count", info.count);
+    add_assoc_long(return_value, "hits", info.hits);
+    add_assoc_long(return_value, "misses", info.misses);
+    add_assoc_long(return_value, "server_handshakes", info.server_handshakes);
+    add_assoc_long(return_value, "server_resumptions", info.server_resumptions);
+    add_assoc_long(return_value, "client_handshakes", info.client_handshakes);
+    add_assoc_long(return_value, "client_resumptions", info.client_resumptions);
+    add_assoc_long(return_value, "ticket_keys", info.ticket_key_count);
+    add_assoc_long(return_value, "ticket_key_lifetime", info.ticket_key_lifetime);
+#else
+    SWOW_SOCKET_SSL_NOT_ENABLED();
+#endif
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_clearSslSessionCache, 0, 0, IS_VOID, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, clearSslSessionCache)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+#ifdef CAT_SSL
+    cat_ssl_session_cache_clear();
+#else
+    SWOW_SOCKET_SSL_NOT_ENABLED();
+#endif
+}
+
+#ifndef CAT_SSL
+#undef SWOW_SOCKET_SSL_NOT_ENABLED
+#endif
+
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_bind, 0, 1, IS_STATIC, 0)
     ZEND_ARG_TYPE_INFO(0, name, IS_STRING, 0)
     ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, port, IS_LONG, 0, "0")
@@ -536,6 +839,115 @@ static PHP_METHOD(Swow_Socket, acceptTo)
     RETURN_THIS();
 }
 
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_acceptMany, 0, 0, IS_ARRAY, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, max, IS_LONG, 0, "Swow\\Socket::DEFAULT_ACCEPT_BATCH_SIZE")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 1, "null")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, acceptMany)
+{
+    SWOW_SOCKET_GETTER(s_server, server);
+    cat_socket_type_t server_type = cat_socket_get_simple_type(server);
+    swow_socket_t *s_connections[CAT_SOCKET_DEFAULT_ACCEPT_BATCH_SIZE];
+    cat_socket_t *connections[CAT_SOCKET_DEFAULT_ACCEPT_BATCH_SIZE];
+    zend_long max = CAT_SOCKET_DEFAULT_ACCEPT_BATCH_SIZE;
+    zend_long timeout;
+    bool timeout_is_null = 1;
+    size_t count = 1, accepted, n;
+
+    ZEND_PARSE_PARAMETERS_START(0, 2)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(max)
+        Z_PARAM_LONG_OR_NULL(timeout, timeout_is_null)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (UNEXPECTED(max <= 0)) {
+        zend_argument_value_error(1, "must be greater than 0");
+        RETURN_THROWS();
+    }
+    if (timeout_is_null) {
+        timeout = cat_socket_get_accept_timeout(server);
+    }
+
+    array_init_size(return_value, max > SWOW_SOCKET_ACCEPT_MANY_INITIAL_SIZE ? SWOW_SOCKET_ACCEPT_MANY_INITIAL_SIZE : (uint32_t) max);
+    /* wait for the first one, then drain the pending ones in growing batches,
+     * so that we never create much more lazy sockets than connections */
+    while (1) {
+        for (n = 0; n < count; n++) {
+            s_connections[n] = swow_socket_get_from_object(
+                swow_socket_create_object(Z_OBJCE_P(ZEND_THIS))
+            );
+            connections[n] = &s_connections[n]->socket;
+            if (likely(server_type != CAT_SOCKET_TYPE_ANY)) {
+                if (UNEXPECTED(cat_socket_create(connections[n], server_type) == NULL)) {
+                    count = n + 1;
+                    break;
+                }
+            } /* else server has not been constructed, but error will be triggered later in socket_accept() */
+        }
+        if (zend_hash_num_elements(Z_ARRVAL_P(return_value)) == 0) {
+            accepted = cat_socket_accept_many(server, connections, count, timeout);
+        } else {
+            accepted = cat_socket_try_accept_many(server, connections, count);
+        }
+        for (n = 0; n < count; n++) {
+            if (n < accepted) {
+                add_next_index_object(return_value, &s_connections[n]->std);
+                continue;
+            }
+            if (cat_socket_is_available(connections[n])) {
+                cat_socket_close(connections[n]);
+            }
+            zend_object_release(&s_connections[n]->std);
+        }
+        if (UNEXPECTED(zend_hash_num_elements(Z_ARRVAL_P(return_value)) == 0)) {
+            zval_ptr_dtor(return_value);
+            ZVAL_UNDEF(return_value);
+            swow_throw_exception_with_last(swow_socket_exception_ce);
+            RETURN_THROWS();
+        }
+        max -= (zend_long) accepted;
+        if (accepted < count || max == 0 ||
+            /* handles come with messages, they can only be accepted one by one */
+            (cat_socket_get_type(server) & CAT_SOCKET_TYPE_FLAG_IPC)) {
+            break;
+        }
+        count = (size_t) CAT_MIN(max, (zend_long) CAT_MIN(count * 2, CAT_SOCKET_DEFAULT_ACCEPT_BATCH_SIZE));
+    }
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_tryAcceptTo, 0, 1, _IS_BOOL, 0)
+    ZEND_ARG_OBJ_INFO(0, connection, Swow\\Socket, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, tryAcceptTo)
+{
+    SWOW_SOCKET_GETTER(s_server, server);
+    zend_object *connection_object;
+    swow_socket_t *s_connection;
+    cat_socket_t *connection;
+    cat_bool_t ret;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_OBJ_OF_CLASS(connection_object, swow_socket_ce)
+    ZEND_PARSE_PARAMETERS_END();
+
+    s_connection = swow_socket_get_from_object(connection_object);
+    connection = &s_connection->socket;
+
+    ret = cat_socket_try_accept(server, connection);
+
+    if (UNEXPECTED(!ret)) {
+        if (cat_get_last_error_code() == CAT_EAGAIN) {
+            RETURN_FALSE;
+        }
+        swow_throw_exception_with_last(swow_socket_exception_ce);
+        RETURN_THROWS();
+    }
+
+    RETURN_TRUE;
+}
+
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_connect, 0, 1, IS_STATIC, 0)
     ZEND_ARG_TYPE_INFO(0, name, IS_STRING, 0)
     ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, port, IS_LONG, 0, "0")
@@ -616,6 +1028,7 @@ static PHP_METHOD(Swow_Socket, enableCrypto)
         swow_hash_str_fetch_str(options_array, "certificate_key", &options.certificate_key);
         swow_hash_str_fetch_bool(options_array, "no_ticket", &options.no_ticket);
         swow_hash_str_fetch_bool(options_array, "no_compression", &options.no_compression);
+        swow_hash_str_fetch_bool(options_array, "ktls", &options.ktls);
         swow_hash_str_fetch_str(options_array, "passphrase", &options.passphrase);
         // TODO: SNI related things
         if (is_client) {
@@ -742,13 +1155,29 @@ static PHP_METHOD_EX(Swow_Socket, _read, bool once, bool may_address, bool peek)
 
     /* check args and initialize */
     s_buffer = swow_buffer_get_from_object(buffer_object);
+    if (timeout_is_null) {
+        timeout = cat_socket_get_read_timeout(socket);
+    }
+    if (once && !peek && s_buffer->buffer.value == NULL && offset == 0) {
+        /* the buffer is unallocated, we wait for data without any buffer attached,
+         * and then allocate it (it is usually taken from the buffer pool) */
+        cat_bool_t readable;
+        SWOW_BUFFER_LOCK(s_buffer);
+        readable = cat_socket_wait_readable_ex(socket, timeout);
+        SWOW_BUFFER_UNLOCK(s_buffer);
+        if (UNEXPECTED(!readable)) {
+            RETVAL_LONG(-1);
+            swow_throw_call_exception_with_last(swow_socket_exception_ce);
+            RETURN_THROWS();
+        }
+        if (s_buffer->buffer.value == NULL) {
+            (void) cat_buffer_alloc(&s_buffer->buffer, size > 0 ? (size_t) size : CAT_BUFFER_COMMON_SIZE);
+        }
+    }
     ptr = swow_buffer_get_writable_space(s_buffer, offset, &size, 1);
     if (UNEXPECTED(ptr == NULL)) {
         RETURN_THROWS();
     }
-    if (timeout_is_null) {
-        timeout = cat_socket_get_read_timeout(socket);
-    }
     if (!may_address) {
         want_address = cat_false;
     } else {
@@ -849,26 +1278,215 @@ static PHP_METHOD(Swow_Socket, recvData)
     SWOW_SOCKET_THROW_ECONNRESET_EXCEPTION_AND_RETURN_IF(Z_LVAL_P(return_value) == 0);
 }
 
-ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_recvFrom, 0, 1, IS_LONG, 0)
-    ZEND_ARG_OBJ_INFO(0, buffer, Swow\\Buffer, 0)
-    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, offset, IS_LONG, 0, "0")
-    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, size, IS_LONG, 0, "-1")
-    ZEND_ARG_INFO_WITH_DEFAULT_VALUE(1, address, "null")
-    ZEND_ARG_INFO_WITH_DEFAULT_VALUE(1, port, "null")
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_recvFrom, 0, 1, IS_LONG, 0)
+    ZEND_ARG_OBJ_INFO(0, buffer, Swow\\Buffer, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, offset, IS_LONG, 0, "0")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, size, IS_LONG, 0, "-1")
+    ZEND_ARG_INFO_WITH_DEFAULT_VALUE(1, address, "null")
+    ZEND_ARG_INFO_WITH_DEFAULT_VALUE(1, port, "null")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 1, "null")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, recvFrom)
+{
+    PHP_METHOD_CALL(Swow_Socket, _read, 1, 1, 0);
+}
+
+#define arginfo_class_Swow_Socket_recvDataFrom arginfo_class_Swow_Socket_recvFrom
+
+static PHP_METHOD(Swow_Socket, recvDataFrom)
+{
+    PHP_METHOD_CALL(Swow_Socket, recvFrom);
+    SWOW_SOCKET_THROW_ECONNRESET_EXCEPTION_AND_RETURN_IF(Z_LVAL_P(return_value) == 0);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_recvMany, 0, 1, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO(0, buffers, IS_ARRAY, 0)
+    ZEND_ARG_INFO_WITH_DEFAULT_VALUE(1, addresses, "null")
+    ZEND_ARG_INFO_WITH_DEFAULT_VALUE(1, ports, "null")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 1, "null")
+    ZEND_ARG_INFO_WITH_DEFAULT_VALUE(1, truncated, "null")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, recvMany)
+{
+    SWOW_SOCKET_GETTER(s_socket, socket);
+    HashTable *buffers_array;
+    zval *z_addresses = NULL, *z_ports = NULL, *z_truncated = NULL;
+    zend_long timeout;
+    bool timeout_is_null = 1;
+    cat_socket_datagram_t *datagrams;
+    swow_buffer_t **buffers;
+    uint32_t count = 0, received, i;
+    zend_ulong index;
+    zend_string *key;
+    zval *z_buffer;
+    ssize_t n = -1;
+
+    ZEND_PARSE_PARAMETERS_START(1, 5)
+        Z_PARAM_ARRAY_HT(buffers_array)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_ZVAL(z_addresses)
+        Z_PARAM_ZVAL(z_ports)
+        Z_PARAM_LONG_OR_NULL(timeout, timeout_is_null)
+        Z_PARAM_ZVAL(z_truncated)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (UNEXPECTED(zend_hash_num_elements(buffers_array) == 0)) {
+        zend_argument_value_error(1, "can not be empty");
+        RETURN_THROWS();
+    }
+    ZEND_HASH_FOREACH_VAL(buffers_array, z_buffer) {
+        if (UNEXPECTED(Z_TYPE_P(z_buffer) != IS_OBJECT || !instanceof_function(Z_OBJCE_P(z_buffer), swow_buffer_ce))) {
+            zend_argument_type_error(1, "must be an array of %s, %s found", ZSTR_VAL(swow_buffer_ce->name), zend_zval_type_name(z_buffer));
+            RETURN_THROWS();
+        }
+    } ZEND_HASH_FOREACH_END();
+    if (timeout_is_null) {
+        timeout = cat_socket_get_read_timeout(socket);
+    }
+
+    /* every buffer receives one datagram from its beginning,
+     * buffers are locked (and kept alive) until we are done */
+    datagrams = emalloc(zend_hash_num_elements(buffers_array) * sizeof(*datagrams));
+    buffers = emalloc(zend_hash_num_elements(buffers_array) * sizeof(*buffers));
+    ZEND_HASH_FOREACH_VAL(buffers_array, z_buffer) {
+        swow_buffer_t *s_buffer = swow_buffer_get_from_object(Z_OBJ_P(z_buffer));
+        zend_long size = -1;
+        char *ptr;
+        if (UNEXPECTED(!swow_buffer_lock(s_buffer))) {
+            goto _error;
+        }
+        /* Read on socket is the same as write on Buffer,
+         * so we should call COW here */
+        swow_buffer_cow(s_buffer);
+        ptr = swow_buffer_get_writable_space_v(s_buffer, 0, &size, 1, count, 1);
+        if (UNEXPECTED(ptr == NULL)) {
+            SWOW_BUFFER_UNLOCK(s_buffer);
+            goto _error;
+        }
+        GC_ADDREF(&s_buffer->std);
+        buffers[count] = s_buffer;
+        datagrams[count].buffer = ptr;
+        datagrams[count].size = size;
+        count++;
+    } ZEND_HASH_FOREACH_END();
+
+    n = cat_socket_recv_many_ex(socket, datagrams, count, timeout);
+    received = n > 0 ? (uint32_t) n : 0;
+
+    for (i = 0; i < received; i++) {
+        swow_buffer_update(buffers[i], datagrams[i].length);
+    }
+    if (z_addresses != NULL || z_ports != NULL || z_truncated != NULL) {
+        zval z_address_list, z_port_list, z_truncated_list;
+        if (z_addresses != NULL) {
+            array_init_size(&z_address_list, received);
+        }
+        if (z_ports != NULL) {
+            array_init_size(&z_port_list, received);
+        }
+        if (z_truncated != NULL) {
+            array_init_size(&z_truncated_list, received);
+        }
+        /* results are set with the same keys of buffers */
+        i = 0;
+        ZEND_HASH_FOREACH_KEY(buffers_array, index, key) {
+            char address[CAT_SOCKADDR_MAX_PATH];
+            size_t address_length = sizeof(address);
+            int port;
+            zval z_tmp;
+            if (i >= received) {
+                break;
+            }
+            if (cat_sockaddr_to_name_silent(&datagrams[i].address.address.common, datagrams[i].address.length, address, &address_length, &port) != 0) {
+                address_length = 0;
+                port = 0;
+            }
+            if (z_addresses != NULL) {
+                ZVAL_STRINGL(&z_tmp, address, address_length);
+                if (key != NULL) {
+                    zend_hash_update(Z_ARR(z_address_list), key, &z_tmp);
+                } else {
+                    zend_hash_index_update(Z_ARR(z_address_list), index, &z_tmp);
+                }
+            }
+            if (z_ports != NULL) {
+                ZVAL_LONG(&z_tmp, port);
+                if (key != NULL) {
+                    zend_hash_update(Z_ARR(z_port_list), key, &z_tmp);
+                } else {
+                    zend_hash_index_update(Z_ARR(z_port_list), index, &z_tmp);
+                }
+            }
+            if (z_truncated != NULL) {
+                ZVAL_BOOL(&z_tmp, datagrams[i].truncated);
+                if (key != NULL) {
+                    zend_hash_update(Z_ARR(z_truncated_list), key, &z_tmp);
+                } else {
+                    zend_hash_index_update(Z_ARR(z_truncated_list), index, &z_tmp);
+                }
+            }
+            i++;
+        } ZEND_HASH_FOREACH_END();
+        if (z_addresses != NULL) {
+            ZEND_TRY_ASSIGN_REF_ARR(z_addresses, Z_ARR(z_address_list));
+        }
+        if (z_ports != NULL) {
+            ZEND_TRY_ASSIGN_REF_ARR(z_ports, Z_ARR(z_port_list));
+        }
+        if (z_truncated != NULL) {
+            ZEND_TRY_ASSIGN_REF_ARR(z_truncated, Z_ARR(z_truncated_list));
+        }
+    }
+
+    /* also for socket exception getReturnValue */
+    RETVAL_LONG(n);
+
+    if (UNEXPECTED(n < 0)) {
+        swow_throw_call_exception_with_last(swow_socket_exception_ce);
+    }
+
+    if (0) {
+        _error:
+        ZEND_ASSERT_HAS_EXCEPTION();
+    }
+    for (i = 0; i < count; i++) {
+        SWOW_BUFFER_UNLOCK(buffers[i]);
+        OBJ_RELEASE(&buffers[i]->std);
+    }
+    efree(buffers);
+    efree(datagrams);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_waitReadable, 0, 0, IS_STATIC, 0)
     ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 1, "null")
 ZEND_END_ARG_INFO()
 
-static PHP_METHOD(Swow_Socket, recvFrom)
+static PHP_METHOD(Swow_Socket, waitReadable)
 {
-    PHP_METHOD_CALL(Swow_Socket, _read, 1, 1, 0);
-}
+    SWOW_SOCKET_GETTER(s_socket, socket);
+    zend_long timeout;
+    bool timeout_is_null = 1;
+    cat_bool_t ret;
 
-#define arginfo_class_Swow_Socket_recvDataFrom arginfo_class_Swow_Socket_recvFrom
+    ZEND_PARSE_PARAMETERS_START(0, 1)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG_OR_NULL(timeout, timeout_is_null)
+    ZEND_PARSE_PARAMETERS_END();
 
-static PHP_METHOD(Swow_Socket, recvDataFrom)
-{
-    PHP_METHOD_CALL(Swow_Socket, recvFrom);
-    SWOW_SOCKET_THROW_ECONNRESET_EXCEPTION_AND_RETURN_IF(Z_LVAL_P(return_value) == 0);
+    if (timeout_is_null) {
+        timeout = cat_socket_get_read_timeout(socket);
+    }
+
+    ret = cat_socket_wait_readable_ex(socket, timeout);
+
+    if (UNEXPECTED(!ret)) {
+        swow_throw_exception_with_last(swow_socket_exception_ce);
+        RETURN_THROWS();
+    }
+
+    RETURN_THIS();
 }
 
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_peek, 0, 1, IS_LONG, 0)
@@ -1301,6 +1919,146 @@ static PHP_METHOD(Swow_Socket, sendTo)
     PHP_METHOD_CALL(Swow_Socket, _write, 1, 1);
 }
 
+static zend_always_inline bool swow_socket_datagram_set_address(cat_socket_t *socket, cat_socket_datagram_t *datagram, const zend_string *address, zend_long port)
+{
+    if (address == NULL || ZSTR_LEN(address) == 0) {
+        datagram->address.length = 0;
+        return true;
+    }
+    /* address family of the socket is used as the hint, only IP or path is acceptable here (no DNS query) */
+    datagram->address.address.common.sa_family = cat_socket_get_af(socket);
+    datagram->address.length = sizeof(datagram->address.address);
+    return cat_sockaddr_getbyname(&datagram->address.address.common, &datagram->address.length, ZSTR_VAL(address), ZSTR_LEN(address), (int) port);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_sendMany, 0, 1, IS_STATIC, 0)
+    ZEND_ARG_TYPE_INFO(0, datagrams, IS_ARRAY, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, address, IS_STRING, 1, "null")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, port, IS_LONG, 1, "null")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 1, "null")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, sendMany)
+{
+    SWOW_SOCKET_GETTER(s_socket, socket);
+    HashTable *datagrams_array;
+    zend_string *address = NULL;
+    zend_long port = 0;
+    bool port_is_null = 1;
+    zend_long timeout;
+    bool timeout_is_null = 1;
+    cat_socket_datagram_t *datagrams;
+    /* Use addref/release for buffer strings to make sure data is immutable (COW),
+     * save strings in a C array and release them before return. */
+    zend_string **strings;
+    uint32_t count = 0, buffer_count = 0, datagrams_array_index = 0;
+    size_t n;
+    zval *z_datagram;
+
+    ZEND_PARSE_PARAMETERS_START(1, 4)
+        Z_PARAM_ARRAY_HT(datagrams_array)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_STR_OR_NULL(address)
+        Z_PARAM_LONG_OR_NULL(port, port_is_null)
+        Z_PARAM_LONG_OR_NULL(timeout, timeout_is_null)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (UNEXPECTED(zend_hash_num_elements(datagrams_array) == 0)) {
+        zend_argument_value_error(1, "can not be empty");
+        RETURN_THROWS();
+    }
+    if (timeout_is_null) {
+        timeout = cat_socket_get_write_timeout(socket);
+    }
+
+    datagrams = emalloc(zend_hash_num_elements(datagrams_array) * sizeof(*datagrams));
+    strings = emalloc(zend_hash_num_elements(datagrams_array) * sizeof(*strings));
+    ZEND_HASH_FOREACH_VAL(datagrams_array, z_datagram) {
+        cat_socket_datagram_t *datagram = &datagrams[count];
+        swow_buffer_t *s_buffer = NULL;
+        zend_string *string = NULL;
+        zend_string *datagram_address = address;
+        zend_long datagram_port = port;
+        zend_long length = -1;
+        const char *ptr;
+        /* [string|Stringable|Buffer, address, port] */
+        if (Z_TYPE_P(z_datagram) == IS_ARRAY) {
+            HashTable *datagram_elements_array = Z_ARR_P(z_datagram);
+            uint32_t datagram_elements_array_count = zend_hash_num_elements(datagram_elements_array);
+            uint32_t index = 0;
+            zval *z_tmp;
+            if (UNEXPECTED(datagram_elements_array_count < 1 || datagram_elements_array_count > 3)) {
+                zend_argument_value_error(1, "[%u] must have 1 to 3 elements, %u given", datagrams_array_index, datagram_elements_array_count);
+                goto _error;
+            }
+            ZEND_HASH_FOREACH_VAL(datagram_elements_array, z_tmp) {
+                ZEND_ASSERT(index == 0 || index == 1 || index == 2);
+                if (index == 0) {
+                    if (UNEXPECTED(!swow_parse_arg_buffer_or_stringable_for_reading(z_tmp, &s_buffer, &string, 1))) {
+                        zend_argument_type_error(1, "[%u][0] ($data) must be of type string or %s, %s given", datagrams_array_index, ZSTR_VAL(swow_buffer_ce->name), zend_zval_type_name(z_tmp));
+                        goto _error;
+                    }
+                } else if (index == 1) {
+                    if (UNEXPECTED(Z_TYPE_P(z_tmp) != IS_STRING)) {
+                        zend_argument_type_error(1, "[%u][1] ($address) must be of type string, %s given", datagrams_array_index, zend_zval_type_name(z_tmp));
+                        goto _error;
+                    }
+                    datagram_address = Z_STR_P(z_tmp);
+                } else if (index == 2) {
+                    if (UNEXPECTED(!swow_parse_arg_long(z_tmp, &datagram_port, NULL, false, 1))) {
+                        zend_argument_type_error(1, "[%u][2] ($port) must be of type int, %s given", datagrams_array_index, zend_zval_type_name(z_tmp));
+                        goto _error;
+                    }
+                }
+                index++;
+            } ZEND_HASH_FOREACH_END();
+        } else if (!swow_parse_arg_buffer_or_stringable_for_reading(z_datagram, &s_buffer, &string, 1)) {
+            zend_argument_type_error(1, "[%u] must be of type string, array or %s, %s given", datagrams_array_index, ZSTR_VAL(swow_buffer_ce->name), zend_zval_type_name(z_datagram));
+            goto _error;
+        }
+        ptr = swow_buffer_or_string_get_readable_space_v(s_buffer, string, 0, &length, 1, datagrams_array_index, 1);
+        if (UNEXPECTED(ptr == NULL)) {
+            goto _error;
+        }
+        if (UNEXPECTED(!swow_socket_datagram_set_address(socket, datagram, datagram_address, datagram_port))) {
+            swow_throw_exception_with_last(swow_socket_exception_ce);
+            goto _error;
+        }
+        if (s_buffer != NULL) {
+            zend_string *buffer_string = swow_buffer_get_string(s_buffer);
+            if (buffer_string != NULL) {
+                strings[buffer_count++] = zend_string_copy(buffer_string);
+            }
+        }
+        /* empty datagram is meaningful, so we do not skip it */
+        datagram->buffer = (char *) ptr;
+        datagram->length = length;
+        count++;
+        datagrams_array_index++;
+    } ZEND_HASH_FOREACH_END();
+
+    n = cat_socket_send_many_ex(socket, datagrams, count, timeout);
+
+    if (UNEXPECTED(n != count)) {
+        /* also for socket exception getReturnValue (count of sent datagrams) */
+        RETVAL_LONG((zend_long) n);
+        swow_throw_call_exception_with_last(swow_socket_exception_ce);
+        goto _error;
+    }
+
+    RETVAL_THIS();
+
+    if (0) {
+        _error:
+        ZEND_ASSERT_HAS_EXCEPTION();
+    }
+    while (buffer_count--) {
+        zend_string_release(strings[buffer_count]);
+    }
+    efree(strings);
+    efree(datagrams);
+}
+
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_sendHandle, 0, 1, IS_STATIC, 0)
     ZEND_ARG_OBJ_INFO(0, handle, Swow\\Socket, 0)
     ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 1, "null")
@@ -1385,6 +2143,138 @@ static PHP_METHOD(Swow_Socket, sendFile)
     RETURN_LONG(written);
 }
 
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_broadcast, 0, 2, IS_ARRAY, 0)
+    ZEND_ARG_TYPE_INFO(0, sockets, IS_ARRAY, 0)
+    ZEND_ARG_OBJ_TYPE_MASK(0, data, Stringable, MAY_BE_STRING, NULL)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 1, "null")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, broadcast)
+{
+    HashTable *sockets_array;
+    swow_buffer_t *s_buffer = NULL;
+    zend_string *string = NULL, *buffer_string = NULL;
+    zend_long length = -1;
+    zend_long timeout;
+    bool timeout_is_null = 1;
+    const char *ptr;
+    cat_socket_write_vector_t vector;
+    cat_socket_t **sockets = NULL;
+    cat_errno_t *errors = NULL;
+    zend_object **objects = NULL;
+    uint32_t count = 0, i;
+    size_t failure_count;
+    zend_ulong index;
+    zend_string *key;
+    zval *z_socket;
+
+    ZEND_PARSE_PARAMETERS_START(2, 3)
+        Z_PARAM_ARRAY_HT(sockets_array)
+        SWOW_PARAM_BUFFER_OR_STRINGABLE_FOR_READING(s_buffer, string)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG_OR_NULL(timeout, timeout_is_null)
+    ZEND_PARSE_PARAMETERS_END();
+
+    ZEND_HASH_FOREACH_VAL(sockets_array, z_socket) {
+        if (UNEXPECTED(Z_TYPE_P(z_socket) != IS_OBJECT || !instanceof_function(Z_OBJCE_P(z_socket), swow_socket_ce))) {
+            zend_argument_type_error(1, "must be an array of %s, %s found", ZSTR_VAL(swow_socket_ce->name), zend_zval_type_name(z_socket));
+            RETURN_THROWS();
+        }
+    } ZEND_HASH_FOREACH_END();
+
+    ptr = swow_buffer_or_string_get_readable_space(s_buffer, string, 0, &length, 2);
+    if (UNEXPECTED(ptr == NULL)) {
+        RETURN_THROWS();
+    }
+    array_init(return_value);
+    if (UNEXPECTED(length == 0 || zend_hash_num_elements(sockets_array) == 0)) {
+        return;
+    }
+    if (timeout_is_null) {
+        timeout = cat_socket_get_global_write_timeout();
+    }
+
+    /* the data is encoded once and shared by all sockets,
+     * keep it and sockets alive during the broadcast, they may be released by others while we are waiting */
+    if (s_buffer != NULL) {
+        buffer_string = swow_buffer_get_string(s_buffer);
+        if (buffer_string != NULL) {
+            zend_string_addref(buffer_string);
+        }
+    }
+    sockets = emalloc(zend_hash_num_elements(sockets_array) * sizeof(*sockets));
+    errors = emalloc(zend_hash_num_elements(sockets_array) * sizeof(*errors));
+    objects = emalloc(zend_hash_num_elements(sockets_array) * sizeof(*objects));
+    ZEND_HASH_FOREACH_VAL(sockets_array, z_socket) {
+        objects[count] = Z_OBJ_P(z_socket);
+        GC_ADDREF(objects[count]);
+        sockets[count] = &swow_socket_get_from_object(objects[count])->socket;
+        count++;
+    } ZEND_HASH_FOREACH_END();
+    vector.base = ptr;
+    vector.length = length;
+
+    failure_count = cat_socket_broadcast(sockets, count, &vector, 1, timeout, errors);
+
+    /* report failed sockets with the same keys */
+    if (failure_count > 0) {
+        i = 0;
+        ZEND_HASH_FOREACH_KEY(sockets_array, index, key) {
+            if (i >= count) {
+                break; /* array has been changed */
+            }
+            if (errors[i] != 0) {
+                if (key != NULL) {
+                    add_assoc_long_ex(return_value, ZSTR_VAL(key), ZSTR_LEN(key), errors[i]);
+                } else {
+                    add_index_long(return_value, index, errors[i]);
+                }
+            }
+            i++;
+        } ZEND_HASH_FOREACH_END();
+    }
+
+    for (i = 0; i < count; i++) {
+        OBJ_RELEASE(objects[i]);
+    }
+    efree(objects);
+    efree(errors);
+    efree(sockets);
+    if (buffer_string != NULL) {
+        zend_string_release(buffer_string);
+    }
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_flush, 0, 0, IS_STATIC, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 1, "null")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, flush)
+{
+    SWOW_SOCKET_GETTER(s_socket, socket);
+    zend_long timeout;
+    bool timeout_is_null = 1;
+    cat_bool_t ret;
+
+    ZEND_PARSE_PARAMETERS_START(0, 1)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG_OR_NULL(timeout, timeout_is_null)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (timeout_is_null) {
+        timeout = cat_socket_get_write_timeout(socket);
+    }
+
+    ret = cat_socket_flush_ex(socket, timeout);
+
+    if (UNEXPECTED(!ret)) {
+        swow_throw_call_exception_with_last(swow_socket_exception_ce);
+        RETURN_THROWS();
+    }
+
+    RETURN_THIS();
+}
+
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_close, 0, 0, _IS_BOOL, 0)
 ZEND_END_ARG_INFO()
 
@@ -1395,6 +2285,10 @@ static PHP_METHOD(Swow_Socket, close)
 
     ZEND_PARSE_PARAMETERS_NONE();
 
+    /* coalesced data is only written in best-effort way by close() */
+    if (cat_socket_get_write_coalescing_buffered_size(socket) > 0) {
+        (void) cat_socket_flush(socket);
+    }
     ret = cat_socket_close(socket);
 
     RETURN_BOOL(ret);
@@ -1436,6 +2330,22 @@ SWOW_SOCKET_IS_XXX_API_GEN(ServerConnection, server_connection)
 
 SWOW_SOCKET_IS_XXX_API_GEN(Client, client)
 
+#define arginfo_class_Swow_Socket_isKtlsSendEnabled arginfo_class_Swow_Socket_close
+
+static PHP_METHOD(Swow_Socket, isKtlsSendEnabled)
+{
+    SWOW_SOCKET_GETTER(s_socket, socket);
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+#ifdef CAT_SSL
+    RETURN_BOOL(cat_socket_is_ktls_send_enabled(socket));
+#else
+    (void) socket;
+    RETURN_FALSE;
+#endif
+}
+
 #define arginfo_class_Swow_Socket_getConnectionError arginfo_class_Swow_Socket_getId
 
 static PHP_METHOD(Swow_Socket, getConnectionError)
@@ -1522,6 +2432,59 @@ static PHP_METHOD(Swow_Socket, getSendBufferSize)
     RETURN_LONG(cat_socket_get_send_buffer_size(socket));
 }
 
+#define arginfo_class_Swow_Socket_isWriteCoalescingEnabled arginfo_class_Swow_Socket_close
+
+static PHP_METHOD(Swow_Socket, isWriteCoalescingEnabled)
+{
+    SWOW_SOCKET_GETTER(s_socket, socket);
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_BOOL(cat_socket_is_write_coalescing_enabled(socket));
+}
+
+#define arginfo_class_Swow_Socket_getWriteCoalescingThreshold arginfo_class_Swow_Socket_getId
+
+static PHP_METHOD(Swow_Socket, getWriteCoalescingThreshold)
+{
+    SWOW_SOCKET_GETTER(s_socket, socket);
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_LONG(cat_socket_get_write_coalescing_threshold(socket));
+}
+
+#define arginfo_class_Swow_Socket_getWriteCoalescingBufferedSize arginfo_class_Swow_Socket_getId
+
+static PHP_METHOD(Swow_Socket, getWriteCoalescingBufferedSize)
+{
+    SWOW_SOCKET_GETTER(s_socket, socket);
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_LONG(cat_socket_get_write_coalescing_buffered_size(socket));
+}
+
+#define arginfo_class_Swow_Socket_getStats arginfo_class_Swow_Socket_getDnsCacheStats
+
+static PHP_METHOD(Swow_Socket, getStats)
+{
+    SWOW_SOCKET_GETTER(s_socket, socket);
+    cat_socket_stats_t stats;
+    cat_bool_t ret;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    ret = cat_socket_get_stats(socket, &stats);
+
+    if (UNEXPECTED(!ret)) {
+        swow_throw_exception_with_last(swow_socket_exception_ce);
+        RETURN_THROWS();
+    }
+
+    swow_socket_stats_to_array(return_value, &stats);
+}
+
 /* setter */
 
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_setRecvBufferSize, 0, 1, IS_STATIC, 0)
@@ -1628,6 +2591,43 @@ static PHP_METHOD(Swow_Socket, setTcpKeepAlive)
     RETURN_THIS();
 }
 
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket_setWriteCoalescing, 0, 0, IS_STATIC, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, enable, _IS_BOOL, 0, "true")
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, threshold, IS_LONG, 0, "0")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Socket, setWriteCoalescing)
+{
+    SWOW_SOCKET_GETTER(s_socket, socket);
+    bool enable = cat_true;
+    zend_long threshold = 0;
+    cat_bool_t ret;
+
+    ZEND_PARSE_PARAMETERS_START(0, 2)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_BOOL(enable)
+        Z_PARAM_LONG(threshold)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (UNEXPECTED(threshold < 0)) {
+        zend_argument_value_error(2, "must be greater than or equal to 0");
+        RETURN_THROWS();
+    }
+
+    if (enable) {
+        ret = cat_socket_enable_write_coalescing(socket, threshold);
+    } else {
+        ret = cat_socket_disable_write_coalescing(socket);
+    }
+
+    if (UNEXPECTED(!ret)) {
+        swow_throw_exception_with_last(swow_socket_exception_ce);
+        RETURN_THROWS();
+    }
+
+    RETURN_THIS();
+}
+
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Socket___debugInfo, 0, 0, IS_ARRAY, 0)
 ZEND_END_ARG_INFO()
 
@@ -1710,6 +2710,8 @@ static const zend_function_entry swow_socket_methods[] = {
     PHP_ME(Swow_Socket, listen,                    arginfo_class_Swow_Socket_listen,              ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, accept,                    arginfo_class_Swow_Socket_accept,              ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, acceptTo,                  arginfo_class_Swow_Socket_acceptTo,            ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Socket, acceptMany,                arginfo_class_Swow_Socket_acceptMany,          ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Socket, tryAcceptTo,               arginfo_class_Swow_Socket_tryAcceptTo,         ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, connect,                   arginfo_class_Swow_Socket_connect,             ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, enableCrypto,              arginfo_class_Swow_Socket_enableCrypto,        ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, getSockAddress,            arginfo_class_Swow_Socket_getAddress,          ZEND_ACC_PUBLIC)
@@ -1721,6 +2723,8 @@ static const zend_function_entry swow_socket_methods[] = {
     PHP_ME(Swow_Socket, recvData,                  arginfo_class_Swow_Socket_recvData,            ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, recvFrom,                  arginfo_class_Swow_Socket_recvFrom,            ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, recvDataFrom,              arginfo_class_Swow_Socket_recvDataFrom,        ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Socket, recvMany,                  arginfo_class_Swow_Socket_recvMany,            ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Socket, waitReadable,              arginfo_class_Swow_Socket_waitReadable,        ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, peek,                      arginfo_class_Swow_Socket_peek,                ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, peekFrom,                  arginfo_class_Swow_Socket_peekFrom,            ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, readString,                arginfo_class_Swow_Socket_readString,          ZEND_ACC_PUBLIC)
@@ -1734,8 +2738,11 @@ static const zend_function_entry swow_socket_methods[] = {
     PHP_ME(Swow_Socket, writeTo,                   arginfo_class_Swow_Socket_writeTo,             ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, send,                      arginfo_class_Swow_Socket_send,                ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, sendTo,                    arginfo_class_Swow_Socket_sendTo,              ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Socket, sendMany,                  arginfo_class_Swow_Socket_sendMany,            ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, sendHandle,                arginfo_class_Swow_Socket_sendHandle,          ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, sendFile,                  arginfo_class_Swow_Socket_sendFile,            ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Socket, broadcast,                 arginfo_class_Swow_Socket_broadcast,           ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Socket, flush,                     arginfo_class_Swow_Socket_flush,               ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, close,                     arginfo_class_Swow_Socket_close,               ZEND_ACC_PUBLIC)
     /* status */
     PHP_ME(Swow_Socket, isAvailable,               arginfo_class_Swow_Socket_isAvailable,         ZEND_ACC_PUBLIC)
@@ -1744,6 +2751,7 @@ static const zend_function_entry swow_socket_methods[] = {
     PHP_ME(Swow_Socket, isServer,                  arginfo_class_Swow_Socket_isServer,            ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, isServerConnection,        arginfo_class_Swow_Socket_isServerConnection,  ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, isClient,                  arginfo_class_Swow_Socket_isClient,            ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Socket, isKtlsSendEnabled,         arginfo_class_Swow_Socket_isKtlsSendEnabled,   ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, getConnectionError,        arginfo_class_Swow_Socket_getConnectionError,  ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, checkLiveness,             arginfo_class_Swow_Socket_checkLiveness,       ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, getIoState,                arginfo_class_Swow_Socket_getIoState,          ZEND_ACC_PUBLIC)
@@ -1751,11 +2759,16 @@ static const zend_function_entry swow_socket_methods[] = {
     PHP_ME(Swow_Socket, getIoStateNaming,          arginfo_class_Swow_Socket_getIoStateNaming,    ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, getRecvBufferSize,         arginfo_class_Swow_Socket_getRecvBufferSize,   ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, getSendBufferSize,         arginfo_class_Swow_Socket_getSendBufferSize,   ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Socket, isWriteCoalescingEnabled,  arginfo_class_Swow_Socket_isWriteCoalescingEnabled, ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Socket, getWriteCoalescingThreshold, arginfo_class_Swow_Socket_getWriteCoalescingThreshold, ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Socket, getWriteCoalescingBufferedSize, arginfo_class_Swow_Socket_getWriteCoalescingBufferedSize, ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Socket, getStats,                  arginfo_class_Swow_Socket_getStats,            ZEND_ACC_PUBLIC)
     /* setter */
     PHP_ME(Swow_Socket, setRecvBufferSize,         arginfo_class_Swow_Socket_setRecvBufferSize,   ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, setSendBufferSize,         arginfo_class_Swow_Socket_setSendBufferSize,   ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, setTcpNodelay,             arginfo_class_Swow_Socket_setTcpNodelay,       ZEND_ACC_PUBLIC)
     PHP_ME(Swow_Socket, setTcpKeepAlive,           arginfo_class_Swow_Socket_setTcpKeepAlive,     ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Socket, setWriteCoalescing,        arginfo_class_Swow_Socket_setWriteCoalescing,  ZEND_ACC_PUBLIC)
     /* magic */
     PHP_ME(Swow_Socket, __debugInfo,               arginfo_class_Swow_Socket___debugInfo,         ZEND_ACC_PUBLIC)
     /* globals */
@@ -1774,6 +2787,19 @@ static const zend_function_entry swow_socket_methods[] = {
     PHP_ME(Swow_Socket, setGlobalHandshakeTimeout, arginfo_class_Swow_Socket_setGlobalTimeout,    ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
     PHP_ME(Swow_Socket, setGlobalReadTimeout,      arginfo_class_Swow_Socket_setGlobalTimeout,    ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
     PHP_ME(Swow_Socket, setGlobalWriteTimeout,     arginfo_class_Swow_Socket_setGlobalTimeout,    ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Socket, setGlobalDnsCacheSize,     arginfo_class_Swow_Socket_setGlobalDnsCacheSize, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Socket, setGlobalDnsCacheTtl,      arginfo_class_Swow_Socket_setGlobalDnsCacheTtl, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Socket, setGlobalDnsCacheNegativeTtl, arginfo_class_Swow_Socket_setGlobalDnsCacheTtl, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Socket, getDnsCacheStats,          arginfo_class_Swow_Socket_getDnsCacheStats,    ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Socket, clearDnsCache,             arginfo_class_Swow_Socket_clearDnsCache,       ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Socket, getGlobalStats,            arginfo_class_Swow_Socket_getGlobalStats,      ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Socket, resetGlobalStats,          arginfo_class_Swow_Socket_resetGlobalStats,    ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Socket, setGlobalSslSessionCacheSize, arginfo_class_Swow_Socket_setGlobalSslSessionCacheSize, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Socket, setGlobalSslSessionCacheTtl, arginfo_class_Swow_Socket_setGlobalSslSessionCacheTtl, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Socket, setGlobalSslTicketKeys,    arginfo_class_Swow_Socket_setGlobalSslTicketKeys, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Socket, setGlobalSslTicketKeyLifetime, arginfo_class_Swow_Socket_setGlobalSslTicketKeyLifetime, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Socket, getSslSessionCacheStats,   arginfo_class_Swow_Socket_getSslSessionCacheStats, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Socket, clearSslSessionCache,      arginfo_class_Swow_Socket_clearSslSessionCache, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
     PHP_FE_END
 };
 
@@ -1799,6 +2825,7 @@ zend_result swow_socket_module_init(INIT_FUNC_ARGS)
     /* constants */
     zend_declare_class_constant_long(swow_socket_ce, ZEND_STRL("INVALID_FD"), CAT_SOCKET_INVALID_FD);
     zend_declare_class_constant_long(swow_socket_ce, ZEND_STRL("DEFAULT_BACKLOG"), CAT_SOCKET_DEFAULT_BACKLOG);
+    zend_declare_class_constant_long(swow_socket_ce, ZEND_STRL("DEFAULT_ACCEPT_BATCH_SIZE"), CAT_SOCKET_DEFAULT_ACCEPT_BATCH_SIZE);
 #define SWOW_SOCKET_TYPE_FLAG_GEN(name, value) \
     zend_declare_class_constant_long(swow_socket_ce, ZEND_STRL("TYPE_FLAG_" #name), (value));
     CAT_SOCKET_TYPE_FLAG_MAP(SWOW_SOCKET_TYPE_FLAG_GEN)
@@ -1828,6 +2855,11 @@ zend_result swow_socket_module_shutdown(INIT_FUNC_ARGS)
     if (!cat_socket_module_shutdown()) {
         return FAILURE;
     }
+#ifdef CAT_SSL
+    if (!cat_ssl_module_shutdown()) {
+        return FAILURE;
+    }
+#endif
 
     return SUCCESS;
 }
@@ -1837,6 +2869,13 @@ zend_result swow_socket_runtime_init(INIT_FUNC_ARGS)
     if (!cat_socket_runtime_init()) {
         return FAILURE;
     }
+#ifdef CAT_SSL
+    if (!cat_ssl_runtime_init()) {
+        return FAILURE;
+    }
+    cat_ssl_session_cache_set_max_size(SWOW_G(ini.ssl_session_cache_size) > 0 ? (size_t) SWOW_G(ini.ssl_session_cache_size) : 0);
+    cat_ssl_session_cache_set_ttl(SWOW_G(ini.ssl_session_cache_ttl) > 0 ? (cat_msec_t) SWOW_G(ini.ssl_session_cache_ttl) : 0);
+#endif
 
     return SUCCESS;
 }
@@ -21,6 +21,7 @@
 #include "swow_hook.h"
 
 #include "cat_socket.h"
+#include "cat_fs.h"
 #include "cat_time.h" /* for time_tv2to() */
 #include "cat_poll.h" /* for select() */
 
@@ -35,6 +36,8 @@
 
 CAT_GLOBALS_DECLARE(swow_stream);
 
+CAT_GLOBALS_CTOR_DECLARE_SZ(swow_stream)
+
 /* php-src: f078bca729f4ab1bc2d60370e83bfa561f86b88d */
 
 #define SWOW_STREAM_MEMBERS(stream, swow_sock, sock, socket) \
@@ -2426,6 +2429,10 @@ zend_result swow_stream_module_init(INIT_FUNC_ARGS)
 
     CAT_GLOBALS_REGISTER(swow_stream);
 
+    if (!cat_fs_module_init()) {
+        return FAILURE;
+    }
+
     REGISTER_LONG_CONSTANT("STREAM_POLLNONE", POLLNONE, CONST_PERSISTENT);
     REGISTER_LONG_CONSTANT("STREAM_POLLIN", POLLIN, CONST_PERSISTENT);
     REGISTER_LONG_CONSTANT("STREAM_POLLPRI", POLLPRI, CONST_PERSISTENT);
@@ -2497,6 +2504,10 @@ zend_result swow_stream_module_shutdown(INIT_FUNC_ARGS)
     // unhook std ops
     memcpy(&php_stream_stdio_ops, &swow_stream_stdio_ops_sync, sizeof(php_stream_stdio_ops));
 
+    if (!cat_fs_module_shutdown()) {
+        return FAILURE;
+    }
+
     CAT_GLOBALS_UNREGISTER(swow_stream);
 
     return SUCCESS;
@@ -2507,6 +2518,7 @@ zend_result swow_stream_runtime_init(INIT_FUNC_ARGS)
     SWOW_STREAM_G(hooking_stdio_ops) = SWOW_G(ini.async_tty) || SWOW_G(ini.async_file);
     SWOW_STREAM_G(hooking_tty) = SWOW_G(ini.async_tty);
     SWOW_STREAM_G(hooking_plain_wrapper) = SWOW_G(ini.async_file);
+    (void) cat_fs_set_backend(SWOW_G(ini.io_uring) ? CAT_FS_BACKEND_AUTO : CAT_FS_BACKEND_THREAD_POOL);
     // prepare tty sockets (FIXME: Why won't Zend bzero() it when we are in ZTS?)
     memset(SWOW_STREAM_G(tty_sockets), 0, sizeof(SWOW_STREAM_G(tty_sockets)));
 
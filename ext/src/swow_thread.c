@@ -18,16 +18,852 @@
 
 #include "swow_thread.h"
 
-SWOW_API zend_class_entry *swow_thread_wait_reference_ce;
-SWOW_API zend_object_handlers swow_thread_wait_reference_handlers;
+#include "SAPI.h"
+#include "php_main.h"
+#include "zend_smart_str.h"
+#include "ext/standard/php_var.h"
 
+SWOW_API zend_class_entry *swow_thread_ce;
+SWOW_API zend_object_handlers swow_thread_handlers;
 SWOW_API zend_class_entry *swow_thread_exception_ce;
 
-SWOW_API CAT_GLOBALS_DECLARE(swow_thread)
+SWOW_API zend_class_entry *swow_thread_channel_ce;
+SWOW_API zend_object_handlers swow_thread_channel_handlers;
+
+SWOW_API CAT_GLOBALS_DECLARE(swow_thread);
 
 CAT_GLOBALS_CTOR_DECLARE_SZ(swow_thread)
 
+#define SWOW_THREAD_CHANNEL_HANDLE_KEY "handle"
+
+static cat_atomic_uint32_t swow_thread_last_id;
+
+#ifdef ZTS
+/* module waits for all threads (including detached ones) to exit on shutdown, but not longer than SWOW_THREAD_SHUTDOWN_TIMEOUT */
+static uv_mutex_t swow_thread_mutex;
+static uv_cond_t swow_thread_cond;
+static uint32_t swow_thread_running_count;
+#endif
+
+/* payload */
+
+static void swow_thread_payload_init(swow_thread_payload_t *payload)
+{
+    payload->data = NULL;
+    payload->length = 0;
+    payload->channels = NULL;
+    payload->channel_count = 0;
+    payload->failed = cat_false;
+}
+
+static void swow_thread_payload_set_data(swow_thread_payload_t *payload, const char *data, size_t length, cat_bool_t failed)
+{
+    payload->data = (char *) cat_sys_malloc(length);
+    memcpy(payload->data, data, length);
+    payload->length = length;
+    payload->failed = failed;
+}
+
+static uint32_t swow_thread_payload_add_channel(swow_thread_payload_t *payload, cat_thread_channel_t *channel)
+{
+    payload->channels = (cat_thread_channel_t **) cat_sys_realloc(payload->channels, sizeof(*payload->channels) * (payload->channel_count + 1));
+    payload->channels[payload->channel_count] = channel;
+
+    return payload->channel_count++;
+}
+
+static void swow_thread_payload_free(swow_thread_payload_t *payload)
+{
+    uint32_t n;
+
+    if (payload->data != NULL) {
+        cat_sys_free(payload->data);
+        payload->data = NULL;
+    }
+    if (payload->channels != NULL) {
+        /* channels which have not been adopted (push failed, never popped or unserialization failed) */
+        for (n = 0; n < payload->channel_count; n++) {
+            if (payload->channels[n] != NULL) {
+                cat_thread_channel_release(payload->channels[n]);
+            }
+        }
+        cat_sys_free(payload->channels);
+        payload->channels = NULL;
+        payload->channel_count = 0;
+    }
+}
+
+static void swow_thread_payload_dtor(void *data)
+{
+    swow_thread_payload_free((swow_thread_payload_t *) data);
+}
+
+static SWOW_MAY_THROW cat_bool_t swow_thread_payload_serialize(swow_thread_payload_t *payload, zval *z_data)
+{
+    swow_thread_payload_t *previous_transfer = SWOW_THREAD_G(transfer);
+    php_serialize_data_t var_hash;
+    smart_str buffer = {0};
+
+    swow_thread_payload_init(payload);
+    SWOW_THREAD_G(transfer) = payload;
+    PHP_VAR_SERIALIZE_INIT(var_hash);
+    php_var_serialize(&buffer, z_data, &var_hash);
+    PHP_VAR_SERIALIZE_DESTROY(var_hash);
+    SWOW_THREAD_G(transfer) = previous_transfer;
+
+    if (UNEXPECTED(EG(exception) != NULL)) {
+        smart_str_free(&buffer);
+        swow_thread_payload_free(payload);
+        return cat_false;
+    }
+    swow_thread_payload_set_data(payload, ZSTR_VAL(buffer.s), ZSTR_LEN(buffer.s), cat_false);
+    smart_str_free(&buffer);
+
+    return cat_true;
+}
+
+static SWOW_MAY_THROW cat_bool_t swow_thread_payload_unserialize(swow_thread_payload_t *payload, zval *z_data)
+{
+    swow_thread_payload_t *previous_transfer = SWOW_THREAD_G(transfer);
+    php_unserialize_data_t var_hash;
+    const unsigned char *p = (const unsigned char *) payload->data;
+    cat_bool_t ret;
+
+    SWOW_THREAD_G(transfer) = payload;
+    PHP_VAR_UNSERIALIZE_INIT(var_hash);
+    ret = php_var_unserialize(z_data, &p, p + payload->length, &var_hash);
+    PHP_VAR_UNSERIALIZE_DESTROY(var_hash);
+    SWOW_THREAD_G(transfer) = previous_transfer;
+
+    if (UNEXPECTED(!ret || EG(exception) != NULL)) {
+        if (EG(exception) == NULL) {
+            zend_throw_error(NULL, "Thread data unserialization failed");
+        }
+        zval_ptr_dtor(z_data);
+        ZVAL_UNDEF(z_data);
+        return cat_false;
+    }
+
+    return cat_true;
+}
+
+/* context */
+
+static swow_thread_context_t *swow_thread_context_create(void)
+{
+    swow_thread_context_t *context = (swow_thread_context_t *) cat_sys_malloc(sizeof(*context));
+
+    /* result channel has room for the only result */
+    context->result = cat_thread_channel_create(1, sizeof(swow_thread_payload_t), swow_thread_payload_dtor);
+    if (UNEXPECTED(context->result == NULL)) {
+        cat_sys_free(context);
+        return NULL;
+    }
+    cat_atomic_uint32_init(&context->refcount, 1);
+    context->id = cat_atomic_uint32_fetch_add(&swow_thread_last_id, 1) + 1;
+    swow_thread_payload_init(&context->input);
+
+    return context;
+}
+
+static void swow_thread_context_release(swow_thread_context_t *context)
+{
+    if (cat_atomic_uint32_fetch_sub(&context->refcount, 1) != 1) {
+        return;
+    }
+    swow_thread_payload_free(&context->input);
+    cat_thread_channel_release(context->result);
+    cat_sys_free(context);
+}
+
+#ifdef ZTS
+static void swow_thread_set_failure(swow_thread_payload_t *result)
+{
+    zend_object *exception = EG(exception);
+    zend_string *exception_message, *message;
+    zval *z_message, rv;
+
+    if (exception == NULL) {
+        swow_thread_payload_set_data(result, ZEND_STRL("Thread exited abnormally"), cat_true);
+        return;
+    }
+    z_message = zend_read_property_ex(zend_get_exception_base(exception), exception, ZSTR_KNOWN(ZEND_STR_MESSAGE), 1, &rv);
+    exception_message = zval_get_string(z_message);
+    message = zend_strpprintf(0, "Thread exited with uncaught %s: %s", ZSTR_VAL(exception->ce->name), ZSTR_VAL(exception_message));
+    zend_string_release(exception_message);
+    zend_clear_exception();
+    swow_thread_payload_set_data(result, ZSTR_VAL(message), ZSTR_LEN(message), cat_true);
+    zend_string_release(message);
+}
+
+static void swow_thread_execute(swow_thread_context_t *context, swow_thread_payload_t *result)
+{
+    zend_fcall_info fci;
+    zend_fcall_info_cache fcc;
+    zval z_input, z_retval, *z_callable, *z_arguments;
+    char *error = NULL;
+    cat_bool_t ret;
+
+    if (UNEXPECTED(!swow_thread_payload_unserialize(&context->input, &z_input))) {
+        goto _error;
+    }
+    z_callable = zend_hash_index_find(Z_ARRVAL(z_input), 0);
+    z_arguments = zend_hash_index_find(Z_ARRVAL(z_input), 1);
+    if (UNEXPECTED(zend_fcall_info_init(z_callable, 0, &fci, &fcc, NULL, &error) != SUCCESS)) {
+        zend_throw_error(NULL, "Thread callable is not available, %s", error != NULL ? error : "unknown error");
+        if (error != NULL) {
+            efree(error);
+        }
+        zval_ptr_dtor(&z_input);
+        goto _error;
+    }
+    ZVAL_UNDEF(&z_retval);
+    fci.retval = &z_retval;
+    zend_fcall_info_args(&fci, z_arguments);
+    ret = zend_call_function(&fci, &fcc) == SUCCESS;
+    zend_fcall_info_args_clear(&fci, 1);
+    zval_ptr_dtor(&z_input);
+    if (UNEXPECTED(EG(exception) != NULL)) {
+        zval_ptr_dtor(&z_retval);
+        goto _error;
+    }
+    /* the call may fail without exception (e.g. the callable became unavailable) */
+    if (UNEXPECTED(!ret || Z_ISUNDEF(z_retval))) {
+        zval_ptr_dtor(&z_retval);
+        swow_thread_payload_set_data(result, ZEND_STRL("Thread callable call failed"), cat_true);
+        return;
+    }
+    ret = swow_thread_payload_serialize(result, &z_retval);
+    zval_ptr_dtor(&z_retval);
+    if (UNEXPECTED(!ret)) {
+        goto _error;
+    }
+
+    return;
+
+    _error:
+    swow_thread_set_failure(result);
+}
+
+static void swow_thread_routine(void *arg)
+{
+    swow_thread_context_t *context = (swow_thread_context_t *) arg;
+    swow_thread_payload_t result;
+
+    swow_thread_payload_init(&result);
+
+    /* every thread runs in its own request, so it has its own Swow runtime (event loop, coroutines and so on) */
+    (void) ts_resource(0);
+    ZEND_TSRMLS_CACHE_UPDATE();
+
+    /* it is not a request of the SAPI, the output goes to the stdout directly (CLI only) */
+    SG(server_context) = NULL;
+    PG(expose_php) = 0;
+    PG(auto_globals_jit) = 1;
+
+    if (UNEXPECTED(php_request_startup() != SUCCESS)) {
+        swow_thread_payload_set_data(&result, ZEND_STRL("Thread request startup failed"), cat_true);
+    } else {
+        SG(headers_sent) = 1;
+        SG(request_info).no_headers = 1;
+        SWOW_THREAD_G(id) = context->id;
+        zend_first_try {
+            swow_thread_execute(context, &result);
+        } zend_catch {
+            swow_thread_payload_free(&result);
+            swow_thread_payload_set_data(&result, ZEND_STRL("Thread exited abnormally"), cat_true);
+        } zend_end_try();
+        /* coroutines which are still running will be waited here */
+        php_request_shutdown(NULL);
+    }
+
+    ts_free_thread();
+
+    if (UNEXPECTED(!cat_thread_channel_try_push(context->result, &result))) {
+        swow_thread_payload_free(&result);
+    }
+    swow_thread_context_release(context);
+
+    uv_mutex_lock(&swow_thread_mutex);
+    if (--swow_thread_running_count == 0) {
+        uv_cond_broadcast(&swow_thread_cond);
+    }
+    uv_mutex_unlock(&swow_thread_mutex);
+}
+
+static void swow_thread_detach_handle(uv_thread_t *thread)
+{
+#ifndef PHP_WIN32
+    (void) pthread_detach(*thread);
+#else
+    (void) CloseHandle(*thread);
+#endif
+}
+#endif /* ZTS */
+
+/* thread */
+
+static zend_object *swow_thread_create_object(zend_class_entry *ce)
+{
+    swow_thread_t *s_thread = swow_object_alloc(swow_thread_t, ce, swow_thread_handlers);
+
+    s_thread->context = NULL;
+    s_thread->state = SWOW_THREAD_STATE_NONE;
+
+    return &s_thread->std;
+}
+
+static void swow_thread_free_object(zend_object *object)
+{
+    swow_thread_t *s_thread = swow_thread_get_from_object(object);
+
+    if (s_thread->context != NULL) {
+#ifdef ZTS
+        if (s_thread->state == SWOW_THREAD_STATE_RUNNING) {
+            /* no one can join it anymore, let it exit on its own */
+            swow_thread_detach_handle(&s_thread->context->thread);
+        }
+#endif
+        swow_thread_context_release(s_thread->context);
+    }
+
+    zend_object_std_dtor(&s_thread->std);
+}
+
+#define getThisThread() (swow_thread_get_from_object(Z_OBJ_P(ZEND_THIS)))
+
+#define SWOW_THREAD_GETTER_CONSTRUCTED(s_thread) \
+    swow_thread_t *s_thread = getThisThread(); \
+    if (UNEXPECTED(s_thread->state == SWOW_THREAD_STATE_NONE)) { \
+        zend_throw_error(NULL, "%s must construct first", ZEND_THIS_NAME); \
+        RETURN_THROWS(); \
+    }
+
+#define SWOW_THREAD_CHECK_JOINABLE(s_thread) do { \
+    if (UNEXPECTED(s_thread->state == SWOW_THREAD_STATE_JOINING)) { \
+        swow_throw_exception(swow_thread_exception_ce, CAT_EBUSY, "Thread is being joined by another coroutine"); \
+        RETURN_THROWS(); \
+    } \
+    if (UNEXPECTED(s_thread->state == SWOW_THREAD_STATE_JOINED)) { \
+        swow_throw_exception(swow_thread_exception_ce, CAT_EMISUSE, "Thread has been joined"); \
+        RETURN_THROWS(); \
+    } \
+    if (UNEXPECTED(s_thread->state == SWOW_THREAD_STATE_DETACHED)) { \
+        swow_throw_exception(swow_thread_exception_ce, CAT_EMISUSE, "Thread has been detached"); \
+        RETURN_THROWS(); \
+    } \
+} while (0)
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_class_Swow_Thread___construct, 0, 0, 1)
+    ZEND_ARG_TYPE_INFO(0, callable, IS_CALLABLE, 0)
+    ZEND_ARG_VARIADIC_TYPE_INFO(0, arguments, IS_MIXED, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Thread, __construct)
+{
+    swow_thread_t *s_thread = getThisThread();
+    zval *z_callable, *arguments = NULL;
+    uint32_t arguments_count = 0;
+
+    if (UNEXPECTED(s_thread->state != SWOW_THREAD_STATE_NONE)) {
+        zend_throw_error(NULL, "%s can be constructed only once", ZEND_THIS_NAME);
+        RETURN_THROWS();
+    }
+
+    ZEND_PARSE_PARAMETERS_START(1, -1)
+        Z_PARAM_ZVAL(z_callable)
+        Z_PARAM_VARIADIC('*', arguments, arguments_count)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (UNEXPECTED(!zend_is_callable(z_callable, 0, NULL))) {
+        zend_argument_type_error(1, "must be a valid callback");
+        RETURN_THROWS();
+    }
+
+#ifndef ZTS
+    (void) arguments;
+    swow_throw_exception(swow_thread_exception_ce, CAT_ENOTSUP, "Thread requires thread-safe (ZTS) build of PHP");
+    RETURN_THROWS();
+#else
+    /* SAPI request context can not be shared with other threads */
+    if (UNEXPECTED(strcmp(sapi_module.name, "cli") != 0 &&
+                   strcmp(sapi_module.name, "micro") != 0 &&
+                   strcmp(sapi_module.name, "phpdbg") != 0)) {
+        swow_throw_exception(swow_thread_exception_ce, CAT_ENOTSUP, "Thread is only supported in CLI");
+        RETURN_THROWS();
+    }
+    swow_thread_context_t *context;
+    zval z_input, z_arguments;
+    cat_bool_t ret;
+    uint32_t n;
+    int error;
+
+    context = swow_thread_context_create();
+    if (UNEXPECTED(context == NULL)) {
+        swow_throw_exception_with_last(swow_thread_exception_ce);
+        RETURN_THROWS();
+    }
+    /* callable and arguments are serialized, so closures should be static */
+    array_init_size(&z_arguments, arguments_count);
+    for (n = 0; n < arguments_count; n++) {
+        Z_TRY_ADDREF(arguments[n]);
+        zend_hash_next_index_insert_new(Z_ARRVAL(z_arguments), &arguments[n]);
+    }
+    array_init_size(&z_input, 2);
+    Z_TRY_ADDREF_P(z_callable);
+    add_next_index_zval(&z_input, z_callable);
+    add_next_index_zval(&z_input, &z_arguments);
+    ret = swow_thread_payload_serialize(&context->input, &z_input);
+    zval_ptr_dtor(&z_input);
+    if (UNEXPECTED(!ret)) {
+        swow_thread_context_release(context);
+        RETURN_THROWS();
+    }
+
+    /* one more reference for the thread */
+    (void) cat_atomic_uint32_fetch_add(&context->refcount, 1);
+    uv_mutex_lock(&swow_thread_mutex);
+    swow_thread_running_count++;
+    uv_mutex_unlock(&swow_thread_mutex);
+    error = uv_thread_create(&context->thread, swow_thread_routine, context);
+    if (UNEXPECTED(error != 0)) {
+        uv_mutex_lock(&swow_thread_mutex);
+        swow_thread_running_count--;
+        uv_mutex_unlock(&swow_thread_mutex);
+        swow_thread_context_release(context);
+        swow_thread_context_release(context);
+        cat_update_last_error_with_reason(error, "Thread create failed");
+        swow_throw_exception_with_last(swow_thread_exception_ce);
+        RETURN_THROWS();
+    }
+
+    s_thread->context = context;
+    s_thread->state = SWOW_THREAD_STATE_RUNNING;
+#endif
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Thread_getId, 0, 0, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Thread, getId)
+{
+    SWOW_THREAD_GETTER_CONSTRUCTED(s_thread);
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_LONG(s_thread->context->id);
+}
+
+#define arginfo_class_Swow_Thread_getCurrentId arginfo_class_Swow_Thread_getId
+
+static PHP_METHOD(Swow_Thread, getCurrentId)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_LONG(SWOW_THREAD_G(id));
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Thread_isRunning, 0, 0, _IS_BOOL, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Thread, isRunning)
+{
+    SWOW_THREAD_GETTER_CONSTRUCTED(s_thread);
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    /* result is pushed when the thread exits */
+    RETURN_BOOL((s_thread->state == SWOW_THREAD_STATE_RUNNING || s_thread->state == SWOW_THREAD_STATE_JOINING) &&
+                cat_thread_channel_get_length(s_thread->context->result) == 0);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Thread_join, 0, 0, IS_MIXED, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 0, "-1")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Thread, join)
+{
+    SWOW_THREAD_GETTER_CONSTRUCTED(s_thread);
+    swow_thread_context_t *context = s_thread->context;
+    swow_thread_payload_t result;
+    zend_long timeout = -1;
+    cat_bool_t ret;
+
+    ZEND_PARSE_PARAMETERS_START(0, 1)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(timeout)
+    ZEND_PARSE_PARAMETERS_END();
+
+    SWOW_THREAD_CHECK_JOINABLE(s_thread);
+
+    s_thread->state = SWOW_THREAD_STATE_JOINING;
+    ret = cat_thread_channel_pop(context->result, &result, timeout);
+    if (UNEXPECTED(!ret)) {
+        s_thread->state = SWOW_THREAD_STATE_RUNNING;
+        swow_throw_exception_with_last(swow_thread_exception_ce);
+        RETURN_THROWS();
+    }
+    /* it has pushed the result, so it is exiting */
+    (void) uv_thread_join(&context->thread);
+    s_thread->state = SWOW_THREAD_STATE_JOINED;
+
+    if (UNEXPECTED(result.failed)) {
+        swow_throw_exception(swow_thread_exception_ce, 0, "%.*s", (int) result.length, result.data);
+        swow_thread_payload_free(&result);
+        RETURN_THROWS();
+    }
+    ret = swow_thread_payload_unserialize(&result, return_value);
+    swow_thread_payload_free(&result);
+    if (UNEXPECTED(!ret)) {
+        RETURN_THROWS();
+    }
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Thread_detach, 0, 0, IS_STATIC, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Thread, detach)
+{
+    SWOW_THREAD_GETTER_CONSTRUCTED(s_thread);
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    SWOW_THREAD_CHECK_JOINABLE(s_thread);
+
+#ifdef ZTS
+    swow_thread_detach_handle(&s_thread->context->thread);
+#endif
+    s_thread->state = SWOW_THREAD_STATE_DETACHED;
+
+    RETURN_THIS();
+}
+
+static const zend_function_entry swow_thread_methods[] = {
+    PHP_ME(Swow_Thread, __construct,  arginfo_class_Swow_Thread___construct,  ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Thread, getId,        arginfo_class_Swow_Thread_getId,        ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Thread, getCurrentId, arginfo_class_Swow_Thread_getCurrentId, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_Thread, isRunning,    arginfo_class_Swow_Thread_isRunning,    ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Thread, join,         arginfo_class_Swow_Thread_join,         ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Thread, detach,       arginfo_class_Swow_Thread_detach,       ZEND_ACC_PUBLIC)
+    PHP_FE_END
+};
+
+/* thread channel */
+
+static zend_object *swow_thread_channel_create_object(zend_class_entry *ce)
+{
+    swow_thread_channel_t *s_channel = swow_object_alloc(swow_thread_channel_t, ce, swow_thread_channel_handlers);
+
+    s_channel->channel = NULL;
+
+    return &s_channel->std;
+}
+
+static void swow_thread_channel_free_object(zend_object *object)
+{
+    swow_thread_channel_t *s_channel = swow_thread_channel_get_from_object(object);
+
+    if (s_channel->channel != NULL) {
+        cat_thread_channel_release(s_channel->channel);
+    }
+
+    zend_object_std_dtor(&s_channel->std);
+}
+
+#define SWOW_THREAD_CHANNEL_GETTER(s_channel, channel) \
+    swow_thread_channel_t *s_channel = swow_thread_channel_get_from_object(Z_OBJ_P(ZEND_THIS)); \
+    cat_thread_channel_t *channel = s_channel->channel
+
+#define SWOW_THREAD_CHANNEL_GETTER_CONSTRUCTED(s_channel, channel) \
+    SWOW_THREAD_CHANNEL_GETTER(s_channel, channel); \
+    if (UNEXPECTED(channel == NULL)) { \
+        zend_throw_error(NULL, "%s must construct first", ZEND_THIS_NAME); \
+        RETURN_THROWS(); \
+    }
+
+#define SWOW_THREAD_CHANNEL_CHECK_TRANSFER(transfer) do { \
+    if (UNEXPECTED(transfer == NULL)) { \
+        zend_throw_error(NULL, "%s can only be (un)serialized when it is being transferred between threads", ZEND_THIS_NAME); \
+        RETURN_THROWS(); \
+    } \
+} while (0)
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_class_Swow_Thread_Channel___construct, 0, 0, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, capacity, IS_LONG, 0, "1")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Thread_Channel, __construct)
+{
+    SWOW_THREAD_CHANNEL_GETTER(s_channel, channel);
+    zend_long capacity = 1;
+
+    if (UNEXPECTED(channel != NULL)) {
+        zend_throw_error(NULL, "%s can be constructed only once", ZEND_THIS_NAME);
+        RETURN_THROWS();
+    }
+
+    ZEND_PARSE_PARAMETERS_START(0, 1)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(capacity)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (UNEXPECTED(capacity < 1 || capacity > CAT_THREAD_CHANNEL_SIZE_MAX)) {
+        zend_argument_value_error(1, "must be between 1 and " CAT_THREAD_CHANNEL_SIZE_FMT, CAT_THREAD_CHANNEL_SIZE_MAX);
+        RETURN_THROWS();
+    }
+
+    channel = cat_thread_channel_create((cat_thread_channel_size_t) capacity, sizeof(swow_thread_payload_t), swow_thread_payload_dtor);
+    if (UNEXPECTED(channel == NULL)) {
+        swow_throw_exception_with_last(swow_thread_exception_ce);
+        RETURN_THROWS();
+    }
+    s_channel->channel = channel;
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Thread_Channel_push, 0, 1, IS_STATIC, 0)
+    ZEND_ARG_TYPE_INFO(0, data, IS_MIXED, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 0, "-1")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Thread_Channel, push)
+{
+    SWOW_THREAD_CHANNEL_GETTER_CONSTRUCTED(s_channel, channel);
+    swow_thread_payload_t payload;
+    zval *z_data;
+    zend_long timeout = -1;
+
+    ZEND_PARSE_PARAMETERS_START(1, 2)
+        Z_PARAM_ZVAL(z_data)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(timeout)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (UNEXPECTED(!swow_thread_payload_serialize(&payload, z_data))) {
+        RETURN_THROWS();
+    }
+    if (UNEXPECTED(!cat_thread_channel_push(channel, &payload, timeout))) {
+        swow_thread_payload_free(&payload);
+        swow_throw_exception_with_last(swow_thread_exception_ce);
+        RETURN_THROWS();
+    }
+
+    RETURN_THIS();
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Thread_Channel_pop, 0, 0, IS_MIXED, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, timeout, IS_LONG, 0, "-1")
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Thread_Channel, pop)
+{
+    SWOW_THREAD_CHANNEL_GETTER_CONSTRUCTED(s_channel, channel);
+    swow_thread_payload_t payload;
+    zend_long timeout = -1;
+    cat_bool_t ret;
+
+    ZEND_PARSE_PARAMETERS_START(0, 1)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(timeout)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (UNEXPECTED(!cat_thread_channel_pop(channel, &payload, timeout))) {
+        swow_throw_exception_with_last(swow_thread_exception_ce);
+        RETURN_THROWS();
+    }
+    ret = swow_thread_payload_unserialize(&payload, return_value);
+    swow_thread_payload_free(&payload);
+    if (UNEXPECTED(!ret)) {
+        RETURN_THROWS();
+    }
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Thread_Channel_close, 0, 0, IS_VOID, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Thread_Channel, close)
+{
+    SWOW_THREAD_CHANNEL_GETTER_CONSTRUCTED(s_channel, channel);
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    cat_thread_channel_close(channel);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Thread_Channel_getCapacity, 0, 0, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Thread_Channel, getCapacity)
+{
+    SWOW_THREAD_CHANNEL_GETTER_CONSTRUCTED(s_channel, channel);
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_LONG(cat_thread_channel_get_capacity(channel));
+}
+
+#define arginfo_class_Swow_Thread_Channel_getLength arginfo_class_Swow_Thread_Channel_getCapacity
+
+static PHP_METHOD(Swow_Thread_Channel, getLength)
+{
+    SWOW_THREAD_CHANNEL_GETTER_CONSTRUCTED(s_channel, channel);
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_LONG(cat_thread_channel_get_length(channel));
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Thread_Channel_isClosed, 0, 0, _IS_BOOL, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_Thread_Channel, isClosed)
+{
+    SWOW_THREAD_CHANNEL_GETTER_CONSTRUCTED(s_channel, channel);
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_BOOL(cat_thread_channel_is_closed(channel));
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Thread_Channel___serialize, 0, 0, IS_ARRAY, 0)
+ZEND_END_ARG_INFO()
+
+/* channel is referenced by the payload, and only its index in the payload is serialized */
+static PHP_METHOD(Swow_Thread_Channel, __serialize)
+{
+    SWOW_THREAD_CHANNEL_GETTER_CONSTRUCTED(s_channel, channel);
+    swow_thread_payload_t *transfer = SWOW_THREAD_G(transfer);
+    uint32_t index;
+
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    SWOW_THREAD_CHANNEL_CHECK_TRANSFER(transfer);
+
+    index = swow_thread_payload_add_channel(transfer, cat_thread_channel_add_ref(channel));
+    array_init(return_value);
+    add_assoc_long(return_value, SWOW_THREAD_CHANNEL_HANDLE_KEY, index);
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_Thread_Channel___unserialize, 0, 1, IS_VOID, 0)
+    ZEND_ARG_TYPE_INFO(0, data, IS_ARRAY, 0)
+ZEND_END_ARG_INFO()
+
+/* it adopts the reference held by the payload, so every handle can only be used once */
+static PHP_METHOD(Swow_Thread_Channel, __unserialize)
+{
+    SWOW_THREAD_CHANNEL_GETTER(s_channel, channel);
+    swow_thread_payload_t *transfer = SWOW_THREAD_G(transfer);
+    HashTable *data;
+    zval *z_handle;
+    zend_long index;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_ARRAY_HT(data)
+    ZEND_PARSE_PARAMETERS_END();
+
+    SWOW_THREAD_CHANNEL_CHECK_TRANSFER(transfer);
+
+    if (UNEXPECTED(channel != NULL)) {
+        zend_throw_error(NULL, "%s can be constructed only once", ZEND_THIS_NAME);
+        RETURN_THROWS();
+    }
+    z_handle = zend_hash_str_find(data, ZEND_STRL(SWOW_THREAD_CHANNEL_HANDLE_KEY));
+    if (UNEXPECTED(z_handle == NULL || Z_TYPE_P(z_handle) != IS_LONG)) {
+        zend_argument_value_error(1, "Expected int for key '" SWOW_THREAD_CHANNEL_HANDLE_KEY "'");
+        RETURN_THROWS();
+    }
+    index = Z_LVAL_P(z_handle);
+    if (UNEXPECTED(index < 0 || (zend_ulong) index >= transfer->channel_count || transfer->channels[index] == NULL)) {
+        zend_argument_value_error(1, "contains an invalid thread channel handle");
+        RETURN_THROWS();
+    }
+    s_channel->channel = transfer->channels[index];
+    transfer->channels[index] = NULL;
+}
+
+static const zend_function_entry swow_thread_channel_methods[] = {
+    PHP_ME(Swow_Thread_Channel, __construct,   arginfo_class_Swow_Thread_Channel___construct,   ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Thread_Channel, push,          arginfo_class_Swow_Thread_Channel_push,          ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Thread_Channel, pop,           arginfo_class_Swow_Thread_Channel_pop,           ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Thread_Channel, close,         arginfo_class_Swow_Thread_Channel_close,         ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Thread_Channel, getCapacity,   arginfo_class_Swow_Thread_Channel_getCapacity,   ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Thread_Channel, getLength,     arginfo_class_Swow_Thread_Channel_getLength,     ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Thread_Channel, isClosed,      arginfo_class_Swow_Thread_Channel_isClosed,      ZEND_ACC_PUBLIC)
+    /* magic */
+    PHP_ME(Swow_Thread_Channel, __serialize,   arginfo_class_Swow_Thread_Channel___serialize,   ZEND_ACC_PUBLIC)
+    PHP_ME(Swow_Thread_Channel, __unserialize, arginfo_class_Swow_Thread_Channel___unserialize, ZEND_ACC_PUBLIC)
+    PHP_FE_END
+};
+
 zend_result swow_thread_module_init(INIT_FUNC_ARGS)
 {
+    CAT_GLOBALS_REGISTER(swow_thread);
+
+    cat_atomic_uint32_init(&swow_thread_last_id, 0);
+#ifdef ZTS
+    if (uv_mutex_init(&swow_thread_mutex) != 0) {
+        return FAILURE;
+    }
+    if (uv_cond_init(&swow_thread_cond) != 0) {
+        uv_mutex_destroy(&swow_thread_mutex);
+        return FAILURE;
+    }
+    swow_thread_running_count = 0;
+#endif
+
+    swow_thread_ce = swow_register_internal_class(
+        "Swow\\Thread", NULL, swow_thread_methods,
+        &swow_thread_handlers, NULL,
+        cat_false, cat_false,
+        swow_thread_create_object,
+        swow_thread_free_object,
+        XtOffsetOf(swow_thread_t, std)
+    );
+
+    swow_thread_exception_ce = swow_register_internal_class(
+        "Swow\\ThreadException", swow_exception_ce, NULL, NULL, NULL, cat_true, cat_true, NULL, NULL, 0
+    );
+
+    swow_thread_channel_ce = swow_register_internal_class(
+        "Swow\\Thread\\Channel", NULL, swow_thread_channel_methods,
+        &swow_thread_channel_handlers, NULL,
+        cat_false, cat_true,
+        swow_thread_channel_create_object,
+        swow_thread_channel_free_object,
+        XtOffsetOf(swow_thread_channel_t, std)
+    );
+
+    return SUCCESS;
+}
+
+zend_result swow_thread_module_shutdown(INIT_FUNC_ARGS)
+{
+#ifdef ZTS
+    /* detached threads are still using the module, wait for them for a while,
+     * but never hang the process shutdown because of a thread which never returns */
+    uint64_t deadline = uv_hrtime() + (uint64_t) SWOW_THREAD_SHUTDOWN_TIMEOUT * 1000 * 1000;
+    uint32_t running_count;
+
+    uv_mutex_lock(&swow_thread_mutex);
+    while (swow_thread_running_count != 0) {
+        uint64_t now = uv_hrtime();
+        if (now >= deadline) {
+            break;
+        }
+        (void) uv_cond_timedwait(&swow_thread_cond, &swow_thread_mutex, deadline - now);
+    }
+    running_count = swow_thread_running_count;
+    uv_mutex_unlock(&swow_thread_mutex);
+    if (running_count == 0) {
+        uv_cond_destroy(&swow_thread_cond);
+        uv_mutex_destroy(&swow_thread_mutex);
+    } else {
+        /* they are still referenced by the running threads, so we leave them as is,
+         * and the threads will be terminated with the process */
+        CAT_WARN(THREAD, "%u thread(s) are still running after waiting for %d ms on shutdown", running_count, SWOW_THREAD_SHUTDOWN_TIMEOUT);
+    }
+#endif
+
+    CAT_GLOBALS_UNREGISTER(swow_thread);
+
     return SUCCESS;
 }
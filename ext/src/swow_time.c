@@ -183,9 +183,22 @@ static const zend_function_entry swow_time_functions[] = {
 
 zend_result swow_time_module_init(INIT_FUNC_ARGS)
 {
+    if (!cat_time_module_init()) {
+        return FAILURE;
+    }
+
     if (!swow_hook_internal_functions(swow_time_functions)) {
         return FAILURE;
     }
 
     return SUCCESS;
 }
+
+zend_result swow_time_module_shutdown(INIT_FUNC_ARGS)
+{
+    if (!cat_time_module_shutdown()) {
+        return FAILURE;
+    }
+
+    return SUCCESS;
+}
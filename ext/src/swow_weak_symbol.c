@@ -225,6 +225,37 @@ int swow_PQconsumeInput_redirect(void *conn) {
     return swow_PQconsumeInput_resolved(conn);
 }
 
+// weak function pointer for PQenterPipelineMode
+#ifdef CAT_OS_WIN
+// extern int PQenterPipelineMode(void *conn);
+# pragma comment(linker, "/alternatename:PQenterPipelineMode=swow_PQenterPipelineMode_redirect")
+#else
+__attribute__((weak, alias("swow_PQenterPipelineMode_redirect"))) extern int PQenterPipelineMode(void *conn);
+#endif
+// resolved function holder
+int (*swow_PQenterPipelineMode_resolved)(void *conn);
+// resolver for PQenterPipelineMode
+int swow_PQenterPipelineMode_resolver(void *conn) {
+    swow_PQenterPipelineMode_resolved = (int (*)(void *conn))DL_FETCH_SYMBOL(DL_FROM_HANDLE, "PQenterPipelineMode");
+
+    if (swow_PQenterPipelineMode_resolved == NULL) {
+#if defined(DL_ERROR)
+        fprintf(stderr, "failed resolve PQenterPipelineMode: %s\n", DL_ERROR());
+#elif defined(CAT_OS_WIN)
+        fprintf(stderr, "failed resolve PQenterPipelineMode: %08x\n", (unsigned int)GetLastError());
+#else
+        fprintf(stderr, "failed resolve PQenterPipelineMode\n",());
+#endif
+        abort();
+    }
+
+    return swow_PQenterPipelineMode_resolved(conn);
+}
+int (*swow_PQenterPipelineMode_resolved)(void *conn) = swow_PQenterPipelineMode_resolver;
+int swow_PQenterPipelineMode_redirect(void *conn) {
+    return swow_PQenterPipelineMode_resolved(conn);
+}
+
 // weak function pointer for PQerrorMessage
 #ifdef CAT_OS_WIN
 // extern char * PQerrorMessage(const void *conn);
@@ -318,6 +349,37 @@ size_t swow_PQescapeStringConn_redirect(void *conn, char *to, const char *from,
     return swow_PQescapeStringConn_resolved(conn, to, from, length, error);
 }
 
+// weak function pointer for PQexitPipelineMode
+#ifdef CAT_OS_WIN
+// extern int PQexitPipelineMode(void *conn);
+# pragma comment(linker, "/alternatename:PQexitPipelineMode=swow_PQexitPipelineMode_redirect")
+#else
+__attribute__((weak, alias("swow_PQexitPipelineMode_redirect"))) extern int PQexitPipelineMode(void *conn);
+#endif
+// resolved function holder
+int (*swow_PQexitPipelineMode_resolved)(void *conn);
+// resolver for PQexitPipelineMode
+int swow_PQexitPipelineMode_resolver(void *conn) {
+    swow_PQexitPipelineMode_resolved = (int (*)(void *conn))DL_FETCH_SYMBOL(DL_FROM_HANDLE, "PQexitPipelineMode");
+
+    if (swow_PQexitPipelineMode_resolved == NULL) {
+#if defined(DL_ERROR)
+        fprintf(stderr, "failed resolve PQexitPipelineMode: %s\n", DL_ERROR());
+#elif defined(CAT_OS_WIN)
+        fprintf(stderr, "failed resolve PQexitPipelineMode: %08x\n", (unsigned int)GetLastError());
+#else
+        fprintf(stderr, "failed resolve PQexitPipelineMode\n",());
+#endif
+        abort();
+    }
+
+    return swow_PQexitPipelineMode_resolved(conn);
+}
+int (*swow_PQexitPipelineMode_resolved)(void *conn) = swow_PQexitPipelineMode_resolver;
+int swow_PQexitPipelineMode_redirect(void *conn) {
+    return swow_PQexitPipelineMode_resolved(conn);
+}
+
 // weak function pointer for PQfinish
 #ifdef CAT_OS_WIN
 // extern void PQfinish(void *conn);
@@ -721,6 +783,37 @@ char * swow_PQgetvalue_redirect(const void *res, int tup_num, int field_num) {
     return swow_PQgetvalue_resolved(res, tup_num, field_num);
 }
 
+// weak function pointer for PQisBusy
+#ifdef CAT_OS_WIN
+// extern int PQisBusy(void *conn);
+# pragma comment(linker, "/alternatename:PQisBusy=swow_PQisBusy_redirect")
+#else
+__attribute__((weak, alias("swow_PQisBusy_redirect"))) extern int PQisBusy(void *conn);
+#endif
+// resolved function holder
+int (*swow_PQisBusy_resolved)(void *conn);
+// resolver for PQisBusy
+int swow_PQisBusy_resolver(void *conn) {
+    swow_PQisBusy_resolved = (int (*)(void *conn))DL_FETCH_SYMBOL(DL_FROM_HANDLE, "PQisBusy");
+
+    if (swow_PQisBusy_resolved == NULL) {
+#if defined(DL_ERROR)
+        fprintf(stderr, "failed resolve PQisBusy: %s\n", DL_ERROR());
+#elif defined(CAT_OS_WIN)
+        fprintf(stderr, "failed resolve PQisBusy: %08x\n", (unsigned int)GetLastError());
+#else
+        fprintf(stderr, "failed resolve PQisBusy\n",());
+#endif
+        abort();
+    }
+
+    return swow_PQisBusy_resolved(conn);
+}
+int (*swow_PQisBusy_resolved)(void *conn) = swow_PQisBusy_resolver;
+int swow_PQisBusy_redirect(void *conn) {
+    return swow_PQisBusy_resolved(conn);
+}
+
 // weak function pointer for PQlibVersion
 #ifdef CAT_OS_WIN
 // extern int PQlibVersion(void);
@@ -907,6 +1000,68 @@ const char * swow_PQparameterStatus_redirect(const void *conn, const char *param
     return swow_PQparameterStatus_resolved(conn, paramName);
 }
 
+// weak function pointer for PQpipelineStatus
+#ifdef CAT_OS_WIN
+// extern int PQpipelineStatus(const void *conn);
+# pragma comment(linker, "/alternatename:PQpipelineStatus=swow_PQpipelineStatus_redirect")
+#else
+__attribute__((weak, alias("swow_PQpipelineStatus_redirect"))) extern int PQpipelineStatus(const void *conn);
+#endif
+// resolved function holder
+int (*swow_PQpipelineStatus_resolved)(const void *conn);
+// resolver for PQpipelineStatus
+int swow_PQpipelineStatus_resolver(const void *conn) {
+    swow_PQpipelineStatus_resolved = (int (*)(const void *conn))DL_FETCH_SYMBOL(DL_FROM_HANDLE, "PQpipelineStatus");
+
+    if (swow_PQpipelineStatus_resolved == NULL) {
+#if defined(DL_ERROR)
+        fprintf(stderr, "failed resolve PQpipelineStatus: %s\n", DL_ERROR());
+#elif defined(CAT_OS_WIN)
+        fprintf(stderr, "failed resolve PQpipelineStatus: %08x\n", (unsigned int)GetLastError());
+#else
+        fprintf(stderr, "failed resolve PQpipelineStatus\n",());
+#endif
+        abort();
+    }
+
+    return swow_PQpipelineStatus_resolved(conn);
+}
+int (*swow_PQpipelineStatus_resolved)(const void *conn) = swow_PQpipelineStatus_resolver;
+int swow_PQpipelineStatus_redirect(const void *conn) {
+    return swow_PQpipelineStatus_resolved(conn);
+}
+
+// weak function pointer for PQpipelineSync
+#ifdef CAT_OS_WIN
+// extern int PQpipelineSync(void *conn);
+# pragma comment(linker, "/alternatename:PQpipelineSync=swow_PQpipelineSync_redirect")
+#else
+__attribute__((weak, alias("swow_PQpipelineSync_redirect"))) extern int PQpipelineSync(void *conn);
+#endif
+// resolved function holder
+int (*swow_PQpipelineSync_resolved)(void *conn);
+// resolver for PQpipelineSync
+int swow_PQpipelineSync_resolver(void *conn) {
+    swow_PQpipelineSync_resolved = (int (*)(void *conn))DL_FETCH_SYMBOL(DL_FROM_HANDLE, "PQpipelineSync");
+
+    if (swow_PQpipelineSync_resolved == NULL) {
+#if defined(DL_ERROR)
+        fprintf(stderr, "failed resolve PQpipelineSync: %s\n", DL_ERROR());
+#elif defined(CAT_OS_WIN)
+        fprintf(stderr, "failed resolve PQpipelineSync: %08x\n", (unsigned int)GetLastError());
+#else
+        fprintf(stderr, "failed resolve PQpipelineSync\n",());
+#endif
+        abort();
+    }
+
+    return swow_PQpipelineSync_resolved(conn);
+}
+int (*swow_PQpipelineSync_resolved)(void *conn) = swow_PQpipelineSync_resolver;
+int swow_PQpipelineSync_redirect(void *conn) {
+    return swow_PQpipelineSync_resolved(conn);
+}
+
 // weak function pointer for PQprotocolVersion
 #ifdef CAT_OS_WIN
 // extern int PQprotocolVersion(const void *conn);
@@ -126,9 +126,11 @@ char *PQcmdTuples(void *res);
 int PQconnectPoll(void *conn);
 void *PQconnectStart(const char *conninfo);
 int  PQconsumeInput(void *conn);
+int  PQenterPipelineMode(void *conn);
 char *PQerrorMessage(const void *conn);
 unsigned char *PQescapeByteaConn(void *conn, const unsigned char *from, size_t from_length, size_t *to_length);
 size_t PQescapeStringConn(void *conn, char *to, const char *from, size_t length, int *error);
+int  PQexitPipelineMode(void *conn);
 void PQfinish(void *conn);
 int  PQflush(void *conn);
 int  PQfmod(const void *res, int field_num);
@@ -142,12 +144,15 @@ int  PQgetisnull(const void *res, int tup_num, int field_num);
 int  PQgetlength(const void *res, int tup_num, int field_num);
 void *PQgetResult(void *conn);
 char *PQgetvalue(const void *res, int tup_num, int field_num);
+int  PQisBusy(void *conn);
 int  PQlibVersion(void);
 int  PQnfields(const void *res);
 int  PQntuples(const void *res);
 void *PQnotifies(void *conn);
 unsigned int  PQoidValue(const void *res);
 const char *PQparameterStatus(const void *conn, const char *paramName);
+int  PQpipelineStatus(const void *conn);
+int  PQpipelineSync(void *conn);
 int  PQprotocolVersion(const void *conn);
 int  PQputCopyData(void *conn, const char *buffer, int nbytes);
 int  PQputCopyEnd(void *conn, const char *errormsg);
@@ -558,9 +558,50 @@ static PHP_METHOD(Swow_WebSocket_WebSocket, unmask)
     cat_websocket_unmask_ex(ptr, length, masking_key != NULL ? ZSTR_VAL(masking_key) : NULL, index);
 }
 
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_WebSocket_WebSocket_getMaskingKernel, 0, 0, IS_STRING, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_WebSocket_WebSocket, getMaskingKernel)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_STRING(cat_websocket_mask_kernel_get_name(cat_websocket_get_mask_kernel()));
+}
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_class_Swow_WebSocket_WebSocket_setMaskingKernel, 0, 1, IS_VOID, 0)
+    ZEND_ARG_TYPE_INFO(0, kernel, IS_STRING, 0)
+ZEND_END_ARG_INFO()
+
+static PHP_METHOD(Swow_WebSocket_WebSocket, setMaskingKernel)
+{
+    zend_string *name;
+    cat_websocket_mask_kernel_t kernel = CAT_WEBSOCKET_MASK_KERNEL_AUTO;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_STR(name)
+    ZEND_PARSE_PARAMETERS_END();
+
+#define SWOW_WEBSOCKET_MASK_KERNEL_MATCH_GEN(_name, value, description) \
+    if (zend_string_equals_literal_ci(name, description)) { \
+        kernel = CAT_WEBSOCKET_MASK_KERNEL_##_name; \
+    } else
+    CAT_WEBSOCKET_MASK_KERNEL_MAP(SWOW_WEBSOCKET_MASK_KERNEL_MATCH_GEN) {
+        zend_argument_value_error(1, "must be one of \"auto\", \"scalar\", \"sse2\", \"avx2\" or \"neon\"");
+        RETURN_THROWS();
+    }
+#undef SWOW_WEBSOCKET_MASK_KERNEL_MATCH_GEN
+
+    if (UNEXPECTED(!cat_websocket_set_mask_kernel(kernel))) {
+        zend_argument_value_error(1, "\"%s\" is not supported on this platform", cat_websocket_mask_kernel_get_name(kernel));
+        RETURN_THROWS();
+    }
+}
+
 static const zend_function_entry swow_websocket_websocket_methods[] = {
-    PHP_ME(Swow_WebSocket_WebSocket, mask,   arginfo_class_Swow_WebSocket_WebSocket_mask,   ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
-    PHP_ME(Swow_WebSocket_WebSocket, unmask, arginfo_class_Swow_WebSocket_WebSocket_unmask, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_WebSocket_WebSocket, mask,             arginfo_class_Swow_WebSocket_WebSocket_mask,             ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_WebSocket_WebSocket, unmask,           arginfo_class_Swow_WebSocket_WebSocket_unmask,           ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_WebSocket_WebSocket, getMaskingKernel, arginfo_class_Swow_WebSocket_WebSocket_getMaskingKernel, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
+    PHP_ME(Swow_WebSocket_WebSocket, setMaskingKernel, arginfo_class_Swow_WebSocket_WebSocket_setMaskingKernel, ZEND_ACC_PUBLIC | ZEND_ACC_STATIC)
     PHP_FE_END
 };
 
@@ -0,0 +1,62 @@
+--TEST--
+swow_buffer: pool
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+?>
+--INI--
+swow.buffer_pool_size=4
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Buffer;
+
+Buffer::clearPool();
+$stats = Buffer::getPoolStats();
+Assert::same($stats['max_count'], 4);
+Assert::same($stats['count'], 0);
+Assert::same($stats['size'], 0);
+
+// released buffers of pooled sizes are cached
+$buffers = [];
+for ($n = 0; $n < 8; $n++) {
+    $buffers[] = new Buffer(Buffer::COMMON_SIZE);
+}
+$buffers = [];
+$stats = Buffer::getPoolStats();
+Assert::same($stats['count'], 4);
+Assert::same($stats['size'], 4 * Buffer::COMMON_SIZE);
+
+// and reused
+$hits = $stats['hits'];
+$buffer = new Buffer(Buffer::COMMON_SIZE);
+Assert::same($buffer->getLength(), 0);
+$buffer->append('foo');
+Assert::same($buffer->toString(), 'foo');
+$stats = Buffer::getPoolStats();
+Assert::same($stats['count'], 3);
+Assert::same($stats['hits'], $hits + 1);
+
+// close() gives the memory back too, but not if it is still shared
+$string = $buffer->toString();
+$buffer->close();
+Assert::same(Buffer::getPoolStats()['count'], 3);
+Assert::same($string, 'foo');
+$buffer->alloc(Buffer::COMMON_SIZE);
+Assert::same(Buffer::getPoolStats()['count'], 2);
+$buffer->close();
+Assert::same(Buffer::getPoolStats()['count'], 3);
+
+// other sizes are not pooled
+$buffer = new Buffer(Buffer::COMMON_SIZE + 1);
+$buffer->close();
+Assert::same(Buffer::getPoolStats()['count'], 3);
+
+Buffer::clearPool();
+Assert::same(Buffer::getPoolStats()['count'], 0);
+
+echo "Done\n";
+?>
+--EXPECT--
+Done
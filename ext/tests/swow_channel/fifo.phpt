@@ -0,0 +1,48 @@
+--TEST--
+swow_channel: fifo order when storage wraps around and grows
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Channel;
+
+foreach ([1, 3, 4, 5000, -1] as $capacity) {
+    $channel = new Channel($capacity);
+    $limit = $capacity === -1 ? 3000 : $capacity;
+    $pushed = $popped = 0;
+    for ($round = 0; $round < 50; $round++) {
+        for ($n = 0; $n < 120 && $channel->getLength() < $limit; $n++) {
+            $channel->push($pushed++);
+        }
+        for ($n = 0; $n < 40 && !$channel->isEmpty(); $n++) {
+            Assert::same($channel->pop(), $popped++);
+        }
+    }
+    while (!$channel->isEmpty()) {
+        Assert::same($channel->pop(), $popped++);
+    }
+    Assert::same($popped, $pushed);
+}
+
+// storage which has been wrapped around can be traversed by gc
+$channel = new Channel(4);
+$channel->push(1);
+$channel->push(2);
+$channel->pop();
+$channel->pop();
+$object = new stdClass();
+$object->channel = $channel;
+for ($n = 0; $n < 4; $n++) {
+    $channel->push($object);
+}
+unset($channel, $object);
+Assert::greaterThanEq(gc_collect_cycles(), 1);
+
+echo "Done\n";
+?>
+--EXPECT--
+Done
@@ -0,0 +1,93 @@
+--TEST--
+swow_channel: pushMany and popMany
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Channel;
+use Swow\ChannelException;
+use Swow\Coroutine;
+
+// buffered: items are pushed until it is full
+$channel = new Channel(4);
+Assert::same($channel->pushMany([]), 0);
+Assert::same($channel->pushMany(['a', 'b', 'c', 'd', 'e', 'f']), 4);
+Assert::true($channel->isFull());
+Assert::same($channel->popMany(3), ['a', 'b', 'c']);
+Assert::same($channel->popMany(100), ['d']);
+Assert::throws(static function () use ($channel): void {
+    $channel->popMany(100, 0);
+}, ChannelException::class);
+
+// waiting producers are woken up after popping
+for ($n = 0; $n < 6; $n++) {
+    Coroutine::run(static function () use ($channel, $n): void {
+        $channel->push($n);
+    });
+}
+Assert::same($channel->getLength(), 4);
+Assert::same($channel->popMany(100), [0, 1, 2, 3]);
+Assert::same($channel->popMany(100), [4, 5]);
+
+// waiting consumers are woken up after pushing
+$received = [];
+for ($n = 0; $n < 3; $n++) {
+    Coroutine::run(static function () use ($channel, &$received): void {
+        $received[] = $channel->pop();
+    });
+}
+Assert::same($channel->pushMany(['x', 'y', 'z']), 3);
+Assert::same($received, ['x', 'y', 'z']);
+Assert::true($channel->isEmpty());
+
+// unbuffered: items are handed over to the waiting peers
+$channel = new Channel();
+$received = [];
+for ($n = 0; $n < 3; $n++) {
+    Coroutine::run(static function () use ($channel, &$received): void {
+        $received[] = $channel->pop();
+    });
+}
+Assert::same($channel->pushMany(['x', 'y', 'z', 'w'], 0), 3);
+Assert::same($received, ['x', 'y', 'z']);
+for ($n = 0; $n < 3; $n++) {
+    Coroutine::run(static function () use ($channel, $n): void {
+        $channel->push($n);
+    });
+}
+Assert::same($channel->popMany(2), [0, 1]);
+Assert::same($channel->popMany(2), [2]);
+
+// pipeline
+$channel = new Channel(64);
+Coroutine::run(static function () use ($channel): void {
+    $items = range(1, TEST_MAX_LOOPS);
+    while ($items) {
+        $items = array_slice($items, $channel->pushMany($items));
+    }
+    $channel->close();
+});
+$sum = 0;
+try {
+    while (true) {
+        $sum += array_sum($channel->popMany(16));
+    }
+} catch (ChannelException) {
+}
+Assert::same($sum, array_sum(range(1, TEST_MAX_LOOPS)));
+
+Assert::throws(static function () use ($channel): void {
+    $channel->pushMany([1]);
+}, ChannelException::class);
+Assert::throws(static function () use ($channel): void {
+    $channel->popMany(0);
+}, ValueError::class);
+
+echo "Done\n";
+?>
+--EXPECT--
+Done
@@ -0,0 +1,32 @@
+--TEST--
+swow_coroutine: getStackPoolStats()
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+skip_if(!Swow\Extension::isBuiltWith('coroutine_stack_pool'), 'coroutine stack pool is not available (e.g. ASan or thread context)');
+?>
+--INI--
+swow.coroutine_stack_pool_size=8
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Coroutine;
+
+$stats = Coroutine::getStackPoolStats();
+Assert::same($stats['max_count'], 8);
+Assert::false($stats['trim']);
+
+for ($n = 0; $n < 16; $n++) {
+    Coroutine::run(static function (): void { });
+}
+
+$stats = Coroutine::getStackPoolStats();
+Assert::lessThanEq($stats['count'], 8);
+Assert::greaterThan($stats['hits'], 0);
+Assert::same($stats['size'] > 0, $stats['count'] > 0);
+
+echo "Done\n";
+?>
+--EXPECT--
+Done
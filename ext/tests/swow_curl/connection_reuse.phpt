@@ -0,0 +1,65 @@
+--TEST--
+swow_curl: keep-alive connections are reused across curl_exec() calls
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+skip_if(PHP_SAPI !== 'cli', 'only for cli');
+skip_if(!getenv('SWOW_HAVE_CURL') && !Swow\Extension::isBuiltWith('curl'), 'extension must be built with libcurl');
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Coroutine;
+use Swow\Socket;
+use Swow\SocketException;
+
+// keep-alive http server
+$connectionCount = 0;
+$server = new Socket(Socket::TYPE_TCP);
+$server->bind('127.0.0.1')->listen();
+Coroutine::run(static function () use ($server, &$connectionCount): void {
+    while (true) {
+        try {
+            $connection = $server->accept();
+        } catch (SocketException) {
+            break;
+        }
+        $connectionCount++;
+        Coroutine::run(static function () use ($connection): void {
+            $buffer = '';
+            try {
+                while (true) {
+                    while (!str_contains($buffer, "\r\n\r\n")) {
+                        $data = $connection->recvString();
+                        if ($data === '') {
+                            break 2;
+                        }
+                        $buffer .= $data;
+                    }
+                    [, $buffer] = explode("\r\n\r\n", $buffer, 2);
+                    $connection->sendString("HTTP/1.1 200 OK\r\nContent-Length: 4\r\n\r\nSwow");
+                }
+            } catch (SocketException) {
+            }
+            $connection->close();
+        });
+    }
+});
+
+$url = "http://127.0.0.1:{$server->getSockPort()}/";
+for ($n = 0; $n < 3; $n++) {
+    $ch = curl_init($url);
+    curl_setopt($ch, CURLOPT_RETURNTRANSFER, true);
+    Assert::same(curl_exec($ch), 'Swow');
+    Assert::same(curl_getinfo($ch, CURLINFO_NUM_CONNECTS), $n === 0 ? 1 : 0);
+    curl_close($ch);
+}
+Assert::same($connectionCount, 1);
+
+$server->close();
+
+echo "Done\n";
+?>
+--EXPECT--
+Done
@@ -0,0 +1,51 @@
+--TEST--
+swow_dns: cache
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+?>
+--INI--
+swow.dns_cache_size=16
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Coroutine;
+use Swow\Socket;
+use Swow\Sync\WaitReference;
+
+$stats = Socket::getDnsCacheStats();
+Assert::same($stats['size'], 16);
+Assert::same($stats['count'], 0);
+
+// concurrent lookups of one name share a single resolution
+$wr = new WaitReference();
+for ($n = 0; $n < 8; $n++) {
+    Coroutine::run(static function () use ($wr): void {
+        Assert::same(gethostbyname('localhost'), '127.0.0.1');
+    });
+}
+WaitReference::wait($wr);
+$stats = Socket::getDnsCacheStats();
+Assert::same($stats['misses'], 1);
+Assert::same($stats['coalesced'], 7);
+Assert::same($stats['count'], 1);
+
+Assert::same(gethostbyname('localhost'), '127.0.0.1');
+Assert::same(Socket::getDnsCacheStats()['hits'], 1);
+
+Socket::clearDnsCache();
+Assert::same(Socket::getDnsCacheStats()['count'], 0);
+
+Socket::setGlobalDnsCacheSize(0);
+Assert::same(gethostbyname('localhost'), '127.0.0.1');
+Assert::same(Socket::getDnsCacheStats()['count'], 0);
+
+Assert::throws(static function (): void {
+    Socket::setGlobalDnsCacheTtl(-1);
+}, ValueError::class);
+
+echo "Done\n";
+?>
+--EXPECT--
+Done
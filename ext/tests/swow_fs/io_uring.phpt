@@ -0,0 +1,83 @@
+--TEST--
+swow_fs: file operations on the io_uring backend (falls back to the thread pool if it is unavailable)
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+skip_if(!is_writable(sys_get_temp_dir()), 'temp dir is not writable');
+?>
+--INI--
+swow.io_uring=1
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Coroutine;
+use Swow\Extension;
+use Swow\Sync\WaitReference;
+
+function io_uring_should_be_available(): bool
+{
+    if (PHP_OS_FAMILY !== 'Linux' || !Extension::isBuiltWith('io_uring')) {
+        return false;
+    }
+    /* statx and IORING_FEAT_RW_CUR_POS require Linux 5.6 */
+    if (version_compare(php_uname('r'), '5.6', '<')) {
+        return false;
+    }
+    $disabled = @file_get_contents('/proc/sys/kernel/io_uring_disabled');
+    if ($disabled !== false && trim($disabled) !== '0') {
+        return false;
+    }
+    /* seccomp filters of container runtimes usually block io_uring syscalls */
+    $status = @file_get_contents('/proc/self/status');
+    if ($status !== false && preg_match('/^Seccomp:\s*2$/m', $status)) {
+        return false;
+    }
+
+    return true;
+}
+
+$dir = sys_get_temp_dir();
+$wr = new WaitReference();
+for ($c = 0; $c < 32; $c++) {
+    Coroutine::run(static function () use ($dir, $c, $wr): void {
+        $file = "{$dir}/swow-test-io-uring-{$c}";
+        $fp = fopen($file, 'w+');
+        for ($n = 0; $n < 16; $n++) {
+            Assert::same(fwrite($fp, str_repeat(chr(ord('a') + $n), 64)), 64);
+        }
+        Assert::true(fflush($fp));
+        Assert::same(fstat($fp)['size'], 16 * 64);
+        for ($n = 15; $n >= 0; $n--) {
+            Assert::same(fseek($fp, $n * 64), 0);
+            Assert::same(fread($fp, 64), str_repeat(chr(ord('a') + $n), 64));
+        }
+        fclose($fp);
+        clearstatcache();
+        Assert::same(stat($file)['size'], 16 * 64);
+        Assert::same(file_get_contents($file, false, null, 64, 4), 'bbbb');
+        unlink($file);
+        Assert::false(@fopen($file, 'r'));
+    });
+}
+WaitReference::wait($wr);
+
+if (io_uring_should_be_available()) {
+    Assert::same(Extension::getFsBackend(), 'io_uring');
+} else {
+    Assert::oneOf(Extension::getFsBackend(), ['io_uring', 'thread_pool']);
+}
+if (!Extension::isBuiltWith('io_uring')) {
+    Assert::same(Extension::getFsBackend(), 'thread_pool');
+}
+
+echo 'Done' . PHP_EOL;
+?>
+--CLEAN--
+<?php
+for ($c = 0; $c < 32; $c++) {
+    @unlink(sys_get_temp_dir() . "/swow-test-io-uring-{$c}");
+}
+?>
+--EXPECT--
+Done
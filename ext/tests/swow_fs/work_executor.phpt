@@ -0,0 +1,60 @@
+--TEST--
+swow_fs: concurrent file operations on the work executor
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+skip_if(!is_writable(sys_get_temp_dir()), 'temp dir is not writable');
+?>
+--INI--
+swow.work_threads=2
+swow.io_uring=0
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Coroutine;
+use Swow\Extension;
+use Swow\Sync\WaitReference;
+
+$before = Extension::getWorkStats()['fs'];
+
+$dir = sys_get_temp_dir();
+$wr = new WaitReference();
+for ($c = 0; $c < 32; $c++) {
+    Coroutine::run(static function () use ($dir, $c, $wr): void {
+        $file = "{$dir}/swow-test-work-executor-{$c}";
+        for ($n = 0; $n < 10; $n++) {
+            $fp = fopen($file, 'w+');
+            fwrite($fp, str_repeat('x', $n));
+            Assert::same(fstat($fp)['size'], $n);
+            fclose($fp);
+            clearstatcache();
+            Assert::same(stat($file)['size'], $n);
+        }
+        unlink($file);
+        Assert::false(file_exists($file));
+    });
+}
+WaitReference::wait($wr);
+
+$stats = Extension::getWorkStats();
+Assert::same($stats['threads'], 2);
+$fs = $stats['fs'];
+Assert::greaterThan($fs['submitted'] - $before['submitted'], 0);
+Assert::same($fs['completed'] - $before['completed'], $fs['submitted'] - $before['submitted']);
+Assert::same($fs['canceled'], $before['canceled']);
+Assert::same($fs['queued'], 0);
+Assert::same($fs['running'], 0);
+Assert::greaterThan($fs['max_running'], 0);
+Assert::lessThanEq($fs['max_running'], 2);
+
+echo 'Done' . PHP_EOL;
+?>
+--CLEAN--
+<?php
+for ($c = 0; $c < 32; $c++) {
+    @unlink(sys_get_temp_dir() . "/swow-test-work-executor-{$c}");
+}
+?>
+--EXPECT--
+Done
@@ -0,0 +1,118 @@
+--TEST--
+swow_http: parse the whole head at once
+--SKIPIF--
+<?php
+
+require __DIR__ . '/../include/skipif.php';
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Http\Parser;
+
+$request = "GET /foo?bar=baz HTTP/1.1\r\n" .
+    "Host: localhost\r\n" .
+    "X-Empty:\r\n" .
+    "X-Test-Header: value1\r\n" .
+    "x-test-header: value2\r\n" .
+    "X-Test-Header: value3\r\n" .
+    "Content-Length: 5\r\n" .
+    "\r\n" .
+    'hello';
+
+// feed it in all kinds of pieces, so that names and values are split across reads
+foreach ([1, 2, 3, 7, strlen($request)] as $chunkSize) {
+    $parser = (new Parser())->setType(Parser::TYPE_REQUEST)->setEvents(Parser::EVENT_BODY | Parser::EVENT_MESSAGE_COMPLETE);
+    $buffer = '';
+    $parsedOffset = 0;
+    foreach (str_split($request, $chunkSize) as $chunk) {
+        $buffer .= $chunk;
+        $parsedOffset += $parser->executeHead($buffer, $parsedOffset);
+        if ($parser->getEvent() === Parser::EVENT_HEADERS_COMPLETE) {
+            break;
+        }
+        Assert::same($parser->getEvent(), Parser::EVENT_NONE);
+        Assert::same($parsedOffset, strlen($buffer));
+    }
+    Assert::same($parser->getEvent(), Parser::EVENT_HEADERS_COMPLETE);
+    Assert::same($parser->getHead(), [
+        'method' => 'GET',
+        'uri' => '/foo?bar=baz',
+        'protocol_version' => '1.1',
+        'headers' => [
+            'Host' => ['localhost'],
+            'X-Empty' => [''],
+            'X-Test-Header' => ['value1', 'value3'],
+            'x-test-header' => ['value2'],
+            'Content-Length' => ['5'],
+        ],
+        'header_names' => [
+            'host' => 'Host',
+            'x-empty' => 'X-Empty',
+            'x-test-header' => 'X-Test-Header',
+            'content-length' => 'Content-Length',
+        ],
+    ]);
+    Assert::same($parser->getContentLength(), 5);
+    // the body is still parsed by execute()
+    $buffer = $request;
+    $parsedOffset += $parser->execute($buffer, $parsedOffset);
+    Assert::same($parser->getEvent(), Parser::EVENT_BODY);
+    Assert::same(substr($buffer, $parser->getDataOffset(), $parser->getDataLength()), 'hello');
+    $parsedOffset += $parser->execute($buffer, $parsedOffset);
+    Assert::same($parser->getEvent(), Parser::EVENT_MESSAGE_COMPLETE);
+    Assert::same($parsedOffset, strlen($request));
+}
+
+// response
+$parser = (new Parser())->setType(Parser::TYPE_RESPONSE);
+$response = "HTTP/1.1 404 Not Found\r\nServer: swow\r\nContent-Length: 0\r\n\r\n";
+Assert::same($parser->executeHead($response), strlen($response));
+Assert::same($parser->getHead(), [
+    'status_code' => 404,
+    'reason_phrase' => 'Not Found',
+    'protocol_version' => '1.1',
+    'headers' => [
+        'Server' => ['swow'],
+        'Content-Length' => ['0'],
+    ],
+    'header_names' => [
+        'server' => 'Server',
+        'content-length' => 'Content-Length',
+    ],
+]);
+
+// the head is reset for the next message
+$response = "HTTP/1.0 200 OK\r\n\r\n";
+$parser->reset()->setType(Parser::TYPE_RESPONSE);
+Assert::same($parser->getHead()['headers'], []);
+Assert::same($parser->executeHead($response), strlen($response));
+Assert::same($parser->getHead()['status_code'], 200);
+Assert::same($parser->getHead()['reason_phrase'], 'OK');
+Assert::same($parser->getHead()['headers'], []);
+
+// arrays returned by getHead() are never changed by the subsequent parsing
+$parser = (new Parser())->setType(Parser::TYPE_REQUEST);
+$buffer = "GET / HTTP/1.1\r\nX-A: 1\r\nX-B: 2\r\n";
+$parsedOffset = $parser->executeHead($buffer);
+Assert::same($parser->getEvent(), Parser::EVENT_NONE);
+$head = $parser->getHead();
+Assert::same($head['headers']['X-A'], ['1']);
+$snapshot = serialize($head);
+$buffer .= "X-A: 3\r\nX-C: 4\r\n\r\n";
+$parser->executeHead($buffer, $parsedOffset);
+Assert::same($parser->getEvent(), Parser::EVENT_HEADERS_COMPLETE);
+Assert::same(serialize($head), $snapshot);
+Assert::same($parser->getHead()['headers'], ['X-A' => ['1', '3'], 'X-B' => ['2'], 'X-C' => ['4']]);
+
+// errors
+$parser = (new Parser())->setType(Parser::TYPE_REQUEST);
+Assert::throws(static function () use ($parser): void {
+    $parser->executeHead("GET / HTTP/1.1\r\nBad Header\r\n\r\n");
+}, Swow\Http\ParserException::class);
+
+echo "Done\n";
+?>
+--EXPECT--
+Done
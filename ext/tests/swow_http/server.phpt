@@ -0,0 +1,194 @@
+--TEST--
+swow_http: native server
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Coroutine;
+use Swow\Http\Server;
+use Swow\Http\Server\Request;
+use Swow\Socket;
+use Swow\Sync\WaitReference;
+
+$server = new Server((new Socket(Socket::TYPE_TCP))->bind('127.0.0.1')->listen());
+$server->setMaxHeaderLength(1024)->setMaxContentLength(4096);
+Assert::same($server->getMaxHeaderLength(), 1024);
+Assert::same($server->getMaxContentLength(), 4096);
+$wr = new WaitReference();
+Coroutine::run(static function () use ($server, $wr): void {
+    $server->serve(static function (Request $request): ?string {
+        switch ($request->getUri()) {
+            case '/echo':
+                $request->respond(200, $request->getBody(), [
+                    'X-Method' => $request->getMethod(),
+                    'X-Protocol-Version' => $request->getProtocolVersion(),
+                    'X-Foo' => $request->getHeader('x-foo'),
+                    'Content-Length' => '999', // ignored
+                    'Transfer-Encoding' => 'chunked', // ignored
+                ]);
+                Assert::true($request->isResponded());
+                return null;
+            case '/return':
+                return 'returned';
+            case '/close':
+                $request->respond(200, 'bye', ['Connection' => 'close']);
+                return null;
+            case '/inject':
+                foreach ([['X-Foo' => "a\r\nSet-Cookie: x=y"], ['X-Foo' => ["a", "b\n"]], ["X-Foo\r\nBar" => 'a'], ['' => 'a']] as $headers) {
+                    Assert::throws(static function () use ($request, $headers): void {
+                        $request->respond(200, '', $headers);
+                    }, ValueError::class);
+                }
+                Assert::false($request->isResponded());
+                $request->respond(200, 'safe');
+                return null;
+            case '/throw':
+                throw new Exception('Handler failed');
+            case '/204':
+            case '/304':
+                $request->respond((int) substr($request->getUri(), 1), 'ignored');
+                return null;
+            case '/large':
+                $request->respond(200, str_repeat('x', 65536));
+                return null;
+            default:
+                Assert::true($request->hasHeader('HOST'));
+                Assert::false($request->hasHeader('X-Nothing'));
+                Assert::same($request->getHeaderNames()['host'], 'Host');
+                $request->respond(404);
+                return null;
+        }
+    });
+});
+
+$client = (new Socket(Socket::TYPE_TCP))->connect($server->getSocket()->getSockAddress(), $server->getSocket()->getSockPort());
+$recvResponse = static function () use (&$client): array {
+    $head = '';
+    while (!str_ends_with($head, "\r\n\r\n")) {
+        $head .= $client->readString(1);
+    }
+    $lines = explode("\r\n", rtrim($head));
+    $headers = [];
+    foreach (array_slice($lines, 1) as $line) {
+        [$name, $value] = explode(': ', $line, 2);
+        $headers[$name][] = $value;
+    }
+    $contentLength = (int) ($headers['Content-Length'][0] ?? 0);
+    $body = $contentLength > 0 ? $client->readString($contentLength) : '';
+
+    return [$lines[0], $headers, $body];
+};
+
+// pipelined requests are answered in order
+$client->sendString(
+    "POST /echo HTTP/1.1\r\nHost: localhost\r\nX-Foo: a\r\nX-Foo: b\r\nContent-Length: 5\r\n\r\nhello" .
+    "GET /return HTTP/1.1\r\nHost: localhost\r\n\r\n" .
+    "POST /echo HTTP/1.1\r\nHost: localhost\r\nTransfer-Encoding: chunked\r\n\r\n3\r\nfoo\r\n3\r\nbar\r\n0\r\n\r\n" .
+    "GET /unknown HTTP/1.1\r\nHost: localhost\r\n\r\n"
+);
+[$statusLine, $headers, $body] = $recvResponse();
+Assert::same($statusLine, 'HTTP/1.1 200 OK');
+Assert::same($headers['X-Method'], ['POST']);
+Assert::same($headers['X-Protocol-Version'], ['1.1']);
+Assert::same($headers['X-Foo'], ['a, b']);
+Assert::same($headers['Content-Length'], ['5']);
+Assert::false(isset($headers['Transfer-Encoding']));
+Assert::same($headers['Connection'], ['keep-alive']);
+Assert::same($body, 'hello');
+[$statusLine, , $body] = $recvResponse();
+Assert::same($statusLine, 'HTTP/1.1 200 OK');
+Assert::same($body, 'returned');
+[$statusLine, , $body] = $recvResponse();
+Assert::same($statusLine, 'HTTP/1.1 200 OK');
+Assert::same($body, 'foobar');
+[$statusLine] = $recvResponse();
+Assert::same($statusLine, 'HTTP/1.1 404 Not Found');
+
+// split across reads
+foreach (str_split("HEAD /echo HTTP/1.0\r\nConnection: keep-alive\r\nX-Foo: split\r\n\r\n", 3) as $chunk) {
+    $client->sendString($chunk);
+    msleep(1);
+}
+[$statusLine, $headers] = $recvResponse();
+Assert::same($statusLine, 'HTTP/1.1 200 OK');
+Assert::same($headers['X-Foo'], ['split']);
+Assert::same($headers['X-Protocol-Version'], ['1.0']);
+Assert::same($headers['Connection'], ['keep-alive']);
+
+// 204 and 304 responses have neither body nor Content-Length
+$client->sendString("GET /204 HTTP/1.1\r\n\r\nGET /304 HTTP/1.1\r\n\r\nGET /return HTTP/1.1\r\n\r\n");
+[$statusLine, $headers] = $recvResponse();
+Assert::same($statusLine, 'HTTP/1.1 204 No Content');
+Assert::false(isset($headers['Content-Length']));
+[$statusLine, $headers] = $recvResponse();
+Assert::same($statusLine, 'HTTP/1.1 304 Not Modified');
+Assert::false(isset($headers['Content-Length']));
+[$statusLine, , $body] = $recvResponse();
+Assert::same($statusLine, 'HTTP/1.1 200 OK');
+Assert::same($body, 'returned');
+
+// large body is written directly
+$client->sendString("GET /large HTTP/1.1\r\n\r\n");
+[, , $body] = $recvResponse();
+Assert::same($body, str_repeat('x', 65536));
+
+// invalid headers are rejected without breaking the response
+$client->sendString("GET /inject HTTP/1.1\r\n\r\n");
+[$statusLine, $headers, $body] = $recvResponse();
+Assert::same($statusLine, 'HTTP/1.1 200 OK');
+Assert::false(isset($headers['Set-Cookie']));
+Assert::same($body, 'safe');
+
+// handler asks to close
+$client->sendString("GET /close HTTP/1.1\r\n\r\n");
+[, $headers, $body] = $recvResponse();
+Assert::same($headers['Connection'], ['close']);
+Assert::same($body, 'bye');
+Assert::same($client->recvString(), '');
+$client->close();
+
+// errors
+$errors = [
+    "GET / HTTP/1.1\r\nBad Header\r\n\r\n" => 'HTTP/1.1 400 Bad Request',
+    'GET /' . str_repeat('x', 2048) . " HTTP/1.1\r\n\r\n" => 'HTTP/1.1 414 Request-URI Too Large',
+    "GET / HTTP/1.1\r\nX-Large: " . str_repeat('x', 2048) . "\r\n\r\n" => 'HTTP/1.1 431 Request Header Fields Too Large',
+    "POST / HTTP/1.1\r\nContent-Length: 8192\r\n\r\n" => 'HTTP/1.1 413 Request Entity Too Large',
+];
+foreach ($errors as $request => $expectedStatusLine) {
+    $client = (new Socket(Socket::TYPE_TCP))->connect($server->getSocket()->getSockAddress(), $server->getSocket()->getSockPort());
+    $client->sendString($request);
+    [$statusLine, $headers] = $recvResponse();
+    Assert::same($statusLine, $expectedStatusLine);
+    Assert::same($headers['Connection'], ['close']);
+    $client->close();
+}
+
+// handler failure only closes its own connection
+$client = (new Socket(Socket::TYPE_TCP))->connect($server->getSocket()->getSockAddress(), $server->getSocket()->getSockPort());
+$client->sendString("GET /throw HTTP/1.1\r\n\r\n");
+[$statusLine, $headers] = $recvResponse();
+Assert::same($statusLine, 'HTTP/1.1 500 Internal Server Error');
+Assert::same($headers['Connection'], ['close']);
+Assert::same($client->recvString(), '');
+$client->close();
+$client = (new Socket(Socket::TYPE_TCP))->connect($server->getSocket()->getSockAddress(), $server->getSocket()->getSockPort());
+$client->sendString("GET /return HTTP/1.1\r\n\r\n");
+[$statusLine, , $body] = $recvResponse();
+Assert::same($statusLine, 'HTTP/1.1 200 OK');
+Assert::same($body, 'returned');
+$client->close();
+
+$server->getSocket()->close();
+WaitReference::wait($wr);
+
+echo "Done\n";
+?>
+--EXPECTF--
+Warning: Uncaught Exception: Handler failed in %s:%d
+Stack trace:
+%A
+Done
@@ -0,0 +1,114 @@
+--TEST--
+swow_pgsql: test batch
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+skip_if_env_not_true('TEST_SWOW_POSTGRESQL');
+skip_if(!Swow\Extension::isBuiltWith('pgsql'), 'pgsql is not built in');
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+require __DIR__ . '/PDOUtil.inc';
+
+PDOUtil::init();
+
+$pdo = PDOUtil::create();
+
+$results = $pdo->pgsqlExecBatch([
+    ['INSERT INTO test_swow_pgsql_users (name, age) values ($1, $2)', ['foo', 18]],
+    ['INSERT INTO test_swow_pgsql_users (name, age) values ($1, $2)', ['bar', null]],
+    'SELECT name, age FROM test_swow_pgsql_users ORDER BY id',
+    ['SELECT $1::int + $2::int AS sum', [1, 2]],
+], PDO::FETCH_ASSOC);
+var_dump($results);
+
+try {
+    $pdo->pgsqlExecBatch([
+        ['INSERT INTO test_swow_pgsql_users (name, age) values ($1, $2)', ['baz', 20]],
+        'SELECT * FROM test_swow_pgsql_not_exists',
+    ]);
+    echo "Never here\n";
+} catch (PDOException $exception) {
+    echo $exception->getCode(), "\n";
+}
+/* failed batch is rolled back as a whole */
+var_dump($pdo->query("SELECT COUNT(*) FROM test_swow_pgsql_users WHERE name = 'baz'")->fetchColumn());
+
+/* the first query fails, the rest are aborted */
+try {
+    $pdo->pgsqlExecBatch([
+        'SELECT * FROM test_swow_pgsql_not_exists',
+        ['INSERT INTO test_swow_pgsql_users (name, age) values ($1, $2)', ['qux', 30]],
+    ]);
+    echo "Never here\n";
+} catch (PDOException $exception) {
+    echo $exception->getCode(), "\n";
+}
+var_dump($pdo->query("SELECT COUNT(*) FROM test_swow_pgsql_users WHERE name = 'qux'")->fetchColumn());
+
+/* batch inside an explicit transaction does not commit it */
+$pdo->beginTransaction();
+var_dump($pdo->pgsqlExecBatch([
+    ['INSERT INTO test_swow_pgsql_users (name, age) values ($1, $2)', ['quux', 40]],
+]));
+var_dump($pdo->inTransaction());
+$pdo->rollBack();
+var_dump($pdo->query("SELECT COUNT(*) FROM test_swow_pgsql_users WHERE name = 'quux'")->fetchColumn());
+
+/* parameters must be convertible to string */
+try {
+    $pdo->pgsqlExecBatch([
+        ['SELECT $1::text', [new stdClass()]],
+    ]);
+    echo "Never here\n";
+} catch (Error $error) {
+    echo $error::class, ': ', $error->getMessage(), "\n";
+}
+
+echo "Done\n";
+?>
+--EXPECT--
+array(4) {
+  [0]=>
+  int(1)
+  [1]=>
+  int(1)
+  [2]=>
+  array(2) {
+    [0]=>
+    array(2) {
+      ["name"]=>
+      string(3) "foo"
+      ["age"]=>
+      int(18)
+    }
+    [1]=>
+    array(2) {
+      ["name"]=>
+      string(3) "bar"
+      ["age"]=>
+      NULL
+    }
+  }
+  [3]=>
+  array(1) {
+    [0]=>
+    array(1) {
+      ["sum"]=>
+      int(3)
+    }
+  }
+}
+42P01
+int(0)
+42P01
+int(0)
+array(1) {
+  [0]=>
+  int(1)
+}
+bool(true)
+int(0)
+Error: Object of class stdClass could not be converted to string
+Done
@@ -0,0 +1,71 @@
+--TEST--
+swow_socket: acceptMany and tryAcceptTo
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Socket;
+
+const TEST_ACCEPT_CONNECTIONS = 32;
+
+$server = new Socket(Socket::TYPE_TCP);
+$server->bind('127.0.0.1')->listen();
+
+// nothing is pending
+Assert::false($server->tryAcceptTo(new Socket(Socket::TYPE_TCP)));
+Assert::throws(static function () use ($server): void {
+    $server->acceptMany(4, 10);
+}, Swow\SocketException::class);
+
+$clients = [];
+for ($n = 0; $n < TEST_ACCEPT_CONNECTIONS; $n++) {
+    $clients[$n] = (new Socket(Socket::TYPE_TCP))->connect($server->getSockAddress(), $server->getSockPort());
+}
+// let all connections arrive at the backlog
+msleep(10);
+
+// it is limited by $max
+$connections = $server->acceptMany(8);
+Assert::same(count($connections), 8);
+$connection = new Socket(Socket::TYPE_TCP);
+Assert::true($server->tryAcceptTo($connection));
+$connections[] = $connection;
+// pending connections are drained in one call
+while (count($connections) < TEST_ACCEPT_CONNECTIONS) {
+    $connections = [...$connections, ...$server->acceptMany()];
+}
+Assert::same(count($connections), TEST_ACCEPT_CONNECTIONS);
+Assert::false($server->tryAcceptTo(new Socket(Socket::TYPE_TCP)));
+// batched and non-blocking accepts are counted as well
+Assert::same(array_sum($server->getStats()['accept_latency']), TEST_ACCEPT_CONNECTIONS);
+
+// all of them are usable
+$ports = [];
+foreach ($connections as $connection) {
+    Assert::isInstanceOf($connection, Socket::class);
+    $ports[$connection->getPeerPort()] = $connection;
+}
+foreach ($clients as $client) {
+    Assert::keyExists($ports, $client->getSockPort());
+    $client->sendString('ping');
+    Assert::same($ports[$client->getSockPort()]->readString(4), 'ping');
+}
+
+Assert::throws(static function () use ($server): void {
+    $server->acceptMany(0);
+}, ValueError::class);
+
+foreach ([...$clients, ...$connections] as $socket) {
+    $socket->close();
+}
+$server->close();
+
+echo "Done\n";
+
+?>
+--EXPECT--
+Done
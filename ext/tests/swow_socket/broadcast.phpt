@@ -0,0 +1,63 @@
+--TEST--
+swow_socket: broadcast
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Coroutine;
+use Swow\Errno;
+use Swow\Socket;
+use Swow\Sync\WaitReference;
+
+const TEST_BROADCAST_CONNECTIONS = 16;
+
+$server = new Socket(Socket::TYPE_TCP);
+$server->bind('127.0.0.1')->listen();
+$clients = $connections = [];
+for ($n = 0; $n < TEST_BROADCAST_CONNECTIONS; $n++) {
+    $clients[$n] = (new Socket(Socket::TYPE_TCP))->connect($server->getSockAddress(), $server->getSockPort());
+    $connections["connection#{$n}"] = $server->accept();
+}
+
+// small data is written directly, big data would block and be waited together
+foreach ([random_bytes(64), random_bytes(4 * 1024 * 1024)] as $data) {
+    $wr = new WaitReference();
+    foreach ($clients as $client) {
+        Coroutine::run(static function () use ($client, $data, $wr): void {
+            Assert::same($client->readString(strlen($data)), $data);
+        });
+    }
+    Assert::same(Socket::broadcast($connections, $data), []);
+    WaitReference::wait($wr);
+}
+
+// failures are reported with the same keys
+$connections['connection#1']->close();
+$errors = Socket::broadcast($connections, 'foo');
+Assert::same(array_keys($errors), ['connection#1']);
+Assert::same($errors['connection#1'], Errno::EBADF);
+
+// the client does not read, it will be timed out
+$data = random_bytes(16 * 1024 * 1024);
+$errors = Socket::broadcast([$connections['connection#2']], $data, 100);
+Assert::same($errors, [Errno::ETIMEDOUT]);
+Assert::false($connections['connection#2']->isAvailable());
+
+Assert::throws(static function (): void {
+    Socket::broadcast([new stdClass()], 'foo');
+}, TypeError::class);
+
+foreach ($clients as $client) {
+    $client->close();
+}
+$server->close();
+
+echo "Done\n";
+
+?>
+--EXPECT--
+Done
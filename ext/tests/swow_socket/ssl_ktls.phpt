@@ -0,0 +1,60 @@
+--TEST--
+swow_socket: SSL with kTLS (falls back to user-space TLS if kernel does not support it)
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+skip_if(!getenv('SWOW_HAVE_SSL') && !Swow\Extension::isBuiltWith('ssl'), 'extension must be built with ssl');
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Coroutine;
+use Swow\Socket;
+use Swow\Sync\WaitReference;
+
+const FILE_SIZE = 1024 * 1024;
+
+$random = getRandomBytes(FILE_SIZE);
+$tmpFile = tmpfile();
+fwrite($tmpFile, $random);
+$filename = stream_get_meta_data($tmpFile)['uri'];
+
+$server = new Socket(Socket::TYPE_TCP);
+$server->bind('127.0.0.1')->listen();
+$wr = new WaitReference();
+Coroutine::run(static function () use ($server, $filename, $wr): void {
+    $connection = $server->accept();
+    $connection->enableCrypto([
+        'certificate' => __DIR__ . '/../include/ssl/server.crt',
+        'certificate_key' => __DIR__ . '/../include/ssl/server.key',
+        'ktls' => true,
+    ]);
+    Assert::same($connection->readString(4), 'ping');
+    if (!Swow\Extension::isBuiltWith('ktls')) {
+        Assert::false($connection->isKtlsSendEnabled());
+    }
+    $connection->sendString('pong');
+    Assert::same($connection->sendFile($filename), FILE_SIZE);
+    Assert::same($connection->readString(3), 'bye');
+    $connection->close();
+});
+$client = new Socket(Socket::TYPE_TCP);
+$client->connect($server->getSockAddress(), $server->getSockPort());
+$client->enableCrypto([
+    'verify_peer' => false,
+    'verify_peer_name' => false,
+    'ktls' => true,
+]);
+$client->sendString('ping');
+Assert::same($client->readString(4), 'pong');
+Assert::same($client->readString(FILE_SIZE), $random);
+$client->sendString('bye');
+WaitReference::wait($wr);
+$client->close();
+$server->close();
+
+echo "Done\n";
+?>
+--EXPECT--
+Done
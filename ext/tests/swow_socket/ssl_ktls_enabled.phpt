@@ -0,0 +1,60 @@
+--TEST--
+swow_socket: SSL sending is offloaded to kTLS when kernel supports it
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+skip_if(!Swow\Extension::isBuiltWith('ktls'), 'extension must be built with kTLS');
+skip_if(PHP_OS_FAMILY !== 'Linux', 'kTLS is only supported on Linux');
+$ulp = @file_get_contents('/proc/sys/net/ipv4/tcp_available_ulp');
+skip_if($ulp === false || !in_array('tls', preg_split('/\s+/', trim($ulp)), true), 'kernel tls module is not loaded');
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Coroutine;
+use Swow\Socket;
+use Swow\Sync\WaitReference;
+
+const FILE_SIZE = 256 * 1024;
+
+$random = getRandomBytes(FILE_SIZE);
+$tmpFile = tmpfile();
+fwrite($tmpFile, $random);
+$filename = stream_get_meta_data($tmpFile)['uri'];
+
+foreach ([true, false] as $ktls) {
+    $server = new Socket(Socket::TYPE_TCP);
+    $server->bind('127.0.0.1')->listen();
+    $wr = new WaitReference();
+    Coroutine::run(static function () use ($server, $filename, $ktls, $wr): void {
+        $connection = $server->accept();
+        $connection->enableCrypto([
+            'certificate' => __DIR__ . '/../include/ssl/server.crt',
+            'certificate_key' => __DIR__ . '/../include/ssl/server.key',
+            'ktls' => $ktls,
+        ]);
+        Assert::same($connection->isKtlsSendEnabled(), $ktls);
+        Assert::same($connection->sendFile($filename), FILE_SIZE);
+        Assert::same($connection->readString(3), 'bye');
+        $connection->close();
+    });
+    $client = new Socket(Socket::TYPE_TCP);
+    $client->connect($server->getSockAddress(), $server->getSockPort());
+    $client->enableCrypto([
+        'verify_peer' => false,
+        'verify_peer_name' => false,
+        'ktls' => $ktls,
+    ]);
+    Assert::same($client->isKtlsSendEnabled(), $ktls);
+    Assert::same($client->readString(FILE_SIZE), $random);
+    $client->sendString('bye');
+    WaitReference::wait($wr);
+    $client->close();
+    $server->close();
+}
+
+echo "Done\n";
+?>
+--EXPECT--
+Done
@@ -0,0 +1,118 @@
+--TEST--
+swow_socket: SSL session resumption with shared session cache and ticket keys
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+skip_if(!getenv('SWOW_HAVE_SSL') && !Swow\Extension::isBuiltWith('ssl'), 'extension must be built with ssl');
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Coroutine;
+use Swow\Socket;
+
+const TEST_ROUNDS = 4;
+
+function testResumption(array $serverOptions): void
+{
+    Socket::clearSslSessionCache();
+    $before = Socket::getSslSessionCacheStats();
+    $server = new Socket(Socket::TYPE_TCP);
+    $server->bind('127.0.0.1')->listen();
+    Coroutine::run(static function () use ($server, $serverOptions): void {
+        for ($n = 0; $n < TEST_ROUNDS; $n++) {
+            $connection = $server->accept();
+            $connection->enableCrypto([
+                'certificate' => __DIR__ . '/../include/ssl/server.crt',
+                'certificate_key' => __DIR__ . '/../include/ssl/server.key',
+            ] + $serverOptions);
+            $connection->sendString('hello');
+            $connection->close();
+        }
+    });
+    for ($n = 0; $n < TEST_ROUNDS; $n++) {
+        $client = new Socket(Socket::TYPE_TCP);
+        $client->connect($server->getSockAddress(), $server->getSockPort());
+        $client->enableCrypto([
+            'verify_peer' => false,
+            'verify_peer_name' => false,
+        ]);
+        Assert::same($client->readString(5), 'hello');
+        $client->close();
+    }
+    $server->close();
+    $after = Socket::getSslSessionCacheStats();
+    Assert::same($after['server_handshakes'] - $before['server_handshakes'], TEST_ROUNDS);
+    Assert::same($after['client_handshakes'] - $before['client_handshakes'], TEST_ROUNDS);
+    /* only the first one is a full handshake */
+    Assert::greaterThan($after['server_resumptions'] - $before['server_resumptions'], 0);
+    Assert::same($after['client_resumptions'] - $before['client_resumptions'], $after['server_resumptions'] - $before['server_resumptions']);
+}
+
+function testClientSettingsIsolation(): void
+{
+    $clientOptionsList = [
+        ['verify_peer' => false, 'verify_peer_name' => false],
+        /* settings are different, session must not be shared */
+        ['verify_peer' => false, 'verify_peer_name' => false, 'verify_depth' => 3],
+        ['verify_peer' => false, 'verify_peer_name' => false, 'ca_file' => __DIR__ . '/../include/ssl/server.crt'],
+        /* same as the first one */
+        ['verify_peer' => false, 'verify_peer_name' => false],
+    ];
+    Socket::clearSslSessionCache();
+    $before = Socket::getSslSessionCacheStats();
+    $server = new Socket(Socket::TYPE_TCP);
+    $server->bind('127.0.0.1')->listen();
+    Coroutine::run(static function () use ($server, $clientOptionsList): void {
+        foreach ($clientOptionsList as $_) {
+            $connection = $server->accept();
+            $connection->enableCrypto([
+                'certificate' => __DIR__ . '/../include/ssl/server.crt',
+                'certificate_key' => __DIR__ . '/../include/ssl/server.key',
+            ]);
+            $connection->sendString('hello');
+            $connection->close();
+        }
+    });
+    foreach ($clientOptionsList as $clientOptions) {
+        $client = new Socket(Socket::TYPE_TCP);
+        $client->connect($server->getSockAddress(), $server->getSockPort());
+        $client->enableCrypto($clientOptions);
+        Assert::same($client->readString(5), 'hello');
+        $client->close();
+    }
+    $server->close();
+    $after = Socket::getSslSessionCacheStats();
+    Assert::same($after['client_resumptions'] - $before['client_resumptions'], 1);
+}
+
+// tickets
+testResumption([]);
+// session ids
+testResumption(['no_ticket' => true]);
+// rotate ticket keys every time, old tickets are still accepted
+Socket::setGlobalSslTicketKeyLifetime(0);
+testResumption([]);
+// user defined ticket keys
+Socket::setGlobalSslTicketKeys([str_repeat('a', 80), str_repeat('b', 80)]);
+Assert::same(Socket::getSslSessionCacheStats()['ticket_keys'], 2);
+testResumption([]);
+Socket::setGlobalSslTicketKeys([]);
+
+testClientSettingsIsolation();
+
+Assert::throws(static function (): void {
+    Socket::setGlobalSslTicketKeys(['short']);
+}, ValueError::class);
+Assert::throws(static function (): void {
+    Socket::setGlobalSslSessionCacheSize(-1);
+}, ValueError::class);
+
+Socket::setGlobalSslSessionCacheSize(0);
+Assert::same(Socket::getSslSessionCacheStats()['count'], 0);
+
+echo "Done\n";
+?>
+--EXPECT--
+Done
@@ -0,0 +1,68 @@
+--TEST--
+swow_socket: io stats
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Coroutine;
+use Swow\Socket;
+use Swow\SocketException;
+
+Socket::resetGlobalStats();
+
+$server = new Socket(Socket::TYPE_TCP);
+$server->bind('127.0.0.1')->listen();
+$client = (new Socket(Socket::TYPE_TCP))->connect($server->getSockAddress(), $server->getSockPort());
+$connection = $server->accept();
+
+$stats = $connection->getStats();
+Assert::same($stats['bytes_read'], 0);
+Assert::same($stats['bytes_written'], 0);
+Assert::same(array_keys($stats['accept_latency']), ['<100us', '<1ms', '<10ms', '<100ms', '<1s', '>=1s']);
+Assert::same(array_sum($server->getStats()['accept_latency']), 1);
+Assert::same(array_sum($client->getStats()['connect_latency']), 1);
+
+$client->sendString('foo');
+Assert::same($connection->readString(3), 'foo');
+// it has to wait for the data
+Coroutine::run(static function () use ($client): void {
+    msleep(10);
+    $client->sendString('bar');
+});
+Assert::same($connection->recvString(), 'bar');
+
+$stats = $client->getStats();
+Assert::same($stats['bytes_written'], 6);
+Assert::greaterThanEq($stats['write_syscalls'], 2);
+$stats = $connection->getStats();
+Assert::same($stats['bytes_read'], 6);
+Assert::greaterThanEq($stats['read_syscalls'], 2);
+Assert::greaterThanEq($stats['read_eagains'], 1);
+Assert::greaterThan($stats['read_wait_time'], 0);
+
+$client->close();
+$connection->close();
+Assert::throws(static function () use ($connection): void {
+    $connection->getStats();
+}, SocketException::class);
+
+// closed sockets are still counted globally
+$stats = Socket::getGlobalStats();
+Assert::same($stats['bytes_read'], 6);
+Assert::same($stats['bytes_written'], 6);
+Assert::same(array_sum($stats['accept_latency']), 1);
+Assert::same(array_sum($stats['connect_latency']), 1);
+
+Socket::resetGlobalStats();
+Assert::same(Socket::getGlobalStats()['bytes_read'], 0);
+
+$server->close();
+
+echo "Done\n";
+?>
+--EXPECT--
+Done
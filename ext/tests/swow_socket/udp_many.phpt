@@ -0,0 +1,122 @@
+--TEST--
+swow_socket: udp batched recv/send
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Buffer;
+use Swow\Coroutine;
+use Swow\Socket;
+use Swow\SocketException;
+use Swow\Sync\WaitReference;
+
+Socket::setGlobalTimeout(1000);
+
+$server = (new Socket(Socket::TYPE_UDP))->bind('127.0.0.1');
+$client = (new Socket(Socket::TYPE_UDP))->bind('127.0.0.1');
+$serverAddress = $server->getSockAddress();
+$serverPort = $server->getSockPort();
+
+$buffers = [];
+for ($n = 0; $n < 16; $n++) {
+    $buffers["buffer{$n}"] = new Buffer(64);
+}
+
+// it waits for the first datagram
+$wr = new WaitReference();
+Coroutine::run(static function () use ($server, $buffers, $client, $wr): void {
+    Assert::same($server->recvMany($buffers, $addresses, $ports), 1);
+    Assert::same($buffers['buffer0']->toString(), 'first');
+    Assert::same($addresses, ['buffer0' => $client->getSockAddress()]);
+    Assert::same($ports, ['buffer0' => $client->getSockPort()]);
+});
+$client->sendTo('first', address: $serverAddress, port: $serverPort);
+WaitReference::wait($wr);
+
+// queued datagrams are received at once
+$datagrams = [];
+for ($n = 0; $n < 100; $n++) {
+    $datagrams[] = "datagram-{$n}";
+}
+$client->sendMany($datagrams, $serverAddress, $serverPort);
+$received = [];
+while (count($received) < count($datagrams)) {
+    $count = $server->recvMany($buffers, $addresses, $ports);
+    Assert::greaterThan($count, 0);
+    Assert::lessThanEq($count, count($buffers));
+    Assert::count($addresses, $count);
+    Assert::count($ports, $count);
+    foreach (array_slice($buffers, 0, $count) as $key => $buffer) {
+        $received[] = $buffer->toString();
+        Assert::same($addresses[$key], $client->getSockAddress());
+        Assert::same($ports[$key], $client->getSockPort());
+    }
+}
+Assert::same($received, $datagrams);
+
+// each datagram may have its own peer, empty datagram is also sent
+$another = (new Socket(Socket::TYPE_UDP))->bind('127.0.0.1');
+$client->sendMany([
+    'foo',
+    ['', $another->getSockAddress(), $another->getSockPort()],
+    ['bar', $another->getSockAddress(), $another->getSockPort()],
+], $serverAddress, $serverPort);
+Assert::same($server->recvStringFrom(), 'foo');
+Assert::same($another->recvMany($buffers), 2);
+Assert::same($buffers['buffer0']->toString(), '');
+Assert::same($buffers['buffer1']->toString(), 'bar');
+$another->close();
+
+// datagrams larger than buffers are truncated
+$client->sendMany(['abcd', 'abcdefgh', 'ab'], $serverAddress, $serverPort);
+$smallBuffers = ['x' => new Buffer(4), 'y' => new Buffer(4), 'z' => new Buffer(4)];
+Assert::same($server->recvMany($smallBuffers, truncated: $truncated), 3);
+Assert::same($smallBuffers['y']->toString(), 'abcd');
+Assert::same($truncated, ['x' => false, 'y' => true, 'z' => false]);
+$wr = new WaitReference();
+Coroutine::run(static function () use ($server, $smallBuffers, $wr): void {
+    Assert::same($server->recvMany([$smallBuffers['x']], truncated: $truncated), 1);
+    Assert::same($smallBuffers['x']->toString(), 'wait');
+    Assert::same($truncated, [true]);
+});
+$client->sendTo('waited', address: $serverAddress, port: $serverPort);
+WaitReference::wait($wr);
+
+// connected socket needs no address
+$client->connect($serverAddress, $serverPort);
+$client->sendMany(['baz']);
+Assert::same($server->recvMany([$buffers['buffer0']]), 1);
+Assert::same($buffers['buffer0']->toString(), 'baz');
+
+// errors
+Assert::throws(static function () use ($server): void {
+    $server->recvMany([new Buffer(64)], timeout: 10);
+}, SocketException::class);
+Assert::throws(static function () use ($server): void {
+    $server->recvMany([]);
+}, ValueError::class);
+Assert::throws(static function () use ($server): void {
+    $server->recvMany(['foo']);
+}, TypeError::class);
+Assert::throws(static function () use ($server): void {
+    $buffer = new Buffer(64);
+    $server->recvMany([$buffer, $buffer]);
+}, Error::class);
+Assert::throws(static function () use ($client): void {
+    $client->sendMany(['foo', [1, 2, 3, 4]]);
+}, ValueError::class);
+Assert::throws(static function () use ($client): void {
+    $client->sendMany(['foo'], 'localhost', 1);
+}, SocketException::class);
+
+$client->close();
+$server->close();
+
+echo "Done\n";
+?>
+--EXPECT--
+Done
@@ -0,0 +1,79 @@
+--TEST--
+swow_socket: wait readable
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Buffer;
+use Swow\Coroutine;
+use Swow\Errno;
+use Swow\Socket;
+use Swow\SocketException;
+use Swow\Sync\WaitReference;
+
+$server = new Socket(Socket::TYPE_TCP);
+$server->bind('127.0.0.1')->listen();
+$client = (new Socket(Socket::TYPE_TCP))->connect($server->getSockAddress(), $server->getSockPort());
+$connection = $server->accept();
+
+// timed out
+try {
+    $connection->waitReadable(10);
+    echo "Never here\n";
+} catch (SocketException $exception) {
+    Assert::same($exception->getCode(), Errno::ETIMEDOUT);
+}
+
+// nothing is read
+$client->sendString('foo');
+Assert::same($connection->waitReadable(), $connection);
+Assert::same($connection->waitReadable(), $connection);
+Assert::same($connection->recvString(), 'foo');
+
+// receiving on an unallocated buffer waits for data first
+$buffer = new Buffer(0);
+$wr = new WaitReference();
+Coroutine::run(static function () use ($connection, $buffer, $wr): void {
+    Assert::same($connection->recvData($buffer), 3);
+    Assert::same($buffer->getSize(), Buffer::COMMON_SIZE);
+    Assert::same($buffer->toString(), 'bar');
+});
+Assert::false($buffer->isAvailable());
+$client->sendString('bar');
+WaitReference::wait($wr);
+
+$buffer = new Buffer(0);
+$client->sendString('baz');
+Assert::same($connection->recv($buffer, size: 64), 3);
+Assert::same($buffer->getSize(), 64);
+Assert::same($buffer->toString(), 'baz');
+
+// canceled by close
+$wr = new WaitReference();
+Coroutine::run(static function () use ($connection, $wr): void {
+    Assert::throws(static function () use ($connection): void {
+        $connection->waitReadable();
+    }, SocketException::class);
+});
+$connection->close();
+WaitReference::wait($wr);
+
+// eof is readable
+$client->close();
+$client = (new Socket(Socket::TYPE_TCP))->connect($server->getSockAddress(), $server->getSockPort());
+$connection = $server->accept();
+$client->close();
+$connection->waitReadable();
+Assert::same($connection->recvString(), '');
+
+$connection->close();
+$server->close();
+
+echo "Done\n";
+?>
+--EXPECT--
+Done
@@ -0,0 +1,90 @@
+--TEST--
+swow_socket: write coalescing
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Coroutine;
+use Swow\Socket;
+use Swow\SocketException;
+use Swow\Sync\WaitReference;
+
+$server = new Socket(Socket::TYPE_TCP);
+$server->bind('127.0.0.1')->listen();
+$client = (new Socket(Socket::TYPE_TCP))->connect($server->getSockAddress(), $server->getSockPort());
+$connection = $server->accept();
+
+Assert::false($connection->isWriteCoalescingEnabled());
+Assert::same($connection->getWriteCoalescingThreshold(), 0);
+$connection->setWriteCoalescing(true, 1024);
+Assert::true($connection->isWriteCoalescingEnabled());
+Assert::same($connection->getWriteCoalescingThreshold(), 1024);
+
+// small writes are buffered and written together at the end of the round
+for ($n = 0; $n < 100; $n++) {
+    $connection->send('x');
+}
+$connection->write(['y', 'z']);
+Assert::same($connection->getWriteCoalescingBufferedSize(), 102);
+Assert::same($client->readString(102), str_repeat('x', 100) . 'yz');
+Assert::same($connection->getWriteCoalescingBufferedSize(), 0);
+
+// explicit flush
+$connection->send('foo')->flush();
+Assert::same($connection->getWriteCoalescingBufferedSize(), 0);
+Assert::same($client->readString(3), 'foo');
+
+// large data is written with the buffered data in order
+$data = random_bytes(64 * 1024);
+$wr = new WaitReference();
+Coroutine::run(static function () use ($client, $data, $wr): void {
+    Assert::same($client->readString(3 + strlen($data)), 'bar' . $data);
+});
+$connection->send('bar')->send($data);
+WaitReference::wait($wr);
+
+// buffered data is written before the file
+$file = tempnam(sys_get_temp_dir(), 'swow');
+file_put_contents($file, 'file');
+$connection->send('baz');
+Assert::same($connection->sendFile($file), 4);
+Assert::same($client->readString(7), 'bazfile');
+unlink($file);
+
+// writes with the peer address are coalesced in order too
+$connection->send('a')->sendTo('b')->writeTo(['c']);
+Assert::same($client->readString(3), 'abc');
+
+// disabling flushes the buffered data
+$connection->send('qux');
+$connection->setWriteCoalescing(false);
+Assert::false($connection->isWriteCoalescingEnabled());
+Assert::same($client->readString(3), 'qux');
+
+// closing flushes the buffered data
+$connection->setWriteCoalescing();
+Assert::same($connection->getWriteCoalescingThreshold(), 16 * 1024);
+$connection->send('bye');
+$connection->close();
+Assert::same($client->readString(3), 'bye');
+Assert::same($client->recvString(), '');
+
+// only stream sockets are supported
+Assert::throws(static function (): void {
+    (new Socket(Socket::TYPE_UDP))->setWriteCoalescing();
+}, SocketException::class);
+Assert::throws(static function () use ($client): void {
+    $client->setWriteCoalescing(true, -1);
+}, ValueError::class);
+
+$client->close();
+$server->close();
+
+echo "Done\n";
+?>
+--EXPECT--
+Done
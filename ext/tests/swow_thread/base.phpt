@@ -0,0 +1,44 @@
+--TEST--
+swow_thread: base
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+skip_if(!ZEND_THREAD_SAFE, 'require ZTS build');
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Coroutine;
+use Swow\Thread;
+use Swow\ThreadException;
+
+$thread = new Thread(static function (int $a, int $b): array {
+    Coroutine::run(static function (): void {
+        usleep(1000);
+    });
+    return [Thread::getCurrentId(), $a + $b];
+}, 1, 2);
+Assert::same(Thread::getCurrentId(), 0);
+Assert::greaterThan($thread->getId(), 0);
+[$id, $sum] = $thread->join();
+Assert::same($id, $thread->getId());
+Assert::same($sum, 3);
+Assert::false($thread->isRunning());
+
+$thread = new Thread(static function (): void {
+    throw new RuntimeException('Oops');
+});
+try {
+    $thread->join();
+    echo "Never here\n";
+} catch (ThreadException $exception) {
+    echo $exception->getMessage(), "\n";
+}
+
+echo "Done\n";
+
+?>
+--EXPECT--
+Thread exited with uncaught RuntimeException: Oops
+Done
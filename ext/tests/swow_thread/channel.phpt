@@ -0,0 +1,68 @@
+--TEST--
+swow_thread: channel
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+skip_if(!ZEND_THREAD_SAFE, 'require ZTS build');
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Thread;
+use Swow\Thread\Channel;
+
+$channel = new Channel(4);
+Assert::same($channel->getCapacity(), 4);
+
+$threads = [];
+for ($n = 0; $n < 2; $n++) {
+    $threads[] = new Thread(static function (Channel $channel, int $n): void {
+        for ($i = 0; $i < 100; $i++) {
+            $channel->push([$n, $i]);
+        }
+    }, $channel, $n);
+}
+$sums = [0, 0];
+for ($i = 0; $i < 200; $i++) {
+    [$n, $value] = $channel->pop();
+    $sums[$n] += $value;
+}
+foreach ($threads as $thread) {
+    $thread->join();
+}
+Assert::same($sums, [4950, 4950]);
+
+$channel->close();
+Assert::true($channel->isClosed());
+
+// channels can be transferred by channels
+$inner = new Channel();
+$outer = new Channel();
+$outer->push($inner);
+$outer->pop()->push('inner');
+Assert::same($inner->pop(), 'inner');
+
+// handles which do not belong to the payload are rejected
+final class ForgedChannel
+{
+    public function __unserialize(array $data): void
+    {
+        unserialize('O:19:"Swow\Thread\Channel":1:{s:6:"handle";i:0;}');
+    }
+}
+$outer->push(new ForgedChannel());
+Assert::throws(static function () use ($outer): void {
+    $outer->pop();
+}, ValueError::class);
+
+try {
+    serialize($channel);
+    echo "Never here\n";
+} catch (Error $error) {
+    echo "Done\n";
+}
+
+?>
+--EXPECT--
+Done
@@ -0,0 +1,61 @@
+--TEST--
+swow_websocket: mask kernels
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.php';
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+use Swow\Buffer;
+use Swow\WebSocket\WebSocket;
+
+function referenceMask(string $data, string $maskingKey, int $index): string
+{
+    $masked = '';
+    for ($i = 0; $i < strlen($data); $i++) {
+        $masked .= $data[$i] ^ $maskingKey[($index + $i) % 4];
+    }
+    return $masked;
+}
+
+$default = WebSocket::getMaskingKernel();
+Assert::notSame($default, 'auto');
+
+$data = random_bytes(1024);
+$maskingKey = random_bytes(WebSocket::MASKING_KEY_LENGTH);
+$buffer = new Buffer(Buffer::COMMON_SIZE);
+foreach (['scalar', 'sse2', 'avx2', 'neon'] as $kernel) {
+    try {
+        WebSocket::setMaskingKernel($kernel);
+    } catch (ValueError) {
+        continue; /* unsupported */
+    }
+    Assert::same(WebSocket::getMaskingKernel(), $kernel);
+    // unaligned heads, tails and rotating indexes
+    foreach ([0, 1, 3, 15, 16, 17, 63, 64, 65, 127, 128, 129, 255, 1000] as $length) {
+        foreach ([0, 1, 7] as $start) {
+            foreach ([0, 1, 2, 3, 5] as $index) {
+                $expected = referenceMask(substr($data, $start, $length), $maskingKey, $index);
+                Assert::same(WebSocket::mask($data, $start, $length, $maskingKey, $index), $expected);
+                $buffer->clear();
+                $buffer->append($data);
+                WebSocket::unmask($buffer, $start, $length, $maskingKey, $index);
+                Assert::same(substr($buffer->toString(), $start, $length), $expected);
+            }
+        }
+    }
+}
+
+WebSocket::setMaskingKernel('auto');
+Assert::same(WebSocket::getMaskingKernel(), $default);
+
+Assert::throws(static function (): void {
+    WebSocket::setMaskingKernel('mmx');
+}, ValueError::class);
+
+echo "Done\n";
+?>
+--EXPECT--
+Done
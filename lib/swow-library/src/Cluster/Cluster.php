@@ -0,0 +1,324 @@
+<?php
+/**
+ * This file is part of Swow
+ *
+ * @link    https://github.com/swow/swow
+ * @contact twosee <twosee@php.net>
+ *
+ * For the full copyright and license information,
+ * please view the LICENSE file that was distributed with this source code
+ */
+
+declare(strict_types=1);
+
+namespace Swow\Cluster;
+
+use Swow\Coroutine;
+use Swow\Signal;
+use Swow\Sync\WaitGroup;
+use Throwable;
+
+use function array_filter;
+use function array_slice;
+use function array_values;
+use function count;
+use function explode;
+use function file_exists;
+use function file_get_contents;
+use function getenv;
+use function is_float;
+use function is_int;
+use function max;
+use function preg_match_all;
+use function shell_exec;
+use function trim;
+use function usleep;
+
+use const PHP_BINARY;
+use const PHP_OS_FAMILY;
+
+/**
+ * Pre-forking multi-process server supervisor.
+ *
+ * The running script is executed again for every worker, Cluster::run() calls the
+ * worker main function in workers, and supervises them in the master process:
+ * crashed workers are restarted, SIGHUP reloads all workers one by one,
+ * SIGINT/SIGTERM stops them gracefully.
+ * Workers should listen with Worker::listen() (SO_REUSEPORT), so that the kernel
+ * balances the connections between them.
+ */
+class Cluster
+{
+    public const WORKER_ID_ENV = 'SWOW_CLUSTER_WORKER_ID';
+
+    /** the file descriptor which workers report their stats to */
+    public const STATS_FD = 3;
+
+    protected int $workerNum;
+
+    /** @var string[] */
+    protected array $command;
+
+    /** @var int restart delay of crashed workers in milliseconds */
+    protected int $restartDelay = 100;
+
+    /** @var int max time to wait for a worker to exit gracefully in milliseconds */
+    protected int $stopTimeout = 30000;
+
+    /** @var int max time to wait for a new worker to be ready when reloading in milliseconds */
+    protected int $readyTimeout = 5000;
+
+    /** @var array<int, WorkerProcess> */
+    protected array $workers = [];
+
+    protected bool $running = false;
+
+    protected int $restarts = 0;
+
+    protected WaitGroup $waitGroup;
+
+    /** @var Coroutine[] */
+    protected array $signalWatchers = [];
+
+    public function __construct(int $workerNum = 0)
+    {
+        $this->workerNum = $workerNum > 0 ? $workerNum : static::getCpuCount();
+        $this->command = static::getCurrentCommand();
+        $this->waitGroup = new WaitGroup();
+    }
+
+    public static function isWorker(): bool
+    {
+        return getenv(static::WORKER_ID_ENV) !== false;
+    }
+
+    public function getWorkerNum(): int
+    {
+        return $this->workerNum;
+    }
+
+    /** @return string[] */
+    public function getCommand(): array
+    {
+        return $this->command;
+    }
+
+    /** @param string[] $command command to start a worker, the current command line is used by default */
+    public function setCommand(array $command): static
+    {
+        $this->command = $command;
+
+        return $this;
+    }
+
+    public function setRestartDelay(int $delay): static
+    {
+        $this->restartDelay = $delay;
+
+        return $this;
+    }
+
+    public function setStopTimeout(int $timeout): static
+    {
+        $this->stopTimeout = $timeout;
+
+        return $this;
+    }
+
+    public function setReadyTimeout(int $timeout): static
+    {
+        $this->readyTimeout = $timeout;
+
+        return $this;
+    }
+
+    public function isRunning(): bool
+    {
+        return $this->running;
+    }
+
+    /**
+     * Run $main(Worker $worker) in workers, or supervise workers until the cluster is stopped in the master.
+     *
+     * @param callable(Worker): mixed $main
+     */
+    public function run(callable $main): void
+    {
+        $id = getenv(static::WORKER_ID_ENV);
+        if ($id !== false) {
+            $worker = new Worker((int) $id, static::STATS_FD);
+            $worker->start();
+            try {
+                $main($worker);
+            } finally {
+                $worker->stop();
+            }
+            return;
+        }
+        $this->running = true;
+        for ($id = 0; $id < $this->workerNum; $id++) {
+            $this->startWorker($id);
+        }
+        $this->watchSignal(Signal::HUP, function (): void {
+            $this->reload();
+        });
+        foreach ([Signal::INT, Signal::TERM] as $signal) {
+            $this->watchSignal($signal, function (): void {
+                $this->stop();
+            });
+        }
+        $this->waitGroup->wait();
+    }
+
+    /**
+     * Replace workers one by one, every new worker is ready before the old one is stopped.
+     * If a new worker does not become ready in time (or crashes on boot), it is stopped,
+     * the old one keeps serving and the reload is aborted.
+     *
+     * @return bool false if the reload was aborted
+     */
+    public function reload(): bool
+    {
+        foreach ($this->workers as $id => $oldWorker) {
+            if (!$this->running) {
+                return false;
+            }
+            $newWorker = $this->startWorker($id);
+            if (!$newWorker->waitReady($this->readyTimeout)) {
+                $this->workers[$id] = $oldWorker;
+                $newWorker->retire($this->stopTimeout);
+                return false;
+            }
+            $oldWorker->retire($this->stopTimeout);
+        }
+
+        return true;
+    }
+
+    public function stop(): void
+    {
+        if (!$this->running) {
+            return;
+        }
+        $this->running = false;
+        foreach ($this->signalWatchers as $signalWatcher) {
+            if ($signalWatcher !== Coroutine::getCurrent() && $signalWatcher->isAvailable()) {
+                $signalWatcher->kill();
+            }
+        }
+        $this->signalWatchers = [];
+        $waitGroup = new WaitGroup();
+        foreach ($this->workers as $worker) {
+            $waitGroup->add();
+            Coroutine::run(function () use ($worker, $waitGroup): void {
+                try {
+                    $worker->retire($this->stopTimeout);
+                } finally {
+                    $waitGroup->done();
+                }
+            });
+        }
+        $waitGroup->wait();
+    }
+
+    /**
+     * @return array{
+     *     'workers': array<int, array<string, mixed>>,
+     *     'restarts': int,
+     *     'total': array<string, int|float>,
+     * }
+     */
+    public function getStats(): array
+    {
+        $workers = [];
+        $total = [];
+        foreach ($this->workers as $id => $worker) {
+            $workers[$id] = $worker->getInfo();
+            foreach ($worker->getStats() as $name => $value) {
+                if (is_int($value) || is_float($value)) {
+                    $total[$name] = ($total[$name] ?? 0) + $value;
+                }
+            }
+        }
+
+        return [
+            'workers' => $workers,
+            'restarts' => $this->restarts,
+            'total' => $total,
+        ];
+    }
+
+    protected function startWorker(int $id): WorkerProcess
+    {
+        $worker = new WorkerProcess($id, $this->command, [static::WORKER_ID_ENV => (string) $id], static::STATS_FD);
+        $this->workers[$id] = $worker;
+        $this->waitGroup->add();
+        Coroutine::run(function () use ($id, $worker): void {
+            try {
+                $worker->wait();
+                if ($this->running && !$worker->isRetired() && $this->workers[$id] === $worker) {
+                    /* it crashed or exited unexpectedly */
+                    $this->restarts++;
+                    usleep($this->restartDelay * 1000);
+                    if ($this->running && $this->workers[$id] === $worker) {
+                        $this->startWorker($id);
+                    }
+                }
+            } finally {
+                $this->waitGroup->done();
+            }
+        });
+
+        return $worker;
+    }
+
+    protected function watchSignal(int $signal, callable $handler): void
+    {
+        $this->signalWatchers[] = Coroutine::run(function () use ($signal, $handler): void {
+            while ($this->running) {
+                try {
+                    Signal::wait($signal);
+                } catch (Throwable) {
+                    break;
+                }
+                $handler();
+            }
+        });
+    }
+
+    public static function getCpuCount(): int
+    {
+        if (PHP_OS_FAMILY === 'Linux' && file_exists('/proc/cpuinfo')) {
+            $count = preg_match_all('/^processor\s*:/m', (string) file_get_contents('/proc/cpuinfo'));
+            if ($count > 0) {
+                return $count;
+            }
+        }
+        $count = match (PHP_OS_FAMILY) {
+            'Windows' => (int) getenv('NUMBER_OF_PROCESSORS'),
+            'Darwin', 'BSD' => (int) trim((string) shell_exec('sysctl -n hw.ncpu 2>/dev/null')),
+            default => (int) trim((string) shell_exec('nproc 2>/dev/null')),
+        };
+
+        return max(1, $count);
+    }
+
+    /** @return string[] */
+    public static function getCurrentCommand(): array
+    {
+        /* keep the same php options (e.g. -d extension=swow) as the master */
+        if (PHP_OS_FAMILY === 'Linux' && file_exists('/proc/self/cmdline')) {
+            $command = array_values(array_filter(
+                explode("\0", (string) file_get_contents('/proc/self/cmdline')),
+                static fn(string $arg): bool => $arg !== ''
+            ));
+            if (count($command) !== 0) {
+                $command[0] = PHP_BINARY;
+                return $command;
+            }
+        }
+        $argv = $_SERVER['argv'] ?? [];
+
+        return [PHP_BINARY, $_SERVER['SCRIPT_FILENAME'] ?? $argv[0], ...array_slice($argv, 1)];
+    }
+}
@@ -0,0 +1,198 @@
+<?php
+/**
+ * This file is part of Swow
+ *
+ * @link    https://github.com/swow/swow
+ * @contact twosee <twosee@php.net>
+ *
+ * For the full copyright and license information,
+ * please view the LICENSE file that was distributed with this source code
+ */
+
+declare(strict_types=1);
+
+namespace Swow\Cluster;
+
+use Swow\Channel;
+use Swow\ChannelException;
+use Swow\Coroutine;
+use Swow\Signal;
+use Swow\Socket;
+use Throwable;
+
+use function fclose;
+use function fopen;
+use function fwrite;
+use function getmypid;
+use function json_encode;
+use function memory_get_usage;
+use function usleep;
+
+use const JSON_PRESERVE_ZERO_FRACTION;
+use const PHP_EOL;
+
+/**
+ * The worker side of a cluster, it is passed to the worker main function by Cluster::run().
+ */
+class Worker
+{
+    /** @var int stats report interval in milliseconds */
+    public const REPORT_INTERVAL = 1000;
+
+    /** @var resource|null */
+    protected $statsStream;
+
+    protected bool $ready = false;
+
+    protected bool $stopping = false;
+
+    /** @var array<string, int|float> */
+    protected array $stats = [];
+
+    /** @var Socket[] */
+    protected array $sockets = [];
+
+    /** @var Coroutine[] */
+    protected array $coroutines = [];
+
+    protected Channel $stopChannel;
+
+    public function __construct(protected int $id, protected int $statsFd)
+    {
+        $this->stopChannel = new Channel();
+    }
+
+    public function getId(): int
+    {
+        return $this->id;
+    }
+
+    public function getPid(): int
+    {
+        return (int) getmypid();
+    }
+
+    public function isStopping(): bool
+    {
+        return $this->stopping;
+    }
+
+    public function start(): void
+    {
+        $statsStream = @fopen("php://fd/{$this->statsFd}", 'w');
+        /* it is not started by a cluster master if the fd is unavailable */
+        $this->statsStream = $statsStream !== false ? $statsStream : null;
+        $this->report();
+        $this->coroutines[] = Coroutine::run(function (): void {
+            while (true) {
+                usleep(static::REPORT_INTERVAL * 1000);
+                $this->report();
+            }
+        });
+        foreach ([Signal::INT, Signal::TERM] as $signal) {
+            $this->coroutines[] = Coroutine::run(function () use ($signal): void {
+                Signal::wait($signal);
+                $this->shutdown();
+            });
+        }
+    }
+
+    public function stop(): void
+    {
+        foreach ($this->coroutines as $coroutine) {
+            if ($coroutine !== Coroutine::getCurrent() && $coroutine->isAvailable()) {
+                $coroutine->kill();
+            }
+        }
+        $this->coroutines = [];
+        if ($this->statsStream !== null) {
+            fclose($this->statsStream);
+            $this->statsStream = null;
+        }
+    }
+
+    /**
+     * Bind the socket with SO_REUSEPORT and listen on it, so that the kernel
+     * balances the incoming connections between all workers.
+     * The socket will be closed when the worker is asked to stop,
+     * so that the accept loop breaks and no new connection comes in.
+     */
+    public function listen(Socket $socket, string $name, int $port = 0, int $backlog = Socket::DEFAULT_BACKLOG): Socket
+    {
+        $socket->bind($name, $port, Socket::BIND_FLAG_REUSEPORT)->listen($backlog);
+        $this->sockets[] = $socket;
+        $this->ready();
+
+        return $socket;
+    }
+
+    /**
+     * Tell the master that the worker is able to serve (listen() calls it automatically).
+     */
+    public function ready(): void
+    {
+        if ($this->ready) {
+            return;
+        }
+        $this->ready = true;
+        $this->report();
+    }
+
+    public function increment(string $name, int|float $value = 1): void
+    {
+        $this->stats[$name] = ($this->stats[$name] ?? 0) + $value;
+    }
+
+    public function setStat(string $name, int|float $value): void
+    {
+        $this->stats[$name] = $value;
+    }
+
+    public function report(): void
+    {
+        if ($this->statsStream === null) {
+            return;
+        }
+        $report = [
+            'stats' => [
+                'memory' => memory_get_usage(),
+                'coroutines' => Coroutine::count(),
+            ] + $this->stats,
+            'ready' => $this->ready,
+        ];
+        try {
+            fwrite($this->statsStream, json_encode($report, JSON_PRESERVE_ZERO_FRACTION) . PHP_EOL);
+        } catch (Throwable) {
+            /* master has gone */
+        }
+    }
+
+    /**
+     * Wait until the worker is asked to stop.
+     *
+     * @return bool false if it was timed out
+     */
+    public function waitForStop(int $timeout = -1): bool
+    {
+        try {
+            $this->stopChannel->pop($timeout);
+        } catch (ChannelException) {
+            /* closed or timed out */
+        }
+
+        return $this->stopping;
+    }
+
+    protected function shutdown(): void
+    {
+        if ($this->stopping) {
+            return;
+        }
+        $this->stopping = true;
+        foreach ($this->sockets as $socket) {
+            $socket->close();
+        }
+        $this->sockets = [];
+        $this->stopChannel->close();
+    }
+}
@@ -0,0 +1,212 @@
+<?php
+/**
+ * This file is part of Swow
+ *
+ * @link    https://github.com/swow/swow
+ * @contact twosee <twosee@php.net>
+ *
+ * For the full copyright and license information,
+ * please view the LICENSE file that was distributed with this source code
+ */
+
+declare(strict_types=1);
+
+namespace Swow\Cluster;
+
+use RuntimeException;
+use Swow\Channel;
+use Swow\ChannelException;
+use Swow\Signal;
+use Throwable;
+
+use function fclose;
+use function fgets;
+use function getenv;
+use function is_array;
+use function json_decode;
+use function microtime;
+use function proc_close;
+use function proc_get_status;
+use function proc_open;
+use function sprintf;
+
+use const STDERR;
+use const STDIN;
+use const STDOUT;
+
+/**
+ * The master side of a worker process.
+ */
+class WorkerProcess
+{
+    /** @var resource */
+    protected $process;
+
+    /** @var resource */
+    protected $statsPipe;
+
+    protected int $pid;
+
+    protected float $startedAt;
+
+    protected ?float $reportedAt = null;
+
+    /** @var array<string, mixed> */
+    protected array $stats = [];
+
+    protected bool $ready = false;
+
+    protected bool $retired = false;
+
+    protected ?int $exitStatus = null;
+
+    protected Channel $readyChannel;
+
+    protected Channel $exitChannel;
+
+    /**
+     * @param string[] $command
+     * @param array<string, string> $env
+     */
+    public function __construct(protected int $id, array $command, array $env, int $statsFd)
+    {
+        $process = proc_open($command, [
+            0 => STDIN,
+            1 => STDOUT,
+            2 => STDERR,
+            $statsFd => ['pipe', 'w'],
+        ], $pipes, null, $env + getenv());
+        if ($process === false) {
+            throw new RuntimeException(sprintf('Failed to start worker#%d', $id));
+        }
+        $this->process = $process;
+        $this->statsPipe = $pipes[$statsFd];
+        $this->pid = proc_get_status($process)['pid'];
+        $this->startedAt = microtime(true);
+        $this->readyChannel = new Channel();
+        $this->exitChannel = new Channel();
+    }
+
+    public function getId(): int
+    {
+        return $this->id;
+    }
+
+    public function getPid(): int
+    {
+        return $this->pid;
+    }
+
+    public function isReady(): bool
+    {
+        return $this->ready;
+    }
+
+    public function isRetired(): bool
+    {
+        return $this->retired;
+    }
+
+    public function hasExited(): bool
+    {
+        return $this->exitStatus !== null;
+    }
+
+    public function getExitStatus(): ?int
+    {
+        return $this->exitStatus;
+    }
+
+    /** @return array<string, mixed> the latest stats reported by the worker */
+    public function getStats(): array
+    {
+        return $this->stats;
+    }
+
+    /** @return array<string, mixed> */
+    public function getInfo(): array
+    {
+        return [
+            'id' => $this->id,
+            'pid' => $this->pid,
+            'started_at' => $this->startedAt,
+            'reported_at' => $this->reportedAt,
+            'ready' => $this->ready,
+            'stats' => $this->stats,
+        ];
+    }
+
+    /**
+     * Consume stats reports until the worker exits, then return its exit status.
+     */
+    public function wait(): int
+    {
+        while (($line = fgets($this->statsPipe)) !== false) {
+            $report = json_decode($line, true);
+            if (!is_array($report)) {
+                continue;
+            }
+            $this->reportedAt = microtime(true);
+            if (is_array($report['stats'] ?? null)) {
+                $this->stats = $report['stats'];
+            }
+            if (($report['ready'] ?? false) && !$this->ready) {
+                $this->ready = true;
+                $this->readyChannel->close();
+            }
+        }
+        fclose($this->statsPipe);
+        $this->exitStatus = proc_close($this->process);
+        $this->readyChannel->close();
+        $this->exitChannel->close();
+
+        return $this->exitStatus;
+    }
+
+    public function waitReady(int $timeout = -1): bool
+    {
+        return $this->waitChannel($this->readyChannel, $timeout) && $this->ready;
+    }
+
+    public function waitExit(int $timeout = -1): bool
+    {
+        return $this->waitChannel($this->exitChannel, $timeout);
+    }
+
+    public function kill(int $signal): void
+    {
+        if ($this->hasExited()) {
+            return;
+        }
+        try {
+            Signal::kill($this->pid, $signal);
+        } catch (Throwable) {
+            /* it may have exited just now */
+        }
+    }
+
+    /**
+     * Ask the worker to stop gracefully, and kill it if it does not exit in time.
+     */
+    public function retire(int $timeout = -1): void
+    {
+        $this->retired = true;
+        $this->kill(Signal::TERM);
+        if (!$this->waitExit($timeout)) {
+            $this->kill(Signal::KILL);
+            $this->waitExit();
+        }
+    }
+
+    /** @return bool false if it was timed out */
+    protected function waitChannel(Channel $channel, int $timeout): bool
+    {
+        try {
+            $channel->pop($timeout);
+        } catch (ChannelException) {
+            /* closed or timed out */
+        }
+
+        return !$channel->isAvailable();
+    }
+}
@@ -78,11 +78,8 @@ trait ReceiverTrait
     protected function __constructReceiver(int $type, int $events): void
     {
         $this->buffer = new Buffer(max(Buffer::COMMON_SIZE, $this->getMaxHeaderLength()));
+        /* head events (URL, STATUS, HEADER_FIELD and HEADER_VALUE) are consumed by HttpParser::executeHead() */
         $requiredEvents =
-            HttpParser::EVENT_URL |
-            HttpParser::EVENT_STATUS |
-            HttpParser::EVENT_HEADER_FIELD |
-            HttpParser::EVENT_HEADER_VALUE |
             HttpParser::EVENT_HEADERS_COMPLETE |
             HttpParser::EVENT_CHUNK_HEADER |
             HttpParser::EVENT_CHUNK_COMPLETE |
@@ -191,7 +188,6 @@ trait ReceiverTrait
         /* }}} */
         /* HTTP related values {{{ */
         $uriOrReasonPhrase = '';
-        $headerName = '';
         $formDataName = '';
         $fileName = '';
         /** @var array<string, array<string>> $headers */
@@ -246,20 +242,26 @@ trait ReceiverTrait
                 // TODO: call $parser->finished() if connection error?
                 while (true) {
                     $previousEvent = $event;
-                    $parsedLength = $parser->execute($buffer, $parsedOffset);
+                    if (!$headersCompleted) {
+                        /* the whole head is collected by the parser,
+                         * it stops only at HEADERS_COMPLETE or when more data is needed */
+                        $parsedLength = $parser->executeHead($buffer, $parsedOffset);
+                    } else {
+                        $parsedLength = $parser->execute($buffer, $parsedOffset);
+                    }
                     $parsedOffset += $parsedLength;
                     $event = $parser->getEvent();
                     if ($event & HttpParser::EVENT_FLAG_DATA) {
                         $dataOffset = $parser->getDataOffset();
                         $dataLength = $parser->getDataLength();
-                        if (!$headersCompleted || ($isMultipart && !$multiPartHeadersCompleted)) {
+                        if ($isMultipart && !$multiPartHeadersCompleted) {
                             $data = $buffer->read($dataOffset, $dataLength);
                         }
                     }
                     if (!$headersCompleted) {
                         $headerLength += $parsedLength;
                         if ($headerLength > $maxHeaderLength) {
-                            throw new ProtocolException(empty($headerName) ? HttpStatus::REQUEST_URI_TOO_LARGE : HttpStatus::REQUEST_HEADER_FIELDS_TOO_LARGE);
+                            throw new ProtocolException($parser->getHead()['headers'] === [] ? HttpStatus::REQUEST_URI_TOO_LARGE : HttpStatus::REQUEST_HEADER_FIELDS_TOO_LARGE);
                         }
                     }
                     if ($event === HttpParser::EVENT_NONE) {
@@ -298,31 +300,12 @@ trait ReceiverTrait
                     }
                     if (!$headersCompleted) {
                         switch ($event) {
-                            case HttpParser::EVENT_HEADER_FIELD:
-                                if ($event !== $previousEvent) {
-                                    $headerName = $data;
-                                } else {
-                                    $headerName .= $data;
-                                }
-                                break;
-                            case HttpParser::EVENT_HEADER_VALUE:
-                                if ($event !== $previousEvent) {
-                                    $headers[$headerName][] = $data;
-                                    $headerNames[strtolower($headerName)] = $headerName;
-                                } else {
-                                    $headers[$headerName][count($headers[$headerName]) - 1] .= $data;
-                                }
-                                break;
-                            case HttpParser::EVENT_URL:
-                            case HttpParser::EVENT_STATUS:
-                                if ($event !== $previousEvent) {
-                                    $uriOrReasonPhrase = $data;
-                                } else {
-                                    $uriOrReasonPhrase .= $data;
-                                }
-                                break;
                             case HttpParser::EVENT_HEADERS_COMPLETE:
                                 $headersCompleted = true;
+                                $head = $parser->getHead();
+                                $uriOrReasonPhrase = $isServerRequest ? $head['uri'] : $head['reason_phrase'];
+                                $headers = $head['headers'];
+                                $headerNames = $head['header_names'];
                                 $shouldKeepAlive = $parser->shouldKeepAlive();
                                 if ($parser->isChunked()) {
                                     $isChunked = true;
@@ -31,6 +31,7 @@ use Swow\WebSocket\Opcode as WebSocketOpcode;
 use Swow\WebSocket\WebSocket;
 use TypeError;
 
+use function array_shift;
 use function in_array;
 use function is_array;
 use function is_bool;
@@ -131,10 +132,15 @@ class EventDriver
             ($this->startHandler)($server);
         }
 
+        /* connections are accepted in batch to save the round trips during connection storms */
+        $acceptedConnections = [];
         while (true) {
             try {
                 $connection = null;
-                $connection = $server->acceptConnection();
+                if ($acceptedConnections === []) {
+                    $acceptedConnections = $server->acceptConnections();
+                }
+                $connection = array_shift($acceptedConnections);
                 if ($connectionHandler !== null) {
                     $connectionHandler($connection);
                 }
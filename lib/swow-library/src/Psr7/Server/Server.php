@@ -15,6 +15,7 @@ namespace Swow\Psr7\Server;
 
 use Closure;
 use Exception;
+use Swow\Errno;
 use Swow\Psr7\Config\LimitationTrait;
 use Swow\Psr7\Message\ServerPsr17FactoryTrait;
 use Swow\Psr7\Message\WebSocketFrameInterface;
@@ -22,6 +23,9 @@ use Swow\Socket;
 use Swow\SocketException;
 use WeakMap;
 
+use function count;
+use function sprintf;
+
 class Server extends Socket
 {
     use LimitationTrait;
@@ -62,24 +66,58 @@ class Server extends Socket
         while (true) {
             $connection = $this->serverConnectionFactory->createServerConnection($this);
             $this->acceptTo($connection, $timeout);
+            if ($this->setupConnection($connection)) {
+                break;
+            }
+        }
+
+        return $connection;
+    }
+
+    /**
+     * Wait for the first connection, then accept up to $max - 1 pending connections without waiting.
+     *
+     * @return ServerConnection[]
+     */
+    public function acceptConnections(int $max = self::DEFAULT_ACCEPT_BATCH_SIZE, ?int $timeout = null): array
+    {
+        $connections = [$this->acceptConnection($timeout)];
+        while (count($connections) < $max) {
+            $connection = $this->serverConnectionFactory->createServerConnection($this);
             try {
-                $connection->addServerParams([
-                    'remote_addr' => $connection->getPeerAddress(),
-                    'remote_port' => $connection->getPeerPort(),
-                ]);
+                if (!$this->tryAcceptTo($connection)) {
+                    break;
+                }
             } catch (SocketException) {
-                /* FIXME: workaround for ENOTCONN error.
-                 * getpeername() may return ENOTCONN in some edge cases,
-                 * it may be caused by the client-side sent RST packet,
-                 * we can not verify this behaviour because it is incidental,
-                 * we ignore it and continue to accept next connection for now. */
-                continue;
+                /* it will be reported by the next accept */
+                break;
+            }
+            if ($this->setupConnection($connection)) {
+                $connections[] = $connection;
             }
-            $this->online($connection);
-            break;
         }
 
-        return $connection;
+        return $connections;
+    }
+
+    protected function setupConnection(ServerConnection $connection): bool
+    {
+        try {
+            $connection->addServerParams([
+                'remote_addr' => $connection->getPeerAddress(),
+                'remote_port' => $connection->getPeerPort(),
+            ]);
+        } catch (SocketException) {
+            /* FIXME: workaround for ENOTCONN error.
+             * getpeername() may return ENOTCONN in some edge cases,
+             * it may be caused by the client-side sent RST packet,
+             * we can not verify this behaviour because it is incidental,
+             * we ignore it and continue to accept next connection for now. */
+            return false;
+        }
+        $this->online($connection);
+
+        return true;
     }
 
     protected const BROADCAST_FLAG_NONE = 0;
@@ -92,8 +130,7 @@ class Server extends Socket
     public function broadcastWebSocketFrame(WebSocketFrameInterface $frame, ?iterable $targets = null, ?Closure $filter = null, int $flags = self::BROADCAST_FLAG_NONE): BroadcastResult
     {
         $targets ??= $this->getConnections();
-        $count = $failureCount = 0;
-        $exceptions = null;
+        $connections = [];
         foreach ($targets as $target) {
             if ($target->getProtocolType() !== $target::PROTOCOL_TYPE_WEBSOCKET) {
                 continue;
@@ -101,17 +138,25 @@ class Server extends Socket
             if ($filter && !$filter($target)) {
                 continue;
             }
-            $count++;
-            try {
-                $target->sendWebSocketFrame($frame);
-            } catch (Exception $exception) {
-                if ($flags & static::BROADCAST_FLAG_RECORD_EXCEPTIONS) {
-                    /* record it and ignore */
-                    /** @var ?WeakMap<ServerConnection, Exception> $exceptions */
-                    $exceptions ??= new WeakMap();
-                    $exceptions[$target] = $exception;
-                }
-                $failureCount++;
+            $connections[] = $target;
+        }
+        $count = count($connections);
+        if ($count === 0) {
+            return new BroadcastResult(0, 0, null);
+        }
+        /* the frame is encoded only once and shared by all connections */
+        $errors = Socket::broadcast($connections, $frame->toString());
+        $failureCount = count($errors);
+        $exceptions = null;
+        if ($flags & static::BROADCAST_FLAG_RECORD_EXCEPTIONS) {
+            foreach ($errors as $index => $error) {
+                /* record it and ignore */
+                /** @var ?WeakMap<ServerConnection, Exception> $exceptions */
+                $exceptions ??= new WeakMap();
+                $exceptions[$connections[$index]] = new SocketException(
+                    sprintf('Socket broadcast failed, reason: %s', Errno::getDescriptionOf($error)),
+                    $error
+                );
             }
         }
 
@@ -18,6 +18,7 @@ use Psr\Http\Message\RequestInterface;
 use Psr\Http\Message\ResponseInterface;
 use Psr\Http\Message\ServerRequestInterface;
 use Stringable;
+use Swow\Buffer;
 use Swow\Errno;
 use Swow\Http\Http;
 use Swow\Http\Message\ServerRequestEntity;
@@ -37,6 +38,7 @@ use Swow\SocketException;
 use Swow\WebSocket\WebSocket;
 use TypeError;
 
+use function array_push;
 use function base64_encode;
 use function dechex;
 use function get_debug_type;
@@ -79,10 +81,26 @@ class ServerConnection extends Socket implements ProtocolTypeInterface
         HttpParser::EVENT_MULTIPART_BODY |
         HttpParser::EVENT_MULTIPART_DATA_END;
 
+    /**
+     * Pending responses are written at once when they reach this size,
+     * even if there are still pipelined requests in the buffer.
+     */
+    public const MAX_PENDING_RESPONSE_SIZE = 64 * 1024;
+
     /* TODO: support chunk transfer encoding */
 
     protected ?Server $server;
 
+    /**
+     * Responses of pipelined requests which have not been written yet,
+     * they will be written together by one write() call.
+     *
+     * @var array<string>
+     */
+    protected array $pendingResponseVector = [];
+
+    protected int $pendingResponseSize = 0;
+
     public function __construct(Server $server)
     {
         parent::__construct($server->getSimpleType());
@@ -133,24 +151,209 @@ class ServerConnection extends Socket implements ProtocolTypeInterface
         );
     }
 
+    /**
+     * Whether there is data of the next (pipelined) request in the buffer already.
+     */
+    public function hasPipelinedRequest(): bool
+    {
+        return $this->parsedOffset < $this->buffer->getLength();
+    }
+
+    /**
+     * Complete responses are kept pending while there are pipelined requests to be handled,
+     * then they are written together with the last one by one writev() call.
+     *
+     * @param array<string> $vector
+     */
+    protected function writeResponse(array $vector): static
+    {
+        if ($this->hasPipelinedRequest()) {
+            foreach ($vector as $part) {
+                $this->pendingResponseSize += strlen($part);
+            }
+            array_push($this->pendingResponseVector, ...$vector);
+            if ($this->pendingResponseSize < static::MAX_PENDING_RESPONSE_SIZE) {
+                return $this;
+            }
+            $vector = [];
+        }
+
+        return $this->flushPendingResponses($vector);
+    }
+
+    /**
+     * Write out pending responses (with the given vector appended) at once.
+     *
+     * @param array<string> $vector
+     */
+    public function flushPendingResponses(array $vector = []): static
+    {
+        if ($this->pendingResponseVector || $vector) {
+            $this->write($vector);
+        }
+
+        return $this;
+    }
+
+    /* Data written directly must not overtake pending responses */
+
+    public function write(array $vector, ?int $timeout = null): static
+    {
+        if ($this->pendingResponseVector) {
+            $vector = [...$this->pendingResponseVector, ...$vector];
+            $this->pendingResponseVector = [];
+            $this->pendingResponseSize = 0;
+        }
+
+        return parent::write($vector, $timeout);
+    }
+
+    public function writeTo(array $vector, ?string $address = null, ?int $port = null, ?int $timeout = null): static
+    {
+        $this->flushPendingResponses();
+
+        return parent::writeTo($vector, $address, $port, $timeout);
+    }
+
+    public function send(Stringable|string $data, int $start = 0, int $length = -1, ?int $timeout = null): static
+    {
+        $this->flushPendingResponses();
+
+        return parent::send($data, $start, $length, $timeout);
+    }
+
+    public function sendTo(Stringable|string $data, int $start = 0, int $length = -1, ?string $address = null, ?int $port = null, ?int $timeout = null): static
+    {
+        $this->flushPendingResponses();
+
+        return parent::sendTo($data, $start, $length, $address, $port, $timeout);
+    }
+
+    public function sendFile(string $filename, int $offset = 0, int $length = 0, ?int $timeout = null): int
+    {
+        $this->flushPendingResponses();
+
+        return parent::sendFile($filename, $offset, $length, $timeout);
+    }
+
+    /* Pending responses must be sent before waiting for more data, otherwise the peer may wait for them forever */
+
+    public function read(Buffer $buffer, int $offset = 0, int $length = -1, ?int $timeout = null): int
+    {
+        $this->flushPendingResponses();
+
+        return parent::read($buffer, $offset, $length, $timeout);
+    }
+
+    public function recv(Buffer $buffer, int $offset = 0, int $size = -1, ?int $timeout = null): int
+    {
+        $this->flushPendingResponses();
+
+        return parent::recv($buffer, $offset, $size, $timeout);
+    }
+
+    public function recvData(Buffer $buffer, int $offset = 0, int $size = -1, ?int $timeout = null): int
+    {
+        $this->flushPendingResponses();
+
+        return parent::recvData($buffer, $offset, $size, $timeout);
+    }
+
+    public function recvFrom(Buffer $buffer, int $offset = 0, int $size = -1, &$address = null, &$port = null, ?int $timeout = null): int
+    {
+        $this->flushPendingResponses();
+
+        return parent::recvFrom($buffer, $offset, $size, $address, $port, $timeout);
+    }
+
+    public function recvDataFrom(Buffer $buffer, int $offset = 0, int $size = -1, &$address = null, &$port = null, ?int $timeout = null): int
+    {
+        $this->flushPendingResponses();
+
+        return parent::recvDataFrom($buffer, $offset, $size, $address, $port, $timeout);
+    }
+
+    public function peek(Buffer $buffer, int $offset = 0, int $size = -1, ?int $timeout = 0): int
+    {
+        $this->flushPendingResponses();
+
+        return parent::peek($buffer, $offset, $size, $timeout);
+    }
+
+    public function peekFrom(Buffer $buffer, int $offset = 0, int $size = -1, &$address = null, &$port = null, ?int $timeout = 0): int
+    {
+        $this->flushPendingResponses();
+
+        return parent::peekFrom($buffer, $offset, $size, $address, $port, $timeout);
+    }
+
+    public function readString(int $length = Buffer::COMMON_SIZE, ?int $timeout = null): string
+    {
+        $this->flushPendingResponses();
+
+        return parent::readString($length, $timeout);
+    }
+
+    public function recvString(int $size = Buffer::COMMON_SIZE, ?int $timeout = null): string
+    {
+        $this->flushPendingResponses();
+
+        return parent::recvString($size, $timeout);
+    }
+
+    public function recvStringData(int $size = Buffer::COMMON_SIZE, ?int $timeout = null): string
+    {
+        $this->flushPendingResponses();
+
+        return parent::recvStringData($size, $timeout);
+    }
+
+    public function recvStringFrom(int $size = Buffer::COMMON_SIZE, &$address = null, &$port = null, ?int $timeout = null): string
+    {
+        $this->flushPendingResponses();
+
+        return parent::recvStringFrom($size, $address, $port, $timeout);
+    }
+
+    public function recvStringDataFrom(int $size = Buffer::COMMON_SIZE, &$address = null, &$port = null, ?int $timeout = null): string
+    {
+        $this->flushPendingResponses();
+
+        return parent::recvStringDataFrom($size, $address, $port, $timeout);
+    }
+
+    public function peekString(int $size = Buffer::COMMON_SIZE, ?int $timeout = 0): string
+    {
+        $this->flushPendingResponses();
+
+        return parent::peekString($size, $timeout);
+    }
+
+    public function peekStringFrom(int $size = Buffer::COMMON_SIZE, &$address = null, &$port = null, ?int $timeout = 0): string
+    {
+        $this->flushPendingResponses();
+
+        return parent::peekStringFrom($size, $address, $port, $timeout);
+    }
+
     public function sendHttpHeader(int $statusCode = HttpStatus::OK, string $reasonPhrase = '', array $headers = [], string $protocolVersion = '1.1'): static
     {
-        return $this->send(Http::packResponse($statusCode, $reasonPhrase, $headers, '', $protocolVersion));
+        return $this->flushPendingResponses([Http::packResponse($statusCode, $reasonPhrase, $headers, '', $protocolVersion)]);
     }
 
     public function sendHttpChunk(string|Stringable $chunkData): static
     {
-        return $this->write([dechex(strlen($chunkData)), "\r\n", $chunkData, "\r\n"]);
+        return $this->flushPendingResponses([dechex(strlen($chunkData)), "\r\n", (string) $chunkData, "\r\n"]);
     }
 
     public function sendHttpLastChunk(): static
     {
-        return $this->send("0\r\n\r\n");
+        return $this->flushPendingResponses(["0\r\n\r\n"]);
     }
 
     public function sendHttpResponse(ResponseInterface $response): static
     {
-        return $this->write(Psr7::convertResponseToVector($response));
+        return $this->writeResponse(Psr7::convertResponseToVector($response));
     }
 
     /** @return array<string, string> */
@@ -189,7 +392,7 @@ class ServerConnection extends Socket implements ProtocolTypeInterface
                     }
                 }
                 $headers += $this->generateResponseHeaders($body, $close);
-                $this->write([
+                $this->writeResponse([
                     Http::packResponse(
                         statusCode: $statusCode,
                         headers: $headers
@@ -211,7 +414,7 @@ class ServerConnection extends Socket implements ProtocolTypeInterface
                     $message = HttpStatus::getReasonPhraseOf($statusCode);
                 }
                 $message = "<html lang=\"en\"><body><h2>HTTP {$statusCode} {$message}</h2><hr><i>Powered by Swow</i></body></html>";
-                $this->write([
+                $this->writeResponse([
                     Http::packResponse(
                         statusCode: $statusCode,
                         headers: $this->generateResponseHeaders($message, $close)
@@ -248,6 +451,8 @@ class ServerConnection extends Socket implements ProtocolTypeInterface
             Psr7::setHeaders($response, $upgradeHeaders);
             $this->sendHttpResponse($response);
         }
+        /* frames may follow the handshake response immediately */
+        $this->flushPendingResponses();
         $this->upgraded(static::PROTOCOL_TYPE_WEBSOCKET);
 
         return $this;
@@ -264,6 +469,13 @@ class ServerConnection extends Socket implements ProtocolTypeInterface
 
     public function close(): bool
     {
+        if ($this->pendingResponseVector) {
+            try {
+                $this->flushPendingResponses();
+            } catch (SocketException) {
+                /* the connection is broken, nothing to do */
+            }
+        }
         $this->offline();
 
         return parent::close();
@@ -283,10 +495,10 @@ class ServerConnection extends Socket implements ProtocolTypeInterface
         }
 
         $headers['Content-Length'] = $length <= 0 ? filesize($filename) : $length;
-        $this->send(Http::packResponse(
+        $this->flushPendingResponses([Http::packResponse(
             statusCode: HttpStatus::OK,
             headers: $headers
-        ));
+        )]);
 
         return $this->sendFile($filename, $offset, $length, $timeout);
     }
@@ -30,6 +30,8 @@ class EofStream extends Socket
 
     use MaxMessageLengthTrait;
 
+    use OnDemandBufferTrait;
+
     public function __construct(string $eof = "\r\n", int $type = self::TYPE_TCP)
     {
         if (!($type & static::TYPE_FLAG_STREAM)) {
@@ -56,7 +58,8 @@ class EofStream extends Socket
         $connection = parent::accept($timeout);
         $connection->eof = $this->eof;
         $connection->maxMessageLength = $this->maxMessageLength;
-        $connection->internalBuffer = new Buffer(Buffer::COMMON_SIZE);
+        $connection->onDemandBuffer = $this->onDemandBuffer;
+        $connection->internalBuffer = $connection->createInternalBuffer();
 
         return $connection;
     }
@@ -81,6 +84,7 @@ class EofStream extends Socket
                     $this->recvData($internalBuffer, $internalBuffer->getLength(), -1, $timeout);
                 } finally {
                     $buffer->unlock();
+                    $this->releaseInternalBuffer();
                 }
             } else {
                 $expectMore = true;
@@ -112,6 +116,7 @@ class EofStream extends Socket
         $nWrite += $buffer->write($offset + $nWrite, $internalBuffer, length: $pos);
         /* next packet data maybe received */
         $internalBuffer->truncateFrom($pos + strlen($eof));
+        $this->releaseInternalBuffer();
 
         return $nWrite;
     }
@@ -143,6 +148,7 @@ class EofStream extends Socket
             } else {
                 $buffer->write($offset, $internalBuffer);
                 $internalBuffer->clear();
+                $this->releaseInternalBuffer();
             }
             $pos = strpos($buffer->toString(), $eof, $eofOffset);
             if ($pos !== false) {
@@ -150,7 +156,9 @@ class EofStream extends Socket
                 if ($length > $maxMessageLength) {
                     throw new MessageTooLargeException($eofOffset, $maxMessageLength);
                 }
+                $this->acquireInternalBuffer();
                 $internalBuffer->append($buffer, $pos + strlen($eof));
+                $this->releaseInternalBuffer();
                 $buffer->truncate($pos);
                 break;
             }
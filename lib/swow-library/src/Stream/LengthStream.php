@@ -35,6 +35,8 @@ class LengthStream extends Socket
 
     use MaxMessageLengthTrait;
 
+    use OnDemandBufferTrait;
+
     public function __construct(string $format = Format::UINT32_BE, int $type = self::TYPE_TCP)
     {
         if (!($type & static::TYPE_FLAG_STREAM)) {
@@ -69,7 +71,8 @@ class LengthStream extends Socket
         $connection->format = $this->format;
         $connection->formatSize = $this->formatSize;
         $connection->maxMessageLength = $this->maxMessageLength;
-        $connection->internalBuffer = new Buffer(Buffer::COMMON_SIZE);
+        $connection->onDemandBuffer = $this->onDemandBuffer;
+        $connection->internalBuffer = $connection->createInternalBuffer();
 
         return $connection;
     }
@@ -93,6 +96,7 @@ class LengthStream extends Socket
                     $this->recvData($internalBuffer, $internalBuffer->getLength(), -1, $timeout);
                 } finally {
                     $buffer->unlock();
+                    $this->releaseInternalBuffer();
                 }
             } else {
                 $expectMore = true;
@@ -113,6 +117,7 @@ class LengthStream extends Socket
         }
         $nWrite = $buffer->write($offset, $internalBuffer, $formatSize);
         $internalBuffer->truncateFrom($formatSize + $nWrite);
+        $this->releaseInternalBuffer();
         if ($nWrite < $length) {
             $nWrite += $this->read($buffer, $offset + $nWrite, $length - $nWrite, $timeout);
         }
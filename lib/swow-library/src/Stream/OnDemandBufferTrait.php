@@ -0,0 +1,64 @@
+<?php
+/**
+ * This file is part of Swow
+ *
+ * @link    https://github.com/swow/swow
+ * @contact twosee <twosee@php.net>
+ *
+ * For the full copyright and license information,
+ * please view the LICENSE file that was distributed with this source code
+ */
+
+declare(strict_types=1);
+
+namespace Swow\Stream;
+
+use Swow\Buffer;
+
+/**
+ * In on-demand mode, the internal buffer is given back to the buffer pool
+ * whenever it holds no pending data, so that idle connections do not pin memory,
+ * receiving on the unallocated buffer waits for data without any buffer attached,
+ * and then takes a new one from the pool.
+ */
+trait OnDemandBufferTrait
+{
+    protected bool $onDemandBuffer = false;
+
+    public function isOnDemandBufferEnabled(): bool
+    {
+        return $this->onDemandBuffer;
+    }
+
+    /** @return $this */
+    public function setOnDemandBuffer(bool $enable = true): static
+    {
+        $this->onDemandBuffer = $enable;
+        if ($enable) {
+            $this->releaseInternalBuffer();
+        } else {
+            $this->acquireInternalBuffer();
+        }
+
+        return $this;
+    }
+
+    protected function createInternalBuffer(): Buffer
+    {
+        return new Buffer($this->onDemandBuffer ? 0 : Buffer::COMMON_SIZE);
+    }
+
+    protected function acquireInternalBuffer(): void
+    {
+        if (!$this->internalBuffer->isAvailable()) {
+            $this->internalBuffer->alloc(Buffer::COMMON_SIZE);
+        }
+    }
+
+    protected function releaseInternalBuffer(): void
+    {
+        if ($this->onDemandBuffer && $this->internalBuffer->isEmpty()) {
+            $this->internalBuffer->close();
+        }
+    }
+}
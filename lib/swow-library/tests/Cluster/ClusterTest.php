@@ -0,0 +1,240 @@
+<?php
+/**
+ * This file is part of Swow
+ *
+ * @link    https://github.com/swow/swow
+ * @contact twosee <twosee@php.net>
+ *
+ * For the full copyright and license information,
+ * please view the LICENSE file that was distributed with this source code
+ */
+
+declare(strict_types=1);
+
+namespace Swow\Tests\Cluster;
+
+use PHPUnit\Framework\Attributes\CoversClass;
+use PHPUnit\Framework\TestCase;
+use Swow\Cluster\Cluster;
+use Swow\Cluster\Worker;
+use Swow\Cluster\WorkerProcess;
+use Swow\Coroutine;
+use Swow\Sync\WaitReference;
+
+use function array_column;
+use function array_unique;
+use function count;
+use function file_exists;
+use function microtime;
+use function str_starts_with;
+use function sys_get_temp_dir;
+use function tempnam;
+use function unlink;
+use function usleep;
+
+use const PHP_BINARY;
+use const PHP_OS_FAMILY;
+
+/**
+ * @internal
+ */
+#[CoversClass(Cluster::class)]
+#[CoversClass(Worker::class)]
+#[CoversClass(WorkerProcess::class)]
+final class ClusterTest extends TestCase
+{
+    protected function setUp(): void
+    {
+        parent::setUp();
+        if (PHP_OS_FAMILY === 'Windows') {
+            $this->markTestSkipped('Unable to run on Windows');
+        }
+    }
+
+    /**
+     * Workers are started with the same php options (e.g. -d extension=swow) as the test runner.
+     *
+     * @return string[]
+     */
+    protected static function getWorkerCommand(string ...$arguments): array
+    {
+        $command = [PHP_BINARY];
+        $currentCommand = Cluster::getCurrentCommand();
+        for ($i = 1; $i < count($currentCommand); $i++) {
+            $argument = $currentCommand[$i];
+            if (!str_starts_with($argument, '-')) {
+                break;
+            }
+            $command[] = $argument;
+            if ($argument === '-d' || $argument === '-c') {
+                $command[] = $currentCommand[++$i];
+            }
+        }
+
+        return [...$command, __DIR__ . '/Fixtures/worker.php', ...$arguments];
+    }
+
+    /**
+     * @param string[] $command
+     * @return array{0: TestingCluster, 1: WaitReference}
+     */
+    protected static function startCluster(int $workerNum, array $command): array
+    {
+        $cluster = new TestingCluster($workerNum);
+        $cluster
+            ->setCommand($command)
+            ->setRestartDelay(10)
+            ->setStopTimeout(1000);
+        $wr = new WaitReference();
+        Coroutine::run(static function () use ($cluster, $wr): void {
+            $cluster->run(static function (): void { });
+        });
+
+        return [$cluster, $wr];
+    }
+
+    protected static function waitUntil(callable $condition, float $timeout = 10): bool
+    {
+        $deadline = microtime(true) + $timeout;
+        while (!$condition()) {
+            if (microtime(true) > $deadline) {
+                return false;
+            }
+            usleep(10 * 1000);
+        }
+
+        return true;
+    }
+
+    /** @param array<int, WorkerProcess> $workers */
+    protected static function allReady(array $workers): bool
+    {
+        foreach ($workers as $worker) {
+            if (!$worker->isReady()) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    public function testSpawnWorkers(): void
+    {
+        [$cluster, $wr] = static::startCluster(2, static::getWorkerCommand('serve'));
+        $this->assertTrue($cluster->isRunning());
+        $this->assertTrue(static::waitUntil(static fn(): bool => static::allReady($cluster->getWorkers())));
+
+        $stats = $cluster->getStats();
+        $this->assertCount(2, $stats['workers']);
+        $this->assertCount(2, array_unique(array_column($stats['workers'], 'pid')));
+        $this->assertSame(0, $stats['restarts']);
+        $this->assertArrayHasKey('memory', $stats['total']);
+
+        $cluster->stop();
+        WaitReference::wait($wr);
+        $this->assertFalse($cluster->isRunning());
+    }
+
+    public function testRestartCrashedWorker(): void
+    {
+        $marker = tempnam(sys_get_temp_dir(), 'swow_cluster_');
+        unlink($marker);
+        try {
+            [$cluster, $wr] = static::startCluster(1, static::getWorkerCommand('crash', $marker));
+            $crashedWorker = $cluster->getWorkers()[0];
+            $this->assertTrue(static::waitUntil(static fn(): bool => $cluster->getStats()['restarts'] === 1 && static::allReady($cluster->getWorkers())));
+            $this->assertSame(1, $crashedWorker->getExitStatus());
+            $restartedWorker = $cluster->getWorkers()[0];
+            $this->assertNotSame($crashedWorker, $restartedWorker);
+            $this->assertNotSame($crashedWorker->getPid(), $restartedWorker->getPid());
+
+            $cluster->stop();
+            WaitReference::wait($wr);
+            $this->assertSame(0, $restartedWorker->getExitStatus());
+            $this->assertSame(1, $cluster->getStats()['restarts']);
+        } finally {
+            if (file_exists($marker)) {
+                unlink($marker);
+            }
+        }
+    }
+
+    public function testReload(): void
+    {
+        [$cluster, $wr] = static::startCluster(2, static::getWorkerCommand('serve'));
+        $this->assertTrue(static::waitUntil(static fn(): bool => static::allReady($cluster->getWorkers())));
+        $oldWorkers = $cluster->getWorkers();
+
+        $this->assertTrue($cluster->reload());
+        $newWorkers = $cluster->getWorkers();
+        foreach ($oldWorkers as $id => $oldWorker) {
+            $this->assertTrue($oldWorker->isRetired());
+            $this->assertSame(0, $oldWorker->getExitStatus());
+            $this->assertNotSame($oldWorker, $newWorkers[$id]);
+            $this->assertTrue($newWorkers[$id]->isReady());
+        }
+        $this->assertSame(0, $cluster->getStats()['restarts']);
+
+        $cluster->stop();
+        WaitReference::wait($wr);
+    }
+
+    public function testReloadKeepsOldWorkerIfNewOneIsNotReady(): void
+    {
+        $marker = tempnam(sys_get_temp_dir(), 'swow_cluster_');
+        unlink($marker);
+        try {
+            [$cluster, $wr] = static::startCluster(1, static::getWorkerCommand('lazy', $marker));
+            $cluster->setReadyTimeout(500);
+            $this->assertTrue(static::waitUntil(static fn(): bool => static::allReady($cluster->getWorkers())));
+            $oldWorker = $cluster->getWorkers()[0];
+
+            $this->assertFalse($cluster->reload());
+            /* the old worker is still serving */
+            $this->assertSame($oldWorker, $cluster->getWorkers()[0]);
+            $this->assertFalse($oldWorker->isRetired());
+            $this->assertFalse($oldWorker->hasExited());
+            $this->assertSame(0, $cluster->getStats()['restarts']);
+
+            $cluster->stop();
+            WaitReference::wait($wr);
+            $this->assertSame(0, $oldWorker->getExitStatus());
+        } finally {
+            if (file_exists($marker)) {
+                unlink($marker);
+            }
+        }
+    }
+
+    public function testShutdown(): void
+    {
+        [$cluster, $wr] = static::startCluster(2, static::getWorkerCommand('serve'));
+        $this->assertTrue(static::waitUntil(static fn(): bool => static::allReady($cluster->getWorkers())));
+        $workers = $cluster->getWorkers();
+
+        $cluster->stop();
+        WaitReference::wait($wr);
+        foreach ($workers as $worker) {
+            /* graceful exit */
+            $this->assertTrue($worker->isRetired());
+            $this->assertSame(0, $worker->getExitStatus());
+        }
+        /* stopped workers are never restarted */
+        $this->assertSame(0, $cluster->getStats()['restarts']);
+    }
+
+    public function testShutdownKillsStubbornWorker(): void
+    {
+        [$cluster, $wr] = static::startCluster(1, static::getWorkerCommand('stubborn'));
+        $this->assertTrue(static::waitUntil(static fn(): bool => static::allReady($cluster->getWorkers())));
+        $worker = $cluster->getWorkers()[0];
+
+        $startTime = microtime(true);
+        $cluster->stop();
+        WaitReference::wait($wr);
+        /* stop timeout is 1s, it was killed instead of sleeping for 60s */
+        $this->assertLessThan(30, microtime(true) - $startTime);
+        $this->assertTrue($worker->hasExited());
+        $this->assertNotSame(0, $worker->getExitStatus());
+    }
+}
@@ -0,0 +1,47 @@
+<?php
+/**
+ * This file is part of Swow
+ *
+ * @link    https://github.com/swow/swow
+ * @contact twosee <twosee@php.net>
+ *
+ * For the full copyright and license information,
+ * please view the LICENSE file that was distributed with this source code
+ */
+
+declare(strict_types=1);
+
+/*
+ * Worker script of ClusterTest, usage: worker.php <mode> [<marker file>]
+ * - serve: become ready and exit once it is asked to stop
+ * - crash: exit abnormally at the first start (the marker file does not exist), then serve
+ * - stubborn: ignore the stop request, so that it will be killed
+ * - lazy: serve at the first start (the marker file does not exist), then never become ready
+ */
+
+use Swow\Cluster\Cluster;
+use Swow\Cluster\Worker;
+
+require dirname(__DIR__, 5) . '/vendor/autoload.php';
+
+$mode = $argv[1] ?? 'serve';
+$marker = $argv[2] ?? '';
+
+(new Cluster())->run(static function (Worker $worker) use ($mode, $marker): void {
+    if ($mode === 'crash' && !file_exists($marker)) {
+        touch($marker);
+        exit(1);
+    }
+    if ($mode === 'lazy' && file_exists($marker)) {
+        $worker->waitForStop();
+        return;
+    }
+    if ($mode === 'lazy') {
+        touch($marker);
+    }
+    $worker->ready();
+    $worker->waitForStop();
+    if ($mode === 'stubborn') {
+        sleep(60);
+    }
+});
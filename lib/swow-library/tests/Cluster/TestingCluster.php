@@ -0,0 +1,29 @@
+<?php
+/**
+ * This file is part of Swow
+ *
+ * @link    https://github.com/swow/swow
+ * @contact twosee <twosee@php.net>
+ *
+ * For the full copyright and license information,
+ * please view the LICENSE file that was distributed with this source code
+ */
+
+declare(strict_types=1);
+
+namespace Swow\Tests\Cluster;
+
+use Swow\Cluster\Cluster;
+use Swow\Cluster\WorkerProcess;
+
+/**
+ * @internal
+ */
+final class TestingCluster extends Cluster
+{
+    /** @return array<int, WorkerProcess> */
+    public function getWorkers(): array
+    {
+        return $this->workers;
+    }
+}
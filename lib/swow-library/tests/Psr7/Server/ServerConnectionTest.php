@@ -20,6 +20,7 @@ use Swow\Http\Status;
 use Swow\Psr7\Psr7;
 use Swow\Psr7\Server\Server;
 use Swow\Psr7\Server\ServerConnection;
+use Swow\Socket;
 use Swow\Sync\WaitReference;
 use Swow\Utils\FileSystem\FileSystem;
 
@@ -27,6 +28,7 @@ use function array_map;
 use function file_exists;
 use function is_numeric;
 use function mkdir;
+use function strlen;
 use function Swow\TestUtils\getRandomBytes;
 
 use const CURLOPT_HEADER;
@@ -112,4 +114,107 @@ final class ServerConnectionTest extends TestCase
         $wr::wait($wr);
         $server->close();
     }
+
+    public function testPipelinedRequests(): void
+    {
+        $server = new Server();
+        $server->bind('127.0.0.1')->listen();
+
+        $wr = new WaitReference();
+        Coroutine::run(static function () use ($server, $wr): void {
+            $connection = $server->acceptConnection();
+            for ($i = 0; $i < 3; $i++) {
+                $request = $connection->recvHttpRequest();
+                $connection->respond((string) $request->getUri());
+            }
+            $connection->close();
+        });
+
+        $client = (new Socket(Socket::TYPE_TCP))->connect($server->getSockAddress(), $server->getSockPort());
+        $client->send(
+            "GET /1 HTTP/1.1\r\nHost: localhost\r\n\r\n" .
+            "GET /2 HTTP/1.1\r\nHost: localhost\r\n\r\n" .
+            "GET /3 HTTP/1.1\r\nHost: localhost\r\n\r\n"
+        );
+        $response = '';
+        while (($data = $client->recvString()) !== '') {
+            $response .= $data;
+        }
+        $client->close();
+        $expected = '';
+        foreach (['/1', '/2', '/3'] as $body) {
+            $expected .= "HTTP/1.1 200 OK\r\nConnection: keep-alive\r\nContent-Length: 2\r\n\r\n{$body}";
+        }
+        $this->assertSame($expected, $response);
+
+        $wr::wait($wr);
+        $server->close();
+    }
+
+    public function testPendingResponsesAreFlushedBeforeReadingBody(): void
+    {
+        $server = new Server();
+        $server->bind('127.0.0.1')->listen();
+
+        $wr = new WaitReference();
+        Coroutine::run(static function () use ($server, $wr): void {
+            $connection = $server->acceptConnection();
+            $request = $connection->recvHttpRequest();
+            $connection->respond((string) $request->getUri());
+            /* the body of the next request is only sent after the peer received the response above */
+            $request = $connection->recvHttpRequest();
+            $connection->respond((string) $request->getBody());
+            $connection->close();
+        });
+
+        $client = (new Socket(Socket::TYPE_TCP))->connect($server->getSockAddress(), $server->getSockPort());
+        $client->send(
+            "GET /1 HTTP/1.1\r\nHost: localhost\r\n\r\n" .
+            "POST /2 HTTP/1.1\r\nHost: localhost\r\nContent-Length: 10\r\n\r\n12345"
+        );
+        $response = "HTTP/1.1 200 OK\r\nConnection: keep-alive\r\nContent-Length: 2\r\n\r\n/1";
+        $this->assertSame($response, $client->readString(strlen($response), 1000));
+        $client->send('67890');
+        $response = "HTTP/1.1 200 OK\r\nConnection: keep-alive\r\nContent-Length: 10\r\n\r\n1234567890";
+        $this->assertSame($response, $client->readString(strlen($response), 1000));
+        $client->close();
+
+        $wr::wait($wr);
+        $server->close();
+    }
+
+    public function testDirectWritesKeepResponseOrder(): void
+    {
+        $server = new Server();
+        $server->bind('127.0.0.1')->listen();
+
+        $wr = new WaitReference();
+        Coroutine::run(static function () use ($server, $wr): void {
+            $connection = $server->acceptConnection();
+            $request = $connection->recvHttpRequest();
+            $connection->respond((string) $request->getUri());
+            $connection->recvHttpRequest();
+            $connection->send("HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\n/2");
+            $connection->close();
+        });
+
+        $client = (new Socket(Socket::TYPE_TCP))->connect($server->getSockAddress(), $server->getSockPort());
+        $client->send(
+            "GET /1 HTTP/1.1\r\nHost: localhost\r\n\r\n" .
+            "GET /2 HTTP/1.1\r\nHost: localhost\r\n\r\n"
+        );
+        $response = '';
+        while (($data = $client->recvString()) !== '') {
+            $response .= $data;
+        }
+        $client->close();
+        $this->assertSame(
+            "HTTP/1.1 200 OK\r\nConnection: keep-alive\r\nContent-Length: 2\r\n\r\n/1" .
+            "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\n/2",
+            $response
+        );
+
+        $wr::wait($wr);
+        $server->close();
+    }
 }
@@ -15,6 +15,7 @@ namespace Swow\Tests\Stream;
 
 use PHPUnit\Framework\Attributes\CoversClass;
 use PHPUnit\Framework\TestCase;
+use Swow\Buffer;
 use Swow\Coroutine;
 use Swow\Errno;
 use Swow\SocketException;
@@ -115,4 +116,36 @@ final class EofStreamTest extends TestCase
             WaitReference::wait($wr);
         }
     }
+
+    public function testOnDemandBuffer(): void
+    {
+        $server = new EofStream();
+        $server->setOnDemandBuffer()->bind('127.0.0.1')->listen();
+        $this->assertTrue($server->isOnDemandBufferEnabled());
+        $wr = new WaitReference();
+        Coroutine::run(function () use ($server, $wr): void {
+            $connection = $server->accept();
+            $this->assertTrue($connection->isOnDemandBufferEnabled());
+            try {
+                /* @phpstan-ignore-next-line */
+                while (true) {
+                    $connection->sendMessage($connection->recvMessageString());
+                }
+            } catch (SocketException $exception) {
+                $this->assertContains($exception->getCode(), [0, Errno::ECONNRESET]);
+            }
+        });
+        $client = new EofStream();
+        $client->connect($server->getSockAddress(), $server->getSockPort());
+        $hits = Buffer::getPoolStats()['hits'];
+        for ($n = 0; $n < Testing::$maxRequestsMid; $n++) {
+            $client->sendMessage("message-{$n}");
+            $this->assertSame("message-{$n}", $client->recvMessageString());
+        }
+        /* the internal buffer of the connection is given back and taken from the pool again */
+        $this->assertGreaterThan($hits, Buffer::getPoolStats()['hits']);
+        $client->close();
+        $server->close();
+        WaitReference::wait($wr);
+    }
 }
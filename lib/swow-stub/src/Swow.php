@@ -68,6 +68,16 @@ namespace Swow
         public const EXTRA_VERSION = '';
 
         public static function isBuiltWith(string $lib): bool { }
+
+        /**
+         * @return array{threads: int, fs: array<string, int>, dns: array<string, int>, cpu: array<string, int>}
+         */
+        public static function getWorkStats(): array { }
+
+        /**
+         * @return string "io_uring" or "thread_pool"
+         */
+        public static function getFsBackend(): string { }
     }
 }
 
@@ -942,6 +952,8 @@ namespace Swow
 
         public static function count(): int { }
 
+        public static function getStackPoolStats(): array { }
+
         public static function get(int $id): ?static { }
 
         /** @return array<int, Coroutine> */
@@ -999,6 +1011,41 @@ namespace Swow
          */
         public function pop(int $timeout = -1): mixed { }
 
+        /**
+         * push items into channel as many as possible at once
+         *
+         * It waits only if none of the items can be pushed, then items are pushed in order
+         * until the channel is full or there is no more waiting consumer (for unbuffered channel),
+         * and waiting consumers are woken up once for all of them.
+         *
+         * @note context switching may happen here
+         *
+         * @throws ChannelException when none of the items can be pushed
+         * @phan-param array<T> $items
+         * @phpstan-param array<T> $items
+         * @psalm-param array<T> $items
+         * @param int $timeout in microseconds
+         * @return int count of pushed items, they are the first n items of `$items`, the rest should be pushed again
+         */
+        public function pushMany(array $items, int $timeout = -1): int { }
+
+        /**
+         * pop at most `$max` items from channel at once
+         *
+         * It waits only if there is nothing to pop, and waiting producers are woken up once for all of them.
+         *
+         * @note context switching may happen here
+         *
+         * @throws ChannelException when nothing can be popped
+         * @param int $max max count of items to pop
+         * @param int $timeout in microseconds
+         * @phan-return list<T>
+         * @phpstan-return list<T>
+         * @psalm-return list<T>
+         * @return array<mixed>
+         */
+        public function popMany(int $max, int $timeout = -1): array { }
+
         public function close(): void { }
 
         public function getCapacity(): int { }
@@ -1029,6 +1076,88 @@ namespace Swow
     class ChannelException extends \Swow\Exception { }
 }
 
+namespace Swow
+{
+    /**
+     * thread runs a callable in a new thread with its own request and event loop (requires ZTS build)
+     *
+     * @note callable and arguments are serialized to be transferred, closures should be static
+     */
+    class Thread
+    {
+        /**
+         * @param callable $callable
+         * @param mixed ...$arguments
+         */
+        public function __construct(callable $callable, mixed ...$arguments) { }
+
+        public function getId(): int { }
+
+        /** @return int id of the current thread, 0 is the main thread */
+        public static function getCurrentId(): int { }
+
+        public function isRunning(): bool { }
+
+        /**
+         * wait for the thread to exit and get its return value
+         *
+         * @note context switching happens here, other coroutines are still running
+         *
+         * @throws ThreadException when the thread exited with an uncaught exception
+         * @param int $timeout in microseconds
+         * @return mixed
+         */
+        public function join(int $timeout = -1): mixed { }
+
+        public function detach(): static { }
+    }
+}
+
+namespace Swow
+{
+    class ThreadException extends \Swow\Exception { }
+}
+
+namespace Swow\Thread
+{
+    /**
+     * channel transfers data across threads, data is serialized and copied
+     *
+     * @note it can be passed to threads as an argument or through another thread channel
+     */
+    class Channel
+    {
+        public function __construct(int $capacity = 1) { }
+
+        /**
+         * @param mixed $data
+         * @param int $timeout in microseconds
+         * @return static
+         */
+        public function push(mixed $data, int $timeout = -1): static { }
+
+        /**
+         * @param int $timeout in microseconds
+         * @return mixed
+         */
+        public function pop(int $timeout = -1): mixed { }
+
+        public function close(): void { }
+
+        public function getCapacity(): int { }
+
+        public function getLength(): int { }
+
+        public function isClosed(): bool { }
+
+        /** @return array<string, int> */
+        public function __serialize(): array { }
+
+        /** @param array<string, int> $data */
+        public function __unserialize(array $data): void { }
+    }
+}
+
 namespace Swow
 {
     /**
@@ -1109,6 +1238,10 @@ namespace Swow
 
         public static function alignSize(int $size = 0, int $alignment = 0): int { }
 
+        public static function getPoolStats(): array { }
+
+        public static function clearPool(): void { }
+
         public function __construct(int $size) { }
 
         public function alloc(int $size): void { }
@@ -1237,6 +1370,7 @@ namespace Swow
     {
         public const INVALID_FD = -1;
         public const DEFAULT_BACKLOG = 511;
+        public const DEFAULT_ACCEPT_BATCH_SIZE = 64;
         public const TYPE_FLAG_STREAM = 1;
         public const TYPE_FLAG_DGRAM = 2;
         public const TYPE_FLAG_INET = 16;
@@ -1342,9 +1476,23 @@ namespace Swow
          */
         public function acceptTo(self $connection, ?int $timeout = null): static { }
 
+        /**
+         * Wait for the first connection, then drain up to $max - 1 pending connections without waiting
+         * @param int $timeout [optional] = $this->getAcceptTimeout()
+         * @return static[] new un-constructed connections
+         */
+        public function acceptMany(int $max = self::DEFAULT_ACCEPT_BATCH_SIZE, ?int $timeout = null): array { }
+
+        /** @return bool false if there is no pending connection */
+        public function tryAcceptTo(self $connection): bool { }
+
         /** @param int $timeout [optional] = $this->getConnectTimeout() */
         public function connect(string $name, int $port = 0, ?int $timeout = null): static { }
 
+        /**
+         * @param array<string, mixed>|null $options 'ktls' => true offloads encryption of sending (and sendFile()) to kernel,
+         *                                           it falls back to user-space TLS if kernel or cipher does not support it
+         */
         public function enableCrypto(?array $options = null): static { }
 
         public function getSockAddress(): string { }
@@ -1379,6 +1527,7 @@ namespace Swow
         /**
          * read at max `$size` bytes data into buffer from socket,
          * returns when any data received or eof.
+         * if the buffer is unallocated, it waits for data first and allocates the buffer only then (`$size` bytes, or {@see Buffer::COMMON_SIZE} by default).
          *
          * @note context switching may happen here
          *
@@ -1467,6 +1616,34 @@ namespace Swow
          */
         public function recvDataFrom(\Swow\Buffer $buffer, int $offset = 0, int $size = -1, &$address = null, &$port = null, ?int $timeout = null): int { }
 
+        /**
+         * receive datagrams into buffers at once, one datagram per buffer (from the beginning of the buffer),
+         * it waits for the first datagram and then receives datagrams which have been queued as many as possible,
+         * peer infos are stored into `$addresses` and `$ports` with the same keys of `$buffers` if applicable,
+         * and so is `$truncated`, which tells whether the datagram was larger than its buffer and the rest of it has been discarded.
+         *
+         * @note context switching may happen here
+         *
+         * @throws SocketException when timed out
+         * @throws SocketException when socket read failed
+         * @param Buffer[] $buffers buffers to write in, length of each buffer will be set to the length of the datagram
+         * @param-out array<string> &$addresses peer addresses in string
+         * @param-out array<int> &$ports peer ports
+         * @param int|null $timeout timeout in microseconds or null for using {@see Socket::getReadTimeout()} value
+         * @param-out array<bool> &$truncated whether the datagrams have been truncated
+         * @return int count of received datagrams, they are stored into the first n buffers
+         */
+        public function recvMany(array $buffers, &$addresses = null, &$ports = null, ?int $timeout = null, &$truncated = null): int { }
+
+        /**
+         * wait until there is data to read (or the connection is closed by peer) without reading anything,
+         * so that no buffer is needed during waiting.
+         *
+         * @throws SocketException when socket wait failed or timed out
+         * @param int|null $timeout timeout in microseconds or null for using {@see Socket::getReadTimeout()} value
+         */
+        public function waitReadable(?int $timeout = null): static { }
+
         /**
          * read at max `$size` bytes data into buffer from socket without removing the read data from socket,
          * only works on some type of socket,
@@ -1719,6 +1896,23 @@ namespace Swow
          */
         public function sendTo(\Stringable|string $data, int $start = 0, int $length = -1, ?string $address = null, ?int $port = null, ?int $timeout = null): static { }
 
+        /**
+         * send datagrams at once, each element of `$datagrams` is the data to send,
+         * or an array of [data, address, port] to send to a different peer.
+         *
+         * @note context switching may happen here
+         *
+         * @throws SocketException when timed out
+         * @throws SocketException when socket write failed, return value of the exception is the count of sent datagrams
+         * @param array<\Stringable|string|array{0: \Stringable|string, 1?: string, 2?: int}> $datagrams datagrams to send
+         * @param string|null $address address to send to, may be ip or path (for UDG type), domain is not supported here
+         * @phpstan-param int<0, 65535>|null $port
+         * @psalm-param int<0, 65535>|null $port
+         * @param int|null $port port to send to
+         * @param int|null $timeout timeout in microseconds or null for using {@see Socket::getWriteTimeout()} value
+         */
+        public function sendMany(array $datagrams, ?string $address = null, ?int $port = null, ?int $timeout = null): static { }
+
         /**
          * Send a socket handle to peer via pipe socket
          * @param int $timeout [optional] = $this->getWriteTimeout()
@@ -1732,6 +1926,22 @@ namespace Swow
          */
         public function sendFile(string $filename, int $offset = 0, int $length = 0, ?int $timeout = null): int { }
 
+        /**
+         * Send the same data to many sockets, the data is shared by all sockets without copy,
+         * it is written directly if the socket is writable, and only the remaining data of
+         * sockets which would block will be queued and waited together
+         * @param array<self> $sockets
+         * @param int $timeout [optional] = Socket::getGlobalWriteTimeout()
+         * @return array<int> error codes of failed sockets, keys are the same as $sockets
+         */
+        public static function broadcast(array $sockets, \Stringable|string $data, ?int $timeout = null): array { }
+
+        /**
+         * Write out the data buffered by write coalescing and wait for it to be done
+         * @param int $timeout [optional] = $this->getWriteTimeout()
+         */
+        public function flush(?int $timeout = null): static { }
+
         public function close(): bool { }
 
         /** @return bool Whether the socket has been constructed and has not been closed */
@@ -1756,6 +1966,11 @@ namespace Swow
          * @return int return Errno constants if the socket is broken, zero otherwise,
          * it's a silent version of {@see Socket::checkLiveness()}
          */
+        /**
+         * @return bool Whether the encryption of sending has been offloaded to the kernel (kTLS)
+         */
+        public function isKtlsSendEnabled(): bool { }
+
         public function getConnectionError(): int { }
 
         /** @throws SocketException when the socket connection is broken */
@@ -1772,6 +1987,22 @@ namespace Swow
 
         public function getSendBufferSize(): int { }
 
+        public function isWriteCoalescingEnabled(): bool { }
+
+        /** @return int 0 if write coalescing is disabled */
+        public function getWriteCoalescingThreshold(): int { }
+
+        /** @return int size of data which is buffered and has not been written yet */
+        public function getWriteCoalescingBufferedSize(): int { }
+
+        /**
+         * I/O statistics of this socket, time is in nanoseconds,
+         * and latency histograms count accept()/connect() by how long they took
+         *
+         * @return array{bytes_read: int, bytes_written: int, read_syscalls: int, write_syscalls: int, read_eagains: int, write_eagains: int, read_wait_time: int, write_wait_time: int, accept_latency: array<string, int>, connect_latency: array<string, int>}
+         */
+        public function getStats(): array { }
+
         public function setRecvBufferSize(int $size): static { }
 
         public function setSendBufferSize(int $size): static { }
@@ -1780,6 +2011,14 @@ namespace Swow
 
         public function setTcpKeepAlive(bool $enable, int $delay): static { }
 
+        /**
+         * Small writes are buffered and written together by one writev() at the end of the current event loop round,
+         * data is written immediately (with buffered data) once the buffered size would reach the threshold,
+         * and it can be written out at any time by {@see Socket::flush()}
+         * @param int $threshold [optional] = 16384 (0 means default)
+         */
+        public function setWriteCoalescing(bool $enable = true, int $threshold = 0): static { }
+
         /** @return array<string, mixed> debug information for var_dump */
         public function __debugInfo(): array { }
 
@@ -1812,6 +2051,45 @@ namespace Swow
         public static function setGlobalReadTimeout(int $timeout): void { }
 
         public static function setGlobalWriteTimeout(int $timeout): void { }
+
+        public static function setGlobalDnsCacheSize(int $size): void { }
+
+        public static function setGlobalDnsCacheTtl(int $ttl): void { }
+
+        public static function setGlobalDnsCacheNegativeTtl(int $ttl): void { }
+
+        public static function getDnsCacheStats(): array { }
+
+        public static function clearDnsCache(): void { }
+
+        /**
+         * Aggregated I/O statistics of all sockets (including closed ones) in the current thread
+         *
+         * @return array{bytes_read: int, bytes_written: int, read_syscalls: int, write_syscalls: int, read_eagains: int, write_eagains: int, read_wait_time: int, write_wait_time: int, accept_latency: array<string, int>, connect_latency: array<string, int>}
+         * @see Socket::getStats()
+         */
+        public static function getGlobalStats(): array { }
+
+        public static function resetGlobalStats(): void { }
+
+        public static function setGlobalSslSessionCacheSize(int $size): void { }
+
+        public static function setGlobalSslSessionCacheTtl(int $ttl): void { }
+
+        /**
+         * Set the session ticket encryption keys shared by all server sockets,
+         * each key is 80 bytes long (16 bytes name, 32 bytes HMAC secret and 32 bytes AES key),
+         * the first one is used to encrypt and others are only used to decrypt,
+         * keys are generated and rotated automatically if it is an empty array (by default).
+         * @param string[] $keys
+         */
+        public static function setGlobalSslTicketKeys(array $keys): void { }
+
+        public static function setGlobalSslTicketKeyLifetime(int $lifetime): void { }
+
+        public static function getSslSessionCacheStats(): array { }
+
+        public static function clearSslSessionCache(): void { }
     }
 }
 
@@ -2355,6 +2633,19 @@ namespace Swow\Http
         /** @return int the length of the data which was parsed, same with $this->getParsedLength() */
         public function execute(\Stringable|string $data, int $start = 0, int $length = -1): int { }
 
+        /**
+         * Parse the request/status line and all header fields in one call,
+         * fields and values split across reads are joined together.
+         * It returns when the head is completed (event is EVENT_HEADERS_COMPLETE) or more data is needed (event is EVENT_NONE).
+         * @return int the length of the data which was parsed
+         */
+        public function executeHead(\Stringable|string $data, int $start = 0, int $length = -1): int { }
+
+        /**
+         * @return array{method?: string, uri?: string, status_code?: int, reason_phrase?: string, protocol_version: string, headers: array<string, array<string>>, header_names: array<string, string>}
+         */
+        public function getHead(): array { }
+
         public function getEvent(): int { }
 
         public function getEventName(): string { }
@@ -2408,6 +2699,80 @@ namespace Swow\Http
     class ParserException extends \Swow\Exception { }
 }
 
+namespace Swow\Http
+{
+    /**
+     * HTTP/1.1 server which does accepting, parsing, keep-alive, pipelining and responding natively,
+     * every connection is served in its own coroutine and the handler is called for every request.
+     */
+    class Server
+    {
+        public const DEFAULT_MAX_HEADER_LENGTH = 8192;
+        public const DEFAULT_MAX_CONTENT_LENGTH = 8388608;
+
+        /** @param \Swow\Socket $socket the listening socket */
+        public function __construct(\Swow\Socket $socket) { }
+
+        public function getSocket(): \Swow\Socket { }
+
+        public function getMaxHeaderLength(): int { }
+
+        public function setMaxHeaderLength(int $maxHeaderLength): static { }
+
+        public function getMaxContentLength(): int { }
+
+        public function setMaxContentLength(int $maxContentLength): static { }
+
+        /**
+         * Accept connections and serve them until the socket is closed.
+         * If the handler returns without calling $request->respond(), a 200 response is sent
+         * with the returned string as its body (or an empty body).
+         * If the handler throws, the connection is answered with 500 and closed,
+         * and the exception is thrown out of the connection coroutine.
+         * @param callable(\Swow\Http\Server\Request $request): mixed $handler
+         */
+        public function serve(callable $handler): void { }
+
+        private function handleConnection(\Swow\Socket $connection): void { }
+    }
+}
+
+namespace Swow\Http\Server
+{
+    final class Request
+    {
+        public function getMethod(): string { }
+
+        public function getUri(): string { }
+
+        public function getProtocolVersion(): string { }
+
+        /** @return array<string, array<string>> */
+        public function getHeaders(): array { }
+
+        /** @return array<string, string> lower-case name => name */
+        public function getHeaderNames(): array { }
+
+        public function hasHeader(string $name): bool { }
+
+        /** @return string values of the header (case-insensitive) joined by comma */
+        public function getHeader(string $name): string { }
+
+        public function getBody(): string { }
+
+        public function shouldKeepAlive(): bool { }
+
+        public function isResponded(): bool { }
+
+        /**
+         * The response is sent after the handler returns, together with responses of other pipelined requests.
+         * Content-Length and Connection headers are managed by the server,
+         * the body is never sent with 1xx, 204 and 304 status codes.
+         */
+        public function respond(int $statusCode = \Swow\Http\Status::OK, string $body = '', array $headers = []): void { }
+    }
+}
+
 namespace Swow\WebSocket
 {
     class WebSocket
@@ -2431,6 +2796,12 @@ namespace Swow\WebSocket
         public static function mask(\Stringable|string $data, int $start = 0, int $length = -1, string $maskingKey = '', int $index = 0): string { }
 
         public static function unmask(\Swow\Buffer $data, int $start = 0, int $length = -1, string $maskingKey = '', int $index = 0): void { }
+
+        /** @return string one of "scalar", "sse2", "avx2" or "neon" */
+        public static function getMaskingKernel(): string { }
+
+        /** @param string $kernel "auto" (select the best one by CPU detection), "scalar", "sse2", "avx2" or "neon" */
+        public static function setMaskingKernel(string $kernel): void { }
     }
 }
 